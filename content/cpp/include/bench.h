@@ -0,0 +1,148 @@
+// Micro-benchmark harness for the 09_Performance templates
+//
+// Header-only: #include "bench.h" (the board puts content/cpp/include on the
+// include path; elsewhere compile with -I content/cpp/include).
+//
+//   bench::Result slow = bench::run("bubble sort", [&] { ... });
+//   bench::Result fast = bench::run("std::sort", [&] { ... });
+//   bench::compare(slow, fast);
+//
+// Each run is warmed up once, then timed in batches of calls long enough
+// for the clock (at least BATCH_MS). The reported time per call is the
+// median of BATCHES batches, so one hiccup doesn't move the result, and
+// the spread (slowest minus fastest batch) shows how repeatable it was.
+//
+// Work the compiler can prove unused may be optimized away entirely -
+// pass each result to bench::keep() so it has to be computed, and inputs
+// known at compile time through bench::hide() so it isn't precomputed.
+
+#ifndef CODEBOARD_BENCH_H
+#define CODEBOARD_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+const double BATCH_MS = 20.0;
+const int BATCHES = 7;
+const long long MAX_CALLS_PER_BATCH = 100000000;
+
+struct Result {
+    std::string name;
+    double nsPerCall;   // Median batch
+    double spread;      // (slowest - fastest batch) / median
+    long long calls;    // Per batch
+};
+
+// Tell the compiler a value is used, so the work producing it stays
+template <typename T>
+inline void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Make the compiler forget what it knows about a value (e.g. a constant n),
+// so work that depends on it can't be computed at compile time
+template <typename T>
+inline void hide(T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : "+r,m"(value) : : "memory");
+#else
+    static volatile T copy;
+    copy = value;
+    value = copy;
+#endif
+}
+
+inline double nowNs() {
+    using namespace std::chrono;
+    return (double)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Nanoseconds as the shortest readable unit, always 10 characters wide
+inline std::string formatNs(double ns) {
+    char text[32];
+    if (ns >= 1e9) std::snprintf(text, sizeof text, "%7.3f s ", ns / 1e9);
+    else if (ns >= 1e6) std::snprintf(text, sizeof text, "%7.3f ms", ns / 1e6);
+    else if (ns >= 1e3) std::snprintf(text, sizeof text, "%7.3f us", ns / 1e3);
+    else std::snprintf(text, sizeof text, "%7.3f ns", ns);
+    return text;
+}
+
+inline void printHeader() {
+    static bool printed = false;
+    if (printed) return;
+    printed = true;
+    std::printf("%-34s %10s %8s %10s\n", "benchmark", "per call", "spread", "calls");
+    std::printf("%-34s %10s %8s %10s\n", "---------", "--------", "------", "-----");
+}
+
+template <typename Body>
+double timeBatch(Body& body, long long calls) {
+    double start = nowNs();
+    for (long long i = 0; i < calls; i++) body();
+    return nowNs() - start;
+}
+
+/**
+ * Time body() and print one line of the results table
+ * @param name - Label in the table
+ * @param body - The work to measure (one call)
+ */
+template <typename Body>
+Result run(const std::string& name, Body body) {
+    printHeader();
+
+    // Warm-up: caches, branch predictors and lazy allocations
+    double first = timeBatch(body, 1);
+
+    // Calls per batch, so a batch lasts at least BATCH_MS
+    long long calls = 1;
+    double elapsed = first;
+    while (elapsed < BATCH_MS * 1e6 && calls < MAX_CALLS_PER_BATCH) {
+        calls *= elapsed < BATCH_MS * 1e5 ? 10 : 2;
+        elapsed = timeBatch(body, calls);
+    }
+
+    std::vector<double> perCall;
+    for (int batch = 0; batch < BATCHES; batch++) {
+        perCall.push_back(timeBatch(body, calls) / calls);
+    }
+    std::sort(perCall.begin(), perCall.end());
+
+    Result result;
+    result.name = name;
+    result.nsPerCall = perCall[BATCHES / 2];
+    result.spread = (perCall.back() - perCall.front()) / result.nsPerCall;
+    result.calls = calls;
+
+    std::printf("%-34s %10s %7.1f%% %10lld\n", name.c_str(),
+                formatNs(result.nsPerCall).c_str(), result.spread * 100, calls);
+    std::fflush(stdout);
+    return result;
+}
+
+/**
+ * Print how much faster the second result is than the first
+ */
+inline void compare(const Result& baseline, const Result& other) {
+    double ratio = baseline.nsPerCall / other.nsPerCall;
+    if (ratio >= 1) {
+        std::printf("=> %s is %.1fx faster than %s\n", other.name.c_str(), ratio, baseline.name.c_str());
+    } else {
+        std::printf("=> %s is %.1fx slower than %s\n", other.name.c_str(), 1 / ratio, baseline.name.c_str());
+    }
+    std::fflush(stdout);
+}
+
+} // namespace bench
+
+#endif
@@ -0,0 +1,53 @@
+// Cache-Friendly Array Traversal
+
+#include <iostream>
+#include <vector>
+#include "bench.h"
+using namespace std;
+
+const int N = 2048;   // N x N ints = 16 MB, much bigger than the CPU caches
+
+// Row by row: consecutive addresses, every cache line is used fully
+long long sumRowMajor(const vector<int>& grid) {
+    long long sum = 0;
+    for (int row = 0; row < N; row++) {
+        for (int col = 0; col < N; col++) {
+            sum += grid[row * N + col];
+        }
+    }
+    return sum;
+}
+
+// Column by column: each access jumps N ints ahead, to another cache line
+long long sumColumnMajor(const vector<int>& grid) {
+    long long sum = 0;
+    for (int col = 0; col < N; col++) {
+        for (int row = 0; row < N; row++) {
+            sum += grid[row * N + col];
+        }
+    }
+    return sum;
+}
+
+int main() {
+    // A 2D array stored row after row, as C++ stores int grid[N][N]
+    vector<int> grid(N * N);
+    for (int i = 0; i < N * N; i++) {
+        grid[i] = i % 100;
+    }
+
+    cout << "Sum of a " << N << " x " << N << " grid" << endl << endl;
+
+    bench::Result rows = bench::run("row by row", [&] {
+        bench::keep(sumRowMajor(grid));
+    });
+    bench::Result cols = bench::run("column by column", [&] {
+        bench::keep(sumColumnMajor(grid));
+    });
+
+    cout << endl;
+    bench::compare(cols, rows);
+    cout << "Same additions, same result: " << sumRowMajor(grid) << " = " << sumColumnMajor(grid) << endl;
+
+    return 0;
+}
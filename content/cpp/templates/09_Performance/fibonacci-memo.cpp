@@ -0,0 +1,63 @@
+// Fibonacci: Recursive vs Memoized vs Iterative
+
+#include <iostream>
+#include <vector>
+#include "bench.h"
+using namespace std;
+
+// Recursive version: recomputes the same values again and again (O(2^n) calls)
+long long fibRecursive(int n) {
+    if (n <= 1) return n;
+    return fibRecursive(n-1) + fibRecursive(n-2);
+}
+
+// Memoized: the same recursion, but each value is computed once (O(n))
+long long fibMemo(int n, vector<long long>& memo) {
+    if (n <= 1) return n;
+    if (memo[n] != -1) return memo[n];
+    memo[n] = fibMemo(n-1, memo) + fibMemo(n-2, memo);
+    return memo[n];
+}
+
+long long fibMemoized(int n) {
+    vector<long long> memo(n + 1, -1);
+    return fibMemo(n, memo);
+}
+
+// Iterative: only the last two values (O(n), no extra memory)
+long long fibIterative(int n) {
+    long long previous = 0, current = 1;
+    if (n == 0) return 0;
+    for (int i = 2; i <= n; i++) {
+        long long next = previous + current;
+        previous = current;
+        current = next;
+    }
+    return current;
+}
+
+int main() {
+    int n = 30;
+
+    cout << "Fib(" << n << ") = " << fibRecursive(n) << " = "
+         << fibMemoized(n) << " = " << fibIterative(n) << endl << endl;
+
+    bench::Result recursive = bench::run("recursive", [&] {
+        bench::hide(n);
+        bench::keep(fibRecursive(n));
+    });
+    bench::Result memoized = bench::run("memoized", [&] {
+        bench::hide(n);
+        bench::keep(fibMemoized(n));
+    });
+    bench::Result iterative = bench::run("iterative", [&] {
+        bench::hide(n);
+        bench::keep(fibIterative(n));
+    });
+
+    cout << endl;
+    bench::compare(recursive, memoized);
+    bench::compare(recursive, iterative);
+
+    return 0;
+}
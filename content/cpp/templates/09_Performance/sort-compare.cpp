@@ -0,0 +1,55 @@
+// Bubble Sort vs std::sort
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include "bench.h"
+using namespace std;
+
+// Same algorithm as 06_Algorithms/sort-bubble.cpp: O(n^2) comparisons
+void bubbleSort(int arr[], int size) {
+    for (int i = 0; i < size - 1; i++) {
+        for (int j = 0; j < size - i - 1; j++) {
+            if (arr[j] > arr[j + 1]) {
+                // Swap
+                int temp = arr[j];
+                arr[j] = arr[j + 1];
+                arr[j + 1] = temp;
+            }
+        }
+    }
+}
+
+void compareSorts(int size) {
+    // The same random numbers for both; every call sorts a fresh copy
+    vector<int> original(size);
+    srand(42);
+    for (int i = 0; i < size; i++) {
+        original[i] = rand() % 10000;
+    }
+
+    cout << "n = " << size << endl;
+    bench::Result bubble = bench::run("bubble sort", [&] {
+        vector<int> numbers = original;
+        bubbleSort(numbers.data(), size);
+        bench::keep(numbers[0]);
+    });
+    bench::Result standard = bench::run("std::sort", [&] {
+        vector<int> numbers = original;
+        sort(numbers.begin(), numbers.end());
+        bench::keep(numbers[0]);
+    });
+    bench::compare(bubble, standard);
+    cout << endl;
+}
+
+int main() {
+    // For a handful of numbers the difference is small;
+    // it grows with n because n^2 grows faster than n log n
+    compareSorts(20);
+    compareSorts(200);
+    compareSorts(2000);
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+// Struct Parameters: by Value vs by const Reference
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench.h"
+using namespace std;
+
+struct Student {
+    string name;
+    int age;
+    vector<double> grades;
+};
+
+// By value: the whole struct is copied on every call,
+// including a new allocation for the grades
+double averageByValue(Student s) {
+    double sum = 0;
+    for (double grade : s.grades) sum += grade;
+    return sum / s.grades.size();
+}
+
+// By const reference: no copy, and const still forbids changes
+double averageByRef(const Student& s) {
+    double sum = 0;
+    for (double grade : s.grades) sum += grade;
+    return sum / s.grades.size();
+}
+
+int main() {
+    Student student = {"Alice", 20, {}};
+    for (int i = 0; i < 200; i++) {
+        student.grades.push_back(5 + i % 6);
+    }
+
+    cout << student.name << ": average " << averageByRef(student)
+         << " over " << student.grades.size() << " grades" << endl << endl;
+
+    bench::Result byValue = bench::run("Student by value", [&] {
+        bench::keep(averageByValue(student));
+    });
+    bench::Result byRef = bench::run("const Student& (by reference)", [&] {
+        bench::keep(averageByRef(student));
+    });
+
+    cout << endl;
+    bench::compare(byValue, byRef);
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+// vector::reserve vs Repeated Growth
+
+#include <iostream>
+#include <vector>
+#include "bench.h"
+using namespace std;
+
+const int N = 100000;
+
+// The vector grows as needed: when full, it allocates a bigger
+// block and moves every element there
+vector<int> fillGrowing(int n) {
+    vector<int> numbers;
+    for (int i = 0; i < n; i++) {
+        numbers.push_back(i);
+    }
+    return numbers;
+}
+
+// One allocation of the final size up front
+vector<int> fillReserved(int n) {
+    vector<int> numbers;
+    numbers.reserve(n);
+    for (int i = 0; i < n; i++) {
+        numbers.push_back(i);
+    }
+    return numbers;
+}
+
+int main() {
+    // How many times does a growing vector reallocate?
+    vector<int> numbers;
+    int reallocations = 0;
+    for (int i = 0; i < N; i++) {
+        size_t before = numbers.capacity();
+        numbers.push_back(i);
+        if (numbers.capacity() != before) reallocations++;
+    }
+    cout << "push_back of " << N << " ints: " << reallocations
+         << " reallocations, final capacity " << numbers.capacity() << endl << endl;
+
+    bench::Result growing = bench::run("push_back, growing", [&] {
+        bench::keep(fillGrowing(N));
+    });
+    bench::Result reserved = bench::run("reserve, then push_back", [&] {
+        bench::keep(fillReserved(N));
+    });
+
+    cout << endl;
+    bench::compare(growing, reserved);
+
+    return 0;
+}
@@ -11,6 +11,16 @@ const fs = require('fs');
 const multer = require('multer');
 const archiver = require('archiver');
 const iconv = require('iconv-lite');
+const TextOps = require('./src/core/TextOps.js');
+const LineDigest = require('./src/core/LineDigest.js');
+const SessionDocuments = require('./server/SessionDocuments.js');
+const WorkspaceManager = require('./server/WorkspaceManager.js');
+const SessionRecorder = require('./server/SessionRecorder.js');
+const CppRunner = require('./server/CppRunner.js');
+const Grader = require('./server/Grader.js');
+const ComplexityLab = require('./server/ComplexityLab.js');
+const SyntaxChecker = require('./server/SyntaxChecker.js');
+const Metrics = require('./server/Metrics.js');
 
 const app = express();
 const server = http.createServer(app);
@@ -180,10 +190,12 @@ function debounce(func, wait) {
 // Save state to file (debounced to avoid excessive writes)
 const saveState = debounce(() => {
     try {
+        const active = boardDocs.active.doc;
         const stateToSave = {
-            code: currentState.code,
+            code: active.code,
+            ...boardDocs.toJSON(),
             savedAt: new Date().toISOString(),
-            lastUpdatedBy: currentState.lastUpdatedBy
+            lastUpdatedBy: active.updatedBy
         };
         fs.writeFileSync(SESSION_FILE, JSON.stringify(stateToSave, null, 2), 'utf8');
         console.log('💾 Session state saved');
@@ -197,8 +209,13 @@ function loadSavedState() {
     try {
         if (fs.existsSync(SESSION_FILE)) {
             const savedData = JSON.parse(fs.readFileSync(SESSION_FILE, 'utf8'));
+            if (Array.isArray(savedData.documents)) {
+                boardDocs.restore(savedData);
+                console.log(`📂 Loaded saved session from ${savedData.savedAt} (${savedData.documents.length} documents)`);
+                return true;
+            }
             if (savedData.code) {
-                currentState.code = savedData.code;
+                boardDocs.active.doc.code = savedData.code;
                 console.log(`📂 Loaded saved session from ${savedData.savedAt}`);
                 return true;
             }
@@ -291,8 +308,7 @@ app.post('/api/clear-session', (req, res) => {
         if (fs.existsSync(SESSION_FILE)) {
             fs.unlinkSync(SESSION_FILE);
         }
-        currentState.code = '';
-        currentState.lastUpdatedBy = null;
+        boardDocs.active.doc.replace('');
         console.log('🗑️ Session cleared');
         res.json({ success: true, message: 'Session cleared' });
     } catch (error) {
@@ -703,13 +719,45 @@ function getFilesRecursively(dir, baseDir) {
 
 // Store current state
 let currentState = {
-    code: '',
     cursorPosition: 0,
-    lastUpdatedBy: null,
     connectedUsers: [],
     language: 'glossa' // Current language (synced from teacher)
 };
 
+// ============================================
+// DELTA CODE SYNC - code_ops (see src/core/TextOps.js)
+// ============================================
+
+// The class board: named documents (tabs), everyone on the active one outside workspace mode
+const boardDocs = new SessionDocuments();
+const MAX_OPS_PER_MESSAGE = 500;
+
+// Private per-student documents (teacher's workspace mode)
+const workspaces = new WorkspaceManager();
+let workspaceSummaryTimer = null;
+
+// ============================================
+// LESSON RECORDING (see server/SessionRecorder.js)
+// ============================================
+const RECORDINGS_DIR = path.join(__dirname, 'recordings');
+const recorder = new SessionRecorder(RECORDINGS_DIR, () => {
+    const active = boardDocs.active;
+    return {
+        code: active.doc.code,
+        version: active.doc.version,
+        docId: active.id,
+        docName: active.name,
+        language: currentState.language
+    };
+});
+
+function isValidOpsMessage(message) {
+    return Array.isArray(message.ops) &&
+        message.ops.length <= MAX_OPS_PER_MESSAGE &&
+        message.ops.every(TextOps.isValid) &&
+        Number.isInteger(message.baseVersion);
+}
+
 // ============================================
 // ACCESS CONTROL - Waiting Room / Lobby System
 // ============================================
@@ -773,12 +821,36 @@ const TEACHER_PASSWORD = process.env.TEACHER_PASSWORD || null;
 const clients = new Map();
 let clientIdCounter = 0;
 
+// Message, handler, event-loop and GC counters (/metrics, /api/metrics)
+const metrics = new Metrics();
+
+// Connections and outbound queues by room: the teacher(s), the waiting room,
+// students following the board, students in their own workspace
+function roomStats() {
+    const rooms = {};
+    for (const name of ['teacher', 'waiting', 'board', 'workspace']) {
+        rooms[name] = { connections: 0, queuedBytes: 0, maxQueuedBytes: 0 };
+    }
+    clients.forEach((client, ws) => {
+        let room = 'board';
+        if (client.role === 'teacher') room = 'teacher';
+        else if (!authenticatedClients.get(ws)) room = 'waiting';
+        else if (workspaces.enabled) room = 'workspace';
+        const stats = rooms[room];
+        stats.connections++;
+        stats.queuedBytes += ws.bufferedAmount;
+        stats.maxQueuedBytes = Math.max(stats.maxQueuedBytes, ws.bufferedAmount);
+    });
+    return rooms;
+}
+
 // Known student identities for reconnection persistence
 // Maps stored studentId -> { name, lastSeen }
 const knownStudents = new Map();
 
 // Broadcast to all clients except sender
 function broadcast(message, excludeClient = null) {
+    recorder.capture(message);
     const data = JSON.stringify(message);
     wss.clients.forEach(client => {
         if (client !== excludeClient && client.readyState === WebSocket.OPEN) {
@@ -789,6 +861,7 @@ function broadcast(message, excludeClient = null) {
 
 // Broadcast to ALL clients including sender
 function broadcastAll(message) {
+    recorder.capture(message);
     const data = JSON.stringify(message);
     wss.clients.forEach(client => {
         if (client.readyState === WebSocket.OPEN) {
@@ -797,7 +870,298 @@ function broadcastAll(message) {
     });
 }
 
+// Send to every teacher except sender
+function sendToTeachers(message, excludeClient = null) {
+    recorder.capture(message);
+    const data = JSON.stringify(message);
+    wss.clients.forEach(targetWs => {
+        const targetClient = clients.get(targetWs);
+        if (targetWs !== excludeClient &&
+            targetWs.readyState === WebSocket.OPEN &&
+            targetClient && targetClient.role === 'teacher') {
+            targetWs.send(data);
+        }
+    });
+}
+
+// ============================================
+// WORKSPACES - per-student documents (see server/WorkspaceManager.js)
+// ============================================
+
+// The board document a message names (message.doc), or the active one
+function boardTarget(docId) {
+    const entry = docId ? boardDocs.get(docId) : boardDocs.active;
+    return entry ? { doc: entry.doc, workspace: null, docId: entry.id } : null;
+}
+
+// The document a code message edits: { doc, workspace, docId }, workspace === null for the board.
+// Students edit their own workspace while the mode is on; the teacher edits
+// the board, or the workspace named by message.workspace (opened from the overview).
+// Returns null when the named workspace or board document no longer exists.
+function resolveDocument(client, message) {
+    if (client.role === 'student' && workspaces.enabled) {
+        const workspace = workspaces.get(client.id, client.name);
+        return { doc: workspace.doc, workspace };
+    }
+    if (client.role === 'student' || message.workspace === undefined || message.workspace === null) {
+        return boardTarget(message.doc);
+    }
+    const workspace = workspaces.enabled ? workspaces.find(message.workspace) : undefined;
+    return workspace ? { doc: workspace.doc, workspace } : null;
+}
+
+// Answer to a code message whose document is gone
+function rejectDocument(ws, message) {
+    if (message.workspace !== undefined && message.workspace !== null) {
+        ws.send(JSON.stringify({ type: 'workspace_closed', workspace: String(message.workspace) }));
+    }
+    // A closed board document: the client already got docs_list / doc_activate
+}
+
+// Tag a code message with the document it belongs to (clients drop the others)
+function forDocument(target, message) {
+    message.workspace = target.workspace ? target.workspace.studentId : null;
+    if (!target.workspace) message.doc = target.docId;
+    return message;
+}
+
+// Send a code change to everyone else who has that document open
+function publishCodeChange(target, message, senderWs) {
+    forDocument(target, message);
+    const workspace = target.workspace;
+    if (!workspace) {
+        // Inactive board documents are not pushed: clients fetch them when activated
+        if (target.docId !== boardDocs.activeId) return;
+        if (workspaces.enabled) {
+            // Students are in their own workspaces - only teachers see the board
+            sendToTeachers(message, senderWs);
+        } else {
+            broadcast(message, senderWs);
+        }
+        return;
+    }
+    
+    workspaces.touch(workspace, message.cursorRow);
+    sendToWorkspace(workspace, message, senderWs);
+}
+
+// Send to the student who owns a workspace and the teachers watching it
+function sendToWorkspace(workspace, message, senderWs = null) {
+    const data = JSON.stringify(message);
+    wss.clients.forEach(targetWs => {
+        if (targetWs === senderWs || targetWs.readyState !== WebSocket.OPEN) return;
+        const targetClient = clients.get(targetWs);
+        const isOwner = targetClient && targetClient.role === 'student' &&
+            String(targetClient.id) === workspace.studentId;
+        if (isOwner || workspace.watchers.has(targetWs)) {
+            targetWs.send(data);
+        }
+    });
+}
+
+// ============================================
+// ANTI-ENTROPY - block hashes let clients find and repair divergence
+// (see src/core/LineDigest.js)
+// ============================================
+
+const DIGEST_INTERVAL_MS = 5000;
+const digestSentFor = new WeakMap(); // SyncedDocument -> version of the last digest sent
+
+// Digest of every document that changed since the last round: the active
+// board document, and in workspace mode each student's workspace
+function sendDigests() {
+    const board = boardTarget(null);
+    if (digestSentFor.get(board.doc) !== board.doc.version) {
+        digestSentFor.set(board.doc, board.doc.version);
+        publishCodeChange(board, { type: 'code_digest', ...board.doc.digest() }, null);
+    }
+    if (!workspaces.enabled) return;
+    workspaces.workspaces.forEach(workspace => {
+        if (digestSentFor.get(workspace.doc) === workspace.doc.version) return;
+        digestSentFor.set(workspace.doc, workspace.doc.version);
+        sendToWorkspace(workspace, forDocument({ doc: workspace.doc, workspace }, {
+            type: 'code_digest',
+            ...workspace.doc.digest()
+        }));
+    });
+}
+
+// A timer callback that throws would end the process: log and try next round
+setInterval(() => {
+    try {
+        sendDigests();
+    } catch (error) {
+        console.error('❌ Sending digests failed:', error);
+    }
+}, DIGEST_INTERVAL_MS);
+
+// ============================================
+// RUNNING C++ (see server/CppRunner.js)
+// ============================================
+
+const cppRunner = new CppRunner(path.join(__dirname, 'content', 'cpp', 'include'), { hide: [__dirname] });
+const runsByClient = new Map(); // ws -> runId of the client's current run
+const MAX_RUN_INPUT_BYTES = 4096;
+
+// Forward a runner event to the client that started the run
+function sendRunEvent(ws, event) {
+    const { type, ...rest } = event;
+    if (type === 'exit' && runsByClient.get(ws) === event.runId) {
+        runsByClient.delete(ws);
+    }
+    if (ws.readyState !== WebSocket.OPEN) return;
+    if (type === 'output') {
+        ws.send(JSON.stringify({ type: 'run_output', ...rest }));
+    } else if (type === 'exit') {
+        ws.send(JSON.stringify({ type: 'run_exit', ...rest }));
+    } else {
+        ws.send(JSON.stringify({ type: 'run_status', state: type, ...rest }));
+    }
+}
+
+// ============================================
+// GRADING (see server/Grader.js)
+// ============================================
+
+const grader = new Grader(cppRunner, path.join(__dirname, 'content', 'cpp', 'exercises'));
+
+// Grade every student workspace; the teachers get one summary message
+async function gradeWorkspaces(ws) {
+    const fail = (error) => ws.send(JSON.stringify({ type: 'grade_results', error }));
+    if (!workspaces.enabled) return fail('Turn on private workspaces first');
+    if (grader.grading) return fail('Grading is already running');
+
+    const submissions = Array.from(workspaces.workspaces.values()).map(workspace => ({
+        studentId: workspace.studentId,
+        name: workspace.name,
+        code: workspace.doc.code
+    }));
+    const startedAt = Date.now();
+    const results = await grader.grade(submissions, workspaces.seedCode);
+
+    const count = status => results.filter(result => result.status === status).length;
+    const summary = {
+        students: results.length,
+        passed: count('passed'),
+        failed: count('failed'),
+        compileErrors: count('compile_error'),
+        ungraded: results.length - count('passed') - count('failed') - count('compile_error')
+    };
+    console.log(`✅ Graded ${results.length} workspaces in ${Date.now() - startedAt} ms: ${summary.passed} passed`);
+    sendToTeachers({ type: 'grade_results', results, summary, timeMs: Date.now() - startedAt });
+}
+
+// ============================================
+// COMPLEXITY LAB (see server/ComplexityLab.js)
+// ============================================
+
+// Benchmark points go to every board as they are measured
+const complexityLab = new ComplexityLab(cppRunner, message => broadcastAll(message));
+
+// ============================================
+// DIAGNOSTICS (see server/SyntaxChecker.js)
+// ============================================
+
+const syntaxChecker = new SyntaxChecker(cppRunner);
+
+function diagnosticsKey(target) {
+    return target.workspace ? `workspace:${target.workspace.studentId}` : `doc:${target.docId}`;
+}
+
+// Check a C++ document once its edits pause (or right away, after a tab switch);
+// the markers go to everyone who has it open
+function checkSyntax(target, now = false) {
+    if (currentState.language !== 'cpp' || !target) return;
+    const send = result => {
+        if (currentState.language === 'cpp') sendDiagnostics(target, result);
+    };
+    if (now) {
+        syntaxChecker.checkNow(diagnosticsKey(target), target.doc, send);
+    } else {
+        syntaxChecker.schedule(diagnosticsKey(target), target.doc, send);
+    }
+}
+
+function sendDiagnostics(target, result, ws = null) {
+    const message = forDocument(target, { type: 'code_diagnostics', ...result });
+    if (ws) {
+        ws.send(JSON.stringify(message));
+    } else if (target.workspace) {
+        sendToWorkspace(target.workspace, message);
+    } else {
+        publishCodeChange(target, message, null);
+    }
+}
+
+// The last markers of a document, for a client that just opened it
+function sendLatestDiagnostics(target, ws) {
+    if (currentState.language !== 'cpp') return;
+    const latest = syntaxChecker.latest(diagnosticsKey(target), target.doc);
+    if (latest) sendDiagnostics(target, latest, ws);
+}
+
+// Turn workspace mode on (students get a copy of the board) or off (back to the board)
+function setWorkspaceMode(enabled) {
+    if (enabled === workspaces.enabled) return;
+    
+    if (enabled) {
+        workspaces.enable(boardDocs.active.doc.code);
+        // Workspaces for everyone already in class, so the overview starts full
+        clients.forEach(client => {
+            if (client.role === 'student' && authenticatedClients.get(client.ws)) {
+                workspaces.get(client.id, client.name);
+            }
+        });
+        workspaceSummaryTimer = setInterval(sendWorkspaceSummaries, WorkspaceManager.SUMMARY_INTERVAL_MS);
+    } else {
+        workspaces.workspaces.forEach(workspace => syntaxChecker.cancel(diagnosticsKey({ workspace })));
+        workspaces.disable();
+        clearInterval(workspaceSummaryTimer);
+        workspaceSummaryTimer = null;
+    }
+    console.log(`📝 Workspace mode: ${enabled ? 'ON' : 'OFF'}`);
+    
+    // Every new workspace starts as the seed at version 0
+    broadcastAll({
+        type: 'workspace_mode',
+        enabled,
+        code: enabled ? workspaces.seedCode : boardDocs.active.doc.code,
+        version: enabled ? 0 : boardDocs.active.doc.version,
+        doc: boardDocs.activeId
+    });
+}
+
+// Low-rate overview for the teacher: changed workspaces only, within a byte budget
+function sendWorkspaceSummaries() {
+    const summaries = workspaces.takeSummaries();
+    if (summaries.length > 0) {
+        sendToTeachers({ type: 'workspace_summaries', summaries });
+    }
+}
+
+// State sent with init: the board, or the student's own workspace
+function initStateFor(client) {
+    const target = resolveDocument(client, {});
+    return {
+        code: target.doc.code,
+        cursorPosition: currentState.cursorPosition,
+        language: currentState.language,
+        version: target.doc.version,
+        workspace: target.workspace ? target.workspace.studentId : null,
+        workspaceMode: workspaces.enabled,
+        documents: boardDocs.list(),
+        activeDoc: boardDocs.activeId
+    };
+}
+
+// Everyone moves to another board document: only its id and version are sent
+function broadcastActiveDocument(excludeClient = null) {
+    const active = boardDocs.active;
+    broadcast({ type: 'doc_activate', docId: active.id, name: active.name, version: active.doc.version }, excludeClient);
+}
+
 wss.on('connection', (ws, req) => {
+    metrics.track(ws);
     const urlParams = new URLSearchParams(req.url.split('?')[1] || '');
     const isTeacher = urlParams.get('role') === 'teacher';
     const providedPassword = urlParams.get('password');
@@ -881,16 +1245,26 @@ wss.on('connection', (ws, req) => {
         // Send current state to new client
         ws.send(JSON.stringify({
             type: 'init',
-            state: {
-                code: currentState.code,
-                cursorPosition: currentState.cursorPosition,
-                language: currentState.language
-            },
+            state: initStateFor(clientInfo),
             yourId: clientId,
             yourRole: clientInfo.role,
             connectedUsers: currentState.connectedUsers
         }));
         
+        // A (re)connecting teacher needs every student's summary again
+        if (isTeacher && workspaces.enabled) {
+            workspaces.touchAll();
+        }
+        if (isTeacher) {
+            ws.send(JSON.stringify({ type: 'recording_state', ...recorder.status() }));
+        }
+        if (complexityLab.series.length > 0) {
+            ws.send(JSON.stringify({ type: 'bench_state', series: complexityLab.state() }));
+        }
+        if (isTeacher || !workspaces.enabled) {
+            sendLatestDiagnostics(boardTarget(null), ws);
+        }
+        
         // Notify others about new connection
         broadcast({
             type: 'user_joined',
@@ -900,23 +1274,34 @@ wss.on('connection', (ws, req) => {
     }
     
     ws.on('message', (data) => {
+        const startedAt = performance.now();
+        let type = null;
         try {
             const message = JSON.parse(data);
             const client = clients.get(ws);
+            type = message.type;
             
             switch (message.type) {
-                case 'code_update':
-                    // Update server state
-                    currentState.code = message.code;
-                    currentState.lastUpdatedBy = client.id;
+                case 'code_update': {
+                    // Update server state (full replace)
+                    if (typeof message.code !== 'string') break;
+                    const target = resolveDocument(client, message);
+                    if (!target) {
+                        rejectDocument(ws, message);
+                        break;
+                    }
+                    const version = target.doc.replace(message.code, client.id);
                     
-                    // Save state to file (debounced)
-                    saveState();
+                    // Save state to file (debounced) - only the board is persisted
+                    if (!target.workspace) saveState();
                     
-                    // Broadcast to others (include cursor position)
-                    broadcast({
+                    ws.send(JSON.stringify(forDocument(target, { type: 'code_ack', version, ackFor: 'full' })));
+                    
+                    // Send to the others on this document (include cursor position)
+                    publishCodeChange(target, {
                         type: 'code_update',
                         code: message.code,
+                        version: version,
                         updatedBy: client.id,
                         updaterName: client.name,
                         updaterRole: client.role,
@@ -924,15 +1309,263 @@ wss.on('connection', (ws, req) => {
                         cursorCol: message.cursorCol,
                         userId: client.id
                     }, ws);
+                    checkSyntax(target);
                     break;
+                }
+                
+                case 'code_ops': {
+                    // Incremental edit: only the changed ranges travel over the wire
+                    const target = resolveDocument(client, message);
+                    if (!target) {
+                        rejectDocument(ws, message);
+                        break;
+                    }
+                    const result = isValidOpsMessage(message)
+                        ? target.doc.applyOps(message.ops, message.baseVersion, client.id)
+                        : null;
                     
-                case 'cursor_update':
-                    // Broadcast cursor position (to teacher only)
+                    if (!result) {
+                        // Can't merge - give the sender the authoritative copy
+                        ws.send(JSON.stringify(forDocument(target, {
+                            type: 'code_resync',
+                            code: target.doc.code,
+                            version: target.doc.version
+                        })));
+                        break;
+                    }
+                    
+                    if (!target.workspace) saveState();
+                    
+                    ws.send(JSON.stringify(forDocument(target, { type: 'code_ack', version: result.version, ackFor: 'ops' })));
+                    
+                    publishCodeChange(target, {
+                        type: 'code_ops',
+                        ops: result.ops,
+                        version: result.version,
+                        updatedBy: client.id,
+                        updaterName: client.name,
+                        updaterRole: client.role,
+                        cursorRow: message.cursorRow,
+                        cursorCol: message.cursorCol,
+                        userId: client.id
+                    }, ws);
+                    checkSyntax(target);
+                    break;
+                }
+                
+                case 'code_resync_request': {
+                    const target = resolveDocument(client, message) || boardTarget(null);
+                    ws.send(JSON.stringify(forDocument(target, {
+                        type: 'code_resync',
+                        code: target.doc.code,
+                        version: target.doc.version
+                    })));
+                    break;
+                }
+                
+                case 'code_repair_request': {
+                    // A client's copy failed the digest: send only the differing blocks.
+                    // A stale request (document changed since) waits for the next digest.
+                    const target = resolveDocument(client, message);
+                    if (!target || target.doc.version !== message.version || !Array.isArray(message.blocks)) break;
+                    ws.send(JSON.stringify(forDocument(target, {
+                        type: 'code_repair',
+                        version: target.doc.version,
+                        blocks: LineDigest.blocks(target.doc.code, message.blocks.slice(0, target.doc.digest().blocks.length))
+                    })));
+                    break;
+                }
+                
+                case 'run_start': {
+                    // Compile and run the document the client is on; one run per client
+                    if (client.role !== 'teacher' && !authenticatedClients.get(ws)) break;
+                    const target = resolveDocument(client, message);
+                    if (!target) {
+                        rejectDocument(ws, message);
+                        break;
+                    }
+                    if (runsByClient.has(ws)) {
+                        cppRunner.stop(runsByClient.get(ws));
+                    }
+                    const runId = cppRunner.submit(target.doc.code, event => sendRunEvent(ws, event));
+                    if (runId) {
+                        runsByClient.set(ws, runId);
+                    } else {
+                        ws.send(JSON.stringify({ type: 'run_exit', runId: null, reason: 'busy' }));
+                    }
+                    break;
+                }
+                
+                case 'run_input':
+                    // A line the user typed for the program's stdin
+                    if (message.runId === runsByClient.get(ws) && typeof message.data === 'string') {
+                        cppRunner.write(message.runId, message.data.slice(0, MAX_RUN_INPUT_BYTES));
+                    }
+                    break;
+                
+                case 'run_eof':
+                    if (message.runId === runsByClient.get(ws)) {
+                        cppRunner.closeInput(message.runId);
+                    }
+                    break;
+                
+                case 'run_stop':
+                    if (message.runId === runsByClient.get(ws)) {
+                        cppRunner.stop(message.runId);
+                    }
+                    break;
+                
+                case 'grade_start':
+                    // Teacher: grade the class's workspaces
+                    if (client.role === 'teacher') {
+                        gradeWorkspaces(ws).catch(error => {
+                            console.error('❌ Grading failed:', error);
+                            ws.send(JSON.stringify({ type: 'grade_results', error: 'Grading failed' }));
+                        });
+                    }
+                    break;
+                
+                case 'bench_start': {
+                    // Teacher: measure how the document's algorithm scales (or a baseline)
+                    if (client.role !== 'teacher') break;
+                    const target = resolveDocument(client, message);
+                    if (!target) {
+                        rejectDocument(ws, message);
+                        break;
+                    }
+                    const error = complexityLab.start(target.doc.code, message.baseline);
+                    if (error) {
+                        ws.send(JSON.stringify({ type: 'bench_error', error }));
+                    }
+                    break;
+                }
+                
+                case 'bench_clear':
+                    if (client.role === 'teacher') {
+                        complexityLab.clear();
+                    }
+                    break;
+                
+                case 'recording_start':
+                case 'recording_stop':
+                    // Teacher started/stopped recording the lesson
+                    if (client.role === 'teacher') {
+                        if (message.type === 'recording_start') {
+                            recorder.start();
+                        } else {
+                            recorder.stop();
+                        }
+                        console.log(`⏺️ Recording: ${recorder.recording ? 'ON' : 'OFF'}`);
+                        sendToTeachers({ type: 'recording_state', ...recorder.status() });
+                    }
+                    break;
+                
+                case 'workspace_mode':
+                    // Teacher turned private student workspaces on/off
+                    if (client.role === 'teacher') {
+                        setWorkspaceMode(!!message.enabled);
+                    }
+                    break;
+                
+                case 'workspace_open': {
+                    // Teacher opened one student: full document, then their live edits
+                    if (client.role !== 'teacher') break;
+                    workspaces.unwatch(ws);
+                    const workspace = workspaces.enabled ? workspaces.find(message.studentId) : undefined;
+                    if (!workspace) {
+                        ws.send(JSON.stringify({ type: 'workspace_closed', workspace: String(message.studentId) }));
+                        break;
+                    }
+                    workspace.watchers.add(ws);
+                    ws.send(JSON.stringify({
+                        type: 'workspace_snapshot',
+                        workspace: workspace.studentId,
+                        name: workspace.name,
+                        code: workspace.doc.code,
+                        version: workspace.doc.version
+                    }));
+                    sendLatestDiagnostics({ doc: workspace.doc, workspace }, ws);
+                    break;
+                }
+                
+                case 'workspace_close':
+                    // Teacher went back to the board
+                    if (client.role !== 'teacher') break;
+                    workspaces.unwatch(ws);
+                    ws.send(JSON.stringify({
+                        type: 'workspace_snapshot',
+                        workspace: null,
+                        doc: boardDocs.activeId,
+                        code: boardDocs.active.doc.code,
+                        version: boardDocs.active.doc.version
+                    }));
+                    sendLatestDiagnostics(boardTarget(null), ws);
+                    break;
+                
+                // ============================================
+                // BOARD DOCUMENTS (tabs)
+                // ============================================
+                
+                case 'doc_create': {
+                    // Teacher opened a new tab (template, exercise, file...)
+                    if (client.role !== 'teacher' || typeof message.code !== 'string') break;
+                    const entry = boardDocs.create(message.name, message.code);
+                    entry.doc.updatedBy = client.id;
+                    boardDocs.activate(entry.id);
+                    saveState();
+                    
+                    // The creator already shows the text
+                    ws.send(JSON.stringify({ type: 'doc_created', docId: entry.id }));
+                    broadcastAll({ type: 'docs_list', documents: boardDocs.list(), activeDoc: boardDocs.activeId });
+                    broadcastActiveDocument(ws);
+                    checkSyntax(boardTarget(null), true);
+                    break;
+                }
+                
+                case 'doc_activate':
+                    // Teacher switched tabs
+                    if (client.role !== 'teacher' || !boardDocs.activate(message.docId)) break;
+                    saveState();
+                    broadcastActiveDocument();
+                    checkSyntax(boardTarget(null), true);
+                    break;
+                
+                case 'doc_close': {
+                    // Teacher closed a tab (the last one stays)
+                    if (client.role !== 'teacher' || !boardDocs.get(message.docId)) break;
+                    const activeChanged = boardDocs.remove(message.docId);
+                    syntaxChecker.cancel(`doc:${message.docId}`);
+                    saveState();
+                    broadcastAll({ type: 'docs_list', documents: boardDocs.list(), activeDoc: boardDocs.activeId });
+                    if (activeChanged) {
+                        broadcastActiveDocument();
+                        checkSyntax(boardTarget(null), true);
+                    }
+                    break;
+                }
+                
+                case 'doc_fetch': {
+                    // A client without a fresh copy of the active (or any) tab
+                    const reply = boardDocs.fetch(message.docId, message.version);
+                    if (reply) {
+                        ws.send(JSON.stringify({ type: 'doc_content', ...reply }));
+                    }
+                    break;
+                }
+                    
+                case 'cursor_update': {
+                    // Broadcast cursor position (to teacher only).
+                    // In workspace mode: only to a teacher who has this student open.
+                    const cursorWorkspace = client.role === 'student' && workspaces.enabled
+                        ? workspaces.get(client.id, client.name)
+                        : null;
+                    if (cursorWorkspace) workspaces.moveCursor(cursorWorkspace, message.line);
                     wss.clients.forEach(targetWs => {
                         const targetClient = clients.get(targetWs);
                         if (targetWs !== ws && 
                             targetWs.readyState === WebSocket.OPEN && 
-                            targetClient && targetClient.role === 'teacher') {
+                            targetClient && targetClient.role === 'teacher' &&
+                            (!cursorWorkspace || cursorWorkspace.watchers.has(targetWs))) {
                             targetWs.send(JSON.stringify({
                                 type: 'cursor_update',
                                 userId: client.id,
@@ -945,6 +1578,7 @@ wss.on('connection', (ws, req) => {
                         }
                     });
                     break;
+                }
                     
                 case 'highlight_selection':
                     // LEGACY: Broadcast highlight selection to all others
@@ -1063,16 +1697,26 @@ wss.on('connection', (ws, req) => {
                     }, ws);
                     break;
                     
-                case 'template_loaded':
+                case 'template_loaded': {
                     // Broadcast when a template is loaded
-                    currentState.code = message.code;
-                    broadcast({
+                    if (typeof message.code !== 'string') break;
+                    const target = resolveDocument(client, message);
+                    if (!target) {
+                        rejectDocument(ws, message);
+                        break;
+                    }
+                    const version = target.doc.replace(message.code, client.id);
+                    ws.send(JSON.stringify(forDocument(target, { type: 'code_ack', version, ackFor: 'full' })));
+                    publishCodeChange(target, {
                         type: 'template_loaded',
                         code: message.code,
+                        version: version,
                         templateName: message.templateName,
                         loadedBy: client.name
                     }, ws);
+                    checkSyntax(target, true);
                     break;
+                }
                 
                 case 'language_change':
                     // Teacher changed language - sync to all students
@@ -1084,6 +1728,8 @@ wss.on('connection', (ws, req) => {
                             language: message.language,
                             changedBy: client.name
                         }, ws);
+                        checkSyntax(boardTarget(null), true);
+                        workspaces.workspaces.forEach(workspace => checkSyntax({ doc: workspace.doc, workspace }, true));
                     }
                     break;
                 
@@ -1159,6 +1805,17 @@ wss.on('connection', (ws, req) => {
                     }
                     break;
                 
+                case 'scope':
+                    // Teacher's current block (compact row range) - show it to all students
+                    if (client.role === 'teacher') {
+                        broadcast({
+                            type: 'scope',
+                            startRow: message.startRow,
+                            endRow: message.endRow
+                        }, ws);
+                    }
+                    break;
+                
                 case 'scroll_to_line':
                     // Teacher sends scroll-to-line command - broadcast to all students
                     if (client.role === 'teacher') {
@@ -1187,11 +1844,7 @@ wss.on('connection', (ws, req) => {
                             // Send init with current state
                             ws.send(JSON.stringify({
                                 type: 'init',
-                                state: {
-                                    code: currentState.code,
-                                    cursorPosition: currentState.cursorPosition,
-                                    language: currentState.language
-                                },
+                                state: initStateFor(client),
                                 yourId: client.id,
                                 yourRole: client.role,
                                 connectedUsers: currentState.connectedUsers
@@ -1252,11 +1905,7 @@ wss.on('connection', (ws, req) => {
                                     // Send init to student
                                     studentWs.send(JSON.stringify({
                                         type: 'init',
-                                        state: {
-                                            code: currentState.code,
-                                            cursorPosition: currentState.cursorPosition,
-                                            language: currentState.language
-                                        },
+                                        state: initStateFor(studentClient),
                                         yourId: studentClient.id,
                                         yourRole: studentClient.role,
                                         connectedUsers: currentState.connectedUsers
@@ -1295,6 +1944,7 @@ wss.on('connection', (ws, req) => {
         } catch (error) {
             console.error('Error parsing message:', error);
         }
+        metrics.handled(type, data.length, performance.now() - startedAt);
     });
     
     ws.on('close', () => {
@@ -1305,6 +1955,16 @@ wss.on('connection', (ws, req) => {
             // Remove from connected users
             currentState.connectedUsers = currentState.connectedUsers.filter(u => u.id !== client.id);
             
+            // Workspaces stay (the student may reconnect); the teacher stops watching
+            if (client.role === 'teacher') {
+                workspaces.unwatch(ws);
+            }
+            
+            // Nobody is left to see the program's output
+            if (runsByClient.has(ws)) {
+                cppRunner.stop(runsByClient.get(ws));
+            }
+            
             // Notify others
             broadcast({
                 type: 'user_left',
@@ -1322,15 +1982,55 @@ wss.on('connection', (ws, req) => {
     });
 });
 
+// Lesson recordings (newest first)
+app.get('/api/recordings', (req, res) => {
+    res.json({ success: true, recordings: recorder.list() });
+});
+
+// Segment index of one recording - replay loads segments on demand
+app.get('/api/recordings/:id', (req, res) => {
+    const index = recorder.index(req.params.id);
+    if (!index) return res.status(404).json({ success: false, error: 'Recording not found' });
+    res.json({ success: true, ...index });
+});
+
+app.get('/api/recordings/:id/segments/:n', (req, res) => {
+    const segment = recorder.segment(req.params.id, parseInt(req.params.n, 10));
+    if (!segment) return res.status(404).json({ success: false, error: 'Segment not found' });
+    res.json({ success: true, ...segment });
+});
+
+app.get('/api/recordings/:id/assets/:hash', (req, res) => {
+    const file = recorder.assetPath(req.params.id, req.params.hash);
+    if (!file) return res.status(404).end();
+    res.type('text/plain').sendFile(file);
+});
+
 // API endpoint for status
 app.get('/api/status', (req, res) => {
+    const cpu = process.cpuUsage();
     res.json({
         status: 'running',
         connectedUsers: currentState.connectedUsers.length,
-        users: currentState.connectedUsers.map(u => ({ name: u.name, role: u.role }))
+        users: currentState.connectedUsers.map(u => ({ name: u.name, role: u.role })),
+        // For tools/loadtest.js: CPU time against uptime gives the server's load
+        server: {
+            cpuMs: Math.round((cpu.user + cpu.system) / 1000),
+            rssBytes: process.memoryUsage.rss(),
+            uptimeMs: Math.round(process.uptime() * 1000)
+        }
     });
 });
 
+// Prometheus scrape target
+app.get('/metrics', (req, res) => {
+    res.type('text/plain; version=0.0.4').send(metrics.prometheus(roomStats()));
+});
+
+app.get('/api/metrics', (req, res) => {
+    res.json(metrics.json(roomStats()));
+});
+
 // File system for content (language-specific files)
 // Note: glossa_programs moved to content/glossa in Phase 2.95
 const CONTENT_DIR = path.join(__dirname, 'content');
@@ -1455,7 +2155,7 @@ server.listen(PORT, () => {
     console.log('║  👨‍🏫 Teacher: http://localhost:3000?role=teacher         ║');
     console.log('║  👨‍🎓 Student: Use the ngrok link                        ║');
     console.log('╚════════════════════════════════════════════════════════════╝');
-    if (currentState.code) {
+    if (boardDocs.active.doc.code) {
         console.log('📂 Previous session restored - code ready');
     }
     console.log('');
@@ -0,0 +1,335 @@
+/**
+ * ComplexityLab - Measures how an algorithm's running time grows
+ *
+ * The teacher benchmarks the document on the board (e.g. the
+ * 06_Algorithms templates). Functions with a known shape are recognised
+ * by their signature:
+ *   void sortName(int arr[], int size)          - sorts random data
+ *   int  name(int arr[], int size)              - scans random data
+ *   int  name(int arr[], int size, int target)  - searches sorted data
+ *   int  fibName(int n)                         - recursion on n
+ * For each one a driver main() is appended to the document (whose own
+ * main is renamed away) and the program is compiled once with -O2, then
+ * run through CppRunner once per input size - a geometric series (an
+ * arithmetic one for fib, whose cost is already exponential in n) until
+ * a call takes longer than MAX_CALL_MS. Each run warms up, then reports
+ * the median of REPETITIONS timed batches: wall and CPU time per call and
+ * the process's peak RSS.
+ *
+ * Points are streamed to every board as they arrive, and when a series
+ * ends the growth curve that fits it best (O(1) ... O(n³), O(cⁿ)) is
+ * sent with it.
+ */
+
+const MAX_SERIES = 6;
+const MAX_POINTS = 16;
+const MAX_CALL_MS = 250;    // Last size: one call took longer than this
+const REPETITIONS = 5;
+const BATCH_MS = 10;        // Fast calls are repeated until a batch takes this long (CPU clocks can be coarse)
+const BENCH_FLAGS = ['-std=c++17', '-O2', '-pipe', '-fdiagnostics-color=never'];
+
+// Recognised function shapes: signature, call and how sizes grow
+const KINDS = {
+    sort: {
+        pattern: /\bvoid\s+(\w*sort\w*)\s*\(\s*int\s+(?:\w+\s*\[\s*\]|\*\s*\w+)\s*,\s*int\s+\w+\s*\)\s*\{/gi,
+        setup: 'std::vector<int> data(n), work(n);\n    for (int &x : data) x = rng() % 1000000;',
+        call: name => `work = data; ${name}(work.data(), (int)n);`,
+        sizes: { start: 250, factor: 2, max: 1 << 22 }
+    },
+    scan: {
+        pattern: /\b(?:int|long\s+long)\s+(\w+)\s*\(\s*int\s+(?:\w+\s*\[\s*\]|\*\s*\w+)\s*,\s*int\s+\w+\s*\)\s*\{/g,
+        setup: 'std::vector<int> data(n);\n    for (int &x : data) x = rng() % 1000000;',
+        call: name => `codeboard_bench::sink += ${name}(data.data(), (int)n);`,
+        sizes: { start: 1000, factor: 4, max: 1 << 24 }
+    },
+    search: {
+        pattern: /\bint\s+(\w+)\s*\(\s*int\s+(?:\w+\s*\[\s*\]|\*\s*\w+)\s*,\s*int\s+\w+\s*,\s*int\s+\w+\s*\)\s*\{/g,
+        setup: 'std::vector<int> data(n);\n    for (long long i = 0; i < n; i++) data[i] = (int)(2 * i);',
+        call: name => `codeboard_bench::sink += ${name}(data.data(), (int)n, (int)(2 * (rng() % n)));`,
+        sizes: { start: 1000, factor: 4, max: 1 << 24 }
+    },
+    recursive: {
+        pattern: /\b(?:int|long\s+long)\s+(fib\w*)\s*\(\s*int\s+\w+\s*\)\s*\{/gi,
+        setup: '',
+        call: name => `codeboard_bench::sink += ${name}((int)n);`,
+        sizes: { start: 10, step: 2, max: 50 }
+    }
+};
+
+// Built-in reference series, to compare the board's algorithm against
+const BASELINES = {
+    'std::sort': {
+        kind: 'sort',
+        source: '#include <algorithm>\nvoid codeboard_std_sort(int *arr, int size) { std::sort(arr, arr + size); }\n',
+        name: 'codeboard_std_sort'
+    }
+};
+
+// Growth models: ln t = ln c + ln f(n)
+const MODELS = [
+    { label: 'O(1)', f: () => 1 },
+    { label: 'O(log n)', f: n => Math.log2(n) },
+    { label: 'O(n)', f: n => n },
+    { label: 'O(n log n)', f: n => n * Math.log2(n) },
+    { label: 'O(n²)', f: n => n * n },
+    { label: 'O(n³)', f: n => n * n * n }
+];
+
+/**
+ * Program measuring one function: reads "n repetitions" on stdin and
+ * prints "wallMs cpuMs peakRssKb" (per call, medians)
+ */
+function driverSource(kind, name) {
+    const spec = KINDS[kind];
+    return `
+#undef main
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <sys/resource.h>
+
+namespace codeboard_bench {
+    double wallMs() {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    double cpuMs() {
+        timespec ts;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+        return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+    }
+    volatile long long sink;
+}
+
+int main() {
+    long long n;
+    int repetitions;
+    if (!(std::cin >> n >> repetitions) || n < 1 || repetitions < 1) return 2;
+    std::mt19937 rng(20240601);
+    ${spec.setup}
+
+    std::vector<double> walls, cpus;
+    for (int r = 0; r <= repetitions; r++) {
+        long long calls = 0;
+        double wall0 = codeboard_bench::wallMs(), cpu0 = codeboard_bench::cpuMs(), wall;
+        do {
+            ${spec.call(name)}
+            calls++;
+            wall = codeboard_bench::wallMs();
+        } while (wall - wall0 < ${BATCH_MS});
+        if (r == 0) continue; // Warm-up
+        walls.push_back((wall - wall0) / calls);
+        cpus.push_back((codeboard_bench::cpuMs() - cpu0) / calls);
+    }
+    std::sort(walls.begin(), walls.end());
+    std::sort(cpus.begin(), cpus.end());
+
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << walls[repetitions / 2] << ' ' << cpus[repetitions / 2] << ' ' << usage.ru_maxrss << std::endl;
+    return 0;
+}
+`;
+}
+
+/**
+ * Best fitting growth curve (least squares on log time)
+ * @param {{ n: number, wallMs: number }[]} points
+ * @returns {{ model: string, slope: number|null, base?: number }|null}
+ */
+function fitGrowth(points) {
+    const usable = points.filter(p => p.wallMs > 0);
+    if (usable.length < 3) return null;
+
+    const mean = values => values.reduce((a, b) => a + b, 0) / values.length;
+    const logT = usable.map(p => Math.log(p.wallMs));
+
+    let best = null;
+    for (const model of MODELS) {
+        const residuals = usable.map((p, i) => logT[i] - Math.log(model.f(p.n)));
+        const c = mean(residuals);
+        const error = residuals.reduce((sum, r) => sum + (r - c) ** 2, 0);
+        if (!best || error < best.error) best = { model: model.label, error };
+    }
+
+    // Straight lines: log-log slope (the exponent), and ln t against n (exponential growth)
+    const line = (xs, ys) => {
+        const mx = mean(xs);
+        const my = mean(ys);
+        const slope = xs.reduce((s, x, i) => s + (x - mx) * (ys[i] - my), 0) /
+            xs.reduce((s, x) => s + (x - mx) ** 2, 0);
+        const error = xs.reduce((s, x, i) => s + (ys[i] - my - slope * (x - mx)) ** 2, 0);
+        return { slope, error };
+    };
+    const logLog = line(usable.map(p => Math.log(p.n)), logT);
+    const exponential = line(usable.map(p => p.n), logT);
+
+    // Two free parameters fit anything a little better: exponential must win clearly
+    if (exponential.slope > 0.05 && exponential.error < best.error / 2) {
+        return { model: 'O(cⁿ)', slope: round(logLog.slope), base: round(Math.exp(exponential.slope)) };
+    }
+    return { model: best.model, slope: round(logLog.slope) };
+}
+
+function round(value) {
+    return Math.round(value * 100) / 100;
+}
+
+class ComplexityLab {
+    /**
+     * @param {CppRunner} runner
+     * @param {Function} broadcast - Sends a message to every board
+     */
+    constructor(runner, broadcast) {
+        this.runner = runner;
+        this.broadcast = broadcast;
+        this.series = [];       // { id, label, kind, status, points, fit, error }
+        this.running = false;
+        this._counter = 0;
+        this._stopped = false;
+    }
+
+    /**
+     * Functions of a document the lab can measure
+     * @param {string} code
+     * @returns {{ name: string, kind: string }[]}
+     */
+    detect(code) {
+        const found = new Map();
+        for (const [kind, spec] of Object.entries(KINDS)) {
+            for (const match of code.matchAll(spec.pattern)) {
+                if (!found.has(match[1])) found.set(match[1], { name: match[1], kind });
+            }
+        }
+        return Array.from(found.values());
+    }
+
+    /**
+     * Benchmark the functions of a document (or a baseline)
+     * @param {string} code
+     * @param {string} [baseline] - Key of BASELINES instead of the document
+     * @returns {string|null} Error message, or null if it started
+     */
+    start(code, baseline) {
+        if (this.running) return 'A benchmark is already running';
+
+        let jobs;
+        if (baseline) {
+            const spec = BASELINES[baseline];
+            if (!spec) return 'Unknown baseline';
+            jobs = [{ label: baseline, kind: spec.kind, source: spec.source + driverSource(spec.kind, spec.name) }];
+        } else {
+            const functions = this.detect(code);
+            if (functions.length === 0) {
+                return 'No function to measure - e.g. void bubbleSort(int arr[], int size)';
+            }
+            jobs = functions.map(fn => ({
+                label: fn.name,
+                kind: fn.kind,
+                source: `#define main codeboard_template_main\n${code}\n${driverSource(fn.kind, fn.name)}`
+            }));
+        }
+
+        this.running = true;
+        this._stopped = false;
+        (async () => {
+            for (const job of jobs) {
+                if (this._stopped) break;
+                await this._measure(job);
+            }
+            this.running = false;
+        })().catch(error => {
+            console.error('❌ Complexity lab failed:', error);
+            this.running = false;
+        });
+        return null;
+    }
+
+    /**
+     * Drop every series (the running one stops after its current size)
+     */
+    clear() {
+        this._stopped = this.running;
+        this.series = [];
+        this.broadcast({ type: 'bench_clear' });
+    }
+
+    /**
+     * Everything measured so far, for boards that join later
+     * @returns {Object[]}
+     */
+    state() {
+        return this.series;
+    }
+
+    async _measure(job) {
+        // Measuring the same function again replaces its series
+        this.series = this.series.filter(s => s.label !== job.label);
+        while (this.series.length >= MAX_SERIES) this.series.shift();
+
+        const series = {
+            id: `b${++this._counter}`,
+            label: job.label,
+            kind: job.kind,
+            status: 'running',
+            points: [],
+            fit: null,
+            error: null
+        };
+        this.series.push(series);
+        this.broadcast({ type: 'bench_series', series });
+
+        const sizes = KINDS[job.kind].sizes;
+        for (let n = sizes.start; n <= sizes.max && series.points.length < MAX_POINTS;
+            n = sizes.step ? n + sizes.step : n * sizes.factor) {
+            if (this._stopped) break;
+            const run = await this._runSize(job.source, n);
+            if (run.error) {
+                // Too big for the limits: keep what we have
+                if (series.points.length === 0) series.error = run.error;
+                break;
+            }
+            const point = { n, ...run.point };
+            series.points.push(point);
+            this.broadcast({ type: 'bench_point', seriesId: series.id, point });
+            if (point.wallMs > MAX_CALL_MS) break;
+        }
+
+        series.status = series.error ? 'error' : 'done';
+        series.fit = fitGrowth(series.points);
+        this.broadcast({ type: 'bench_done', seriesId: series.id, status: series.status, fit: series.fit, error: series.error });
+    }
+
+    // One process per size, so peak RSS belongs to that size alone
+    _runSize(source, n) {
+        return new Promise(resolve => {
+            let stdout = '';
+            const submit = () => {
+                const id = this.runner.submit(source, event => {
+                    if (event.type === 'running') {
+                        this.runner.write(event.runId, `${n} ${REPETITIONS}\n`);
+                        this.runner.closeInput(event.runId);
+                    } else if (event.type === 'output' && event.stream === 'stdout') {
+                        stdout += event.data;
+                    } else if (event.type === 'exit') {
+                        const [wallMs, cpuMs, peakRssKb] = stdout.trim().split(/\s+/).map(Number);
+                        if (event.reason || event.exitCode !== 0 || !Number.isFinite(wallMs)) {
+                            resolve({ error: event.compileError || event.reason || `exit code ${event.exitCode}` });
+                        } else {
+                            resolve({ point: { wallMs, cpuMs, peakRssKb } });
+                        }
+                    }
+                }, { flags: BENCH_FLAGS });
+                if (id === null) setTimeout(submit, 500); // Runner queue full
+            };
+            submit();
+        });
+    }
+}
+
+ComplexityLab.fitGrowth = fitGrowth;
+ComplexityLab.BASELINES = Object.keys(BASELINES);
+
+module.exports = ComplexityLab;
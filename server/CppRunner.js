@@ -0,0 +1,778 @@
+/**
+ * CppRunner - Compiles and runs C++ from the board
+ *
+ * Each run compiles one document with the local g++ in a temporary
+ * directory, then runs the binary under resource limits (CPU time,
+ * memory, file size, processes) and a wall-clock timeout, in a sandbox:
+ * - new user, mount and network namespaces (`unshare -rnm`), so there
+ *   is no network, and an empty tmpfs is mounted over the temporary
+ *   directory, the home directory and the server's own directory
+ *   (teacher-info.json, saved state, uploads). Only the job's directory
+ *   stays reachable, as the working directory.
+ * - no capabilities (`setpriv`), so the program can't unmount them
+ * - a new PID namespace, so killing the job kills everything it forked
+ *   (the sandbox shell is its init and reports a signal as 128 + number)
+ * - as nobody (SANDBOX_ID) when the server itself runs as root
+ * g++ runs in the same sandbox (a copy of the shared headers and the
+ * prelude are bind-mounted into the job's directory first), so
+ * `#include "/path"` can't show a file either, and only diagnostics
+ * about main.cpp are passed on.
+ * Without unshare/setpriv or user namespaces programs are refused, unless
+ * the server is started with CPP_RUN_UNSANDBOXED=1.
+ *
+ * Output is delivered in batches (at most every OUTPUT_FLUSH_MS, or when
+ * OUTPUT_BATCH_BYTES are waiting) so a tight print loop doesn't become
+ * thousands of WebSocket frames.
+ *
+ * Compiling is the expensive part, so at most MAX_COMPILING jobs compile
+ * at once. Programs mostly sit waiting for input and are CPU-limited
+ * anyway, so up to MAX_ACTIVE jobs may be compiling or running. The
+ * rest wait in a FIFO queue of MAX_QUEUED.
+ *
+ * Compiling is also made cheaper:
+ * - A source is compiled with `-include prelude.h`, a prelude of the
+ *   standard headers it includes itself, and the prelude is precompiled
+ *   once per set of headers and flags (g++ can crash on a .gch built with
+ *   other -O flags), so <iostream> isn't parsed again on every run. Only
+ *   headers the source includes before any other directive go in it, so
+ *   the program sees exactly the names and macros it would with a plain
+ *   g++ (a forced <algorithm> would make `int count` ambiguous with
+ *   std::count). A source with no such headers compiles without one.
+ *   Until the .gch is ready g++ reads the plain header - same result,
+ *   just slower. Only runs create preludes (the syntax checker uses the
+ *   ones that exist), MAX_PCH_BUILDS .gch are built at once, and the
+ *   least recently used of MAX_PRELUDES is dropped for a new one.
+ * - Builds are cached by a hash of compiler, flags, source and the
+ *   shared headers: when a class runs the same template, only the first
+ *   run compiles, and runs that arrive while it compiles wait for it
+ *   instead of compiling too.
+ *   Compile errors are cached the same way.
+ *
+ * Headers in includeDir (content/cpp/include, e.g. the bench.h harness of
+ * the performance templates) can be included with #include "name.h".
+ *
+ * A job reports through its onEvent callback (every event also has runId):
+ *   { type: 'queued', position }  { type: 'compiling' }  { type: 'running' }
+ *   { type: 'output', stream, data }
+ *   { type: 'exit', exitCode, signal, reason, compileError, timeMs }
+ */
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const crypto = require('crypto');
+const { spawn, spawnSync } = require('child_process');
+const { StringDecoder } = require('string_decoder');
+
+const MAX_COMPILING = Math.max(1, Math.min(4, os.cpus().length - 1));
+const MAX_ACTIVE = 40;
+const MAX_QUEUED = 60;
+const MAX_SOURCE_BYTES = 256 * 1024;  // UTF-8; larger sources are rejected, not cut
+
+const COMPILE_TIMEOUT_MS = 20000;
+const RUN_TIMEOUT_MS = 120000;        // Wall clock, includes time waiting for input
+const CPU_SECONDS = 5;
+const MEMORY_KB = 256 * 1024;
+const FILE_SIZE_BLOCKS = 2048;        // ulimit -f blocks (512 B in dash, 1 KB in bash)
+const MAX_PROCESSES = 32;
+
+const OUTPUT_LIMIT_BYTES = 256 * 1024;
+const OUTPUT_BATCH_BYTES = 4096;
+const OUTPUT_FLUSH_MS = 40;
+const COMPILE_ERROR_LIMIT = 16 * 1024;
+
+const SANDBOX_ID = 65534;             // nobody/nogroup
+const UNSHARE_ARGS = ['-rnm', '--fork', '--pid', '--kill-child', '--mount-proc'];
+const STREAM_WAIT_MS = 1000;          // After a program exits, for output still in its pipes
+const UNSANDBOXED = process.env.CPP_RUN_UNSANDBOXED === '1';
+
+const COMPILER = process.env.CXX || 'g++';
+const COMPILE_FLAGS = ['-std=c++17', '-O1', '-pipe', '-fdiagnostics-color=never'];
+
+// Standard headers a prelude may precompile (a missing or misspelled one must fail in the source)
+const STANDARD_HEADERS = new Set([
+    'algorithm', 'array', 'atomic', 'bitset', 'cassert', 'cctype', 'cfloat', 'chrono', 'climits',
+    'cmath', 'complex', 'cstddef', 'cstdint', 'cstdio', 'cstdlib', 'cstring', 'ctime', 'deque',
+    'exception', 'fstream', 'functional', 'iomanip', 'ios', 'iosfwd', 'iostream', 'istream',
+    'iterator', 'limits', 'list', 'map', 'memory', 'mutex', 'numeric', 'optional', 'ostream',
+    'queue', 'random', 'regex', 'set', 'sstream', 'stack', 'stdexcept', 'string', 'string_view',
+    'thread', 'tuple', 'type_traits', 'typeinfo', 'unordered_map', 'unordered_set', 'utility',
+    'valarray', 'variant', 'vector', 'bits/stdc++.h'
+]);
+const PRELUDE_FILE = 'prelude.h';
+const MAX_PRELUDES = 32;
+const MAX_PCH_BUILDS = 1;
+const PRELUDE_GRACE_MS = 60000;       // A dropped prelude's files outlive any compile that may use them
+const STAMP_TTL_MS = 2000;            // How long includeStamp() trusts itself when includeDir isn't watched
+const MAX_CACHED_BUILDS = 200;
+
+/**
+ * Standard headers the source includes before any other directive (#define, #if, ...),
+ * which a prelude can include first without changing the program
+ * @param {string} source
+ * @returns {string[]} Sorted, so sources with the same headers share a prelude
+ */
+function preludeHeaders(source) {
+    const headers = new Set();
+    for (const line of source.split('\n')) {
+        const directive = line.match(/^\s*#\s*(\w*)\s*(.*)$/);
+        if (!directive) continue;
+        if (directive[1] !== 'include') break;
+        const header = directive[2].match(/^<([^>]+)>/);
+        if (header && STANDARD_HEADERS.has(header[1])) headers.add(header[1]);
+    }
+    return [...headers].sort();
+}
+
+// Inside new namespaces: bind each [source, target] of binds into the working directory, hide
+// each directory in "$@" under an empty tmpfs (abort if one can't be), run `then`, and run
+// program without capabilities. The shell stays as the namespace's init (signals a PID 1
+// sends itself are ignored) and exits with the program's status
+function sandboxScript(then, program, binds = []) {
+    return [
+        ...binds.map(([source, target]) => `mount --bind ${shellQuote(source)} ${shellQuote(target)} || exit 126`),
+        'for dir in "$@"; do mount -t tmpfs -o size=1m,mode=755 codeboard "$dir" || exit 126; done',
+        then,
+        // Its own "Segmentation fault" notices are not the program's output
+        'exec 3>&2 2>/dev/null',
+        `(setpriv --bounding-set=-all --inh-caps=-all --no-new-privs ${program} 2>&3 3>&-)`,
+        'exit $?'
+    ].join('; ');
+}
+
+// The sandbox needs unprivileged user namespaces, mount and setpriv; try it once
+function detectSandbox(spawnOptions) {
+    const probe = spawnSync('unshare', [...UNSHARE_ARGS, '/bin/sh', '-c', sandboxScript(':', 'true'), 'sh', os.tmpdir()], {
+        ...spawnOptions,
+        cwd: os.tmpdir(),
+        stdio: 'ignore',
+        timeout: 2000
+    });
+    return probe.status === 0;
+}
+
+function shellQuote(arg) {
+    return `'${String(arg).replace(/'/g, `'\\''`)}'`;
+}
+
+/**
+ * Compiler arguments before the output and source
+ * @param {string[]} flags
+ * @param {string|null} includeDir - For #include "..."
+ * @param {string|null} prelude - Header to include first
+ * @returns {string[]}
+ */
+function compilerArgsWith(flags, includeDir, prelude) {
+    return [
+        ...flags,
+        ...(includeDir ? ['-iquote', includeDir] : []),
+        ...(prelude ? ['-include', prelude] : [])
+    ];
+}
+
+// g++ output about main.cpp only: a diagnostic located in another file (a header, or
+// whatever an #include names) is dropped with its source excerpt, so it can't show the file
+function ownDiagnostics(output) {
+    let keep = true;
+    const own = output.split('\n').filter(line => {
+        if (/^\S/.test(line)) {
+            const located = line.match(/^([^\s:][^:]*):(?:\d+:|\s(?:In|At) )/);
+            keep = located ? located[1] === 'main.cpp' : !line.startsWith('In file included from ');
+        }
+        return keep;
+    }).join('\n');
+    return own.trim() || !output.trim() ? own : 'Compilation failed in a file that main.cpp includes.\n';
+}
+
+// Kill a child spawned `detached` together with everything in its process group
+function killGroup(child) {
+    try {
+        process.kill(-child.pid, 'SIGKILL');
+    } catch (error) {
+        child.kill('SIGKILL'); // Not started, or already gone
+    }
+}
+
+// Existing directories to hide, without those inside another (hidden with it)
+function hiddenDirs(dirs) {
+    const resolved = [...new Set(dirs.filter(Boolean).map(dir => path.resolve(dir)))]
+        .filter(dir => dir !== path.parse(dir).root && fs.existsSync(dir))
+        .sort((a, b) => a.length - b.length);
+    return resolved.filter((dir, i) => !resolved.slice(0, i).some(outer => dir.startsWith(outer + path.sep)));
+}
+
+class CppRunner {
+    /**
+     * @param {string} [includeDir] - Shared headers for #include "..."
+     * @param {Object} [options]
+     * @param {string[]} [options.hide] - More directories programs must not see (the server's)
+     */
+    constructor(includeDir = null, options = {}) {
+        this.includeDir = includeDir;
+        this.jobs = new Map();     // jobId -> job (until it exits)
+        this.queue = [];           // Waiting jobs
+        this.compiling = 0;        // Compile slots in use
+        this.builds = new Map();   // build key -> { binary } | { compileError }, oldest first
+        this.building = new Map(); // build key -> jobs waiting for that compile
+        this._counter = 0;
+        this._sandbox = undefined;   // Detected on first run
+        this._runAs = process.getuid && process.getuid() === 0 ? SANDBOX_ID : null;
+        this._hidden = hiddenDirs([os.tmpdir(), os.homedir(), ...(options.hide || [])]);
+        this._preludes = new Map();  // flags and headers -> prelude.h precompiled for them, oldest use first
+        this._preludeCounter = 0;
+        this._pchWaiting = [];       // { key, header, flags } whose .gch waits for a build slot
+        this._pchBuilding = 0;
+        this._stamp = undefined;     // includeStamp(), until includeDir changes
+        this._includeCopy = null;    // { stamp, dir }: includeDir copied where the sandbox can bind it
+        this._stampAt = 0;
+        this._watching = false;
+        this._watchIncludes();
+
+        this.cacheDir = fs.mkdtempSync(path.join(os.tmpdir(), 'codeboard-cpp-cache-'));
+        fs.chmodSync(this.cacheDir, 0o711); // The sandboxed compiler binds its prelude from here
+    }
+
+    /**
+     * Queue a run
+     * @param {string} code - C++ source
+     * @param {Function} onEvent - Called with the job's events (see top)
+     * @param {Object} [options]
+     * @param {string[]} [options.flags] - Compiler flags instead of COMPILE_FLAGS
+     * @returns {string|null} Job id, or null when the queue is full
+     */
+    submit(code, onEvent, options = {}) {
+        const source = String(code);
+        if (Buffer.byteLength(source, 'utf8') > MAX_SOURCE_BYTES) {
+            // Compiling a cut-off program would only report a confusing error at the cut
+            return this._reject(onEvent, 'source_too_large',
+                `The program is larger than ${MAX_SOURCE_BYTES / 1024} KB and was not compiled.`);
+        }
+        if (!this._sandboxed() && !UNSANDBOXED) {
+            return this._reject(onEvent, 'no_sandbox',
+                'Programs can\'t run in a sandbox on this server (needs unshare, setpriv and user namespaces).\n' +
+                'Start the server with CPP_RUN_UNSANDBOXED=1 to run them without one.');
+        }
+        if (this.queue.length >= MAX_QUEUED) return null;
+
+        const flags = options.flags || COMPILE_FLAGS;
+        const job = {
+            id: `r${++this._counter}`,
+            code: source,
+            flags,
+            key: crypto.createHash('sha1')
+                .update(JSON.stringify([COMPILER, flags, this.includeStamp(), source]))
+                .digest('hex'),
+            onEvent: null,
+            dir: null,
+            child: null,
+            state: 'queued',
+            compileSlot: false,
+            output: { stdout: '', stderr: '', bytes: 0, timer: null },
+            reason: null,
+            startedAt: 0,
+            timeout: null
+        };
+        // Every event carries the job id
+        job.onEvent = event => onEvent({ runId: job.id, ...event });
+        this.jobs.set(job.id, job);
+        this.queue.push(job);
+        job.onEvent({ type: 'queued', position: this.queue.length });
+        this._pump();
+        return job.id;
+    }
+
+    /**
+     * Send stdin to a running program
+     * @param {string} jobId
+     * @param {string} data
+     */
+    write(jobId, data) {
+        const job = this.jobs.get(jobId);
+        if (job && job.state === 'running' && job.child.stdin.writable) {
+            job.child.stdin.write(String(data));
+        }
+    }
+
+    /**
+     * End of input (Ctrl+D)
+     * @param {string} jobId
+     */
+    closeInput(jobId) {
+        const job = this.jobs.get(jobId);
+        if (job && job.state === 'running') {
+            job.child.stdin.end();
+        }
+    }
+
+    /**
+     * Cancel a job: dequeue it, or kill what it is running
+     * @param {string} jobId
+     */
+    stop(jobId) {
+        const job = this.jobs.get(jobId);
+        if (!job) return;
+        if (job.state === 'queued') {
+            this.queue.splice(this.queue.indexOf(job), 1);
+            this._finish(job, { exitCode: null, signal: null, reason: 'stopped' });
+            return;
+        }
+        const waiting = this.building.get(job.key);
+        if (waiting && waiting.includes(job)) {
+            // Waiting for someone else's compile
+            waiting.splice(waiting.indexOf(job), 1);
+            this._finish(job, { exitCode: null, signal: null, reason: 'stopped' });
+            return;
+        }
+        job.reason = job.reason || 'stopped';
+        if (job.child) killGroup(job.child);
+    }
+
+    // Whether programs run sandboxed; reported once
+    _sandboxed() {
+        if (this._sandbox === undefined) {
+            this._sandbox = detectSandbox(this._spawnOptions());
+            if (!this._sandbox) {
+                console.warn(UNSANDBOXED
+                    ? '⚠️ CppRunner: no sandbox - CPP_RUN_UNSANDBOXED=1, programs run with network and file access'
+                    : '⚠️ CppRunner: no sandbox (unshare, setpriv, user namespaces) - C++ programs are refused');
+            }
+        }
+        return this._sandbox;
+    }
+
+    // Programs don't run as root
+    _spawnOptions() {
+        return this._runAs === null ? {} : { uid: this._runAs, gid: this._runAs };
+    }
+
+    // A job that ends before it is queued; its exit still arrives after submit() returns
+    _reject(onEvent, reason, message) {
+        const runId = `r${++this._counter}`;
+        setImmediate(() => onEvent({
+            runId, type: 'exit', exitCode: null, signal: null, reason, compileError: message, timeMs: 0
+        }));
+        return runId;
+    }
+
+    // Jobs that have left the queue and not exited yet
+    get active() {
+        return this.jobs.size - this.queue.length;
+    }
+
+    _pump() {
+        // Cached (or being built) jobs don't need a compile slot, so they may pass the queue head
+        let i = 0;
+        while (i < this.queue.length && this.active < MAX_ACTIVE) {
+            const job = this.queue[i];
+            if (this.builds.has(job.key) || this.building.has(job.key)) {
+                this.queue.splice(i, 1);
+                this._reuseBuild(job);
+            } else if (this.compiling < MAX_COMPILING) {
+                this.queue.splice(i, 1);
+                this._compile(job);
+            } else {
+                i++;
+            }
+        }
+        // Everyone still waiting moves up
+        this.queue.forEach((job, n) => job.onEvent({ type: 'queued', position: n + 1 }));
+    }
+
+    // Same source was built before (or is being built right now)
+    _reuseBuild(job) {
+        job.state = 'compiling';
+        job.onEvent({ type: 'compiling' });
+
+        const build = this.builds.get(job.key);
+        if (!build) {
+            this.building.get(job.key).push(job);
+            return;
+        }
+        // Most recently used last
+        this.builds.delete(job.key);
+        this.builds.set(job.key, build);
+
+        if (build.compileError !== undefined) {
+            this._finish(job, { exitCode: 1, signal: null, reason: 'compile_error', compileError: build.compileError });
+            return;
+        }
+        try {
+            job.dir = this._jobDir();
+            fs.copyFileSync(build.binary, path.join(job.dir, 'prog'));
+        } catch (error) {
+            this._finish(job, { exitCode: null, signal: null, reason: 'error', compileError: error.message });
+            return;
+        }
+        this._run(job);
+    }
+
+    _compile(job) {
+        this.compiling++;
+        job.compileSlot = true;
+        job.state = 'compiling';
+        job.onEvent({ type: 'compiling' });
+        this.building.set(job.key, []);
+
+        let command;
+        try {
+            job.dir = this._jobDir();
+            fs.writeFileSync(path.join(job.dir, 'main.cpp'), job.code);
+            command = this._compileCommand(job);
+        } catch (error) {
+            this._buildDone(job, null);
+            this._finish(job, { exitCode: null, signal: null, reason: 'error', compileError: error.message });
+            return;
+        }
+
+        const compiler = spawn(command[0], command.slice(1), {
+            ...(this._sandbox ? this._spawnOptions() : {}),
+            detached: true,
+            cwd: job.dir,
+            env: this._sandbox ? { PATH: process.env.PATH || '/usr/bin:/bin', LANG: 'C.UTF-8', TMPDIR: '.' } : process.env,
+            stdio: ['ignore', 'ignore', 'pipe']
+        });
+        job.child = compiler;
+        let diagnostics = '';
+        compiler.stderr.on('data', chunk => {
+            if (diagnostics.length < COMPILE_ERROR_LIMIT) diagnostics += chunk;
+        });
+        const timeout = setTimeout(() => {
+            job.reason = 'compile_timeout';
+            killGroup(compiler);
+        }, COMPILE_TIMEOUT_MS);
+
+        compiler.on('error', error => {
+            // g++ missing
+            job.reason = job.reason || 'error';
+            diagnostics = `${COMPILER}: ${error.message}`;
+        });
+        compiler.on('close', (exitCode) => {
+            clearTimeout(timeout);
+            job.child = null;
+            this.compiling--;
+            job.compileSlot = false;
+
+            if (job.reason) {
+                // Stopped or broken: nothing to cache, waiting jobs compile for themselves
+                this._buildDone(job, null);
+                this._finish(job, { exitCode: null, signal: null, reason: job.reason, compileError: ownDiagnostics(diagnostics) || null });
+            } else if (exitCode !== 0) {
+                const compileError = ownDiagnostics(diagnostics).slice(0, COMPILE_ERROR_LIMIT);
+                this._buildDone(job, { compileError });
+                this._finish(job, { exitCode, signal: null, reason: 'compile_error', compileError });
+            } else {
+                const binary = path.join(this.cacheDir, job.key);
+                let build = null;
+                try {
+                    fs.copyFileSync(path.join(job.dir, 'prog'), binary);
+                    build = { binary };
+                } catch (error) {
+                    console.warn('⚠️ CppRunner: could not cache build:', error.message);
+                }
+                this._buildDone(job, build);
+                this._run(job);
+            }
+        });
+    }
+
+    // Record a compile's result and hand it to the jobs waiting for it
+    _buildDone(job, build) {
+        const waiting = this.building.get(job.key) || [];
+        this.building.delete(job.key);
+
+        if (build) {
+            this.builds.set(job.key, build);
+            while (this.builds.size > MAX_CACHED_BUILDS) {
+                const [oldest, evicted] = this.builds.entries().next().value;
+                this.builds.delete(oldest);
+                if (evicted.binary) fs.rm(evicted.binary, { force: true }, () => {});
+            }
+            waiting.forEach(waiter => this._reuseBuild(waiter));
+        } else {
+            // Back to the front of the queue, in order
+            waiting.forEach(waiter => { waiter.state = 'queued'; });
+            this.queue.unshift(...waiting);
+        }
+        this._pump();
+    }
+
+    /**
+     * Compiler arguments before the output and source: flags, shared headers, prelude
+     * @param {string[]} [flags]
+     * @param {string} [source] - The prelude holds its standard headers; none without it
+     * @param {boolean} [create] - False to only use a prelude that already exists
+     * @returns {string[]}
+     */
+    compilerArgs(flags = COMPILE_FLAGS, source = '', create = true) {
+        return compilerArgsWith(flags, this.includeDir, this._prelude(flags, preludeHeaders(source), create));
+    }
+
+    // g++ for a job, sandboxed like its program: the shared headers and the prelude's
+    // directory are bound to include/ and prelude/ in the job's directory before the rest is hidden
+    _compileCommand(job) {
+        const includeDir = this._sandbox ? this._sandboxIncludes() : this.includeDir;
+        const prelude = this._prelude(job.flags, preludeHeaders(job.code));
+        const output = ['-o', 'prog', 'main.cpp'];
+        if (!this._sandbox) {
+            return [COMPILER, ...compilerArgsWith(job.flags, this.includeDir, prelude), ...output];
+        }
+        const binds = [];
+        if (includeDir) binds.push([includeDir, 'include']);
+        if (prelude) binds.push([path.dirname(prelude), 'prelude']);
+        for (const [, target] of binds) {
+            fs.mkdirSync(path.join(job.dir, target));
+            if (this._runAs !== null) fs.chownSync(path.join(job.dir, target), this._runAs, this._runAs);
+        }
+        const args = compilerArgsWith(job.flags, includeDir && 'include', prelude && `prelude/${PRELUDE_FILE}`);
+        const program = [COMPILER, ...args, ...output].map(shellQuote).join(' ');
+        return ['unshare', ...UNSHARE_ARGS, '/bin/sh', '-c', sandboxScript(':', program, binds), 'sh', ...this._hidden];
+    }
+
+    // includeDir may sit where nobody can't reach it (under /root), so the sandbox binds a
+    // copy in cacheDir, made again when the headers change
+    _sandboxIncludes() {
+        const stamp = this.includeStamp();
+        if (stamp === null) return null;
+        if (!this._includeCopy || this._includeCopy.stamp !== stamp) {
+            const dir = fs.mkdtempSync(path.join(this.cacheDir, 'include-'));
+            fs.cpSync(this.includeDir, dir, { recursive: true });
+            fs.chmodSync(dir, 0o755);
+            if (this._includeCopy) fs.rm(this._includeCopy.dir, { recursive: true, force: true }, () => {});
+            this._includeCopy = { stamp, dir };
+        }
+        return this._includeCopy.dir;
+    }
+
+    // A fresh directory for a job, owned by whoever runs its compiler and program
+    _jobDir() {
+        const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'codeboard-run-'));
+        if (this._runAs !== null) fs.chownSync(dir, this._runAs, this._runAs);
+        return dir;
+    }
+
+    /**
+     * Names and mtimes of the shared headers, so editing one invalidates cached builds.
+     * Read again only after includeDir changes (or STAMP_TTL_MS, if it can't be watched)
+     * @returns {string|null}
+     */
+    includeStamp() {
+        if (!this.includeDir) return null;
+        if (this._stamp === undefined || (!this._watching && Date.now() - this._stampAt > STAMP_TTL_MS)) {
+            try {
+                this._stamp = fs.readdirSync(this.includeDir)
+                    .map(name => `${name}:${fs.statSync(path.join(this.includeDir, name)).mtimeMs}`)
+                    .join('|');
+            } catch (error) {
+                this._stamp = null;
+            }
+            this._stampAt = Date.now();
+        }
+        return this._stamp;
+    }
+
+    _watchIncludes() {
+        if (!this.includeDir) return;
+        try {
+            const watcher = fs.watch(this.includeDir, { persistent: false }, () => {
+                this._stamp = undefined;
+            });
+            watcher.on('error', () => {
+                this._watching = false;
+                watcher.close();
+            });
+            this._watching = true;
+        } catch (error) {
+            this._watching = false; // Missing directory or no inotify: fall back to the TTL
+        }
+    }
+
+    // The prelude header for these flags and headers; its .gch is built in the background
+    // on first use and g++ picks it up once it exists. Null for no headers, or when there is
+    // none yet and create is false (the source compiles without one)
+    _prelude(flags, headers, create = true) {
+        if (headers.length === 0) return null;
+        const key = JSON.stringify([flags, headers]);
+        const existing = this._preludes.get(key);
+        if (existing) {
+            // Most recently used last
+            this._preludes.delete(key);
+            this._preludes.set(key, existing);
+            return existing;
+        }
+        if (!create) return null;
+
+        if (this._preludes.size >= MAX_PRELUDES) {
+            const [oldest, evicted] = this._preludes.entries().next().value;
+            this._preludes.delete(oldest);
+            // Compiles and checks started with it may still read it; none lasts this long
+            setTimeout(() => fs.rm(path.dirname(evicted), { recursive: true, force: true }, () => {}),
+                PRELUDE_GRACE_MS).unref();
+        }
+
+        const dir = path.join(this.cacheDir, `pch-${++this._preludeCounter}`);
+        const header = path.join(dir, PRELUDE_FILE);
+        fs.mkdirSync(dir);
+        fs.writeFileSync(header, headers.map(h => `#include <${h}>\n`).join(''));
+        this._preludes.set(key, header);
+        this._pchWaiting.push({ key, header, flags });
+        this._buildPch();
+        return header;
+    }
+
+    // Precompile waiting preludes, MAX_PCH_BUILDS at a time
+    _buildPch() {
+        while (this._pchBuilding < MAX_PCH_BUILDS && this._pchWaiting.length > 0) {
+            const { key, header, flags } = this._pchWaiting.shift();
+            if (this._preludes.get(key) !== header) continue; // Dropped before its turn
+
+            this._pchBuilding++;
+            const pending = `${header}.gch.tmp`;
+            const child = spawn(COMPILER, [...flags, '-x', 'c++-header', header, '-o', pending], {
+                stdio: 'ignore'
+            });
+            const timeout = setTimeout(() => child.kill('SIGKILL'), COMPILE_TIMEOUT_MS);
+            child.on('error', () => {});
+            child.on('close', (exitCode) => {
+                clearTimeout(timeout);
+                this._pchBuilding--;
+                this._buildPch();
+                if (exitCode !== 0) return; // Sources still compile with the plain header
+                // Renamed into place so no compile reads a half-written .gch
+                fs.rename(pending, `${header}.gch`, () => {});
+            });
+        }
+    }
+
+    _run(job) {
+        // Limits are set by the shell (one per ulimit call; processes is -u in bash, -p in dash),
+        // then it becomes the program. A limit that can't be set aborts the run.
+        const limits = [
+            `ulimit -t ${CPU_SECONDS} && ulimit -v ${MEMORY_KB} && ulimit -f ${FILE_SIZE_BLOCKS} && ulimit -c 0 || exit 126`,
+            `ulimit -u ${MAX_PROCESSES} 2>/dev/null || ulimit -p ${MAX_PROCESSES} 2>/dev/null`
+        ].join('; ');
+        const command = this._sandbox
+            ? ['unshare', ...UNSHARE_ARGS, '/bin/sh', '-c', sandboxScript(limits, './prog'), 'sh', ...this._hidden]
+            : ['/bin/sh', '-c', `${limits}; exec ./prog`];
+
+        job.state = 'running';
+        job.startedAt = Date.now();
+        job.child = spawn(command[0], command.slice(1), {
+            ...this._spawnOptions(),
+            detached: true, // Its own process group, so killGroup() also gets what it forks
+            cwd: job.dir,
+            env: { PATH: '/usr/bin:/bin', LANG: 'C.UTF-8' },
+            stdio: ['pipe', 'pipe', 'pipe']
+        });
+        job.onEvent({ type: 'running' });
+
+        // A character split between two chunks is held back by its stream's decoder
+        const decoders = { stdout: new StringDecoder('utf8'), stderr: new StringDecoder('utf8') };
+        job.child.stdout.on('data', chunk => this._output(job, 'stdout', decoders.stdout.write(chunk)));
+        job.child.stderr.on('data', chunk => this._output(job, 'stderr', decoders.stderr.write(chunk)));
+        job.child.stdin.on('error', () => {}); // Program exited before reading its input
+        job.timeout = setTimeout(() => {
+            job.reason = 'timeout';
+            killGroup(job.child);
+        }, RUN_TIMEOUT_MS);
+
+        job.child.on('error', error => {
+            job.reason = job.reason || 'error';
+            this._output(job, 'stderr', error.message);
+        });
+        // Something the program forked may still hold its pipes open (outside the sandbox), so
+        // 'close' could never come: at exit the rest of its group is killed, and the output that
+        // arrives within STREAM_WAIT_MS is all there is
+        const child = job.child;
+        let streamWait = null;
+        const done = (exitCode, signal) => {
+            if (job.state === 'done') return;
+            clearTimeout(job.timeout);
+            clearTimeout(streamWait);
+            for (const stream of ['stdout', 'stderr']) {
+                this._output(job, stream, decoders[stream].end());
+            }
+            if (this._sandbox && signal === null && exitCode > 128) {
+                // The sandbox shell's report of a signal
+                signal = Object.keys(os.constants.signals).find(name => os.constants.signals[name] === exitCode - 128) || null;
+                if (signal) exitCode = null;
+            }
+            // We only kill with a reason set; any other SIGKILL/SIGXCPU is the CPU limit
+            const reason = job.reason || (signal === 'SIGXCPU' || signal === 'SIGKILL' ? 'cpu_limit' : null);
+            this._finish(job, { exitCode, signal, reason });
+        };
+        child.on('exit', (exitCode, signal) => {
+            killGroup(child);
+            streamWait = setTimeout(() => {
+                child.stdout.destroy();
+                child.stderr.destroy();
+                done(exitCode, signal);
+            }, STREAM_WAIT_MS);
+        });
+        child.on('close', done);
+    }
+
+    _output(job, stream, text) {
+        const out = job.output;
+        if (!text || out.bytes >= OUTPUT_LIMIT_BYTES) return;
+
+        let bytes = Buffer.byteLength(text, 'utf8');
+        if (out.bytes + bytes > OUTPUT_LIMIT_BYTES) {
+            // Cut at the limit; a decoder drops a character the cut splits
+            const room = Buffer.from(text, 'utf8').subarray(0, OUTPUT_LIMIT_BYTES - out.bytes);
+            text = new StringDecoder('utf8').write(room);
+            bytes = room.length;
+            job.reason = 'output_limit';
+            if (job.child) killGroup(job.child);
+        }
+        out.bytes += bytes;
+        out[stream] += text;
+
+        if (out.stdout.length + out.stderr.length >= OUTPUT_BATCH_BYTES) {
+            this._flushOutput(job);
+        } else if (!out.timer) {
+            out.timer = setTimeout(() => this._flushOutput(job), OUTPUT_FLUSH_MS);
+        }
+    }
+
+    _flushOutput(job) {
+        const out = job.output;
+        clearTimeout(out.timer);
+        out.timer = null;
+        for (const stream of ['stdout', 'stderr']) {
+            if (out[stream]) {
+                job.onEvent({ type: 'output', stream, data: out[stream] });
+                out[stream] = '';
+            }
+        }
+    }
+
+    _finish(job, result) {
+        this._flushOutput(job);
+        if (job.compileSlot) {
+            this.compiling--;
+            job.compileSlot = false;
+        }
+        job.state = 'done';
+        this.jobs.delete(job.id);
+        if (job.dir) {
+            fs.rm(job.dir, { recursive: true, force: true }, () => {});
+        }
+        job.onEvent({
+            type: 'exit',
+            exitCode: result.exitCode,
+            signal: result.signal,
+            reason: result.reason || null,
+            compileError: result.compileError || null,
+            timeMs: job.startedAt ? Date.now() - job.startedAt : 0
+        });
+        this._pump();
+    }
+}
+
+CppRunner.COMPILER = COMPILER;
+CppRunner.COMPILE_FLAGS = COMPILE_FLAGS;
+CppRunner.MAX_COMPILING = MAX_COMPILING;
+CppRunner.MAX_ACTIVE = MAX_ACTIVE;
+CppRunner.MAX_SOURCE_BYTES = MAX_SOURCE_BYTES;
+
+module.exports = CppRunner;
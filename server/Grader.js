@@ -0,0 +1,320 @@
+/**
+ * Grader - Checks students' C++ exercises against the solved references
+ *
+ * Each level folder of content/cpp/exercises holds ex_*.cpp skeletons,
+ * their ex_*-solved.cpp references and a tests.json with the stdin of
+ * each test:
+ *   { "ex_rectangle": ["3\n4\n", "2.5\n10\n"], "ex_guess_number": null }
+ * An exercise missing from tests.json is run once with no input; null
+ * means it can't be graded (random output).
+ *
+ * The reference runs once per test and its output is cached until the
+ * files change. The list of exercises is read again when a folder or a
+ * skeleton changes (checked at most every CATALOG_CHECK_MS), so
+ * exercises added or edited while the server runs are graded too. Submissions run through the CppRunner pool (so each one
+ * compiles once - its tests share the build) with at most
+ * MAX_PARALLEL_TESTS at a time, leaving the rest of the pool to the
+ * class's own runs. A test passes when stdout (after normalizing line
+ * endings and trailing whitespace) and the exit code match the reference.
+ *
+ * A submission is matched to the exercise whose skeleton it shares the
+ * most lines with, so one grading pass covers students working on
+ * different exercises of a level.
+ */
+
+const fs = require('fs');
+const path = require('path');
+
+const TEST_TIMEOUT_MS = 3000;       // From the moment the program starts
+const MAX_PARALLEL_TESTS = 8;
+const MIN_SIMILARITY = 0.3;         // Dice score of shared lines with the skeleton
+const RETRY_MS = 200;               // Runner queue full
+const MISMATCH_CHARS = 120;
+const CATALOG_CHECK_MS = 2000;
+
+const TESTS_FILE = 'tests.json';
+
+/**
+ * Output as compared: \n line endings, no trailing whitespace or blank lines
+ * @param {string} text
+ * @returns {string}
+ */
+function normalizeOutput(text) {
+    return text.replace(/\r\n?/g, '\n')
+        .split('\n')
+        .map(line => line.replace(/\s+$/, ''))
+        .join('\n')
+        .replace(/\n+$/, '');
+}
+
+// Modification times of the exercise folders and skeletons: adding, removing or editing
+// an exercise changes it (references and tests.json are stamped per exercise)
+function catalogStamp(dir) {
+    const parts = [];
+    const walk = (folder) => {
+        parts.push(`${folder}:${fs.statSync(folder).mtimeMs}`);
+        for (const item of fs.readdirSync(folder, { withFileTypes: true })) {
+            const full = path.join(folder, item.name);
+            if (item.isDirectory()) {
+                walk(full);
+            } else if (/^ex_.+\.cpp$/.test(item.name)) {
+                parts.push(`${item.name}:${fs.statSync(full).mtimeMs}`);
+            }
+        }
+    };
+    try {
+        walk(dir);
+    } catch (error) {
+        return null; // Missing, or changing while we read it
+    }
+    return parts.join('|');
+}
+
+// Non-trivial lines of a source, for matching submissions to skeletons
+function significantLines(code) {
+    return new Set(code.split('\n')
+        .map(line => line.trim())
+        .filter(line => line.length > 2 && !/^[{}();]*$/.test(line)));
+}
+
+class Grader {
+    /**
+     * @param {CppRunner} runner
+     * @param {string} dir - content/cpp/exercises
+     */
+    constructor(runner, dir) {
+        this.runner = runner;
+        this.dir = dir;
+        this.grading = false;
+        this._catalog = null;       // { stamp, exercises }, read on first use
+        this._catalogCheckedAt = 0;
+        this._expected = new Map(); // exercise id -> { stamp, entry: Promise of the outputs }
+        this._running = 0;
+        this._waiting = [];         // Tests waiting for a slot
+    }
+
+    /**
+     * Every gradable exercise
+     * @returns {Object[]} { id, name, skeletonLines, solvedPath, testsPath }
+     */
+    catalog() {
+        if (this._catalog && Date.now() - this._catalogCheckedAt < CATALOG_CHECK_MS) {
+            return this._catalog.exercises;
+        }
+        const stamp = catalogStamp(this.dir);
+        this._catalogCheckedAt = Date.now();
+        if (this._catalog && stamp !== null && stamp === this._catalog.stamp) {
+            return this._catalog.exercises;
+        }
+        const exercises = [];
+        const walk = (folder) => {
+            for (const item of fs.readdirSync(folder, { withFileTypes: true })) {
+                const full = path.join(folder, item.name);
+                if (item.isDirectory()) {
+                    walk(full);
+                    continue;
+                }
+                const match = item.name.match(/^(ex_.+?)(?<!-solved)\.cpp$/);
+                const solvedPath = match && path.join(folder, `${match[1]}-solved.cpp`);
+                if (!match || !fs.existsSync(solvedPath)) continue;
+                exercises.push({
+                    id: path.relative(this.dir, path.join(folder, match[1])).split(path.sep).join('/'),
+                    name: match[1],
+                    skeletonLines: significantLines(fs.readFileSync(full, 'utf8')),
+                    solvedPath,
+                    testsPath: path.join(folder, TESTS_FILE)
+                });
+            }
+        };
+        if (fs.existsSync(this.dir)) walk(this.dir);
+        this._catalog = { stamp, exercises };
+        return exercises;
+    }
+
+    /**
+     * The exercise a submission was written from
+     * @param {string} code
+     * @returns {Object|null}
+     */
+    identify(code) {
+        const lines = significantLines(code);
+        let best = null;
+        let bestScore = MIN_SIMILARITY;
+        for (const exercise of this.catalog()) {
+            let shared = 0;
+            exercise.skeletonLines.forEach(line => { if (lines.has(line)) shared++; });
+            // Dice, so a short skeleton (hello world) doesn't match every longer program
+            const score = 2 * shared / Math.max(1, exercise.skeletonLines.size + lines.size);
+            if (score > bestScore) {
+                best = exercise;
+                bestScore = score;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * Grade a batch of submissions
+     * @param {{ studentId: string, name: string, code: string }[]} submissions
+     * @param {string} [fallbackCode] - Code the students started from, if a submission isn't recognised
+     * @returns {Promise<Object[]>} One result per submission (see _gradeOne)
+     */
+    async grade(submissions, fallbackCode = '') {
+        this.grading = true;
+        try {
+            const fallback = fallbackCode ? this.identify(fallbackCode) : null;
+            return await Promise.all(submissions.map(submission =>
+                this._gradeOne(submission, this.identify(submission.code) || fallback)));
+        } finally {
+            this.grading = false;
+        }
+    }
+
+    async _gradeOne(submission, exercise) {
+        const result = {
+            studentId: submission.studentId,
+            name: submission.name,
+            exercise: exercise ? exercise.id : null,
+            status: 'unknown_exercise',
+            passed: 0,
+            total: 0,
+            mismatch: null
+        };
+        if (!exercise) return result;
+
+        const expected = await this._expectedOutputs(exercise);
+        if (!expected.outputs) {
+            result.status = expected.status;
+            return result;
+        }
+
+        result.total = expected.outputs.length;
+        const runs = await Promise.all(expected.inputs.map(input => this._runTest(submission.code, input)));
+        runs.forEach((run, i) => {
+            if (run.reason === 'compile_error' && result.status !== 'compile_error') {
+                result.status = 'compile_error';
+                result.mismatch = { test: i + 1, error: (run.compileError || '').slice(0, MISMATCH_CHARS * 4) };
+            }
+            const output = normalizeOutput(run.stdout);
+            if (!run.reason && output === expected.outputs[i].stdout && run.exitCode === expected.outputs[i].exitCode) {
+                result.passed++;
+            } else if (!result.mismatch) {
+                result.mismatch = run.reason
+                    ? { test: i + 1, reason: run.reason }
+                    : output !== expected.outputs[i].stdout
+                        ? { test: i + 1, ...this._firstDifference(expected.outputs[i].stdout, output) }
+                        : { test: i + 1, reason: 'exit_code', expected: String(expected.outputs[i].exitCode), actual: String(run.exitCode) };
+            }
+        });
+        if (result.status !== 'compile_error') {
+            result.status = result.passed === result.total ? 'passed' : 'failed';
+        }
+        return result;
+    }
+
+    // Reference outputs of an exercise, recomputed when its files change
+    async _expectedOutputs(exercise) {
+        let inputs;
+        let stamp;
+        try {
+            const tests = fs.existsSync(exercise.testsPath)
+                ? JSON.parse(fs.readFileSync(exercise.testsPath, 'utf8'))
+                : {};
+            inputs = exercise.name in tests ? tests[exercise.name] : [''];
+            stamp = `${fs.statSync(exercise.solvedPath).mtimeMs}:${fs.existsSync(exercise.testsPath) ? fs.statSync(exercise.testsPath).mtimeMs : 0}`;
+        } catch (error) {
+            console.error(`❌ Grader: bad tests for ${exercise.id}:`, error.message);
+            return { status: 'no_reference' };
+        }
+        if (inputs === null) return { status: 'not_graded' };
+
+        const cached = this._expected.get(exercise.id);
+        if (cached && cached.stamp === stamp) return cached.entry;
+
+        const entry = (async () => {
+            const reference = fs.readFileSync(exercise.solvedPath, 'utf8');
+            const runs = await Promise.all(inputs.map(input => this._runTest(reference, input)));
+            const failed = runs.find(run => run.reason);
+            if (failed) {
+                console.error(`❌ Grader: reference ${exercise.id} failed (${failed.reason})`);
+                return { status: 'no_reference' };
+            }
+            return { inputs, outputs: runs.map(run => ({ stdout: normalizeOutput(run.stdout), exitCode: run.exitCode })) };
+        })();
+        this._expected.set(exercise.id, { stamp, entry });
+        const result = await entry;
+        if (!result.outputs) this._expected.delete(exercise.id); // Try again next time
+        return result;
+    }
+
+    _firstDifference(expected, actual) {
+        const expectedLines = expected.split('\n');
+        const actualLines = actual.split('\n');
+        let line = 0;
+        while (line < expectedLines.length && expectedLines[line] === actualLines[line]) line++;
+        return {
+            line: line + 1,
+            expected: (expectedLines[line] ?? '').slice(0, MISMATCH_CHARS),
+            actual: (actualLines[line] ?? '(no output)').slice(0, MISMATCH_CHARS)
+        };
+    }
+
+    /**
+     * One program run with the given stdin
+     * @returns {Promise<{ stdout: string, exitCode: number|null, reason: string|null, compileError: string|null }>}
+     */
+    async _runTest(code, input) {
+        await this._slot();
+        try {
+            return await new Promise(resolve => this._submit(code, input, resolve));
+        } finally {
+            this._running--;
+            const next = this._waiting.shift();
+            if (next) next();
+        }
+    }
+
+    _slot() {
+        if (this._running < MAX_PARALLEL_TESTS) {
+            this._running++;
+            return Promise.resolve();
+        }
+        return new Promise(resolve => this._waiting.push(() => {
+            this._running++;
+            resolve();
+        }));
+    }
+
+    _submit(code, input, resolve) {
+        let stdout = '';
+        let timer = null;
+        let timedOut = false;
+        const id = this.runner.submit(code, event => {
+            if (event.type === 'running') {
+                this.runner.write(event.runId, input);
+                this.runner.closeInput(event.runId);
+                timer = setTimeout(() => {
+                    timedOut = true;
+                    this.runner.stop(event.runId);
+                }, TEST_TIMEOUT_MS);
+            } else if (event.type === 'output' && event.stream === 'stdout') {
+                stdout += event.data;
+            } else if (event.type === 'exit') {
+                clearTimeout(timer);
+                // A crash is an error; an exit code is compared with the reference's
+                const reason = timedOut ? 'timeout'
+                    : event.reason || (event.signal ? 'runtime_error' : null);
+                resolve({ stdout, exitCode: event.exitCode, reason, compileError: event.compileError });
+            }
+        });
+        if (id === null) {
+            // Runner queue is full: try again shortly
+            setTimeout(() => this._submit(code, input, resolve), RETRY_MS);
+        }
+    }
+}
+
+Grader.normalizeOutput = normalizeOutput;
+Grader.TEST_TIMEOUT_MS = TEST_TIMEOUT_MS;
+
+module.exports = Grader;
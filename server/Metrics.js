@@ -0,0 +1,344 @@
+/**
+ * Metrics - Message, handler, event-loop and GC counters of the server
+ *
+ * Per message type: messages and bytes received and sent, and a histogram
+ * of how long the ws 'message' handler ran for it (the synchronous part:
+ * work a handler hands to a child process or a timer is not included).
+ * Beside those, event-loop lag (perf_hooks.monitorEventLoopDelay, in
+ * windows of LAG_WINDOW_MS) and GC pauses by kind. Served as Prometheus
+ * text (/metrics) and JSON (/api/metrics); the caller adds the gauges it
+ * owns (connections and outbound queue per room).
+ *
+ * Counting runs for every message, so it allocates nothing: each type has
+ * one record with a Float64Array of buckets, received types are looked up
+ * by the string JSON.parse already made, and the type of an outgoing
+ * message is read from the JSON text in place ('{"type":"...') through a
+ * small open-addressing table, without slicing it out. Only the first
+ * message of a new type creates its record. Clients choose the types they
+ * send, so at most MAX_TYPES are kept; the rest count as 'other'.
+ */
+
+const { monitorEventLoopDelay, PerformanceObserver, constants } = require('perf_hooks');
+
+// Handler duration buckets, upper bounds in ms
+const DURATION_BUCKETS_MS = [0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 25, 50, 100, 250, 1000];
+const MAX_TYPES = 100;
+const MAX_TYPE_CHARS = 40;
+const TYPE_TABLE_SIZE = 256;           // Power of two, above MAX_TYPES
+const LAG_WINDOW_MS = 10000;
+const LAG_RESOLUTION_MS = 10;          // Sampling interval, included in every reading
+const TYPE_PREFIX = '{"type":"';
+
+const GC_KINDS = {
+    [constants.NODE_PERFORMANCE_GC_MINOR]: 'minor',
+    [constants.NODE_PERFORMANCE_GC_MAJOR]: 'major',
+    [constants.NODE_PERFORMANCE_GC_INCREMENTAL]: 'incremental',
+    [constants.NODE_PERFORMANCE_GC_WEAKCB]: 'weakcb'
+};
+
+class Metrics {
+    constructor() {
+        this.startedAt = Date.now();
+        this.connectionsOpened = 0;
+        this._types = new Map();                         // name -> record
+        this._other = this._createRecord('other');
+        this._invalid = this._createRecord('invalid');   // Not JSON, or no string type
+        this._table = new Array(TYPE_TABLE_SIZE).fill(null); // Outgoing type lookup
+        this._hashes = new Int32Array(TYPE_TABLE_SIZE);
+        this._lastSent = null;                           // Broadcasts send one string to many
+        this._lastSentRecord = null;
+        this._lastSentBytes = 0;
+
+        // Event-loop lag: the last complete window
+        this._loop = monitorEventLoopDelay({ resolution: LAG_RESOLUTION_MS });
+        this._loop.enable();
+        this.lag = null;
+        this._lagTimer = setInterval(() => this._rollLag(), LAG_WINDOW_MS);
+        this._lagTimer.unref();
+
+        // GC pauses by kind
+        this.gc = {};
+        for (const kind of Object.values(GC_KINDS)) {
+            this.gc[kind] = { count: 0, seconds: 0, maxSeconds: 0 };
+        }
+        this._gcObserver = new PerformanceObserver(list => {
+            for (const entry of list.getEntries()) {
+                const stats = this.gc[GC_KINDS[entry.detail ? entry.detail.kind : entry.kind]];
+                if (!stats) continue;
+                const seconds = entry.duration / 1000;
+                stats.count++;
+                stats.seconds += seconds;
+                if (seconds > stats.maxSeconds) stats.maxSeconds = seconds;
+            }
+        });
+        this._gcObserver.observe({ entryTypes: ['gc'] });
+    }
+
+    /**
+     * Count a connection's outgoing messages: wraps its send()
+     * @param {WebSocket} ws
+     */
+    track(ws) {
+        this.connectionsOpened++;
+        const send = ws.send;
+        ws.send = (data, options, callback) => {
+            this.sent(data);
+            return send.call(ws, data, options, callback);
+        };
+    }
+
+    /**
+     * One received message, after its handler returned
+     * @param {*} type - message.type (anything a client sent), null if unparsable
+     * @param {number} bytes
+     * @param {number} ms - Handler duration
+     */
+    handled(type, bytes, ms) {
+        const record = typeof type === 'string' ? this._recordFor(type) : this._invalid;
+        record.received++;
+        record.receivedBytes += bytes;
+        record.durationCount++;
+        record.durationSumMs += ms;
+        const buckets = record.durations;
+        let i = 0;
+        while (i < DURATION_BUCKETS_MS.length && ms > DURATION_BUCKETS_MS[i]) i++;
+        buckets[i]++;
+    }
+
+    /**
+     * One outgoing message
+     * @param {string|Buffer} data
+     */
+    sent(data) {
+        let record;
+        let bytes;
+        if (data === this._lastSent) {
+            record = this._lastSentRecord;
+            bytes = this._lastSentBytes;
+        } else if (typeof data === 'string') {
+            record = this._outgoingRecord(data);
+            bytes = Buffer.byteLength(data);
+            this._lastSent = data;
+            this._lastSentRecord = record;
+            this._lastSentBytes = bytes;
+        } else {
+            record = this._other;
+            bytes = data.length;
+        }
+        record.sent++;
+        record.sentBytes += bytes;
+    }
+
+    /**
+     * Prometheus text exposition (format 0.0.4)
+     * @param {Object} rooms - room -> { connections, queuedBytes, maxQueuedBytes }
+     * @returns {string}
+     */
+    prometheus(rooms = {}) {
+        const lines = [];
+        const metric = (name, type, help) => lines.push(`# HELP ${name} ${help}`, `# TYPE ${name} ${type}`);
+        const records = this._records();
+
+        metric('codeboard_messages_received_total', 'counter', 'WebSocket messages received, by type');
+        records.forEach(r => lines.push(`codeboard_messages_received_total{type="${label(r.name)}"} ${r.received}`));
+        metric('codeboard_received_bytes_total', 'counter', 'WebSocket bytes received, by message type');
+        records.forEach(r => lines.push(`codeboard_received_bytes_total{type="${label(r.name)}"} ${r.receivedBytes}`));
+        metric('codeboard_messages_sent_total', 'counter', 'WebSocket messages sent (one per recipient), by type');
+        records.forEach(r => lines.push(`codeboard_messages_sent_total{type="${label(r.name)}"} ${r.sent}`));
+        metric('codeboard_sent_bytes_total', 'counter', 'WebSocket bytes sent, by message type');
+        records.forEach(r => lines.push(`codeboard_sent_bytes_total{type="${label(r.name)}"} ${r.sentBytes}`));
+
+        metric('codeboard_handler_duration_seconds', 'histogram', 'Time in the message handler, by message type');
+        for (const r of records) {
+            if (r.durationCount === 0) continue;
+            const type = label(r.name);
+            let cumulative = 0;
+            DURATION_BUCKETS_MS.forEach((bound, i) => {
+                cumulative += r.durations[i];
+                lines.push(`codeboard_handler_duration_seconds_bucket{type="${type}",le="${bound / 1000}"} ${cumulative}`);
+            });
+            lines.push(`codeboard_handler_duration_seconds_bucket{type="${type}",le="+Inf"} ${r.durationCount}`);
+            lines.push(`codeboard_handler_duration_seconds_sum{type="${type}"} ${r.durationSumMs / 1000}`);
+            lines.push(`codeboard_handler_duration_seconds_count{type="${type}"} ${r.durationCount}`);
+        }
+
+        metric('codeboard_connections', 'gauge', 'Open WebSocket connections, by room');
+        Object.entries(rooms).forEach(([room, s]) => lines.push(`codeboard_connections{room="${label(room)}"} ${s.connections}`));
+        metric('codeboard_outbound_queue_bytes', 'gauge', 'Bytes queued to be sent (ws.bufferedAmount), summed by room');
+        Object.entries(rooms).forEach(([room, s]) => lines.push(`codeboard_outbound_queue_bytes{room="${label(room)}"} ${s.queuedBytes}`));
+        metric('codeboard_outbound_queue_max_bytes', 'gauge', 'Largest single connection queue, by room');
+        Object.entries(rooms).forEach(([room, s]) => lines.push(`codeboard_outbound_queue_max_bytes{room="${label(room)}"} ${s.maxQueuedBytes}`));
+        metric('codeboard_connections_opened_total', 'counter', 'WebSocket connections accepted');
+        lines.push(`codeboard_connections_opened_total ${this.connectionsOpened}`);
+
+        const lag = this.lagStats();
+        metric('codeboard_event_loop_lag_seconds', 'summary', `Event-loop lag over the last ${LAG_WINDOW_MS / 1000} s`);
+        lines.push(`codeboard_event_loop_lag_seconds{quantile="0.5"} ${lag.p50Ms / 1000}`);
+        lines.push(`codeboard_event_loop_lag_seconds{quantile="0.99"} ${lag.p99Ms / 1000}`);
+        lines.push(`codeboard_event_loop_lag_seconds{quantile="1"} ${lag.maxMs / 1000}`);
+
+        metric('codeboard_gc_pauses_total', 'counter', 'Garbage collections, by kind');
+        Object.entries(this.gc).forEach(([kind, s]) => lines.push(`codeboard_gc_pauses_total{kind="${kind}"} ${s.count}`));
+        metric('codeboard_gc_pause_seconds_total', 'counter', 'Time paused in garbage collection, by kind');
+        Object.entries(this.gc).forEach(([kind, s]) => lines.push(`codeboard_gc_pause_seconds_total{kind="${kind}"} ${s.seconds}`));
+        metric('codeboard_gc_pause_max_seconds', 'gauge', 'Longest garbage collection pause, by kind');
+        Object.entries(this.gc).forEach(([kind, s]) => lines.push(`codeboard_gc_pause_max_seconds{kind="${kind}"} ${s.maxSeconds}`));
+
+        const cpu = process.cpuUsage();
+        const memory = process.memoryUsage();
+        metric('process_cpu_seconds_total', 'counter', 'User and system CPU time');
+        lines.push(`process_cpu_seconds_total ${(cpu.user + cpu.system) / 1e6}`);
+        metric('process_resident_memory_bytes', 'gauge', 'Resident memory size');
+        lines.push(`process_resident_memory_bytes ${memory.rss}`);
+        metric('nodejs_heap_used_bytes', 'gauge', 'V8 heap in use');
+        lines.push(`nodejs_heap_used_bytes ${memory.heapUsed}`);
+        metric('process_start_time_seconds', 'gauge', 'Start time since the epoch');
+        lines.push(`process_start_time_seconds ${Math.floor(this.startedAt / 1000)}`);
+
+        return `${lines.join('\n')}\n`;
+    }
+
+    /**
+     * The same numbers as an object (ms rather than seconds)
+     * @param {Object} rooms - room -> { connections, queuedBytes, maxQueuedBytes }
+     */
+    json(rooms = {}) {
+        const messages = {};
+        for (const r of this._records()) {
+            // [upper bound ms, count] (not cumulative), the last bound is null (+Inf)
+            const buckets = Array.from(r.durations, (count, i) =>
+                [i < DURATION_BUCKETS_MS.length ? DURATION_BUCKETS_MS[i] : null, count]);
+            messages[r.name] = {
+                received: r.received,
+                receivedBytes: r.receivedBytes,
+                sent: r.sent,
+                sentBytes: r.sentBytes,
+                handlerMs: r.durationCount > 0
+                    ? { count: r.durationCount, mean: r.durationSumMs / r.durationCount, buckets }
+                    : null
+            };
+        }
+        const memory = process.memoryUsage();
+        const cpu = process.cpuUsage();
+        return {
+            uptimeMs: Date.now() - this.startedAt,
+            messages,
+            rooms,
+            connectionsOpened: this.connectionsOpened,
+            eventLoopLagMs: this.lagStats(),
+            gc: this.gc,
+            process: {
+                cpuMs: (cpu.user + cpu.system) / 1000,
+                rssBytes: memory.rss,
+                heapUsedBytes: memory.heapUsed
+            }
+        };
+    }
+
+    /**
+     * Event-loop lag of the last complete window (the current one until the first closes)
+     * @returns {{ windowMs, meanMs, p50Ms, p99Ms, maxMs }}
+     */
+    lagStats() {
+        return this.lag || this._readLag();
+    }
+
+    // ---------------- Records ----------------
+
+    _createRecord(name) {
+        return {
+            name,
+            received: 0,
+            receivedBytes: 0,
+            sent: 0,
+            sentBytes: 0,
+            durations: new Float64Array(DURATION_BUCKETS_MS.length + 1),
+            durationSumMs: 0,
+            durationCount: 0
+        };
+    }
+
+    _recordFor(name) {
+        const record = this._types.get(name);
+        if (record) return record;
+        if (this._types.size >= MAX_TYPES || name.length > MAX_TYPE_CHARS) return this._other;
+        const created = this._createRecord(name);
+        this._types.set(name, created);
+        return created;
+    }
+
+    // Type of a message as JSON.stringify wrote it: '{"type":"name",...'
+    _outgoingRecord(data) {
+        if (!data.startsWith(TYPE_PREFIX)) return this._other;
+        const start = TYPE_PREFIX.length;
+        const limit = Math.min(data.length, start + MAX_TYPE_CHARS + 1);
+        let hash = 0;
+        let end = start;
+        for (; end < limit; end++) {
+            const code = data.charCodeAt(end);
+            if (code === 34) break; // '"'
+            hash = (Math.imul(hash, 31) + code) | 0;
+        }
+        if (end === limit) return this._other;
+
+        const mask = TYPE_TABLE_SIZE - 1;
+        for (let slot = hash & mask, probes = 0; probes < TYPE_TABLE_SIZE; slot = (slot + 1) & mask, probes++) {
+            const record = this._table[slot];
+            if (record === null) {
+                // First message of this type: the only allocation
+                const found = this._recordFor(data.slice(start, end));
+                if (found === this._other) return found;
+                this._table[slot] = found;
+                this._hashes[slot] = hash;
+                return found;
+            }
+            if (this._hashes[slot] === hash && sameName(record.name, data, start, end)) return record;
+        }
+        return this._other;
+    }
+
+    _records() {
+        const records = [...this._types.values()];
+        if (this._other.received || this._other.sent) records.push(this._other);
+        if (this._invalid.received) records.push(this._invalid);
+        return records;
+    }
+
+    // ---------------- Event loop ----------------
+
+    _readLag() {
+        const h = this._loop;
+        const ms = ns => Math.max(0, Math.round((ns / 1e6 - LAG_RESOLUTION_MS) * 100) / 100);
+        return {
+            windowMs: LAG_WINDOW_MS,
+            meanMs: h.count > 0 ? ms(h.mean) : 0,
+            p50Ms: h.count > 0 ? ms(h.percentile(50)) : 0,
+            p99Ms: h.count > 0 ? ms(h.percentile(99)) : 0,
+            maxMs: h.count > 0 ? ms(h.max) : 0
+        };
+    }
+
+    _rollLag() {
+        this.lag = this._readLag();
+        this._loop.reset();
+    }
+}
+
+// name === data.slice(start, end), without the slice
+function sameName(name, data, start, end) {
+    if (name.length !== end - start) return false;
+    for (let i = 0; i < name.length; i++) {
+        if (name.charCodeAt(i) !== data.charCodeAt(start + i)) return false;
+    }
+    return true;
+}
+
+// Prometheus label value escaping
+function label(value) {
+    return String(value).replace(/[\\"\n]/g, c => (c === '\n' ? '\\n' : `\\${c}`));
+}
+
+Metrics.DURATION_BUCKETS_MS = DURATION_BUCKETS_MS;
+Metrics.MAX_TYPES = MAX_TYPES;
+
+module.exports = Metrics;
@@ -0,0 +1,186 @@
+/**
+ * RecordingLog - Binary file format of lesson recordings
+ *
+ *   file    = 'CBR1' frame*
+ *   frame   = u32 startMs | u32 endMs | u32 byteLength | deflateRaw(segment)
+ *   segment = record*                      (the first one is a keyframe)
+ *   record  = varint dt | varint kind | varint byteLength | JSON body
+ *
+ * dt is milliseconds since the previous record (the first one: since
+ * startMs), kind an index into KINDS and the body the message without
+ * its `type`. Every frame inflates on its own, so seeking reads one
+ * segment, and the frame headers alone make the index.
+ */
+
+const fs = require('fs');
+const zlib = require('zlib');
+
+const MAGIC = Buffer.from('CBR1');
+const FRAME_HEADER_BYTES = 12;
+
+// Message types a recording can hold (append only - the index is the on-disk kind)
+const KINDS = [
+    'keyframe',
+    'code_update', 'code_ops', 'template_loaded', 'doc_activate',
+    'language_change', 'mode_change', 'breakpoints', 'scope', 'scroll_to_line',
+    'highlight_selection', 'highlight_tiles', 'laser_point',
+    'pdf_load', 'pdf_sync', 'pdf_laser',
+    'markdown_content', 'markdown_state', 'markdown_laser'
+];
+const KIND_OF = new Map(KINDS.map((type, kind) => [type, kind]));
+
+function writeVarint(bytes, value) {
+    while (value >= 0x80) {
+        bytes.push((value & 0x7f) | 0x80);
+        value = Math.floor(value / 128);
+    }
+    bytes.push(value);
+}
+
+function readVarint(buffer, pos) {
+    let value = 0;
+    let scale = 1;
+    let byte;
+    do {
+        byte = buffer[pos.offset++];
+        value += (byte & 0x7f) * scale;
+        scale *= 128;
+    } while (byte & 0x80);
+    return value;
+}
+
+/**
+ * @param {string} type
+ * @returns {boolean} true if messages of this type can be recorded
+ */
+function isRecordable(type) {
+    return KIND_OF.has(type);
+}
+
+/**
+ * Encode one segment as a frame
+ * @param {{ t: number, message: Object }[]} records - t in ms since the recording started
+ * @param {number} startMs
+ * @param {number} endMs
+ * @returns {Buffer}
+ */
+function encodeFrame(records, startMs, endMs) {
+    const chunks = [];
+    let last = startMs;
+    for (const { t, message } of records) {
+        const { type, ...body } = message;
+        const json = Buffer.from(JSON.stringify(body));
+        const head = [];
+        writeVarint(head, Math.max(0, t - last));
+        writeVarint(head, KIND_OF.get(type));
+        writeVarint(head, json.length);
+        chunks.push(Buffer.from(head), json);
+        last = Math.max(last, t);
+    }
+    const body = zlib.deflateRawSync(Buffer.concat(chunks));
+
+    const header = Buffer.alloc(FRAME_HEADER_BYTES);
+    header.writeUInt32LE(startMs, 0);
+    header.writeUInt32LE(endMs, 4);
+    header.writeUInt32LE(body.length, 8);
+    return Buffer.concat([header, body]);
+}
+
+/**
+ * Decode the body of a frame
+ * @param {Buffer} body - Deflated segment
+ * @param {number} startMs
+ * @returns {{ t: number, message: Object }[]}
+ */
+function decodeSegment(body, startMs) {
+    const buffer = zlib.inflateRawSync(body);
+    const pos = { offset: 0 };
+    const records = [];
+    let t = startMs;
+    while (pos.offset < buffer.length) {
+        t += readVarint(buffer, pos);
+        const type = KINDS[readVarint(buffer, pos)];
+        const length = readVarint(buffer, pos);
+        const json = buffer.toString('utf8', pos.offset, pos.offset + length);
+        pos.offset += length;
+        records.push({ t, message: { type, ...JSON.parse(json) } });
+    }
+    return records;
+}
+
+/**
+ * Start a new recording file
+ * @param {string} file
+ */
+function create(file) {
+    fs.writeFileSync(file, MAGIC);
+}
+
+/**
+ * Append one segment
+ * @param {string} file
+ * @param {{ t: number, message: Object }[]} records
+ * @param {number} startMs
+ * @param {number} endMs
+ */
+function append(file, records, startMs, endMs) {
+    fs.appendFileSync(file, encodeFrame(records, startMs, endMs));
+}
+
+/**
+ * Segment index from the frame headers (bodies are not read)
+ * @param {string} file
+ * @returns {{ startMs: number, endMs: number, offset: number, length: number }[]}
+ */
+function readIndex(file) {
+    const fd = fs.openSync(file, 'r');
+    try {
+        const size = fs.fstatSync(fd).size;
+        const header = Buffer.alloc(FRAME_HEADER_BYTES);
+        const segments = [];
+        let offset = MAGIC.length;
+        while (offset + FRAME_HEADER_BYTES <= size) {
+            fs.readSync(fd, header, 0, FRAME_HEADER_BYTES, offset);
+            const length = header.readUInt32LE(8);
+            if (offset + FRAME_HEADER_BYTES + length > size) break; // Torn write at the end
+            segments.push({
+                startMs: header.readUInt32LE(0),
+                endMs: header.readUInt32LE(4),
+                offset: offset + FRAME_HEADER_BYTES,
+                length
+            });
+            offset += FRAME_HEADER_BYTES + length;
+        }
+        return segments;
+    } finally {
+        fs.closeSync(fd);
+    }
+}
+
+/**
+ * Records of one segment
+ * @param {string} file
+ * @param {Object} segment - Entry of readIndex()
+ * @returns {{ t: number, message: Object }[]}
+ */
+function readSegment(file, segment) {
+    const fd = fs.openSync(file, 'r');
+    try {
+        const body = Buffer.alloc(segment.length);
+        fs.readSync(fd, body, 0, segment.length, segment.offset);
+        return decodeSegment(body, segment.startMs);
+    } finally {
+        fs.closeSync(fd);
+    }
+}
+
+module.exports = {
+    KINDS,
+    isRecordable,
+    encodeFrame,
+    decodeSegment,
+    create,
+    append,
+    readIndex,
+    readSegment
+};
@@ -0,0 +1,140 @@
+/**
+ * SessionDocuments - The board's named documents (tabs)
+ *
+ * A session holds several documents; the teacher picks the active one.
+ * Only the active document is live: its edits go out as code_ops to the
+ * class. Switching tabs sends just { docId, version } - clients that have
+ * the document cached at that version show it at once, the others fetch
+ * it (as the ops since their cached version when the history still has
+ * them, otherwise as the full text).
+ */
+
+const SyncedDocument = require('./SyncedDocument.js');
+
+class SessionDocuments {
+    constructor() {
+        this.documents = new Map(); // docId -> { id, name, doc }
+        this.activeId = null;
+        this._counter = 0;
+        this.create('main', '');
+    }
+
+    /**
+     * @param {string} name
+     * @param {string} [code='']
+     * @returns {{ id: string, name: string, doc: SyncedDocument }}
+     */
+    create(name, code = '') {
+        const entry = { id: `d${++this._counter}`, name: String(name || 'untitled'), doc: new SyncedDocument(code) };
+        this.documents.set(entry.id, entry);
+        if (!this.activeId) this.activeId = entry.id;
+        return entry;
+    }
+
+    /**
+     * @param {string} docId
+     * @returns {Object|undefined}
+     */
+    get(docId) {
+        return this.documents.get(docId);
+    }
+
+    /**
+     * The document everyone is on
+     * @returns {{ id: string, name: string, doc: SyncedDocument }}
+     */
+    get active() {
+        return this.documents.get(this.activeId);
+    }
+
+    /**
+     * @param {string} docId
+     * @returns {boolean} false if there is no such document
+     */
+    activate(docId) {
+        if (!this.documents.has(docId)) return false;
+        this.activeId = docId;
+        return true;
+    }
+
+    /**
+     * Close a document; the last one always stays.
+     * Closing the active document activates its neighbour.
+     * @param {string} docId
+     * @returns {boolean} true if the active document changed
+     */
+    remove(docId) {
+        if (!this.documents.has(docId) || this.documents.size === 1) return false;
+        const ids = Array.from(this.documents.keys());
+        const index = ids.indexOf(docId);
+        this.documents.delete(docId);
+        if (docId !== this.activeId) return false;
+        this.activeId = ids[index + 1] || ids[index - 1];
+        return true;
+    }
+
+    /**
+     * Tab list for clients: metadata only, never the text
+     * @returns {{ id: string, name: string, version: number }[]}
+     */
+    list() {
+        return Array.from(this.documents.values()).map(entry => ({
+            id: entry.id,
+            name: entry.name,
+            version: entry.doc.version
+        }));
+    }
+
+    /**
+     * Reply to doc_fetch: the ops since the client's cached version when
+     * the history has them and they are smaller than the text
+     * @param {string} docId
+     * @param {number|null} sinceVersion - Version the client has cached
+     * @returns {Object|null} { docId, version, code } or { docId, version, baseVersion, ops }
+     */
+    fetch(docId, sinceVersion) {
+        const entry = this.documents.get(docId);
+        if (!entry) return null;
+        const doc = entry.doc;
+
+        if (Number.isInteger(sinceVersion)) {
+            const ops = doc.changesSince(sinceVersion);
+            if (ops && JSON.stringify(ops).length < doc.code.length) {
+                return { docId, version: doc.version, baseVersion: sinceVersion, ops };
+            }
+        }
+        return { docId, version: doc.version, code: doc.code };
+    }
+
+    /**
+     * Saved form (.session-state.json)
+     */
+    toJSON() {
+        return {
+            activeDoc: this.activeId,
+            documents: Array.from(this.documents.values()).map(entry => ({
+                id: entry.id,
+                name: entry.name,
+                code: entry.doc.code
+            }))
+        };
+    }
+
+    /**
+     * Load a saved session
+     * @param {Object} saved - toJSON() output
+     */
+    restore(saved) {
+        if (!saved || !Array.isArray(saved.documents) || saved.documents.length === 0) return;
+        this.documents.clear();
+        this.activeId = null;
+        for (const { name, code } of saved.documents) {
+            this.create(name, code || '');
+        }
+        // Ids are re-issued; keep the same tab active by position
+        const index = saved.documents.findIndex(doc => doc.id === saved.activeDoc);
+        this.activeId = Array.from(this.documents.keys())[Math.max(0, index)];
+    }
+}
+
+module.exports = SessionDocuments;
@@ -0,0 +1,232 @@
+/**
+ * SessionRecorder - Records the lesson for replay
+ *
+ * Every room event the server fans out (code changes, tab switches,
+ * laser, highlights, PDF / Markdown state...) is appended to a
+ * RecordingLog. Every KEYFRAME_INTERVAL_MS the current segment is written
+ * and a new one starts with a keyframe: the board text plus the latest
+ * message of each "state" type (PDF page, mode, language...), so a replay
+ * can seek anywhere by reading a single segment.
+ *
+ * Large payloads (PDF data, Markdown files) are stored once as assets
+ * next to the log and referenced as { asset: hash }.
+ *
+ * Layout: recordings/<id>/lesson.cbr, recordings/<id>/assets/<sha1>
+ */
+
+const fs = require('fs');
+const path = require('path');
+const crypto = require('crypto');
+const RecordingLog = require('./RecordingLog.js');
+
+const KEYFRAME_INTERVAL_MS = 30000;
+
+// Last message of these types is part of every keyframe
+const STATE_TYPES = new Set([
+    'language_change', 'mode_change', 'breakpoints', 'scope',
+    'highlight_selection', 'highlight_tiles',
+    'pdf_load', 'pdf_sync', 'markdown_content', 'markdown_state'
+]);
+
+// type -> field stored as an asset
+const ASSET_FIELDS = {
+    pdf_load: 'pdfData',
+    markdown_content: 'content'
+};
+
+const LOG_FILE = 'lesson.cbr';
+
+class SessionRecorder {
+    /**
+     * @param {string} dir - Directory of all recordings
+     * @param {Function} snapshot - () => { code, version, docId, docName, language }
+     */
+    constructor(dir, snapshot) {
+        this.dir = dir;
+        this.snapshot = snapshot;
+        this.current = null; // { id, startedAt, file, records, segmentStart, timer }
+        this._state = new Map(); // state key -> latest message
+    }
+
+    get recording() {
+        return this.current !== null;
+    }
+
+    /**
+     * @returns {{ recording: boolean, id: string|null, startedAt: number|null }}
+     */
+    status() {
+        return {
+            recording: this.recording,
+            id: this.current ? this.current.id : null,
+            startedAt: this.current ? this.current.startedAt : null
+        };
+    }
+
+    start() {
+        if (this.current) return;
+        const startedAt = Date.now();
+        const id = String(startedAt);
+        const folder = path.join(this.dir, id);
+        fs.mkdirSync(path.join(folder, 'assets'), { recursive: true });
+
+        const file = path.join(folder, LOG_FILE);
+        RecordingLog.create(file);
+        this.current = { id, startedAt, file, folder, records: [], segmentStart: 0, timer: null };
+        this._state.clear();
+        this._beginSegment(0);
+        this.current.timer = setInterval(() => this._roll(), KEYFRAME_INTERVAL_MS);
+    }
+
+    stop() {
+        if (!this.current) return;
+        clearInterval(this.current.timer);
+        this._flush(this._now());
+        this.current = null;
+        this._state.clear();
+    }
+
+    /**
+     * Record a message the server sends to the room (ignored unless recording
+     * and of a recordable type)
+     * @param {Object} message
+     */
+    capture(message) {
+        if (!this.current || !RecordingLog.isRecordable(message.type) || message.type === 'keyframe') return;
+
+        let entry = message;
+        if (message.type === 'doc_activate') {
+            // Clients fetch the new tab's text; a replay has no server to ask
+            entry = { ...message, code: this.snapshot().code };
+        }
+        const field = ASSET_FIELDS[message.type];
+        if (field && typeof message[field] === 'string') {
+            entry = { ...entry, [field]: { asset: this._storeAsset(message[field]) } };
+        }
+
+        if (STATE_TYPES.has(entry.type)) {
+            // Latest message per type (and user); re-inserted so keyframes keep the order things happened
+            const key = entry.userId !== undefined ? `${entry.type}:${entry.userId}` : entry.type;
+            this._state.delete(key);
+            this._state.set(key, entry);
+        }
+        this.current.records.push({ t: this._now(), message: entry });
+    }
+
+    /**
+     * @returns {{ id: string, startedAt: number, duration: number, bytes: number }[]} Newest first
+     */
+    list() {
+        if (!fs.existsSync(this.dir)) return [];
+        return fs.readdirSync(this.dir)
+            .filter(id => /^\d+$/.test(id) && fs.existsSync(path.join(this.dir, id, LOG_FILE)))
+            .map(id => {
+                const file = path.join(this.dir, id, LOG_FILE);
+                const segments = RecordingLog.readIndex(file);
+                return {
+                    id,
+                    startedAt: Number(id),
+                    duration: segments.length > 0 ? segments[segments.length - 1].endMs : 0,
+                    bytes: fs.statSync(file).size
+                };
+            })
+            .sort((a, b) => b.startedAt - a.startedAt);
+    }
+
+    /**
+     * @param {string} id
+     * @returns {{ id: string, duration: number, segments: Object[] }|null}
+     */
+    index(id) {
+        const file = this._file(id);
+        if (!file) return null;
+        const segments = RecordingLog.readIndex(file);
+        return {
+            id,
+            duration: segments.length > 0 ? segments[segments.length - 1].endMs : 0,
+            segments: segments.map(({ startMs, endMs }) => ({ startMs, endMs }))
+        };
+    }
+
+    /**
+     * One segment, decoded, with the assets it references
+     * @param {string} id
+     * @param {number} n - Segment number
+     * @returns {Object|null} { startMs, endMs, records, assets }
+     */
+    segment(id, n) {
+        const file = this._file(id);
+        if (!file) return null;
+        const segment = RecordingLog.readIndex(file)[n];
+        if (!segment) return null;
+
+        const records = RecordingLog.readSegment(file, segment);
+        const assets = new Set();
+        const collect = (message) => {
+            const field = ASSET_FIELDS[message.type];
+            if (field && message[field] && message[field].asset) assets.add(message[field].asset);
+        };
+        for (const { message } of records) {
+            collect(message);
+            if (message.type === 'keyframe') message.state.forEach(collect);
+        }
+        return { startMs: segment.startMs, endMs: segment.endMs, records, assets: Array.from(assets) };
+    }
+
+    /**
+     * @param {string} id
+     * @param {string} hash
+     * @returns {string|null} Path of the asset file
+     */
+    assetPath(id, hash) {
+        if (!/^\d+$/.test(id) || !/^[0-9a-f]{40}$/.test(hash)) return null;
+        const file = path.join(this.dir, id, 'assets', hash);
+        return fs.existsSync(file) ? file : null;
+    }
+
+    _file(id) {
+        if (!/^\d+$/.test(String(id))) return null;
+        const file = path.join(this.dir, String(id), LOG_FILE);
+        return fs.existsSync(file) ? file : null;
+    }
+
+    _now() {
+        return Date.now() - this.current.startedAt;
+    }
+
+    _beginSegment(t) {
+        const snapshot = this.snapshot();
+        this.current.segmentStart = t;
+        this.current.records = [{
+            t,
+            message: { type: 'keyframe', ...snapshot, state: Array.from(this._state.values()) }
+        }];
+    }
+
+    // Write the segment and start the next one (an idle segment just grows)
+    _roll() {
+        if (this.current.records.length <= 1) return;
+        const t = this._now();
+        this._flush(t);
+        this._beginSegment(t);
+    }
+
+    _flush(endMs) {
+        const { file, records, segmentStart } = this.current;
+        RecordingLog.append(file, records, segmentStart, endMs);
+        this.current.records = [];
+    }
+
+    _storeAsset(text) {
+        const hash = crypto.createHash('sha1').update(text).digest('hex');
+        const file = path.join(this.current.folder, 'assets', hash);
+        if (!fs.existsSync(file)) {
+            fs.writeFileSync(file, text);
+        }
+        return hash;
+    }
+}
+
+SessionRecorder.KEYFRAME_INTERVAL_MS = KEYFRAME_INTERVAL_MS;
+
+module.exports = SessionRecorder;
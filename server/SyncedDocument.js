@@ -0,0 +1,118 @@
+/**
+ * SyncedDocument - One server-side document under delta sync
+ *
+ * Holds the authoritative text, its version and the recent changes, so
+ * code_ops made against an older version can be rebased (see
+ * src/core/TextOps.js). The class board and every student workspace are
+ * one SyncedDocument each.
+ */
+
+const TextOps = require('../src/core/TextOps.js');
+const LineDigest = require('../src/core/LineDigest.js');
+
+// Changes kept for rebasing late edits
+const HISTORY_LIMIT = 200;
+
+class SyncedDocument {
+    /**
+     * @param {string} [code='']
+     */
+    constructor(code = '') {
+        this.code = code;
+        this.version = 0;      // Bumped on every change
+        this.history = [];     // { version, ops } - ops === null marks a full replace
+        this.updatedBy = null; // Client id of the last change
+        this._digest = null;   // LineDigest of the current version (computed on demand)
+    }
+
+    /**
+     * Replace the whole text
+     * @param {string} code
+     * @param {*} [updatedBy]
+     * @returns {number} New version
+     */
+    replace(code, updatedBy = null) {
+        this.code = code;
+        this.updatedBy = updatedBy;
+        return this._record(null);
+    }
+
+    /**
+     * Apply ops made against baseVersion
+     * @param {Object[]} ops - Validated ops (TextOps.isValid)
+     * @param {number} baseVersion
+     * @param {*} [updatedBy]
+     * @returns {{ ops: Object[], version: number }|null} Rebased ops and new
+     *   version, or null when they can't be merged (the sender must resync)
+     */
+    applyOps(ops, baseVersion, updatedBy = null) {
+        const rebased = this.rebase(ops, baseVersion);
+        if (!rebased) return null;
+        this.code = TextOps.applyAll(this.code, rebased);
+        this.updatedBy = updatedBy;
+        return { ops: rebased, version: this._record(rebased) };
+    }
+
+    /**
+     * Rebase ops made against baseVersion onto the current text.
+     * Returns null when that is impossible (history gone or a full replace in between).
+     */
+    rebase(ops, baseVersion) {
+        if (baseVersion === this.version) return ops;
+        if (baseVersion > this.version) return null;
+
+        const oldest = this.history.length > 0 ? this.history[0].version : this.version + 1;
+        if (baseVersion + 1 < oldest) return null;
+
+        for (const entry of this.history) {
+            if (entry.version <= baseVersion) continue;
+            if (!entry.ops) return null;
+            ops = TextOps.transform(ops, entry.ops, false)[0];
+        }
+        return ops;
+    }
+
+    /**
+     * Every op applied after sinceVersion, in order (applyAll on the text
+     * at sinceVersion gives the current text).
+     * Returns null when the history no longer covers it or has a full replace.
+     */
+    changesSince(sinceVersion) {
+        if (sinceVersion === this.version) return [];
+        if (sinceVersion > this.version) return null;
+
+        const oldest = this.history.length > 0 ? this.history[0].version : this.version + 1;
+        if (sinceVersion + 1 < oldest) return null;
+
+        const ops = [];
+        for (const entry of this.history) {
+            if (entry.version <= sinceVersion) continue;
+            if (!entry.ops) return null;
+            ops.push(...entry.ops);
+        }
+        return ops;
+    }
+
+    /**
+     * Block hashes of the current text (see src/core/LineDigest.js),
+     * computed once per version
+     * @returns {{ version: number, lineCount: number, root: number, blocks: number[] }}
+     */
+    digest() {
+        if (!this._digest || this._digest.version !== this.version) {
+            this._digest = { version: this.version, ...LineDigest.compute(this.code) };
+        }
+        return this._digest;
+    }
+
+    _record(ops) {
+        this.version++;
+        this.history.push({ version: this.version, ops });
+        if (this.history.length > HISTORY_LIMIT) {
+            this.history.shift();
+        }
+        return this.version;
+    }
+}
+
+module.exports = SyncedDocument;
@@ -0,0 +1,249 @@
+/**
+ * SyntaxChecker - Live compiler diagnostics for the C++ documents
+ *
+ * After an edit, a document is checked with `g++ -fsyntax-only` once
+ * typing pauses for DEBOUNCE_MS. Only the latest check of a document
+ * survives: an edit cancels the pending timer and kills a check that is
+ * still compiling the older text, so fast typing never piles up compiler
+ * processes. At most MAX_CHECKING run at once (a short FIFO of documents
+ * waits for a slot; each reads its text when it starts, so it is always
+ * the newest).
+ *
+ * The check uses the runner's flags and shared headers, and the
+ * precompiled prelude a run of this text would use, if one exists (it
+ * holds only the headers the text includes itself, so the check reports
+ * what a run would). The results are cached by a hash of the text, so
+ * undoing back to a checked version or reopening a tab costs nothing.
+ *
+ * Diagnostics are { row, col, severity: 'error'|'warning', message } with
+ * 0-based row and col in characters (g++ reports bytes).
+ */
+
+const crypto = require('crypto');
+const { spawn } = require('child_process');
+const CppRunner = require('./CppRunner.js');
+
+const DEBOUNCE_MS = 400;
+const MAX_CHECKING = 2;
+const CHECK_TIMEOUT_MS = 10000;
+const MAX_CACHED = 200;
+const MAX_DIAGNOSTICS = 50;
+const MESSAGE_CHARS = 300;
+
+const CHECK_FLAGS = [
+    '-fsyntax-only',
+    '-fdiagnostics-column-unit=byte',
+    '-fno-diagnostics-show-caret',
+    '-fno-diagnostics-show-option'
+];
+
+// "<stdin>:12:5: error: expected ';' before 'return'"
+const DIAGNOSTIC_LINE = /^<stdin>:(\d+):(\d+): (fatal error|error|warning): (.*)$/;
+
+/**
+ * Diagnostics in the source itself (not in headers; notes are skipped)
+ * @param {string} output - g++ stderr
+ * @param {string} code - The checked source, to turn byte columns into characters
+ * @returns {Object[]}
+ */
+function parseDiagnostics(output, code) {
+    const lines = code.split('\n');
+    const diagnostics = [];
+    for (const line of output.split('\n')) {
+        const match = line.match(DIAGNOSTIC_LINE);
+        if (!match) continue;
+        const row = Number(match[1]) - 1;
+        const bytes = Buffer.from(lines[row] || '', 'utf8').subarray(0, Number(match[2]) - 1);
+        diagnostics.push({
+            row,
+            col: bytes.toString('utf8').length,
+            severity: match[3] === 'warning' ? 'warning' : 'error',
+            message: match[4].slice(0, MESSAGE_CHARS)
+        });
+        if (diagnostics.length === MAX_DIAGNOSTICS) break;
+    }
+    return diagnostics;
+}
+
+class SyntaxChecker {
+    /**
+     * @param {CppRunner} runner - Source of the compiler arguments
+     */
+    constructor(runner) {
+        this.runner = runner;
+        this.checking = 0;
+        this._documents = new Map(); // key -> { doc, onResult, timer, child, waiting }
+        this._waiting = [];          // Keys waiting for a slot
+        this._cache = new Map();     // text hash -> diagnostics, oldest first
+        this._latest = new Map();    // key -> { version, diagnostics } of the last check
+    }
+
+    /**
+     * Check a document once its edits pause; replaces any earlier check of it
+     * @param {string} key - Identifies the document
+     * @param {SyncedDocument} doc - Read when the check starts
+     * @param {Function} onResult - Called with { version, diagnostics }
+     */
+    schedule(key, doc, onResult) {
+        const entry = this._cancel(key);
+        entry.doc = doc;
+        entry.onResult = onResult;
+        entry.timer = setTimeout(() => {
+            entry.timer = null;
+            this._enqueue(key);
+        }, DEBOUNCE_MS);
+        this._documents.set(key, entry);
+    }
+
+    /**
+     * Check now, without waiting for a pause (tab switched, language changed)
+     */
+    checkNow(key, doc, onResult) {
+        const entry = this._cancel(key);
+        Object.assign(entry, { doc, onResult });
+        this._documents.set(key, entry);
+        this._enqueue(key);
+    }
+
+    /**
+     * Forget a document (closed, or the language is no longer C++)
+     * @param {string} key
+     */
+    cancel(key) {
+        this._cancel(key);
+        this._documents.delete(key);
+        this._latest.delete(key);
+    }
+
+    /**
+     * The last result for a document, if it still matches its version
+     * @returns {{ version: number, diagnostics: Object[] }|null}
+     */
+    latest(key, doc) {
+        const result = this._latest.get(key);
+        return result && result.version === doc.version ? result : null;
+    }
+
+    // Stop the timer and any running check of key; returns its (reusable) entry
+    _cancel(key) {
+        const entry = this._documents.get(key) || { doc: null, onResult: null, timer: null, child: null, waiting: false };
+        clearTimeout(entry.timer);
+        entry.timer = null;
+        entry.waiting = false; // Its stale place in the queue is skipped
+        if (entry.child) {
+            entry.child.cancelled = true;
+            entry.child.kill('SIGKILL');
+            entry.child = null;
+        }
+        return entry;
+    }
+
+    _enqueue(key) {
+        const entry = this._documents.get(key);
+        if (!entry) return;
+        if (this._tooLarge(key, entry)) return;
+        const hash = this._hash(entry.doc.code);
+        if (this._cache.has(hash)) {
+            this._deliver(key, entry, entry.doc.version, this._cache.get(hash));
+            return;
+        }
+        if (!entry.waiting) {
+            entry.waiting = true;
+            this._waiting.push(key);
+        }
+        this._pump();
+    }
+
+    _pump() {
+        while (this.checking < MAX_CHECKING && this._waiting.length > 0) {
+            const key = this._waiting.shift();
+            const entry = this._documents.get(key);
+            if (!entry || !entry.waiting) continue;
+            entry.waiting = false;
+            this._check(key, entry);
+        }
+    }
+
+    _check(key, entry) {
+        const code = entry.doc.code;
+        const version = entry.doc.version;
+        if (this._tooLarge(key, entry)) return;
+        const hash = this._hash(code);
+
+        let args;
+        try {
+            args = [...this.runner.compilerArgs(undefined, code, false), ...CHECK_FLAGS, '-x', 'c++', '-'];
+        } catch (error) {
+            console.error('❌ SyntaxChecker:', error.message);
+            return;
+        }
+
+        this.checking++;
+        const child = spawn(CppRunner.COMPILER, args, { stdio: ['pipe', 'ignore', 'pipe'] });
+        entry.child = child;
+        let stderr = '';
+        child.stderr.on('data', chunk => {
+            if (stderr.length < 64 * 1024) stderr += chunk;
+        });
+        child.stdin.on('error', () => {}); // Killed before it read everything
+        child.stdin.end(code);
+        const timer = setTimeout(() => child.kill('SIGKILL'), CHECK_TIMEOUT_MS);
+
+        let done = false;
+        const finish = (exitCode) => {
+            if (done) return;
+            done = true;
+            clearTimeout(timer);
+            this.checking--;
+            if (entry.child === child) entry.child = null;
+            if (!child.cancelled && exitCode !== null) {
+                const diagnostics = parseDiagnostics(stderr, code);
+                this._remember(hash, diagnostics);
+                this._deliver(key, entry, version, diagnostics);
+            }
+            this._pump();
+        };
+        child.on('error', (error) => {
+            console.error('❌ SyntaxChecker:', error.message);
+            finish(null);
+        });
+        child.on('close', finish);
+    }
+
+    // The runner refuses such a source, so say so instead of checking a cut-off copy
+    _tooLarge(key, entry) {
+        if (Buffer.byteLength(entry.doc.code, 'utf8') <= CppRunner.MAX_SOURCE_BYTES) return false;
+        this._deliver(key, entry, entry.doc.version, [{
+            row: 0,
+            col: 0,
+            severity: 'error',
+            message: `The program is larger than ${CppRunner.MAX_SOURCE_BYTES / 1024} KB and is not checked.`
+        }]);
+        return true;
+    }
+
+    _deliver(key, entry, version, diagnostics) {
+        const result = { version, diagnostics };
+        this._latest.set(key, result);
+        entry.onResult(result);
+    }
+
+    _remember(hash, diagnostics) {
+        this._cache.delete(hash);
+        this._cache.set(hash, diagnostics);
+        if (this._cache.size > MAX_CACHED) {
+            this._cache.delete(this._cache.keys().next().value);
+        }
+    }
+
+    _hash(code) {
+        return crypto.createHash('sha1')
+            .update(JSON.stringify([CppRunner.COMPILE_FLAGS, this.runner.includeStamp(), code]))
+            .digest('hex');
+    }
+}
+
+SyntaxChecker.parseDiagnostics = parseDiagnostics;
+SyntaxChecker.DEBOUNCE_MS = DEBOUNCE_MS;
+
+module.exports = SyntaxChecker;
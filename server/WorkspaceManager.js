@@ -0,0 +1,179 @@
+/**
+ * WorkspaceManager - Private per-student documents for exercises
+ *
+ * While workspace mode is on, every student edits their own copy of the
+ * board (a SyncedDocument seeded with the board's code at the moment the
+ * teacher turned the mode on). The teacher sees the class through:
+ * - summaries: a viewport-sized excerpt around each student's cursor,
+ *   sent at most once per tick and only for workspaces that changed,
+ *   under a fixed byte budget per tick - so the overview costs the same
+ *   bandwidth for 10 or 100 students, large classes just refresh slower
+ * - watching: the full document and its live code_ops, for the one
+ *   student the teacher has opened
+ *
+ * Workspaces live in memory only; the board is what .session-state.json keeps.
+ */
+
+const SyncedDocument = require('./SyncedDocument.js');
+
+// Excerpt shown per student in the teacher's overview
+const SUMMARY_LINES = 12;
+const SUMMARY_COLUMNS = 60;
+
+// Overview traffic: one batch per tick, at most this many bytes of summaries
+const SUMMARY_INTERVAL_MS = 1000;
+const SUMMARY_BUDGET_BYTES = 8 * 1024;
+
+class WorkspaceManager {
+    constructor() {
+        this.enabled = false;
+        this.seedCode = '';
+        this.workspaces = new Map(); // studentId -> workspace (see _create)
+    }
+
+    /**
+     * Turn workspace mode on: students start from a copy of the board
+     * @param {string} seedCode - Board code at this moment
+     */
+    enable(seedCode) {
+        this.enabled = true;
+        this.seedCode = seedCode;
+        this.workspaces.clear();
+    }
+
+    /**
+     * Turn workspace mode off and drop every workspace
+     */
+    disable() {
+        this.enabled = false;
+        this.seedCode = '';
+        this.workspaces.clear();
+    }
+
+    /**
+     * A student's workspace, created from the seed on first use
+     * @param {string|number} studentId
+     * @param {string} name
+     * @returns {Object}
+     */
+    get(studentId, name) {
+        const id = String(studentId);
+        let workspace = this.workspaces.get(id);
+        if (!workspace) {
+            workspace = this._create(id, name);
+            this.workspaces.set(id, workspace);
+        }
+        return workspace;
+    }
+
+    /**
+     * @param {string|number} studentId
+     * @returns {Object|undefined}
+     */
+    find(studentId) {
+        return this.workspaces.get(String(studentId));
+    }
+
+    /**
+     * Note a change for the next summaries
+     * @param {Object} workspace
+     * @param {number} [cursorRow] - 1-based row of the student's cursor
+     */
+    touch(workspace, cursorRow) {
+        this.moveCursor(workspace, cursorRow);
+        workspace.dirty = true;
+    }
+
+    /**
+     * Follow the student's cursor: the next summary is centered on it
+     * (a cursor move alone does not send a summary)
+     * @param {Object} workspace
+     * @param {number} cursorRow - 1-based
+     */
+    moveCursor(workspace, cursorRow) {
+        if (Number.isInteger(cursorRow) && cursorRow > 0) {
+            workspace.cursorRow = cursorRow - 1;
+        }
+    }
+
+    /**
+     * Stop sending live changes to a teacher socket (closed, or opened another student)
+     * @param {WebSocket} ws
+     */
+    unwatch(ws) {
+        for (const workspace of this.workspaces.values()) {
+            workspace.watchers.delete(ws);
+        }
+    }
+
+    /**
+     * Summaries of changed workspaces for this tick, longest-waiting first,
+     * within the byte budget (always at least one, so nothing starves)
+     * @param {number} [budget=SUMMARY_BUDGET_BYTES]
+     * @returns {Object[]}
+     */
+    takeSummaries(budget = SUMMARY_BUDGET_BYTES) {
+        const dirty = Array.from(this.workspaces.values())
+            .filter(workspace => workspace.dirty)
+            .sort((a, b) => a.summarySentAt - b.summarySentAt);
+
+        const summaries = [];
+        let bytes = 0;
+        const now = Date.now();
+        for (const workspace of dirty) {
+            const summary = WorkspaceManager.summarize(workspace);
+            const size = JSON.stringify(summary).length;
+            if (summaries.length > 0 && bytes + size > budget) break;
+            summaries.push(summary);
+            bytes += size;
+            workspace.dirty = false;
+            workspace.summarySentAt = now;
+        }
+        return summaries;
+    }
+
+    /**
+     * Mark every workspace for the next summaries (a teacher just connected)
+     */
+    touchAll() {
+        for (const workspace of this.workspaces.values()) {
+            workspace.dirty = true;
+        }
+    }
+
+    _create(id, name) {
+        return {
+            studentId: id,
+            name,
+            doc: new SyncedDocument(this.seedCode),
+            cursorRow: 0,
+            dirty: true,
+            summarySentAt: 0,
+            watchers: new Set() // Teacher sockets receiving the full document
+        };
+    }
+
+    /**
+     * Excerpt of a workspace: SUMMARY_LINES lines around the cursor,
+     * each cut at SUMMARY_COLUMNS
+     * @param {Object} workspace
+     * @returns {{ studentId, name, version, lineCount, firstLine, lines: string[] }}
+     */
+    static summarize(workspace) {
+        const allLines = workspace.doc.code.split('\n');
+        const maxFirst = Math.max(0, allLines.length - SUMMARY_LINES);
+        const firstLine = Math.min(maxFirst, Math.max(0, workspace.cursorRow - Math.floor(SUMMARY_LINES / 2)));
+        return {
+            studentId: workspace.studentId,
+            name: workspace.name,
+            version: workspace.doc.version,
+            lineCount: allLines.length,
+            firstLine,
+            lines: allLines.slice(firstLine, firstLine + SUMMARY_LINES).map(line => line.slice(0, SUMMARY_COLUMNS))
+        };
+    }
+}
+
+WorkspaceManager.SUMMARY_INTERVAL_MS = SUMMARY_INTERVAL_MS;
+
+module.exports = WorkspaceManager;
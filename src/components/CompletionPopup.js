@@ -0,0 +1,148 @@
+/**
+ * CompletionPopup - Autocomplete dropdown for GridEditor
+ *
+ * Shows the suggestions for the word in front of the cursor: the
+ * document's identifiers and the language's snippets and keywords, ranked
+ * in the worker (see core/CompletionTrie.js). update() is called on every
+ * keystroke; only the answer to the latest request is shown, so a slow
+ * reply never flashes stale items.
+ *
+ * Keys while open: ↑/↓ choose, Enter/Tab accept, Esc close.
+ */
+
+class CompletionPopup {
+    /**
+     * @param {GridEditor} editor
+     * @param {Object} [options]
+     * @param {number} [options.maxItems=8]
+     */
+    constructor(editor, options = {}) {
+        this.editor = editor;
+        this.maxItems = options.maxItems || 8;
+
+        this.items = [];
+        this.selected = 0;
+        this.prefix = '';
+        this.isOpen = false;
+        this._request = 0; // Id of the latest completion query
+
+        this.element = document.createElement('div');
+        this.element.className = 'grid-editor-completions';
+        this.element.style.display = 'none';
+
+        // mousedown keeps the focus in the editor's hidden input
+        this.element.addEventListener('mousedown', (e) => {
+            e.preventDefault();
+            e.stopPropagation();
+            const el = e.target.closest('.completion-item');
+            if (el) this._accept(parseInt(el.dataset.index, 10));
+        });
+    }
+
+    /**
+     * Re-query for the word before the cursor (closes if there is none)
+     */
+    update() {
+        const prefix = this._wordBeforeCursor();
+        if (!prefix || this.editor.isReadOnly()) {
+            this.close();
+            return;
+        }
+
+        const request = ++this._request;
+        const { row, col } = this.editor.getCursor();
+        this.editor.getCompletions(prefix, this.maxItems).then(items => {
+            const cursor = this.editor.getCursor();
+            if (request !== this._request || cursor.row !== row || cursor.col !== col) return;
+            if (!items || items.length === 0) {
+                this.close();
+                return;
+            }
+            this.prefix = prefix;
+            this.items = items;
+            this.selected = 0;
+            this._render();
+        });
+    }
+
+    /**
+     * Hide the list and drop any pending reply
+     */
+    close() {
+        this._request++;
+        if (!this.isOpen) return;
+        this.isOpen = false;
+        this.items = [];
+        this.element.style.display = 'none';
+    }
+
+    /**
+     * Keyboard handling while the list is open
+     * @param {KeyboardEvent} e
+     * @returns {boolean} true if the key was used
+     */
+    handleKeyDown(e) {
+        if (!this.isOpen) return false;
+
+        if (e.key === 'ArrowDown' || e.key === 'ArrowUp') {
+            const step = e.key === 'ArrowDown' ? 1 : -1;
+            this.selected = (this.selected + step + this.items.length) % this.items.length;
+            this._updateSelection();
+        } else if (e.key === 'Enter' || e.key === 'Tab') {
+            this._accept(this.selected);
+        } else if (e.key === 'Escape') {
+            this.close();
+        } else {
+            return false;
+        }
+        e.preventDefault();
+        return true;
+    }
+
+    _wordBeforeCursor() {
+        const { row, col } = this.editor.getCursor();
+        const match = /[\p{L}_][\p{L}\p{N}_]*$/u.exec(this.editor.getLine(row).slice(0, col));
+        return match ? match[0] : '';
+    }
+
+    _accept(index) {
+        const item = this.items[index];
+        const prefix = this.prefix;
+        this.close();
+        if (item) this.editor.acceptCompletion(item, prefix);
+    }
+
+    _render() {
+        const rows = this.items.map((item, i) => {
+            const el = document.createElement('div');
+            el.className = `completion-item ${item.kind}`;
+            el.dataset.index = i;
+            el.title = item.desc || '';
+            el.textContent = item.text;
+            return el;
+        });
+        this.element.replaceChildren(...rows);
+        this._updateSelection();
+
+        // Under the start of the word
+        const padding = 15;
+        const { row, col } = this.editor.getCursor();
+        this.element.style.left = `${(col - this.prefix.length) * this.editor.charWidth + padding}px`;
+        this.element.style.top = `${(row + 1) * this.editor.charHeight + padding}px`;
+        this.element.style.display = 'block';
+        this.isOpen = true;
+    }
+
+    _updateSelection() {
+        Array.from(this.element.children).forEach((el, i) => {
+            el.classList.toggle('selected', i === this.selected);
+        });
+        const current = this.element.children[this.selected];
+        if (current && current.scrollIntoView) current.scrollIntoView({ block: 'nearest' });
+    }
+}
+
+// Export for use
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = CompletionPopup;
+}
@@ -0,0 +1,278 @@
+/**
+ * ComplexityPanel Component
+ * Live plot of the complexity lab's benchmarks (every board)
+ *
+ * The teacher benchmarks the algorithm on the board; the server
+ * (server/ComplexityLab.js) measures it over growing input sizes and
+ * streams each point to everyone. The plot shows time per call against
+ * n - log-log by default, where O(n²) and O(n log n) are straight lines
+ * of different slope - and the legend the growth curve that fits best.
+ *
+ * Dependencies:
+ * - Collaboration (startBenchmark / clearBenchmarks)
+ * - LanguageManager (current language)
+ * - UIManager (escapeHtml)
+ */
+
+const ComplexityPanel = {
+    series: [],            // { id, label, kind, status, points, fit, error }, in order
+    logScale: true,
+    _frame: null,
+
+    PALETTE: ['--accent-blue', '--accent-orange', '--accent-green', '--accent-purple', '--accent-yellow', '--accent-red'],
+    MARGIN: { left: 56, right: 12, top: 10, bottom: 30 },
+
+    /**
+     * Initialize complexity panel
+     */
+    init() {
+        const bind = (id, handler) => {
+            const el = document.getElementById(id);
+            if (el) el.addEventListener('click', handler);
+        };
+        bind('bench-btn', () => this._start());
+        bind('bench-baseline-btn', () => this._start('std::sort'));
+        bind('bench-clear-btn', () => {
+            if (typeof Collaboration !== 'undefined') Collaboration.clearBenchmarks();
+        });
+        bind('bench-scale-btn', () => {
+            this.logScale = !this.logScale;
+            document.getElementById('bench-scale-btn').textContent = this.logScale ? 'log' : 'linear';
+            this._redraw();
+        });
+        bind('bench-close-btn', () => this.hide());
+
+        window.addEventListener('resize', () => this._redraw());
+        window.addEventListener('languageChanged', () => this._updateButton());
+        this._updateButton();
+        console.log('📈 Complexity Panel initialized');
+    },
+
+    show() {
+        const panel = document.getElementById('complexity-panel');
+        if (panel) panel.style.display = 'flex';
+        this._redraw();
+    },
+
+    hide() {
+        const panel = document.getElementById('complexity-panel');
+        if (panel) panel.style.display = 'none';
+    },
+
+    /**
+     * bench_* messages from the server
+     * @param {Object} message
+     */
+    handleMessage(message) {
+        switch (message.type) {
+            case 'bench_state':
+                // Joined while results are up
+                this.series = message.series;
+                if (this.series.length > 0) this.show();
+                break;
+
+            case 'bench_series':
+                this.series = this.series.filter(s => s.label !== message.series.label);
+                this.series.push(message.series);
+                this.show();
+                break;
+
+            case 'bench_point': {
+                const series = this.series.find(s => s.id === message.seriesId);
+                if (series) series.points.push(message.point);
+                break;
+            }
+
+            case 'bench_done': {
+                const series = this.series.find(s => s.id === message.seriesId);
+                if (series) Object.assign(series, { status: message.status, fit: message.fit, error: message.error });
+                break;
+            }
+
+            case 'bench_clear':
+                this.series = [];
+                break;
+
+            case 'bench_error':
+                showToast(`⚠️ ${message.error}`, 'warning');
+                return;
+        }
+        this._setStatus();
+        this._renderLegend();
+        this._redraw();
+    },
+
+    _start(baseline) {
+        if (typeof Collaboration === 'undefined' || !Collaboration.connected) {
+            showToast('⚠️ Not connected to the server', 'warning');
+            return;
+        }
+        this.show();
+        Collaboration.startBenchmark(baseline);
+    },
+
+    _setStatus() {
+        const status = document.getElementById('bench-status');
+        if (!status) return;
+        const running = this.series.find(s => s.status === 'running');
+        status.textContent = running ? `⏳ Measuring ${running.label}… (n = ${running.points.length ? running.points[running.points.length - 1].n : '…'})` : '';
+    },
+
+    _renderLegend() {
+        const legend = document.getElementById('bench-legend');
+        if (!legend) return;
+        legend.innerHTML = this.series.map((series, i) => {
+            const last = series.points[series.points.length - 1];
+            let detail;
+            if (series.error) {
+                detail = `❌ ${escapeHtml(series.error.split('\n')[0])}`;
+            } else if (series.fit) {
+                detail = `<strong>${escapeHtml(series.fit.model)}</strong>` +
+                    (series.fit.base ? ` · ×${series.fit.base} per n` : ` · slope ${series.fit.slope}`);
+            } else {
+                detail = series.status === 'running' ? 'measuring…' : 'too few points to fit';
+            }
+            const stats = last
+                ? ` · n = ${last.n.toLocaleString()}: ${this._formatMs(last.wallMs)} (CPU ${this._formatMs(last.cpuMs)}), ${(last.peakRssKb / 1024).toFixed(1)} MB`
+                : '';
+            return `
+                <div class="bench-legend-item">
+                    <span class="bench-legend-color" style="background: ${this._color(i)}"></span>
+                    <span class="bench-legend-label">${escapeHtml(series.label)}</span>
+                    <span class="bench-legend-detail">${detail}${stats}</span>
+                </div>
+            `;
+        }).join('');
+    },
+
+    _redraw() {
+        if (this._frame) return;
+        this._frame = requestAnimationFrame(() => {
+            this._frame = null;
+            this._draw();
+        });
+    },
+
+    _draw() {
+        const canvas = document.getElementById('bench-canvas');
+        if (!canvas || canvas.offsetParent === null) return;
+
+        const ratio = window.devicePixelRatio || 1;
+        const width = canvas.clientWidth;
+        const height = canvas.clientHeight;
+        canvas.width = width * ratio;
+        canvas.height = height * ratio;
+        const ctx = canvas.getContext('2d');
+        ctx.setTransform(ratio, 0, 0, ratio, 0, 0);
+        ctx.clearRect(0, 0, width, height);
+
+        const points = this.series.flatMap(s => s.points).filter(p => p.wallMs > 0);
+        const style = getComputedStyle(document.body);
+        ctx.font = '11px sans-serif';
+        ctx.fillStyle = style.getPropertyValue('--text-muted');
+        if (points.length === 0) {
+            ctx.fillText('Benchmark a sort, search or recursive function to see how it scales', this.MARGIN.left, height / 2);
+            return;
+        }
+
+        // Axes: n and ms per call, scaled to the data
+        const x = this._axis(points.map(p => p.n), this.MARGIN.left, width - this.MARGIN.right);
+        const y = this._axis(points.map(p => p.wallMs), height - this.MARGIN.bottom, this.MARGIN.top);
+
+        ctx.strokeStyle = style.getPropertyValue('--border-color');
+        ctx.lineWidth = 1;
+        ctx.textAlign = 'center';
+        x.ticks.forEach(tick => {
+            const px = x.map(tick);
+            ctx.beginPath();
+            ctx.moveTo(px, this.MARGIN.top);
+            ctx.lineTo(px, height - this.MARGIN.bottom);
+            ctx.stroke();
+            ctx.fillText(this._formatCount(tick), px, height - this.MARGIN.bottom + 14);
+        });
+        ctx.textAlign = 'right';
+        y.ticks.forEach(tick => {
+            const py = y.map(tick);
+            ctx.beginPath();
+            ctx.moveTo(this.MARGIN.left, py);
+            ctx.lineTo(width - this.MARGIN.right, py);
+            ctx.stroke();
+            ctx.fillText(this._formatMs(tick), this.MARGIN.left - 6, py + 4);
+        });
+        ctx.textAlign = 'center';
+        ctx.fillText('n', width - this.MARGIN.right - 6, height - 4);
+
+        this.series.forEach((series, i) => {
+            const visible = series.points.filter(p => p.wallMs > 0);
+            ctx.strokeStyle = this._color(i);
+            ctx.fillStyle = this._color(i);
+            ctx.lineWidth = 2;
+            ctx.beginPath();
+            visible.forEach((p, j) => {
+                if (j === 0) ctx.moveTo(x.map(p.n), y.map(p.wallMs));
+                else ctx.lineTo(x.map(p.n), y.map(p.wallMs));
+            });
+            ctx.stroke();
+            visible.forEach(p => {
+                ctx.beginPath();
+                ctx.arc(x.map(p.n), y.map(p.wallMs), 3, 0, 2 * Math.PI);
+                ctx.fill();
+            });
+        });
+    },
+
+    // Scale from values to pixels, log10 or linear, with round tick values
+    _axis(values, from, to) {
+        let min = Math.min(...values);
+        let max = Math.max(...values);
+        if (this.logScale) {
+            const lo = Math.floor(Math.log10(min));
+            const hi = Math.max(lo + 1, Math.ceil(Math.log10(max)));
+            const ticks = [];
+            for (let e = lo; e <= hi; e++) ticks.push(10 ** e);
+            return {
+                ticks,
+                map: v => from + (Math.log10(v) - lo) / (hi - lo) * (to - from)
+            };
+        }
+        min = 0;
+        const step = 10 ** Math.floor(Math.log10(max / 4 || 1));
+        const niceStep = [1, 2, 5, 10].map(k => k * step).find(s => max / s <= 6);
+        max = Math.ceil(max / niceStep) * niceStep;
+        const ticks = [];
+        for (let t = 0; t <= max + niceStep / 2; t += niceStep) ticks.push(t);
+        return {
+            ticks,
+            map: v => from + (v - min) / (max - min || 1) * (to - from)
+        };
+    },
+
+    _color(index) {
+        const name = this.PALETTE[index % this.PALETTE.length];
+        return getComputedStyle(document.body).getPropertyValue(name).trim() || '#569cd6';
+    },
+
+    _formatMs(ms) {
+        if (ms >= 1000) return `${(ms / 1000).toPrecision(3)} s`;
+        if (ms >= 1) return `${ms.toPrecision(3)} ms`;
+        if (ms >= 0.001) return `${(ms * 1000).toPrecision(3)} µs`;
+        return `${(ms * 1e6).toPrecision(3)} ns`;
+    },
+
+    _formatCount(n) {
+        if (n >= 1e6) return `${n / 1e6}M`;
+        if (n >= 1e3) return `${n / 1e3}k`;
+        return String(n);
+    },
+
+    _updateButton() {
+        const button = document.getElementById('bench-btn');
+        if (!button || typeof LanguageManager === 'undefined') return;
+        button.style.display = LanguageManager.getCurrentLanguage() === 'cpp' ? '' : 'none';
+    }
+};
+
+// Export for module systems if available
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = ComplexityPanel;
+}
@@ -0,0 +1,75 @@
+/**
+ * DocumentTabs Component
+ * Tab bar of the board's documents
+ *
+ * The teacher opens templates, exercises and files as tabs and switches
+ * the class between them; students see which tab the board is on.
+ * Rendering only - the documents themselves are synced by Collaboration
+ * (active tab live, the others fetched on demand and cached).
+ *
+ * Dependencies:
+ * - UIManager (escapeHtml)
+ * - Collaboration (activate / close / open)
+ */
+
+const DocumentTabs = {
+    _bound: false,
+
+    /**
+     * Draw the tabs
+     * @param {Object[]} documents - [{ id, name, version }]
+     * @param {string|null} activeId
+     * @param {boolean} isTeacher - Teachers can switch, close and add tabs
+     */
+    render(documents, activeId, isTeacher) {
+        const bar = document.getElementById('document-tabs');
+        if (!bar) return;
+        this._bind(bar);
+
+        // A single document needs no tab bar for students
+        bar.style.display = (isTeacher || documents.length > 1) ? 'flex' : 'none';
+        bar.classList.toggle('read-only', !isTeacher);
+
+        const tabs = documents.map(doc => {
+            const active = doc.id === activeId ? ' active' : '';
+            const close = isTeacher && documents.length > 1
+                ? '<span class="document-tab-close" title="Close">×</span>'
+                : '';
+            return `<div class="document-tab${active}" data-doc-id="${escapeHtml(doc.id)}" title="${escapeHtml(doc.name)}">` +
+                `<span class="document-tab-name">${escapeHtml(doc.name)}</span>${close}</div>`;
+        });
+        if (isTeacher) {
+            tabs.push('<div class="document-tab-new" title="New tab">+</div>');
+        }
+        bar.innerHTML = tabs.join('');
+    },
+
+    /**
+     * One delegated listener for every tab
+     */
+    _bind(bar) {
+        if (this._bound) return;
+        this._bound = true;
+
+        bar.addEventListener('click', (e) => {
+            if (typeof Collaboration === 'undefined' || Collaboration.myRole !== 'teacher') return;
+
+            if (e.target.closest('.document-tab-new')) {
+                Collaboration.openDocument('', `untitled-${Collaboration.documents.length + 1}`);
+                return;
+            }
+            const tab = e.target.closest('[data-doc-id]');
+            if (!tab) return;
+            if (e.target.closest('.document-tab-close')) {
+                Collaboration.closeDocument(tab.dataset.docId);
+            } else {
+                Collaboration.activateDocument(tab.dataset.docId);
+            }
+        });
+    }
+};
+
+// Export for module systems if available
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = DocumentTabs;
+}
@@ -4,12 +4,14 @@
  * 
  * Dependencies:
  * - UIManager (for showToast)
+ * - VirtualList (file list rendering)
  * - Collaboration (for sync when loading files)
  */
 
 const FileBrowser = {
     currentPath: '',
     rootPath: '',
+    _fileList: null, // VirtualList over #file-list (created on first render)
     
     /**
      * Initialize file browser
@@ -206,36 +208,32 @@ const FileBrowser = {
     },
     
     /**
-     * Render file list
+     * Render file list (virtualized: only visible items are in the DOM)
      */
     renderFileList(items) {
         const fileList = document.getElementById('file-list');
         
-        if (!items || items.length === 0) {
-            fileList.innerHTML = '<div class="file-empty">Empty folder</div>';
-            return;
-        }
-        
-        fileList.innerHTML = items.map(item => `
-            <div class="file-item ${item.type}" data-path="${item.path}" data-type="${item.type}">
-                <span class="file-icon">${this.getFileIcon(item.name, item.type)}</span>
-                <span class="file-name">${item.name.replace(/\.(gls|glo|py|cpp|h|md|pdf)$/, '')}</span>
-            </div>
-        `).join('');
-        
-        // Add click handlers
-        fileList.querySelectorAll('.file-item').forEach(item => {
-            item.addEventListener('click', () => {
-                const path = item.dataset.path;
-                const type = item.dataset.type;
-                
-                if (type === 'folder') {
-                    this.loadFolder(path);
-                } else {
-                    this.loadFile(path);
+        if (!this._fileList) {
+            this._fileList = new VirtualList(fileList, {
+                key: item => item.path,
+                empty: '<div class="file-empty">Empty folder</div>',
+                render: item => `
+                    <div class="file-item ${item.type}" data-path="${item.path}" data-type="${item.type}">
+                        <span class="file-icon">${this.getFileIcon(item.name, item.type)}</span>
+                        <span class="file-name">${item.name.replace(/\.(gls|glo|py|cpp|h|md|pdf)$/, '')}</span>
+                    </div>
+                `,
+                onClick: item => {
+                    if (item.type === 'folder') {
+                        this.loadFolder(item.path);
+                    } else {
+                        this.loadFile(item.path);
+                    }
                 }
             });
-        });
+        }
+        
+        this._fileList.setItems(items || []);
     },
     
     /**
@@ -353,6 +351,9 @@ const FileBrowser = {
                 }
             }
             
+            // Teacher: the file opens in a new tab (see Collaboration.openDocument)
+            const openedAsTab = typeof Collaboration !== 'undefined' && Collaboration.openDocument(data.content, `📄 ${data.name}`);
+            
             // Update editor (GridEditor or legacy)
             if (gridEditor) {
                 gridEditor.setValue(data.content);
@@ -364,7 +365,7 @@ const FileBrowser = {
             }
             
             // Sync with collaboration
-            if (typeof Collaboration !== 'undefined' && Collaboration.connected) {
+            if (!openedAsTab && typeof Collaboration !== 'undefined' && Collaboration.connected) {
                 Collaboration.sendTemplateLoaded(data.content, `📄 ${data.name}`);
             }
             
@@ -15,14 +15,33 @@ class GridEditor {
         };
         
         // Editor state
-        this.lines = ['']; // Array of strings, one per line
+        this.buffer = new TextBuffer(''); // Line-indexed document (see core/TextBuffer.js)
+        // Highlighting, bracket matching and word indexing run in a worker when possible
+        this.analysis = typeof EditorWorkerClient !== 'undefined'
+            ? EditorWorkerClient.create(this.buffer)
+            : null;
+        this.highlightCache = !this.analysis && typeof HighlightCache !== 'undefined'
+            ? new HighlightCache(this.buffer) // Re-tokenizes only edited lines
+            : null;
+        this.blockIndex = typeof BlockIndex !== 'undefined'
+            ? new BlockIndex(this.buffer) // Block openers by row, for SmartInserter
+            : null;
+        this.bracketMatch = null; // { open, close } pair at the cursor (from the worker)
+        this.scope = null; // { startRow, endRow } of the innermost block around the cursor
+        this.remoteScope = null; // Teacher's scope (students)
+        this._structureRequest = null; // "version:row:col" of the last structure query
+        this.buffer.onChange((change) => {
+            this.bracketMatch = null;
+            this.diagnostics.clear(); // Positions are stale; the next check sends new ones
+            this._trackWidestLine(change);
+        });
         this.cursor = { row: 0, col: 0 }; // 0-indexed cursor position
         this.selection = new Set(); // Set of "row,col" strings for selected tiles
         this.selectionAnchor = null; // Starting point of selection
         
         // Remote highlights (from teacher)
         this.remoteHighlights = new Set(); // Set of "row,col" for teacher highlights
-        this.remoteCursor = null; // { row, col } for teacher's cursor
+        this.remoteCursors = null; // Other users' cursors (RemoteCursorLayer, created with the DOM)
         
         // Laser pointer (Ctrl+hover)
         this.laserPoint = null; // { row, col } for laser pointer position
@@ -33,6 +52,9 @@ class GridEditor {
         this.breakpoints = new Set(); // Set of row numbers with breakpoints
         this.remoteBreakpoints = new Set(); // Breakpoints from teacher
         
+        // Compiler diagnostics (C++, from the server): row -> [{ col, endCol, severity, title }]
+        this.diagnostics = new Map();
+        
         // DOM elements
         this.gridElement = null;
         this.hiddenInput = null;
@@ -42,6 +64,12 @@ class GridEditor {
         this.charWidth = 0;
         this.charHeight = 0;
         
+        // Virtualized rendering: only rows near the viewport are in the DOM
+        this.overscanRows = options.overscanRows || 20; // Extra rows above/below the viewport
+        this.renderedRange = { start: 0, end: 0 }; // Rows in the DOM: [start, end)
+        this._widestLine = 0; // Longest line seen (sizes the horizontal scroll area)
+        this._renderFrame = null;
+        
         // Event callbacks
         this.onContentChange = null;
         this.onSelectionChange = null;
@@ -49,11 +77,16 @@ class GridEditor {
         this.onLaserPoint = null;
         this.onBreakpointChange = null;
         this.onScrollToLine = null; // Callback for Ctrl+dblclick to sync students
-        
-        // Undo/Redo stacks
-        this.undoStack = [];
-        this.redoStack = [];
-        this.maxUndoLevels = 50;
+        this.onGutterChange = null; // Rendered rows, scroll position or breakpoints changed
+        this.onScopeChange = null; // Receives { startRow, endRow } (or null) when the cursor's scope changes
+        this.onEdit = null; // Receives { offset, deleteCount, text } for every local edit
+        this.onCompletionAccept = null; // Receives a chosen snippet suggestion ({ insert, smart }) to expand
+        this._silentEdits = false; // True while applying remote changes (no onEdit echo)
+        
+        // Undo/Redo: edit log with inverse ops, bounded by memory (see core/UndoHistory.js)
+        this.history = new UndoHistory(this.buffer, {
+            maxBytes: options.maxUndoBytes || 16 * 1024 * 1024
+        });
         this._lastUndoSaveTime = 0;
         this._undoDebounceMs = 300; // Minimum ms between undo saves (groups rapid typing)
         
@@ -109,6 +142,27 @@ class GridEditor {
         this.laserElement.className = 'grid-editor-laser-pointer';
         this.laserElement.style.display = 'none';
         
+        // Scope overlays: block around the cursor, and the teacher's (students)
+        this.scopeElement = document.createElement('div');
+        this.scopeElement.className = 'grid-editor-scope';
+        this.scopeElement.style.display = 'none';
+        this.remoteScopeElement = document.createElement('div');
+        this.remoteScopeElement.className = 'grid-editor-scope remote';
+        this.remoteScopeElement.style.display = 'none';
+        
+        // Other users' cursors: batched per frame, pooled elements
+        this.remoteCursors = typeof RemoteCursorLayer !== 'undefined'
+            ? new RemoteCursorLayer(this.gridElement, {
+                className: 'grid-editor-remote-cursor',
+                place: (el, row, col) => this._placeRemoteCursor(el, row, col)
+            })
+            : null;
+        
+        // Autocomplete dropdown (suggestions come from the worker)
+        this.completions = this.analysis && typeof CompletionPopup !== 'undefined'
+            ? new CompletionPopup(this)
+            : null;
+        
         // Append to container
         this.container.appendChild(this.gridElement);
         this.container.appendChild(this.hiddenInput);
@@ -167,6 +221,7 @@ class GridEditor {
             
             e.preventDefault(); // Prevent default focus behavior
             this.hiddenInput.focus();
+            if (this.completions) this.completions.close();
             this._handleMouseDown(e);
         });
         
@@ -181,8 +236,8 @@ class GridEditor {
             const row = Math.max(0, Math.floor(y / this.charHeight));
             
             // Clamp to valid range
-            const clampedRow = Math.min(row, this.lines.length - 1);
-            const clampedCol = Math.min(col, this.lines[clampedRow]?.length || 0);
+            const clampedRow = Math.min(row, this.buffer.lineCount - 1);
+            const clampedCol = Math.min(col, this.buffer.getLineLength(clampedRow));
             
             if (!e.shiftKey) {
                 this.selection.clear();
@@ -205,8 +260,8 @@ class GridEditor {
                 const col = Math.max(0, Math.floor(x / this.charWidth));
                 const row = Math.max(0, Math.floor(y / this.charHeight));
                 
-                const clampedRow = Math.min(row, this.lines.length - 1);
-                const clampedCol = Math.min(col, this.lines[clampedRow]?.length || 0);
+                const clampedRow = Math.min(row, this.buffer.lineCount - 1);
+                const clampedCol = Math.min(col, this.buffer.getLineLength(clampedRow));
                 
                 const pos = { row: clampedRow, col: clampedCol };
                 
@@ -223,10 +278,13 @@ class GridEditor {
             this.isDragging = false;
         });
         
-        // Scroll sync - sync line numbers when scrolling
-        this.gridElement.addEventListener('scroll', () => {
-            this._syncLineNumbersScroll();
-        });
+        // Scroll: render newly exposed rows and keep the gutter in sync
+        this.gridElement.addEventListener('scroll', () => this._handleScroll());
+        
+        // The viewport can grow without scrolling (resize, layout mode switch)
+        if (typeof ResizeObserver !== 'undefined') {
+            new ResizeObserver(() => this._handleScroll()).observe(this.gridElement);
+        }
         
         // Keyboard events on hidden input
         // Use capture phase for Ctrl+Z to prevent browser's native undo
@@ -235,6 +293,9 @@ class GridEditor {
         this.hiddenInput.addEventListener('paste', (e) => this._handlePaste(e));
         this.hiddenInput.addEventListener('copy', (e) => this._handleCopy(e));
         this.hiddenInput.addEventListener('cut', (e) => this._handleCut(e));
+        this.hiddenInput.addEventListener('blur', () => {
+            if (this.completions) this.completions.close();
+        });
         
         // Capture Ctrl+Z/Y at document level to prevent browser's native undo on hiddenInput
         document.addEventListener('keydown', (e) => {
@@ -297,6 +358,25 @@ class GridEditor {
             }
         });
         
+        // Keyword lists arrive with the language pack - re-highlight everything
+        window.addEventListener('languageChanged', () => {
+            this.diagnostics.clear(); // Compiler markers are C++ only
+            if (this.analysis) {
+                this.analysis.setLanguage(this._getLanguage(), true);
+                this.render();
+            } else if (this.highlightCache) {
+                this.highlightCache.invalidate();
+                this.render();
+            } else {
+                this.render();
+            }
+        });
+        
+        // Fresh classes from the worker: repaint with them
+        if (this.analysis) {
+            this.analysis.onHighlight = () => this.render();
+        }
+        
         // Keep hidden input focused when grid is focused
         this.gridElement.addEventListener('focus', () => {
             this.hiddenInput.focus();
@@ -378,7 +458,7 @@ class GridEditor {
         const col = Math.floor(x / this.charWidth);
         
         // Clamp to valid range
-        const maxRow = Math.max(0, this.lines.length - 1);
+        const maxRow = Math.max(0, this.buffer.lineCount - 1);
         const clampedRow = Math.max(0, Math.min(row, maxRow));
         
         // For laser pointer, allow pointing beyond line length
@@ -386,7 +466,7 @@ class GridEditor {
         if (allowBeyondLine) {
             clampedCol = Math.max(0, col); // Just ensure non-negative
         } else {
-            const maxCol = this.lines[clampedRow] ? this.lines[clampedRow].length : 0;
+            const maxCol = this.buffer.getLineLength(clampedRow);
             clampedCol = Math.max(0, Math.min(col, maxCol));
         }
         
@@ -407,7 +487,7 @@ class GridEditor {
         
         // For multi-line selection, select full lines in between
         for (let row = startRow; row <= endRow; row++) {
-            const line = this.lines[row] || '';
+            const line = this.buffer.getLine(row);
             let colStart, colEnd;
             
             if (startRow === endRow) {
@@ -466,7 +546,7 @@ class GridEditor {
                 text += '\n'.repeat(cell.row - lastRow);
                 lastRow = cell.row;
             }
-            const char = this.lines[cell.row]?.[cell.col] || '';
+            const char = this.buffer.getLine(cell.row)[cell.col] || '';
             text += char;
         }
         
@@ -495,6 +575,9 @@ class GridEditor {
         const ctrl = e.ctrlKey || e.metaKey;
         const shift = e.shiftKey;
         
+        // Open suggestion list takes arrows, Enter, Tab and Escape
+        if (this.completions && this.completions.handleKeyDown(e)) return;
+        
         // Navigation keys
         if (key === 'ArrowLeft') {
             e.preventDefault();
@@ -518,10 +601,10 @@ class GridEditor {
         } else if (key === 'End') {
             e.preventDefault();
             if (ctrl) {
-                const lastRow = this.lines.length - 1;
-                this._moveCursorTo(lastRow, this.lines[lastRow].length, shift);
+                const lastRow = this.buffer.lineCount - 1;
+                this._moveCursorTo(lastRow, this.buffer.getLineLength(lastRow), shift);
             } else {
-                this._moveCursorTo(this.cursor.row, this.lines[this.cursor.row].length, shift);
+                this._moveCursorTo(this.cursor.row, this.buffer.getLineLength(this.cursor.row), shift);
             }
         } else if (key === 'PageUp') {
             e.preventDefault();
@@ -577,6 +660,7 @@ class GridEditor {
         this._insertText(text);
         this.render();
         this._notifyContentChange();
+        if (this.completions) this.completions.update();
     }
     
     _handlePaste(e) {
@@ -619,10 +703,10 @@ class GridEditor {
         // Handle moving left from start of line
         if (newCol < 0 && newRow > 0) {
             newRow--;
-            newCol = this.lines[newRow].length;
+            newCol = this.buffer.getLineLength(newRow);
         }
         // Handle moving right from end of line
-        else if (newCol > this.lines[this.cursor.row].length && newRow < this.lines.length - 1) {
+        else if (newCol > this.buffer.getLineLength(this.cursor.row) && newRow < this.buffer.lineCount - 1) {
             newRow++;
             newCol = 0;
         }
@@ -632,11 +716,12 @@ class GridEditor {
     
     _moveCursorTo(row, col, extendSelection) {
         // Clamp values
-        row = Math.max(0, Math.min(row, this.lines.length - 1));
-        col = Math.max(0, Math.min(col, this.lines[row].length));
+        row = Math.max(0, Math.min(row, this.buffer.lineCount - 1));
+        col = Math.max(0, Math.min(col, this.buffer.getLineLength(row)));
         
         const oldPos = { ...this.cursor };
         this.cursor = { row, col };
+        if (this.completions) this.completions.close();
         
         if (extendSelection) {
             if (!this.selectionAnchor) {
@@ -680,36 +765,28 @@ class GridEditor {
     // TEXT EDITING
     // ============================================
     
+    /**
+     * Single entry point for local document edits.
+     * Updates the buffer in place and reports the change as a range op.
+     * @returns {{ row: number, col: number }} Position right after the inserted text
+     */
+    _replaceRange(startRow, startCol, endRow, endCol, text) {
+        const start = this.buffer.offsetAt(startRow, startCol);
+        const end = this.buffer.offsetAt(endRow, endCol);
+        const endPos = this.buffer.replaceRange(startRow, startCol, endRow, endCol, text);
+        this._emitEdit({ offset: start, deleteCount: end - start, text });
+        return endPos;
+    }
+    
+    _emitEdit(op) {
+        if (!op || this._silentEdits || !this.onEdit) return;
+        if (op.deleteCount === 0 && op.text === '') return;
+        this.onEdit(op);
+    }
+    
     _insertText(text) {
-        const textLines = text.split('\n');
         const { row, col } = this.cursor;
-        const currentLine = this.lines[row];
-        
-        if (textLines.length === 1) {
-            // Single line insert
-            this.lines[row] = currentLine.slice(0, col) + text + currentLine.slice(col);
-            this.cursor.col = col + text.length;
-        } else {
-            // Multi-line insert
-            const before = currentLine.slice(0, col);
-            const after = currentLine.slice(col);
-            
-            // First line
-            this.lines[row] = before + textLines[0];
-            
-            // Middle lines
-            for (let i = 1; i < textLines.length - 1; i++) {
-                this.lines.splice(row + i, 0, textLines[i]);
-            }
-            
-            // Last line
-            const lastLineIdx = row + textLines.length - 1;
-            this.lines.splice(lastLineIdx, 0, textLines[textLines.length - 1] + after);
-            
-            // Update cursor
-            this.cursor.row = lastLineIdx;
-            this.cursor.col = textLines[textLines.length - 1].length;
-        }
+        this.cursor = this._replaceRange(row, col, row, col, text);
     }
     
     _deleteSelection() {
@@ -721,22 +798,19 @@ class GridEditor {
             return { row, col };
         }).sort((a, b) => b.row - a.row || b.col - a.col); // Reverse order
         
-        // Group by row
-        const rowGroups = new Map();
-        for (const cell of cells) {
-            if (!rowGroups.has(cell.row)) {
-                rowGroups.set(cell.row, []);
+        // Delete runs of adjacent cells (in reverse order so earlier columns stay valid)
+        let i = 0;
+        while (i < cells.length) {
+            const row = cells[i].row;
+            const runEnd = cells[i].col;
+            let runStart = runEnd;
+            i++;
+            while (i < cells.length && cells[i].row === row && cells[i].col === runStart - 1) {
+                runStart--;
+                i++;
             }
-            rowGroups.get(cell.row).push(cell.col);
-        }
-        
-        // Delete characters from each row (in reverse order)
-        for (const [row, cols] of rowGroups) {
-            cols.sort((a, b) => b - a); // Reverse order within row
-            for (const col of cols) {
-                if (col < this.lines[row].length) {
-                    this.lines[row] = this.lines[row].slice(0, col) + this.lines[row].slice(col + 1);
-                }
+            if (runStart < this.buffer.getLineLength(row)) {
+                this._replaceRange(row, runStart, row, runEnd + 1, '');
             }
         }
         
@@ -763,19 +837,19 @@ class GridEditor {
         
         if (col > 0) {
             // Delete character before cursor
-            this.lines[row] = this.lines[row].slice(0, col - 1) + this.lines[row].slice(col);
+            this._replaceRange(row, col - 1, row, col, '');
             this.cursor.col--;
         } else if (row > 0) {
             // Merge with previous line
-            const prevLineLength = this.lines[row - 1].length;
-            this.lines[row - 1] += this.lines[row];
-            this.lines.splice(row, 1);
+            const prevLineLength = this.buffer.getLineLength(row - 1);
+            this._replaceRange(row - 1, prevLineLength, row, 0, '');
             this.cursor.row--;
             this.cursor.col = prevLineLength;
         }
         
         this.render();
         this._notifyContentChange();
+        if (this.completions && this.completions.isOpen) this.completions.update();
     }
     
     _handleDelete() {
@@ -788,14 +862,14 @@ class GridEditor {
         }
         
         const { row, col } = this.cursor;
+        const lineLength = this.buffer.getLineLength(row);
         
-        if (col < this.lines[row].length) {
+        if (col < lineLength) {
             // Delete character at cursor
-            this.lines[row] = this.lines[row].slice(0, col) + this.lines[row].slice(col + 1);
-        } else if (row < this.lines.length - 1) {
+            this._replaceRange(row, col, row, col + 1, '');
+        } else if (row < this.buffer.lineCount - 1) {
             // Merge with next line
-            this.lines[row] += this.lines[row + 1];
-            this.lines.splice(row + 1, 1);
+            this._replaceRange(row, lineLength, row + 1, 0, '');
         }
         
         this.render();
@@ -807,11 +881,9 @@ class GridEditor {
         this._deleteSelection();
         
         const { row, col } = this.cursor;
-        const currentLine = this.lines[row];
         
         // Split line at cursor
-        this.lines[row] = currentLine.slice(0, col);
-        this.lines.splice(row + 1, 0, currentLine.slice(col));
+        this._replaceRange(row, col, row, col, '\n');
         
         // Move cursor to start of new line
         this.cursor.row++;
@@ -829,7 +901,7 @@ class GridEditor {
         if (shift) {
             // Unindent - remove spaces from start of line
             const { row } = this.cursor;
-            const line = this.lines[row];
+            const line = this.buffer.getLine(row);
             let removeCount = 0;
             
             for (let i = 0; i < this.options.tabSize && i < line.length; i++) {
@@ -838,7 +910,7 @@ class GridEditor {
             }
             
             if (removeCount > 0) {
-                this.lines[row] = line.slice(removeCount);
+                this._replaceRange(row, 0, row, removeCount, '');
                 this.cursor.col = Math.max(0, this.cursor.col - removeCount);
             }
         } else {
@@ -854,14 +926,16 @@ class GridEditor {
     _selectAll() {
         this.selection.clear();
         
-        for (let row = 0; row < this.lines.length; row++) {
-            for (let col = 0; col < this.lines[row].length; col++) {
+        const lines = this.buffer.getLines();
+        for (let row = 0; row < lines.length; row++) {
+            for (let col = 0; col < lines[row].length; col++) {
                 this.selection.add(`${row},${col}`);
             }
         }
         
+        const lastRow = lines.length - 1;
         this.selectionAnchor = { row: 0, col: 0 };
-        this.cursor = { row: this.lines.length - 1, col: this.lines[this.lines.length - 1].length };
+        this.cursor = { row: lastRow, col: lines[lastRow].length };
         
         this.render();
         this._notifySelectionChange();
@@ -887,56 +961,41 @@ class GridEditor {
     }
     
     _doSaveUndo() {
-        this._doSaveUndoState({
-            lines: [...this.lines],
-            cursor: { ...this.cursor },
-            selection: new Set(this.selection)
-        });
+        // Start a new undo step; every edit until the next one belongs to it
+        this.history.checkpoint(this._getUndoState());
     }
     
-    _doSaveUndoState(state) {
-        this.undoStack.push(state);
-        
-        if (this.undoStack.length > this.maxUndoLevels) {
-            this.undoStack.shift();
-        }
-        
-        this.redoStack = [];
+    _getUndoState() {
+        return {
+            cursor: { ...this.cursor },
+            selection: new Set(this.selection)
+        };
     }
     
     undo() {
-        if (this.undoStack.length === 0) return;
-        
-        // Save current state for redo
-        this.redoStack.push({
-            lines: [...this.lines],
-            cursor: { ...this.cursor },
-            selection: new Set(this.selection)
-        });
-        
-        const state = this.undoStack.pop();
-        this.lines = state.lines;
-        this.cursor = state.cursor;
-        this.selection = state.selection;
-        
-        this.render();
-        this._notifyContentChange();
+        this._applyHistoryStep(this.history.undo(this._getUndoState()));
     }
     
     redo() {
-        if (this.redoStack.length === 0) return;
-        
-        // Save current state for undo
-        this.undoStack.push({
-            lines: [...this.lines],
-            cursor: { ...this.cursor },
-            selection: new Set(this.selection)
-        });
+        this._applyHistoryStep(this.history.redo());
+    }
+
+    /**
+     * Forget undo/redo steps (another document was loaded in place of this one)
+     */
+    clearUndoHistory() {
+        this.history.clear();
+    }
+    
+    _applyHistoryStep(step) {
+        if (!step) return;
         
-        const state = this.redoStack.pop();
-        this.lines = state.lines;
-        this.cursor = state.cursor;
-        this.selection = state.selection;
+        // Undo/redo edits are sent to other users like any local edit
+        for (const op of step.ops) {
+            this._emitEdit(op);
+        }
+        this.cursor = step.state.cursor;
+        this.selection = step.state.selection;
         
         this.render();
         this._notifyContentChange();
@@ -947,15 +1006,27 @@ class GridEditor {
     // ============================================
     
     render() {
-        // Get syntax highlighting data for all lines
-        const highlightData = this._getSyntaxHighlighting();
+        if (this._renderFrame) {
+            cancelAnimationFrame(this._renderFrame);
+            this._renderFrame = null;
+        }
+        
+        const lineCount = this.buffer.lineCount;
+        const { start, end } = this._getVisibleRange(this.overscanRows);
+        this.renderedRange = { start, end };
         
-        // Build grid HTML
-        let html = '';
+        // Get syntax highlighting data (only the rendered rows are needed)
+        const highlightData = this._getSyntaxHighlighting(start, end);
         
-        for (let row = 0; row < this.lines.length; row++) {
-            const line = this.lines[row];
+        // Spacers stand in for the rows outside the range, so scroll height,
+        // scroll width and absolute positions stay those of the full document
+        const spacerWidth = (this._widestLine + 1) * this.charWidth;
+        let html = `<div class="grid-editor-spacer" style="height: ${start * this.charHeight}px; width: ${spacerWidth}px;"></div>`;
+        
+        for (let row = start; row < end; row++) {
+            const line = this.buffer.getLine(row);
             const lineHighlight = highlightData[row] || [];
+            const lineDiagnostics = this.diagnostics.get(row);
             
             html += `<div class="grid-editor-row" data-row="${row}" style="height: ${this.charHeight}px;">`;
             
@@ -977,12 +1048,15 @@ class GridEditor {
                 const isRemoteHighlight = this.remoteHighlights.has(`${row},${col}`);
                 const isCursor = row === this.cursor.row && col === this.cursor.col;
                 const syntaxClass = lineHighlight[col] || '';
+                const diagnostic = lineDiagnostics && lineDiagnostics.find(d => col >= d.col && col < d.endCol);
                 
                 let classes = 'grid-editor-cell';
                 if (syntaxClass) classes += ` ${syntaxClass}`;
+                if (this._isBracketMatch(row, col)) classes += ' bracket-match';
                 if (isSelected) classes += ' selected';
                 if (isRemoteHighlight) classes += ' remote-highlight';
                 if (isCursor) classes += ' cursor-cell';
+                if (diagnostic) classes += ` diagnostic-${diagnostic.severity}`;
                 
                 // Escape HTML and handle special characters
                 let displayChar;
@@ -1000,24 +1074,28 @@ class GridEditor {
                     displayChar = char;
                 }
                 
-                html += `<span class="${classes}" data-row="${row}" data-col="${col}" style="width: ${this.charWidth}px; height: ${this.charHeight}px; line-height: ${this.charHeight}px;">${displayChar}</span>`;
+                const title = diagnostic ? ` title="${diagnostic.title}"` : '';
+                html += `<span class="${classes}" data-row="${row}" data-col="${col}"${title} style="width: ${this.charWidth}px; height: ${this.charHeight}px; line-height: ${this.charHeight}px;">${displayChar}</span>`;
             }
             
             html += '</div>';
         }
         
+        html += `<div class="grid-editor-spacer" style="height: ${(lineCount - end) * this.charHeight}px; width: ${spacerWidth}px;"></div>`;
+        
         // Preserve scroll position
         const scrollTop = this.gridElement.scrollTop;
         const scrollLeft = this.gridElement.scrollLeft;
 
         this.gridElement.innerHTML = html;
+        this.gridElement.appendChild(this.scopeElement);
+        this.gridElement.appendChild(this.remoteScopeElement);
         this.gridElement.appendChild(this.cursorElement);
         this.gridElement.appendChild(this.laserElement);
-        
-        // Add remote cursor if exists
-        if (this.remoteCursor) {
-            this._renderRemoteCursor();
-        }
+        if (this.remoteCursors) this.gridElement.appendChild(this.remoteCursors.element);
+        if (this.completions) this.gridElement.appendChild(this.completions.element);
+        this._updateScopeElement(this.scopeElement, this.scope);
+        this._updateScopeElement(this.remoteScopeElement, this.remoteScope);
         
         // Update laser pointer position
         this._updateLaserElement();
@@ -1028,43 +1106,238 @@ class GridEditor {
         
         // Update cursor element position
         this._updateCursorElement();
+        
+        this._requestStructure();
+        this._notifyGutterChange();
     }
     
-    _renderRemoteCursor() {
-        let remoteCursorEl = this.gridElement.querySelector('.grid-editor-remote-cursor');
-        if (!remoteCursorEl) {
-            remoteCursorEl = document.createElement('div');
-            remoteCursorEl.className = 'grid-editor-remote-cursor';
-            this.gridElement.appendChild(remoteCursorEl);
-        }
+    /**
+     * Rows intersecting the viewport, widened by `overscan` rows on each side
+     * @param {number} [overscan=0]
+     * @returns {{start: number, end: number}} Row range [start, end)
+     */
+    _getVisibleRange(overscan = 0) {
+        const padding = 15;
+        const lineCount = this.buffer.lineCount;
+        const rowHeight = this.charHeight || 1;
+        const first = Math.floor(Math.max(0, this.gridElement.scrollTop - padding) / rowHeight);
+        const visibleRows = Math.ceil(this.gridElement.clientHeight / rowHeight) + 1;
         
+        const start = Math.max(0, Math.min(first, lineCount) - overscan);
+        const end = Math.min(lineCount, first + visibleRows + overscan);
+        return { start, end: Math.max(start, end) };
+    }
+    
+    /**
+     * Rows currently in the DOM
+     * @returns {{start: number, end: number}} Row range [start, end)
+     */
+    getRenderedRange() {
+        return { ...this.renderedRange };
+    }
+    
+    _handleScroll() {
+        const visible = this._getVisibleRange();
+        const rendered = this.renderedRange;
+        if (visible.start < rendered.start || visible.end > rendered.end) {
+            this._scheduleRender();
+        }
+        this._notifyGutterChange();
+    }
+    
+    /**
+     * Render on the next frame (coalesces bursts of scroll events)
+     */
+    _scheduleRender() {
+        if (this._renderFrame) return;
+        if (typeof requestAnimationFrame === 'undefined') {
+            this.render();
+            return;
+        }
+        this._renderFrame = requestAnimationFrame(() => {
+            this._renderFrame = null;
+            this.render();
+        });
+    }
+    
+    /**
+     * Keep the longest line length for the spacer width. Edits can only grow
+     * it here (shrinking would need a full scan); setValue() recomputes it.
+     */
+    _trackWidestLine(change) {
+        for (let row = change.startRow; row < change.startRow + change.insertedLines; row++) {
+            const length = this.buffer.getLineLength(row);
+            if (length > this._widestLine) this._widestLine = length;
+        }
+    }
+    
+    _measureWidestLine() {
+        let widest = 0;
+        for (let row = 0; row < this.buffer.lineCount; row++) {
+            widest = Math.max(widest, this.buffer.getLineLength(row));
+        }
+        this._widestLine = widest;
+    }
+    
+    _placeRemoteCursor(el, row, col) {
         // Add padding offset (15px from grid padding) - same as local cursor
         const padding = 15;
-        const x = this.remoteCursor.col * this.charWidth + padding;
-        const y = this.remoteCursor.row * this.charHeight + padding;
-        
-        remoteCursorEl.style.left = `${x}px`;
-        remoteCursorEl.style.top = `${y}px`;
-        remoteCursorEl.style.height = `${this.charHeight}px`;
-        remoteCursorEl.style.display = 'block';
+        el.style.left = `${col * this.charWidth + padding}px`;
+        el.style.top = `${row * this.charHeight + padding}px`;
+        el.style.height = `${this.charHeight}px`;
     }
     
     // ============================================
     // SYNTAX HIGHLIGHTING
     // ============================================
     
-    _getSyntaxHighlighting() {
-        // Delegate to SyntaxHighlighter class
-        const currentLang = typeof LanguageManager !== 'undefined' 
-            ? LanguageManager.getCurrentLanguage() 
+    _getLanguage() {
+        return typeof LanguageManager !== 'undefined'
+            ? LanguageManager.getCurrentLanguage()
             : 'glossa';
+    }
+    
+    /**
+     * Per-character classes, indexed by row. Only rows in [start, end) are
+     * guaranteed to be filled in.
+     */
+    _getSyntaxHighlighting(start, end) {
+        // Delegate to SyntaxHighlighter class
+        const currentLang = this._getLanguage();
+        
+        // Worker path: last-known classes now, fresh ones trigger another render
+        if (this.analysis) {
+            this.analysis.setLanguage(currentLang);
+            this.analysis.requestHighlight(start, end);
+            return this.analysis.classes;
+        }
+        
+        // Incremental path: cached per line, cursor-only renders tokenize nothing
+        if (this.highlightCache) {
+            return this.highlightCache.highlight(currentLang);
+        }
         
         if (typeof SyntaxHighlighter !== 'undefined') {
-            return SyntaxHighlighter.highlight(this.lines, currentLang);
+            return SyntaxHighlighter.highlight(this.buffer.getLines(), currentLang);
         }
         
-        // Fallback: return empty highlighting
-        return this.lines.map(line => new Array(line.length).fill(''));
+        // Fallback: no highlighting
+        return [];
+    }
+    
+    // ============================================
+    // BRACKET MATCHING & SCOPE
+    // ============================================
+    
+    _isBracketMatch(row, col) {
+        const match = this.bracketMatch;
+        if (!match) return false;
+        for (const pos of [match.open, match.close]) {
+            if (pos.row === row && col >= pos.col && col < pos.col + pos.length) return true;
+        }
+        return false;
+    }
+    
+    /**
+     * Ask the worker for the pair at the cursor and the enclosing scope
+     * (once per position/version)
+     */
+    _requestStructure() {
+        if (!this.analysis) return;
+        
+        const { row, col } = this.cursor;
+        const key = `${this.buffer.version}:${row}:${col}`;
+        if (key === this._structureRequest) return;
+        this._structureRequest = key;
+        
+        this.analysis.queryStructure(row, col).then(result => {
+            if (key !== this._structureRequest || !result) return; // Cursor or document moved on
+            this._setBracketMatchCells(false);
+            this.bracketMatch = result.match;
+            this._setBracketMatchCells(true);
+            this._setScope(result.scope
+                ? { startRow: result.scope.open.row, endRow: result.scope.close.row }
+                : null);
+        });
+    }
+    
+    _setBracketMatchCells(on) {
+        if (!this.bracketMatch) return;
+        for (const pos of [this.bracketMatch.open, this.bracketMatch.close]) {
+            for (let col = pos.col; col < pos.col + pos.length; col++) {
+                const cell = this.gridElement.querySelector(`.grid-editor-cell[data-row="${pos.row}"][data-col="${col}"]`);
+                if (cell) cell.classList.toggle('bracket-match', on);
+            }
+        }
+    }
+    
+    _setScope(range) {
+        const current = this.scope;
+        if (range === current || (range && current &&
+            range.startRow === current.startRow && range.endRow === current.endRow)) {
+            return;
+        }
+        this.scope = range;
+        this._updateScopeElement(this.scopeElement, range);
+        if (this.onScopeChange) {
+            this.onScopeChange(range);
+        }
+    }
+    
+    /**
+     * Show the teacher's current scope (students)
+     * @param {{startRow: number, endRow: number}|null} range - 0-indexed rows, inclusive
+     */
+    setRemoteScope(range) {
+        this.remoteScope = range;
+        this._updateScopeElement(this.remoteScopeElement, range);
+    }
+    
+    _updateScopeElement(element, range) {
+        if (!range) {
+            element.style.display = 'none';
+            return;
+        }
+        const padding = 15;
+        element.style.top = `${range.startRow * this.charHeight + padding}px`;
+        element.style.height = `${(range.endRow - range.startRow + 1) * this.charHeight}px`;
+        element.style.display = 'block';
+    }
+    
+    // ============================================
+    // AUTOCOMPLETE
+    // ============================================
+    
+    /**
+     * Suggestions for prefix, ranked in the worker (document identifiers,
+     * then the language's snippets and keywords)
+     * @param {string} prefix
+     * @param {number} [limit=20]
+     * @returns {Promise<{text, kind, insert, smart, desc}[]>}
+     */
+    getCompletions(prefix, limit = 20) {
+        if (!this.analysis) return Promise.resolve([]);
+        return this.analysis.getCompletions(prefix, limit);
+    }
+    
+    /**
+     * Replace the word being typed with a suggestion. Snippets only drop the
+     * typed prefix here; onCompletionAccept inserts their template.
+     * @param {{text: string, kind: string, smart: string|null}} item
+     * @param {string} prefix - Text before the cursor that the suggestion completes
+     */
+    acceptCompletion(item, prefix) {
+        const { row, col } = this.cursor;
+        const isSnippet = item.kind === 'snippet' && !!this.onCompletionAccept;
+        
+        this._doSaveUndo();
+        this.cursor = this._replaceRange(row, col - prefix.length, row, col, isSnippet ? '' : item.text);
+        this.render();
+        this._notifyContentChange();
+        
+        if (isSnippet) {
+            this.onCompletionAccept(item);
+        }
     }
     
     _updateCursorElement() {
@@ -1097,16 +1370,6 @@ class GridEditor {
         this.laserElement.style.display = 'block';
     }
     
-    /**
-     * Sync line numbers scroll with grid scroll
-     */
-    _syncLineNumbersScroll() {
-        const lineNumbers = document.getElementById('line-numbers');
-        if (lineNumbers) {
-            lineNumbers.scrollTop = this.gridElement.scrollTop;
-        }
-    }
-    
     _escapeHtml(text) {
         const div = document.createElement('div');
         div.textContent = text;
@@ -1118,7 +1381,57 @@ class GridEditor {
     // ============================================
     
     getValue() {
-        return this.lines.join('\n');
+        return this.buffer.getText();
+    }
+    
+    /**
+     * Text of a single line (0-based) without materializing the document
+     * @param {number} row
+     * @returns {string}
+     */
+    getLine(row) {
+        return this.buffer.getLine(row);
+    }
+    
+    /**
+     * Underlying TextBuffer, for modules that index the document by line
+     * @returns {TextBuffer}
+     */
+    getBuffer() {
+        return this.buffer;
+    }
+    
+    /**
+     * Block-opener index of the document (see core/BlockIndex.js)
+     * @returns {BlockIndex|null}
+     */
+    getBlockIndex() {
+        return this.blockIndex;
+    }
+    
+    /**
+     * Insert text as one undoable local edit (keyword / snippet insertion)
+     * @param {number} offset - Character offset to insert at
+     * @param {string} text
+     * @param {number} [cursorOffset] - Cursor offset afterwards (default: after the text)
+     */
+    insertAt(offset, text, cursorOffset = offset + text.length) {
+        this._doSaveUndo();
+        
+        const { row, col } = this.buffer.positionAt(offset);
+        this._replaceRange(row, col, row, col, text);
+        
+        const cursor = this.buffer.positionAt(cursorOffset);
+        this._notifyContentChange();
+        this._moveCursorTo(cursor.row, cursor.col, false);
+    }
+    
+    /**
+     * Replace the document, editing only the span that actually changed
+     * @param {string} text
+     */
+    _applyText(text) {
+        this._emitEdit(this.buffer.setText(text));
     }
     
     setValue(text, options = {}) {
@@ -1128,22 +1441,27 @@ class GridEditor {
             this._doSaveUndo(); // Direct save, bypasses debounce
         }
         
-        this.lines = text.split('\n');
+        // Remote updates must not be echoed back as local edits
+        this._silentEdits = !!options.skipNotify;
+        this._applyText(text);
+        this._silentEdits = false;
         
         // Only reset cursor for local changes, not remote
         if (!options.preserveCursor) {
             this.cursor = { row: 0, col: 0 };
         } else {
             // Clamp cursor to valid position
-            this.cursor.row = Math.min(this.cursor.row, this.lines.length - 1);
-            this.cursor.col = Math.min(this.cursor.col, this.lines[this.cursor.row]?.length || 0);
+            this.cursor.row = Math.min(this.cursor.row, this.buffer.lineCount - 1);
+            this.cursor.col = Math.min(this.cursor.col, this.buffer.getLineLength(this.cursor.row));
         }
         
         this.selection.clear();
         this.selectionAnchor = null;
+        if (this.completions) this.completions.close();
         
         // Don't clear remote highlights - they're managed separately
         
+        this._measureWidestLine();
         this.render();
         
         // Only notify content change for local edits, not remote updates
@@ -1152,6 +1470,37 @@ class GridEditor {
         }
     }
     
+    /**
+     * Apply edits made by another user, in order, without echoing them back.
+     * Only the touched lines change; the local cursor is shifted along.
+     * @param {Object[]} ops - [{ offset, deleteCount, text }]
+     * @param {Object} options - { skipUndo }
+     */
+    applyRemoteOps(ops, options = {}) {
+        if (!ops || ops.length === 0) return;
+        
+        if (!options.skipUndo) {
+            this._saveUndo();
+        }
+        
+        let cursorOffset = this.buffer.offsetAt(this.cursor.row, this.cursor.col);
+        for (const op of ops) {
+            if (op.offset < cursorOffset) {
+                const opEnd = op.offset + op.deleteCount;
+                cursorOffset = cursorOffset >= opEnd
+                    ? cursorOffset + op.text.length - op.deleteCount
+                    : op.offset + op.text.length;
+            }
+            this.buffer.replace(op.offset, op.deleteCount, op.text);
+        }
+        this.cursor = this.buffer.positionAt(cursorOffset);
+        
+        this.selection.clear();
+        this.selectionAnchor = null;
+        
+        this.render();
+    }
+    
     getCursor() {
         return { ...this.cursor };
     }
@@ -1161,11 +1510,11 @@ class GridEditor {
     }
     
     getLineCount() {
-        return this.lines.length;
+        return this.buffer.lineCount;
     }
     
     getCharCount() {
-        return this.lines.reduce((sum, line) => sum + line.length, 0) + (this.lines.length - 1);
+        return this.buffer.length;
     }
     
     focus() {
@@ -1193,14 +1542,24 @@ class GridEditor {
         this.render();
     }
     
-    setRemoteCursor(row, col) {
-        this.remoteCursor = { row, col };
-        this.render();
+    /**
+     * Show another user's cursor. Updates are drawn once per animation
+     * frame and hidden after a few seconds without news (RemoteCursorLayer).
+     * @param {number} row - 0-indexed
+     * @param {number} col - 0-indexed
+     * @param {string} [userId='remote']
+     */
+    setRemoteCursor(row, col, userId = 'remote') {
+        if (this.remoteCursors) this.remoteCursors.set(userId, row, col);
     }
     
-    clearRemoteCursor() {
-        this.remoteCursor = null;
-        this.render();
+    /**
+     * @param {string} [userId] - Hide only this user's cursor (default: all)
+     */
+    clearRemoteCursor(userId) {
+        if (!this.remoteCursors) return;
+        if (userId === undefined) this.remoteCursors.clear();
+        else this.remoteCursors.remove(userId);
     }
     
     // ============================================
@@ -1230,6 +1589,7 @@ class GridEditor {
         this.container.style.setProperty('--editor-font-size', `${size}px`);
         this._calculateCharDimensions();
         this.render();
+        if (this.remoteCursors) this.remoteCursors.refresh();
     }
     
     // ============================================
@@ -1253,8 +1613,10 @@ class GridEditor {
     // ============================================
     
     _notifyContentChange() {
+        // The document is not passed along: joining it on every keystroke is
+        // exactly the cost the TextBuffer avoids. Use getValue() when needed.
         if (this.onContentChange) {
-            this.onContentChange(this.getValue());
+            this.onContentChange();
         }
     }
     
@@ -1282,6 +1644,12 @@ class GridEditor {
         }
     }
     
+    _notifyGutterChange() {
+        if (this.onGutterChange) {
+            this.onGutterChange();
+        }
+    }
+    
     // ============================================
     // BREAKPOINT MARKERS
     // ============================================
@@ -1293,10 +1661,7 @@ class GridEditor {
             this.breakpoints.add(row);
         }
         this._notifyBreakpointChange();
-        // Update line numbers display
-        if (typeof updateLineNumbers === 'function') {
-            updateLineNumbers();
-        }
+        this._notifyGutterChange();
     }
     
     setBreakpoint(row, enabled) {
@@ -1320,15 +1685,52 @@ class GridEditor {
         for (const row of rows) {
             this.remoteBreakpoints.add(row);
         }
-        // Update line numbers display
-        if (typeof updateLineNumbers === 'function') {
-            updateLineNumbers();
-        }
+        this._notifyGutterChange();
     }
     
     clearBreakpoints() {
         this.breakpoints.clear();
         this._notifyBreakpointChange();
+        this._notifyGutterChange();
+    }
+    
+    // ============================================
+    // DIAGNOSTICS
+    // ============================================
+    
+    /**
+     * Underline the tiles the compiler complains about (hover shows the message)
+     * @param {Object[]} diagnostics - { row, col, severity: 'error'|'warning', message }, 0-based
+     */
+    setDiagnostics(diagnostics) {
+        this.diagnostics.clear();
+        // Errors first, so they win where a warning overlaps
+        const sorted = [...diagnostics].sort((a, b) => (a.severity === 'error' ? 0 : 1) - (b.severity === 'error' ? 0 : 1));
+        for (const diagnostic of sorted) {
+            if (diagnostic.row < 0 || diagnostic.row >= this.buffer.lineCount) continue;
+            const line = this.buffer.getLine(diagnostic.row);
+            const col = Math.min(Math.max(0, diagnostic.col), line.length);
+            // The whole word the column points into; one tile otherwise (e.g. a missing ';')
+            let endCol = col + 1;
+            if (/\w/.test(line[col] || '')) {
+                while (endCol < line.length && /\w/.test(line[endCol])) endCol++;
+            }
+            const rowDiagnostics = this.diagnostics.get(diagnostic.row) || [];
+            rowDiagnostics.push({
+                col,
+                endCol,
+                severity: diagnostic.severity,
+                title: this._escapeHtml(`${diagnostic.severity}: ${diagnostic.message}`).replace(/"/g, '&quot;')
+            });
+            this.diagnostics.set(diagnostic.row, rowDiagnostics);
+        }
+        this.render();
+    }
+    
+    clearDiagnostics() {
+        if (this.diagnostics.size === 0) return;
+        this.diagnostics.clear();
+        this.render();
     }
     
     // ============================================
@@ -1345,7 +1747,7 @@ class GridEditor {
         const row = lineNumber - 1;
         
         // Clamp to valid range
-        const maxRow = Math.max(0, this.lines.length - 1);
+        const maxRow = Math.max(0, this.buffer.lineCount - 1);
         const targetRow = Math.max(0, Math.min(row, maxRow));
         
         // Calculate scroll position to center the line
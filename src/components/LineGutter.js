@@ -0,0 +1,150 @@
+/**
+ * LineGutter - Virtualized line numbers for GridEditor
+ *
+ * Shows only the rows GridEditor has in the DOM (see getRenderedRange),
+ * between two spacers that keep the scroll height of the whole document.
+ * update() is cheap enough to call on every keystroke:
+ * - line elements are reused when the rendered range moves
+ * - if the range and line count are unchanged, only rows whose breakpoint
+ *   state changed are touched
+ * Breakpoint clicks (teacher) go through one delegated listener.
+ */
+
+class LineGutter {
+    /**
+     * @param {HTMLElement} element - The #line-numbers container
+     * @param {GridEditor} editor
+     * @param {Object} [options]
+     * @param {boolean} [options.interactive=false] - Clicking a number toggles a breakpoint
+     */
+    constructor(element, editor, options = {}) {
+        this.element = element;
+        this.editor = editor;
+        this.interactive = !!options.interactive;
+
+        // What is currently shown
+        this.start = 0;
+        this.end = 0;
+        this.rowHeight = 0;
+        this.rows = [];   // Line number elements for rows [start, end)
+        this.marked = []; // Breakpoint state shown on each of those rows
+
+        this.element.innerHTML = '';
+        this.topSpacer = this._createSpacer();
+        this.rowsElement = document.createElement('div');
+        this.bottomSpacer = this._createSpacer();
+        this.element.appendChild(this.topSpacer);
+        this.element.appendChild(this.rowsElement);
+        this.element.appendChild(this.bottomSpacer);
+        this.element.classList.toggle('interactive', this.interactive);
+
+        this.element.addEventListener('click', (e) => this._handleClick(e));
+    }
+
+    /**
+     * Bring the gutter in line with the editor's rendered rows, line count,
+     * breakpoints and scroll position
+     */
+    update() {
+        const { start, end } = this.editor.getRenderedRange();
+        const lineCount = this.editor.getLineCount();
+        const rowHeight = this.editor.charHeight;
+
+        if (rowHeight !== this.rowHeight) {
+            this.rowHeight = rowHeight;
+            this.element.style.setProperty('--row-height', `${rowHeight}px`);
+        }
+
+        if (start !== this.start || end !== this.end) {
+            this._renderRange(start, end);
+        } else {
+            this._updateBreakpoints();
+        }
+
+        this.topSpacer.style.height = `${start * rowHeight}px`;
+        this.bottomSpacer.style.height = `${Math.max(0, lineCount - end) * rowHeight}px`;
+
+        this.element.scrollTop = this.editor.gridElement.scrollTop;
+    }
+
+    _createSpacer() {
+        const spacer = document.createElement('div');
+        spacer.className = 'line-number-spacer';
+        return spacer;
+    }
+
+    /**
+     * Show rows [start, end), keeping the elements of rows already shown
+     */
+    _renderRange(start, end) {
+        const rows = new Array(end - start);
+        const marked = new Array(end - start);
+
+        for (let row = start; row < end; row++) {
+            const i = row - start;
+            if (row >= this.start && row < this.end) {
+                rows[i] = this.rows[row - this.start];
+                marked[i] = this.marked[row - this.start];
+            } else {
+                rows[i] = this._createRow(row);
+                marked[i] = false;
+            }
+            const hasBreakpoint = this.editor.hasBreakpoint(row);
+            if (marked[i] !== hasBreakpoint) {
+                this._setMarked(rows[i], hasBreakpoint);
+                marked[i] = hasBreakpoint;
+            }
+        }
+
+        this.rowsElement.replaceChildren(...rows);
+        this.start = start;
+        this.end = end;
+        this.rows = rows;
+        this.marked = marked;
+    }
+
+    _createRow(row) {
+        const el = document.createElement('div');
+        el.className = 'line-number';
+        el.dataset.line = row;
+        el.textContent = row + 1;
+        return el;
+    }
+
+    /**
+     * Toggle the marker on rows whose breakpoint state changed
+     */
+    _updateBreakpoints() {
+        for (let i = 0; i < this.rows.length; i++) {
+            const hasBreakpoint = this.editor.hasBreakpoint(this.start + i);
+            if (this.marked[i] !== hasBreakpoint) {
+                this._setMarked(this.rows[i], hasBreakpoint);
+                this.marked[i] = hasBreakpoint;
+            }
+        }
+    }
+
+    _setMarked(el, on) {
+        el.classList.toggle('has-breakpoint', on);
+        if (on) {
+            const marker = document.createElement('span');
+            marker.className = 'breakpoint-marker';
+            marker.textContent = '●';
+            el.insertBefore(marker, el.firstChild);
+        } else if (el.firstChild && el.firstChild.nodeType === 1) {
+            el.removeChild(el.firstChild);
+        }
+    }
+
+    _handleClick(e) {
+        if (!this.interactive) return;
+        const el = e.target.closest('.line-number');
+        if (!el || !this.element.contains(el)) return;
+        this.editor.toggleBreakpoint(parseInt(el.dataset.line, 10));
+    }
+}
+
+// Export for use
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = LineGutter;
+}
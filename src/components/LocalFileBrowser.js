@@ -14,6 +14,7 @@ const LocalFileBrowser = {
     folderNameEl: null,
     breadcrumbEl: null,
     fileListEl: null,
+    _fileList: null,         // VirtualList over fileListEl
     
     // State
     rootHandle: null,        // Root directory handle
@@ -186,41 +187,32 @@ const LocalFileBrowser = {
     },
     
     /**
-     * Render file list
+     * Render file list (virtualized: only visible items are in the DOM)
      */
     _renderFileList(items) {
         if (!this.fileListEl) return;
         
-        if (items.length === 0) {
-            this.fileListEl.innerHTML = '<div class="file-empty">No supported files</div>';
-            return;
-        }
-        
-        this.fileListEl.innerHTML = items.map(item => `
-            <div class="file-item ${item.type}" data-name="${item.name}" data-type="${item.type}">
-                <span class="file-icon">${this._getFileIcon(item.name, item.type)}</span>
-                <span class="file-name">${item.name}</span>
-            </div>
-        `).join('');
-        
-        // Store handles for click handlers
-        const handleMap = new Map();
-        items.forEach(item => handleMap.set(item.name, item.handle));
-        
-        // Add click handlers
-        this.fileListEl.querySelectorAll('.file-item').forEach(el => {
-            el.addEventListener('click', async () => {
-                const name = el.dataset.name;
-                const type = el.dataset.type;
-                const handle = handleMap.get(name);
-                
-                if (type === 'folder') {
-                    await this._navigateToFolder(handle);
-                } else {
-                    await this._loadFile(handle);
+        if (!this._fileList) {
+            this._fileList = new VirtualList(this.fileListEl, {
+                key: item => item.name,
+                empty: '<div class="file-empty">No supported files</div>',
+                render: item => `
+                    <div class="file-item ${item.type}" data-name="${item.name}" data-type="${item.type}">
+                        <span class="file-icon">${this._getFileIcon(item.name, item.type)}</span>
+                        <span class="file-name">${item.name}</span>
+                    </div>
+                `,
+                onClick: async item => {
+                    if (item.type === 'folder') {
+                        await this._navigateToFolder(item.handle);
+                    } else {
+                        await this._loadFile(item.handle);
+                    }
                 }
             });
-        });
+        }
+        
+        this._fileList.setItems(items);
     },
     
     /**
@@ -0,0 +1,117 @@
+/**
+ * RecordingsPanel Component
+ * Teacher's lesson recording controls and list of past recordings
+ *
+ * Recording happens on the server (server/SessionRecorder.js); this panel
+ * starts/stops it and opens a recording in a replay tab
+ * (index.html?replay=<id>, see ReplayPlayer.js).
+ *
+ * Dependencies:
+ * - UIManager (escapeHtml)
+ * - Collaboration (recording_start / recording_stop)
+ */
+
+const RecordingsPanel = {
+    recording: false,
+    startedAt: null,
+    _elapsedTimer: null,
+
+    /**
+     * Initialize recordings panel (teacher only)
+     */
+    init() {
+        const toggle = document.getElementById('recording-toggle');
+        if (toggle) {
+            toggle.addEventListener('click', () => {
+                if (typeof Collaboration !== 'undefined') {
+                    Collaboration.setRecording(!this.recording);
+                }
+            });
+        }
+
+        const list = document.getElementById('recording-list');
+        if (list) {
+            list.addEventListener('click', (e) => {
+                const item = e.target.closest('[data-recording-id]');
+                if (item) {
+                    window.open(`${window.location.pathname}?replay=${encodeURIComponent(item.dataset.recordingId)}`, '_blank');
+                }
+            });
+        }
+
+        this.refresh();
+        console.log('⏺️ Recordings Panel initialized');
+    },
+
+    /**
+     * Recording state from the server
+     * @param {{ recording: boolean, startedAt: number|null }} state
+     */
+    setState(state) {
+        const wasRecording = this.recording;
+        this.recording = state.recording;
+        this.startedAt = state.startedAt;
+
+        const toggle = document.getElementById('recording-toggle');
+        if (toggle) {
+            toggle.classList.toggle('active', this.recording);
+            toggle.textContent = this.recording ? '⏹ Stop' : '⏺ Record';
+        }
+
+        clearInterval(this._elapsedTimer);
+        this._elapsedTimer = this.recording ? setInterval(() => this._updateElapsed(), 1000) : null;
+        this._updateElapsed();
+
+        // A recording just finished: show it in the list
+        if (wasRecording && !this.recording) {
+            this.refresh();
+        }
+    },
+
+    /**
+     * Reload the list of recordings
+     */
+    async refresh() {
+        const list = document.getElementById('recording-list');
+        if (!list) return;
+        try {
+            const response = await fetch('/api/recordings');
+            const data = await response.json();
+            this._renderList(data.recordings || []);
+        } catch (error) {
+            console.warn('Could not load recordings:', error);
+        }
+    },
+
+    _renderList(recordings) {
+        const list = document.getElementById('recording-list');
+        if (recordings.length === 0) {
+            list.innerHTML = '<div class="no-students">No recordings yet</div>';
+            return;
+        }
+        list.innerHTML = recordings.map(rec => `
+            <div class="recording-item" data-recording-id="${escapeHtml(rec.id)}" title="Open replay in a new tab">
+                <span class="recording-item-date">${escapeHtml(new Date(rec.startedAt).toLocaleString())}</span>
+                <span class="recording-item-meta">${this._formatDuration(rec.duration)} · ${(rec.bytes / 1024 / 1024).toFixed(1)} MB</span>
+            </div>
+        `).join('');
+    },
+
+    _updateElapsed() {
+        const elapsed = document.getElementById('recording-elapsed');
+        if (!elapsed) return;
+        elapsed.textContent = this.recording ? `● ${this._formatDuration(Date.now() - this.startedAt)}` : '';
+    },
+
+    _formatDuration(ms) {
+        const total = Math.floor(ms / 1000);
+        const minutes = String(Math.floor(total / 60)).padStart(2, '0');
+        const seconds = String(total % 60).padStart(2, '0');
+        return `${minutes}:${seconds}`;
+    }
+};
+
+// Export for module systems if available
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = RecordingsPanel;
+}
@@ -0,0 +1,132 @@
+/**
+ * RemoteCursorLayer - Other users' cursors, batched per animation frame
+ *
+ * A class of 40 students sending cursor_update at 10 Hz used to cost one
+ * DOM update and one hide timer per message. Here:
+ * - set() only records the latest position per user; the positions are
+ *   applied together in the next animation frame
+ * - cursor elements come from a pool and go back to it when a user idles
+ * - one sweep timer hides every cursor idle for longer than idleMs
+ */
+
+class RemoteCursorLayer {
+    /**
+     * @param {HTMLElement} container - Element the layer is appended to
+     * @param {Object} options
+     * @param {Function} options.place - place(el, line, column) positions a cursor element
+     * @param {string} [options.className='visual-cursor'] - Class of the cursor elements
+     * @param {number} [options.idleMs=5000] - Hide a cursor after this long without updates
+     * @param {number} [options.sweepMs=1000] - How often idle cursors are looked for
+     */
+    constructor(container, options) {
+        this.place = options.place;
+        this.className = options.className || 'visual-cursor';
+        this.idleMs = options.idleMs || 5000;
+        this.sweepMs = options.sweepMs || 1000;
+
+        this.cursors = new Map(); // userId -> { el, line, column, updatedAt }
+        this.pending = new Map(); // userId -> { line, column } not yet on screen
+        this.pool = [];           // Hidden elements ready for reuse
+        this._frame = null;
+        this._sweepTimer = null;
+
+        this.element = document.createElement('div');
+        this.element.className = 'remote-cursor-layer';
+        container.appendChild(this.element);
+    }
+
+    /**
+     * Record a user's cursor position; drawn in the next frame
+     * @param {string} userId
+     * @param {number} line
+     * @param {number} column
+     */
+    set(userId, line, column) {
+        this.pending.set(userId, { line, column });
+        if (!this._frame) {
+            this._frame = requestAnimationFrame(() => this._flush());
+        }
+    }
+
+    /**
+     * Hide a user's cursor now (e.g. the user left)
+     * @param {string} userId
+     */
+    remove(userId) {
+        this.pending.delete(userId);
+        const cursor = this.cursors.get(userId);
+        if (cursor) this._release(userId, cursor);
+    }
+
+    /**
+     * Hide every cursor
+     */
+    clear() {
+        this.pending.clear();
+        for (const [userId, cursor] of this.cursors) {
+            this._release(userId, cursor);
+        }
+    }
+
+    /**
+     * Re-position every visible cursor (scroll, font size change)
+     */
+    refresh() {
+        for (const cursor of this.cursors.values()) {
+            this.place(cursor.el, cursor.line, cursor.column);
+        }
+    }
+
+    _flush() {
+        this._frame = null;
+        const now = Date.now();
+        for (const [userId, { line, column }] of this.pending) {
+            let cursor = this.cursors.get(userId);
+            if (!cursor) {
+                cursor = { el: this._acquire(), line, column, updatedAt: now };
+                this.cursors.set(userId, cursor);
+            }
+            cursor.line = line;
+            cursor.column = column;
+            cursor.updatedAt = now;
+            this.place(cursor.el, line, column);
+            cursor.el.style.display = 'block';
+        }
+        this.pending.clear();
+
+        if (!this._sweepTimer && this.cursors.size > 0) {
+            this._sweepTimer = setInterval(() => this._sweep(), this.sweepMs);
+        }
+    }
+
+    _sweep() {
+        const expired = Date.now() - this.idleMs;
+        for (const [userId, cursor] of this.cursors) {
+            if (cursor.updatedAt <= expired) this._release(userId, cursor);
+        }
+        if (this.cursors.size === 0) {
+            clearInterval(this._sweepTimer);
+            this._sweepTimer = null;
+        }
+    }
+
+    _acquire() {
+        const el = this.pool.pop();
+        if (el) return el;
+        const created = document.createElement('div');
+        created.className = this.className;
+        this.element.appendChild(created);
+        return created;
+    }
+
+    _release(userId, cursor) {
+        cursor.el.style.display = 'none';
+        this.pool.push(cursor.el);
+        this.cursors.delete(userId);
+    }
+}
+
+// Export for use
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = RemoteCursorLayer;
+}
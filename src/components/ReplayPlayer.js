@@ -0,0 +1,283 @@
+/**
+ * ReplayPlayer Component
+ * Plays back a recorded lesson (index.html?replay=<id>)
+ *
+ * The page runs without a live connection: recorded messages go through
+ * Collaboration.handleMessage() as if the server had just sent them, on
+ * a read-only board. Recordings are split into segments that each start
+ * with a keyframe (see server/SessionRecorder.js), so seeking loads one
+ * segment, applies its keyframe and plays the events up to the target.
+ *
+ * Dependencies:
+ * - Collaboration (handleMessage, code sync state)
+ * - GridEditor (read-only board)
+ */
+
+const ReplayPlayer = {
+    id: null,
+    duration: 0,
+    segments: [],          // [{ startMs, endMs }] from the index
+    position: 0,           // Playback time (ms since the recording started)
+    playing: false,
+    speed: 1,
+
+    _segments: new Map(),  // n -> Promise of a loaded segment
+    _assets: new Map(),    // hash -> text
+    _loaded: new Map(),    // type -> last applied "load" message (skip re-loading the same PDF)
+    _segmentNo: -1,        // Segment being played
+    _recordIndex: 0,       // Next record to apply in it
+    _timer: null,
+    _lastTick: 0,
+    _busy: false,          // A segment is loading
+
+    /**
+     * Start the replay page
+     * @param {string} id - Recording id
+     */
+    async start(id) {
+        this.id = id;
+        document.body.classList.add('is-replay');
+        if (typeof gridEditor !== 'undefined' && gridEditor) {
+            gridEditor.setReadOnly(true);
+        }
+        this._bindControls();
+
+        try {
+            const response = await fetch(`/api/recordings/${encodeURIComponent(id)}`);
+            const index = await response.json();
+            if (!index.success) throw new Error(index.error);
+            this.duration = index.duration;
+            this.segments = index.segments;
+        } catch (error) {
+            console.error('Replay load failed:', error);
+            showToast('❌ Recording not found', 'error');
+            return;
+        }
+
+        const seek = document.getElementById('replay-seek');
+        if (seek) seek.max = this.duration;
+        await this.seek(0);
+        console.log(`⏯️ Replay ${id}: ${this.segments.length} segments, ${this._formatTime(this.duration)}`);
+    },
+
+    play() {
+        if (this.playing || this.segments.length === 0) return;
+        if (this.position >= this.duration) {
+            this.seek(0);
+        }
+        this.playing = true;
+        this._lastTick = performance.now();
+        this._timer = setInterval(() => this._tick(), 50);
+        this._updateControls();
+    },
+
+    pause() {
+        this.playing = false;
+        clearInterval(this._timer);
+        this._timer = null;
+        this._updateControls();
+    },
+
+    /**
+     * Jump to a point: keyframe of its segment, then the events up to it
+     * @param {number} ms
+     */
+    async seek(ms) {
+        if (this.segments.length === 0) return;
+        ms = Math.max(0, Math.min(this.duration, ms));
+
+        let n = 0;
+        while (n + 1 < this.segments.length && this.segments[n + 1].startMs <= ms) n++;
+
+        this._busy = true;
+        let segment;
+        try {
+            segment = await this._loadSegment(n);
+        } catch (error) {
+            this._failed(error);
+            return;
+        } finally {
+            this._busy = false;
+        }
+
+        this._segmentNo = n;
+        this._recordIndex = 0;
+        this.position = ms;
+        this._applyUntil(segment, ms);
+        this._updateControls();
+    },
+
+    setSpeed(speed) {
+        this.speed = speed;
+    },
+
+    _tick() {
+        const now = performance.now();
+        const elapsed = (now - this._lastTick) * this.speed;
+        this._lastTick = now;
+        if (this._busy) return;
+
+        this.position = Math.min(this.duration, this.position + elapsed);
+        this._advance().catch(error => this._failed(error));
+        if (this.position >= this.duration) {
+            this.pause();
+        }
+        this._updateControls();
+    },
+
+    // Apply everything up to this.position, moving on to the next segments
+    async _advance() {
+        let segment = await this._segments.get(this._segmentNo);
+        this._applyUntil(segment, this.position);
+
+        while (this._recordIndex >= segment.records.length && this._segmentNo + 1 < this.segments.length &&
+               this.segments[this._segmentNo + 1].startMs <= this.position) {
+            this._busy = true;
+            try {
+                segment = await this._loadSegment(this._segmentNo + 1);
+            } finally {
+                this._busy = false;
+            }
+            this._segmentNo++;
+            // Playing on: the board already matches the keyframe
+            this._recordIndex = 1;
+            this._applyUntil(segment, this.position);
+        }
+
+        // Fetch the next segment ahead of time
+        if (this._segmentNo + 1 < this.segments.length) {
+            this._loadSegment(this._segmentNo + 1).catch(() => {});
+        }
+    },
+
+    _failed(error) {
+        console.error('Replay segment failed:', error);
+        this.pause();
+        showToast('❌ Could not load this part of the recording', 'error');
+    },
+
+    _applyUntil(segment, ms) {
+        const records = segment.records;
+        while (this._recordIndex < records.length && records[this._recordIndex].t <= ms) {
+            this._apply(records[this._recordIndex].message);
+            this._recordIndex++;
+        }
+    },
+
+    _apply(message) {
+        switch (message.type) {
+            case 'keyframe':
+                if (message.language) {
+                    this._dispatch({ type: 'language_change', language: message.language });
+                }
+                this._loadBoard(message.docId, message.code, message.version);
+                message.state.forEach(state => this._dispatch(state));
+                break;
+
+            case 'doc_activate':
+                // Recorded with the tab's text
+                this._loadBoard(message.docId, message.code, message.version);
+                break;
+
+            default:
+                this._dispatch(message);
+        }
+    },
+
+    _loadBoard(docId, code, version) {
+        Collaboration.activeWorkspace = null;
+        Collaboration.activeDocId = docId;
+        Collaboration._resetCodeSync(version);
+        Collaboration.updateEditorContent(code, false);
+        if (typeof StatusBar !== 'undefined' && StatusBar.updateLineNumbers) {
+            StatusBar.updateLineNumbers();
+        }
+    },
+
+    _dispatch(message) {
+        const resolved = {};
+        for (const [key, value] of Object.entries(message)) {
+            resolved[key] = value && typeof value === 'object' && value.asset ? this._assets.get(value.asset) : value;
+        }
+
+        // Same PDF / Markdown / language as on screen: nothing to reload
+        if (['pdf_load', 'markdown_content', 'language_change'].includes(message.type)) {
+            const key = message.type === 'language_change' ? message.language : JSON.stringify(message);
+            if (this._loaded.get(message.type) === key) return;
+            this._loaded.set(message.type, key);
+        }
+        Collaboration.handleMessage(resolved);
+    },
+
+    /**
+     * Fetch a segment and the assets it needs (cached)
+     * @param {number} n
+     * @returns {Promise<Object>}
+     */
+    _loadSegment(n) {
+        if (!this._segments.has(n)) {
+            const promise = fetch(`/api/recordings/${encodeURIComponent(this.id)}/segments/${n}`)
+                .then(response => response.json())
+                .then(async segment => {
+                    if (!segment.success) throw new Error(segment.error);
+                    await Promise.all(segment.assets
+                        .filter(hash => !this._assets.has(hash))
+                        .map(hash => fetch(`/api/recordings/${encodeURIComponent(this.id)}/assets/${hash}`)
+                            .then(response => response.text())
+                            .then(text => this._assets.set(hash, text))));
+                    return segment;
+                })
+                .catch(error => {
+                    this._segments.delete(n);
+                    throw error;
+                });
+            this._segments.set(n, promise);
+        }
+        return this._segments.get(n);
+    },
+
+    _bindControls() {
+        const bar = document.getElementById('replay-bar');
+        if (bar) bar.style.display = 'flex';
+
+        const playBtn = document.getElementById('replay-play');
+        if (playBtn) {
+            playBtn.addEventListener('click', () => this.playing ? this.pause() : this.play());
+        }
+
+        const seek = document.getElementById('replay-seek');
+        if (seek) {
+            seek.addEventListener('input', () => {
+                this.seek(Number(seek.value));
+            });
+        }
+
+        const speed = document.getElementById('replay-speed');
+        if (speed) {
+            speed.addEventListener('change', () => this.setSpeed(Number(speed.value)));
+        }
+    },
+
+    _updateControls() {
+        const playBtn = document.getElementById('replay-play');
+        if (playBtn) playBtn.textContent = this.playing ? '⏸' : '▶';
+
+        const seek = document.getElementById('replay-seek');
+        if (seek && document.activeElement !== seek) seek.value = this.position;
+
+        const time = document.getElementById('replay-time');
+        if (time) time.textContent = `${this._formatTime(this.position)} / ${this._formatTime(this.duration)}`;
+    },
+
+    _formatTime(ms) {
+        const total = Math.floor(ms / 1000);
+        const minutes = String(Math.floor(total / 60)).padStart(2, '0');
+        const seconds = String(total % 60).padStart(2, '0');
+        return `${minutes}:${seconds}`;
+    }
+};
+
+// Export for module systems if available
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = ReplayPlayer;
+}
@@ -0,0 +1,289 @@
+/**
+ * RunPanel Component
+ * Run the current C++ or GLOSSA document, with a console
+ *
+ * C++ runs in server/CppRunner.js; its output arrives in batches
+ * (run_output) and each line typed here goes to its stdin (run_input).
+ * GLOSSA runs in the browser (core/GlossaRunner.js), which reports in the
+ * same messages; its compile and runtime errors are also marked in the
+ * editor. Only shown for those two languages.
+ *
+ * Dependencies:
+ * - Collaboration (startRun / sendRunInput / stopRun)
+ * - GlossaRunner (GLOSSA programs)
+ * - LanguageManager (current language)
+ */
+
+const RunPanel = {
+    runId: null,          // Run whose events we show
+    _pending: false,      // run_start sent, id not known yet
+    running: false,
+    _glossa: null,        // GlossaRunner, created on the first GLOSSA run
+    _local: false,        // The current run is GLOSSA in this browser
+
+    // Console keeps the last MAX_OUTPUT_CHARS characters
+    MAX_OUTPUT_CHARS: 200000,
+
+    EXIT_REASONS: {
+        compile_error: '❌ Compilation failed',
+        compile_timeout: '⏱️ Compilation took too long',
+        timeout: '⏱️ Stopped: time limit',
+        cpu_limit: '⏱️ Stopped: CPU time limit',
+        output_limit: '📜 Stopped: too much output',
+        source_too_large: '📏 Program too large to compile',
+        no_sandbox: '🔒 Running C++ is disabled on this server',
+        stopped: '⏹ Stopped',
+        busy: '🚦 Server busy - try again in a moment',
+        error: '❌ Could not run the program',
+        runtime_error: '❌ Runtime error',
+        step_limit: '⏱️ Stopped: instruction limit'
+    },
+
+    /**
+     * Initialize run panel
+     */
+    init() {
+        const runBtn = document.getElementById('run-btn');
+        if (runBtn) {
+            runBtn.addEventListener('click', () => this.start());
+        }
+
+        const stopBtn = document.getElementById('run-stop-btn');
+        if (stopBtn) {
+            stopBtn.addEventListener('click', () => {
+                if (this._local) {
+                    this._glossa.stop();
+                } else if (this.runId && typeof Collaboration !== 'undefined') {
+                    Collaboration.stopRun(this.runId);
+                }
+            });
+        }
+
+        const closeBtn = document.getElementById('run-close-btn');
+        if (closeBtn) {
+            closeBtn.addEventListener('click', () => this.hide());
+        }
+
+        const input = document.getElementById('run-input');
+        if (input) {
+            input.addEventListener('keydown', (e) => this._onInputKey(e, input));
+        }
+
+        window.addEventListener('languageChanged', () => this._updateRunButton());
+        this._updateRunButton();
+        console.log('▶️ Run Panel initialized');
+    },
+
+    /**
+     * Run the document the editor is on
+     */
+    start() {
+        if (typeof LanguageManager !== 'undefined' && LanguageManager.getCurrentLanguage() === 'glossa') {
+            this._startGlossa();
+            return;
+        }
+        if (typeof Collaboration === 'undefined' || !Collaboration.connected) {
+            showToast('⚠️ Not connected to the server', 'warning');
+            return;
+        }
+        this.show();
+        document.getElementById('run-output').textContent = '';
+        this.runId = null;
+        this._pending = true;
+        this._setRunning(false);
+        this._setStatus('⏳ Starting…');
+        this._local = false;
+        Collaboration.startRun();
+    },
+
+    // GLOSSA compiles and runs here; no server needed
+    _startGlossa() {
+        if (!this._glossa && typeof GlossaRunner !== 'undefined') {
+            this._glossa = GlossaRunner.create(message => this._onGlossaMessage(message));
+        }
+        if (!this._glossa) {
+            showToast('⚠️ Running GLOSSA needs Web Workers', 'warning');
+            return;
+        }
+        this.show();
+        document.getElementById('run-output').textContent = '';
+        this._setRunning(false);
+        this._setStatus('🔨 Compiling…');
+        if (typeof gridEditor !== 'undefined' && gridEditor) gridEditor.clearDiagnostics();
+
+        const runId = this._glossa.run(gridEditor.getValue());
+        if (!runId) {
+            this._setStatus(this.EXIT_REASONS.error);
+            return;
+        }
+        this.runId = runId;
+        this._pending = false;
+        this._local = true;
+    },
+
+    _onGlossaMessage(message) {
+        if (message.type === 'run_status') {
+            this.handleStatus(message);
+        } else if (message.type === 'run_output') {
+            this.handleOutput(message);
+        } else if (message.type === 'run_exit') {
+            this.handleExit(message);
+        }
+    },
+
+    show() {
+        const panel = document.getElementById('run-panel');
+        if (panel) panel.style.display = 'flex';
+    },
+
+    hide() {
+        const panel = document.getElementById('run-panel');
+        if (panel) panel.style.display = 'none';
+    },
+
+    /**
+     * run_status: queued / compiling / running
+     */
+    handleStatus(message) {
+        if (!this._accept(message)) return;
+        if (message.state === 'queued') {
+            this._setStatus(`⏳ Queued (#${message.position})`);
+        } else if (message.state === 'compiling') {
+            this._setStatus('🔨 Compiling…');
+        } else if (message.state === 'running') {
+            this._setStatus('▶ Running');
+            this._setRunning(true);
+            const input = document.getElementById('run-input');
+            if (input) input.focus();
+        }
+    },
+
+    /**
+     * run_output: a batch of stdout / stderr
+     */
+    handleOutput(message) {
+        if (!this._accept(message)) return;
+        this._append(message.data, message.stream === 'stderr' ? 'run-stderr' : null);
+    },
+
+    /**
+     * run_exit: finished, failed to compile, or stopped
+     */
+    handleExit(message) {
+        if (!this._accept(message)) return;
+        this._pending = false;
+        this._setRunning(false);
+
+        if (message.compileError) {
+            this._append(message.compileError, 'run-stderr');
+        }
+        // GLOSSA errors come with their line; mark it in the editor too
+        const errors = message.errors || (message.error ? [message.error] : []);
+        errors.forEach(error => this._append(`Γραμμή ${error.row + 1}: ${error.message}\n`, 'run-stderr'));
+        if (errors.length > 0 && typeof gridEditor !== 'undefined' && gridEditor) {
+            gridEditor.setDiagnostics(errors.map(error => ({ row: error.row, col: error.col || 0, severity: 'error', message: error.message })));
+        }
+
+        let status = this.EXIT_REASONS[message.reason];
+        if (!status) {
+            const seconds = (message.timeMs / 1000).toFixed(1);
+            status = message.signal
+                ? `💥 Terminated (${message.signal}) after ${seconds} s`
+                : `${message.exitCode === 0 ? '✔' : '⚠️'} Exited with code ${message.exitCode} (${seconds} s)`;
+        }
+        if (message.steps) {
+            status += ` · ${this._formatSteps(message.steps)} instructions`;
+        }
+        this._setStatus(status);
+    },
+
+    _formatSteps(steps) {
+        if (steps >= 1e9) return `${(steps / 1e9).toFixed(1)}G`;
+        if (steps >= 1e6) return `${(steps / 1e6).toFixed(1)}M`;
+        if (steps >= 1e3) return `${(steps / 1e3).toFixed(1)}k`;
+        return String(steps);
+    },
+
+    // Events of an older run (replaced by a new Run click) are dropped
+    _accept(message) {
+        if (this._pending && this.runId === null) {
+            this.runId = message.runId;
+        }
+        return message.runId === this.runId;
+    },
+
+    _onInputKey(e, input) {
+        if (!this.running) return;
+        if (!this._local && typeof Collaboration === 'undefined') return;
+        if (e.key === 'Enter') {
+            e.preventDefault();
+            const line = input.value;
+            input.value = '';
+            this._append(`${line}\n`, 'run-echo');
+            if (this._local) {
+                this._glossa.sendInput(`${line}\n`);
+            } else {
+                Collaboration.sendRunInput(this.runId, `${line}\n`);
+            }
+        } else if (e.key === 'd' && e.ctrlKey) {
+            // End of input, like Ctrl+D in a terminal
+            e.preventDefault();
+            if (this._local) {
+                this._glossa.sendEof();
+            } else {
+                Collaboration.sendRunEof(this.runId);
+            }
+        }
+    },
+
+    _append(text, className) {
+        const output = document.getElementById('run-output');
+        if (!output) return;
+
+        const atBottom = output.scrollHeight - output.scrollTop - output.clientHeight < 20;
+        if (className) {
+            const span = document.createElement('span');
+            span.className = className;
+            span.textContent = text;
+            output.appendChild(span);
+        } else {
+            output.appendChild(document.createTextNode(text));
+        }
+
+        // Drop the oldest output beyond the limit
+        let excess = output.textContent.length - this.MAX_OUTPUT_CHARS;
+        while (excess > 0 && output.firstChild) {
+            const length = output.firstChild.textContent.length;
+            output.removeChild(output.firstChild);
+            excess -= length;
+        }
+        if (atBottom) {
+            output.scrollTop = output.scrollHeight;
+        }
+    },
+
+    _setStatus(text) {
+        const status = document.getElementById('run-status');
+        if (status) status.textContent = text;
+    },
+
+    _setRunning(running) {
+        this.running = running;
+        const input = document.getElementById('run-input');
+        if (input) input.disabled = !running;
+        const stopBtn = document.getElementById('run-stop-btn');
+        if (stopBtn) stopBtn.disabled = !running && !this._pending;
+    },
+
+    _updateRunButton() {
+        const runBtn = document.getElementById('run-btn');
+        if (!runBtn || typeof LanguageManager === 'undefined') return;
+        const language = LanguageManager.getCurrentLanguage();
+        runBtn.style.display = language === 'cpp' || language === 'glossa' ? '' : 'none';
+    }
+};
+
+// Export for module systems if available
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = RunPanel;
+}
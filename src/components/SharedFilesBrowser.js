@@ -32,6 +32,9 @@ const SharedFilesBrowser = {
     // Navigation path stack
     navigationPath: [],
     
+    // VirtualList over #shared-list (folders, or the open folder's files)
+    _list: null,
+    
     // Notification badge element
     notificationBadge: null,
     
@@ -573,53 +576,19 @@ const SharedFilesBrowser = {
             return;
         }
         
-        if (this.sharedFolders.length === 0) {
-            // Show empty state
-            const emptyText = 'No files shared yet';
-            const emptyHint = 'Click "Upload File(s)" or drag & drop';
-            
-            listContainer.innerHTML = `
-                <div class="empty-state">
-                    <span class="empty-icon">📭</span>
-                    <span class="empty-text">${emptyText}</span>
-                    <span class="empty-hint">${emptyHint}</span>
-                </div>
-            `;
-        } else {
-            // Get current user name to check if they uploaded the file
-            const currentUser = this._getCurrentUserName();
-            
-            // Render files with uploader info and download button (only for files NOT uploaded by current user)
-            listContainer.innerHTML = this.sharedFolders.map(folder => {
-                const icon = folder.isFolder === false ? this._getFileIcon(folder.name) : '📁';
-                const typeLabel = folder.isFolder === false ? '1 file' : `${folder.fileCount} files`;
-                
-                // Only show download button if current user is NOT the uploader
-                const isOwnUpload = folder.uploadedBy === currentUser;
-                const downloadBtn = isOwnUpload ? '' : `
-                    <button class="folder-download-btn" data-folder="${folder.name}" title="Download${folder.isFolder === false ? '' : ' as ZIP'}">
-                        <span>⬇️</span>
-                    </button>
-                `;
-                
-                return `
-                <div class="file-item folder-item ${folder.isFolder === false ? 'single-file-item' : ''} ${isOwnUpload ? 'own-upload' : ''}" data-folder="${folder.name}">
-                    <span class="file-icon">${icon}</span>
-                    <div class="folder-info">
-                        <span class="file-name">${folder.name}</span>
-                        <span class="folder-meta">
-                            <span class="file-count">${typeLabel}</span>
-                            ${folder.uploadedBy ? `<span class="uploaded-by">${isOwnUpload ? '(your upload)' : 'by ' + folder.uploadedBy}</span>` : ''}
-                        </span>
-                    </div>
-                    ${downloadBtn}
-                </div>
-            `}).join('');
-            
-            // Attach click handlers
-            this._attachFolderClickHandlers();
-            this._attachDownloadButtonHandlers();
-        }
+        // Show empty state
+        const emptyText = 'No files shared yet';
+        const emptyHint = 'Click "Upload File(s)" or drag & drop';
+        const empty = `
+            <div class="empty-state">
+                <span class="empty-icon">📭</span>
+                <span class="empty-text">${emptyText}</span>
+                <span class="empty-hint">${emptyHint}</span>
+            </div>
+        `;
+        
+        // Files with uploader info and download button (only for files NOT uploaded by current user)
+        this._getList(listContainer).setItems(this.sharedFolders, { empty });
         
         // Update count
         if (countEl) {
@@ -628,38 +597,69 @@ const SharedFilesBrowser = {
     },
     
     /**
-     * Attach click handlers to folder items
+     * Virtualized list over #shared-list (recreated if render() replaced the element).
+     * Shows shared folders, or the files of currentFolder; clicks are delegated.
      */
-    _attachFolderClickHandlers() {
-        const listContainer = document.getElementById('shared-list');
-        if (!listContainer) return;
+    _getList(listContainer) {
+        if (this._list && this._list.container === listContainer) return this._list;
         
-        listContainer.querySelectorAll('.folder-item').forEach(item => {
-            // Only attach click to the folder info area, not the download button
-            item.addEventListener('click', (e) => {
-                // Don't navigate if clicking on download button
-                if (e.target.closest('.folder-download-btn')) return;
-                
-                const folderName = item.dataset.folder;
-                this._openFolder(folderName);
-            });
+        this._list = new VirtualList(listContainer, {
+            key: entry => this.currentFolder ? `file:${entry.path || entry.name}` : `folder:${entry.name}`,
+            render: entry => this.currentFolder ? this._renderFileItem(entry) : this._renderFolderItem(entry),
+            onClick: (entry, e) => {
+                if (this.currentFolder) {
+                    this._openFile(`${this.currentFolder.name}/${entry.path}`, entry.name);
+                } else if (e.target.closest('.folder-download-btn')) {
+                    this._downloadFolder(entry.name);
+                } else {
+                    this._openFolder(entry.name);
+                }
+            }
+        });
+        
+        // Back button lives in the list header
+        listContainer.addEventListener('click', (e) => {
+            if (e.target.closest('#nav-back-btn')) this._navigateBack();
         });
+        return this._list;
     },
     
-    /**
-     * Attach click handlers to download buttons
-     */
-    _attachDownloadButtonHandlers() {
-        const listContainer = document.getElementById('shared-list');
-        if (!listContainer) return;
+    _renderFolderItem(folder) {
+        const currentUser = this._getCurrentUserName();
+        const icon = folder.isFolder === false ? this._getFileIcon(folder.name) : '📁';
+        const typeLabel = folder.isFolder === false ? '1 file' : `${folder.fileCount} files`;
+        
+        // Only show download button if current user is NOT the uploader
+        const isOwnUpload = folder.uploadedBy === currentUser;
+        const downloadBtn = isOwnUpload ? '' : `
+            <button class="folder-download-btn" data-folder="${folder.name}" title="Download${folder.isFolder === false ? '' : ' as ZIP'}">
+                <span>⬇️</span>
+            </button>
+        `;
         
-        listContainer.querySelectorAll('.folder-download-btn').forEach(btn => {
-            btn.addEventListener('click', (e) => {
-                e.stopPropagation(); // Prevent folder navigation
-                const folderName = btn.dataset.folder;
-                this._downloadFolder(folderName);
-            });
-        });
+        return `
+            <div class="file-item folder-item ${folder.isFolder === false ? 'single-file-item' : ''} ${isOwnUpload ? 'own-upload' : ''}" data-folder="${folder.name}">
+                <span class="file-icon">${icon}</span>
+                <div class="folder-info">
+                    <span class="file-name">${folder.name}</span>
+                    <span class="folder-meta">
+                        <span class="file-count">${typeLabel}</span>
+                        ${folder.uploadedBy ? `<span class="uploaded-by">${isOwnUpload ? '(your upload)' : 'by ' + folder.uploadedBy}</span>` : ''}
+                    </span>
+                </div>
+                ${downloadBtn}
+            </div>
+        `;
+    },
+    
+    _renderFileItem(file) {
+        return `
+            <div class="file-item shared-file-item" data-path="${this.currentFolder.name}/${file.path}" data-name="${file.name}">
+                <span class="file-icon">${this._getFileIcon(file.name)}</span>
+                <span class="file-name">${file.path || file.name}</span>
+                <span class="file-size">${this._formatFileSize(file.size)}</span>
+            </div>
+        `;
     },
     
     /**
@@ -759,8 +759,8 @@ const SharedFilesBrowser = {
         
         const files = this.currentFolder.files || [];
         
-        // Build navigation header with back button
-        let html = `
+        // Navigation header with back button
+        const header = `
             <div class="folder-nav">
                 <button class="nav-back-btn" id="nav-back-btn" title="Go back">
                     <span>◀</span>
@@ -768,46 +768,19 @@ const SharedFilesBrowser = {
                 <span class="nav-path">📁 ${this.navigationPath.join(' / ')}</span>
             </div>
         `;
+        const empty = `
+            <div class="empty-state">
+                <span class="empty-icon">📭</span>
+                <span class="empty-text">Empty folder</span>
+            </div>
+        `;
         
-        if (files.length === 0) {
-            html += `
-                <div class="empty-state">
-                    <span class="empty-icon">📭</span>
-                    <span class="empty-text">Empty folder</span>
-                </div>
-            `;
-        } else {
-            html += files.map(file => `
-                <div class="file-item shared-file-item" data-path="${this.currentFolder.name}/${file.path}" data-name="${file.name}">
-                    <span class="file-icon">${this._getFileIcon(file.name)}</span>
-                    <span class="file-name">${file.path || file.name}</span>
-                    <span class="file-size">${this._formatFileSize(file.size)}</span>
-                </div>
-            `).join('');
-        }
-        
-        listContainer.innerHTML = html;
+        this._getList(listContainer).setItems(files, { header, empty });
         
         // Update count
         if (countEl) {
             countEl.textContent = files.length;
         }
-        
-        // Attach handlers
-        this._attachBackButtonHandler();
-        this._attachFileClickHandlers();
-    },
-    
-    /**
-     * Attach click handler to back button
-     */
-    _attachBackButtonHandler() {
-        const backBtn = document.getElementById('nav-back-btn');
-        if (backBtn) {
-            backBtn.addEventListener('click', () => {
-                this._navigateBack();
-            });
-        }
     },
     
     /**
@@ -819,22 +792,6 @@ const SharedFilesBrowser = {
         this._renderFolderList();
     },
     
-    /**
-     * Attach click handlers to file items
-     */
-    _attachFileClickHandlers() {
-        const listContainer = document.getElementById('shared-list');
-        if (!listContainer) return;
-        
-        listContainer.querySelectorAll('.shared-file-item').forEach(item => {
-            item.addEventListener('click', () => {
-                const filePath = item.dataset.path;
-                const fileName = item.dataset.name;
-                this._openFile(filePath, fileName);
-            });
-        });
-    },
-    
     /**
      * Open a file (load into editor or handle appropriately)
      * @param {string} filePath - Path to file
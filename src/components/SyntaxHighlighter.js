@@ -1,6 +1,13 @@
 /**
  * SyntaxHighlighter - Multi-language syntax highlighting for GridEditor
  * Supports GLOSSA, Python, C++, and Java
+ *
+ * Tokenizing is done by the table-driven lexers that LexerCompiler builds
+ * from each language pack, so the grid and the HTML view color code the
+ * same way. Lines take the state left open by the previous line
+ * (block comment, raw string, triple-quoted string) and return the state
+ * they leave open, so constructs spanning lines are colored correctly and
+ * HighlightCache can re-tokenize only the lines an edit affects.
  */
 
 class SyntaxHighlighter {
@@ -13,621 +20,202 @@ class SyntaxHighlighter {
      */
     static highlight(lines, language = 'glossa') {
         const result = [];
+        let state = SyntaxHighlighter.STATE_NORMAL;
         
         for (let row = 0; row < lines.length; row++) {
             const line = lines[row];
             const lineClasses = new Array(line.length).fill('');
-            
-            // Language-specific highlighting
-            if (language === 'glossa') {
-                this.highlightGlossaLine(line, lineClasses);
-            } else if (language === 'python') {
-                this.highlightPythonLine(line, lineClasses);
-            } else if (language === 'cpp') {
-                this.highlightCppLine(line, lineClasses);
-            } else if (language === 'java') {
-                this.highlightJavaLine(line, lineClasses);
-            }
-            
+            state = this.highlightLine(line, lineClasses, language, state);
             result.push(lineClasses);
         }
         
         return result;
     }
     
-    // ============================================
-    // GLOSSA HIGHLIGHTING
-    // ============================================
-    
-    static highlightGlossaLine(line, lineClasses) {
-        // Check for comment (! anywhere in line)
-        const commentIndex = line.indexOf('!');
-        if (commentIndex !== -1) {
-            // Everything from ! to end is comment
-            for (let i = commentIndex; i < line.length; i++) {
-                lineClasses[i] = 'syntax-comment';
-            }
-            // Only highlight the part before the comment
-            if (commentIndex === 0) return;
-            line = line.substring(0, commentIndex);
-        }
-        
-        // Use detailed GLOSSA highlighting logic
-        this.highlightGlossaTokens(line, lineClasses);
+    /**
+     * Highlight a single line
+     * @param {string} line - Line text
+     * @param {string[]} lineClasses - Output, one class per character (pre-filled with '')
+     * @param {string} language - Language code
+     * @param {string} state - State left open by the previous line
+     * @returns {string} State left open by this line
+     */
+    static highlightLine(line, lineClasses, language, state = SyntaxHighlighter.STATE_NORMAL) {
+        const lexer = this.getLexer(language);
+        if (!lexer) return SyntaxHighlighter.STATE_NORMAL;
+        return lexer.tokenizeLine(line, lineClasses, state);
     }
     
-    static highlightGlossaTokens(line, lineClasses) {
-        // Original GLOSSA highlighting logic
-        if (typeof GLOSSA_KEYWORDS === 'undefined') return;
-        
-        let pos = 0;
-        
-        while (pos < line.length) {
-            // Skip whitespace
-            if (/\s/.test(line[pos])) {
-                pos++;
-                continue;
-            }
-            
-            // Check for string (single quotes)
-            if (line[pos] === "'") {
-                const start = pos;
-                pos++;
-                while (pos < line.length && line[pos] !== "'") {
-                    pos++;
-                }
-                if (pos < line.length) pos++; // Include closing quote
-                for (let i = start; i < pos; i++) {
-                    lineClasses[i] = 'syntax-string';
-                }
-                continue;
-            }
-            
-            // Check for number
-            if (/\d/.test(line[pos])) {
-                const start = pos;
-                while (pos < line.length && /[\d.]/.test(line[pos])) {
-                    pos++;
-                }
-                for (let i = start; i < pos; i++) {
-                    lineClasses[i] = 'syntax-number';
-                }
-                continue;
-            }
-            
-            // Check for operators
-            const twoChar = line.substring(pos, pos + 2);
-            if (twoChar === '<-' || twoChar === '<>' || twoChar === '<=' || twoChar === '>=') {
-                lineClasses[pos] = 'syntax-operator';
-                lineClasses[pos + 1] = 'syntax-operator';
-                pos += 2;
-                continue;
-            }
-            
-            if ('+-*/^=<>'.includes(line[pos])) {
-                lineClasses[pos] = 'syntax-operator';
-                pos++;
-                continue;
-            }
-            
-            // Check for brackets
-            if ('[]()'.includes(line[pos])) {
-                lineClasses[pos] = 'syntax-bracket';
-                pos++;
-                continue;
-            }
-            
-            // Check for punctuation
-            if (':,'.includes(line[pos])) {
-                lineClasses[pos] = 'syntax-punctuation';
-                pos++;
-                continue;
-            }
-            
-            // Check for word (identifier or keyword)
-            if (/[α-ωά-ώΑ-ΩΆ-Ώa-zA-Z_]/.test(line[pos])) {
-                const start = pos;
-                while (pos < line.length && /[α-ωά-ώΑ-ΩΆ-Ώa-zA-Z0-9_]/.test(line[pos])) {
-                    pos++;
-                }
-                const word = line.substring(start, pos);
-                const syntaxClass = this.getGlossaKeywordClass(word);
-                
-                if (syntaxClass) {
-                    for (let i = start; i < pos; i++) {
-                        lineClasses[i] = syntaxClass;
-                    }
-                }
-                continue;
-            }
-            
-            // Skip unknown character
-            pos++;
-        }
+    /**
+     * Compiled lexer of a language pack (see LexerCompiler), or null while
+     * the pack is still loading
+     * @param {string} language - Language code
+     * @returns {Object|null}
+     */
+    static getLexer(language) {
+        const namespace = SyntaxHighlighter.LANGUAGE_NAMESPACES[language];
+        const pack = namespace && typeof window !== 'undefined' && window.Languages
+            ? window.Languages[namespace]
+            : null;
+        return (pack && pack.syntax && pack.syntax.lexer) || null;
     }
-    
-    static getGlossaKeywordClass(word) {
-        const upperWord = word.toUpperCase();
-        
-        // Structure keywords
-        if (GLOSSA_KEYWORDS.structure?.includes(upperWord) || 
-            GLOSSA_KEYWORDS.structure?.includes(word)) {
-            return 'syntax-keyword';
-        }
-        
-        // Algorithm keywords
-        if (GLOSSA_KEYWORDS.algorithm?.some(k => k.toUpperCase() === upperWord)) {
-            return 'syntax-keyword';
-        }
-        
-        // Control flow - IF
-        if (GLOSSA_KEYWORDS.ifStatement?.includes(upperWord) ||
-            GLOSSA_KEYWORDS.ifStatement?.includes(word)) {
-            return 'syntax-control';
-        }
-        
-        // Control flow - SELECT
-        if (GLOSSA_KEYWORDS.selectStatement?.includes(upperWord) ||
-            GLOSSA_KEYWORDS.selectStatement?.includes(word)) {
-            return 'syntax-control';
-        }
-        
-        // Control flow - FOR
-        if (GLOSSA_KEYWORDS.forLoop?.includes(upperWord) ||
-            GLOSSA_KEYWORDS.forLoop?.includes(word)) {
-            return 'syntax-control';
-        }
-        
-        // Control flow - WHILE
-        if (GLOSSA_KEYWORDS.whileLoop?.includes(upperWord) ||
-            GLOSSA_KEYWORDS.whileLoop?.includes(word)) {
-            return 'syntax-control';
-        }
-        
-        // Control flow - DO-WHILE
-        if (GLOSSA_KEYWORDS.doWhileLoop?.includes(upperWord) ||
-            GLOSSA_KEYWORDS.doWhileLoop?.includes(word)) {
-            return 'syntax-control';
-        }
-        
-        // I/O
-        if (GLOSSA_KEYWORDS.io?.includes(upperWord) ||
-            GLOSSA_KEYWORDS.io?.includes(word)) {
-            return 'syntax-io';
-        }
-        
-        // Types - Declaration
-        if (GLOSSA_KEYWORDS.typesDeclaration?.includes(upperWord) ||
-            GLOSSA_KEYWORDS.typesDeclaration?.includes(word)) {
-            return 'syntax-type';
-        }
-        
-        // Types - Return
-        if (GLOSSA_KEYWORDS.typesReturn?.includes(upperWord) ||
-            GLOSSA_KEYWORDS.typesReturn?.includes(word)) {
-            return 'syntax-type';
-        }
-        
-        // Boolean literals
-        if (GLOSSA_KEYWORDS.booleanLiterals?.includes(upperWord) ||
-            GLOSSA_KEYWORDS.booleanLiterals?.includes(word)) {
-            return 'syntax-logical';
-        }
-        
-        // Logical operators
-        if (GLOSSA_KEYWORDS.logicalOperators?.includes(upperWord) ||
-            GLOSSA_KEYWORDS.logicalOperators?.includes(word)) {
-            return 'syntax-logical';
-        }
-        
-        // Arithmetic operators (DIV, MOD)
-        if (GLOSSA_KEYWORDS.arithmeticOperators?.includes(upperWord) ||
-            GLOSSA_KEYWORDS.arithmeticOperators?.includes(word)) {
-            return 'syntax-logical';
-        }
-        
-        // Subprograms
-        if (GLOSSA_KEYWORDS.subprograms?.includes(upperWord) ||
-            GLOSSA_KEYWORDS.subprograms?.includes(word)) {
-            return 'syntax-keyword';
-        }
-        
-        // Built-in functions
-        if (GLOSSA_KEYWORDS.builtinFunctions?.includes(word) ||
-            GLOSSA_KEYWORDS.builtinFunctions?.includes(upperWord)) {
-            return 'syntax-function';
-        }
-        
-        return null;
+}
+
+// Language code -> window.Languages namespace
+SyntaxHighlighter.LANGUAGE_NAMESPACES = {
+    glossa: 'Glossa',
+    python: 'Python',
+    cpp: 'Cpp',
+    java: 'Java'
+};
+
+// Line states carried from one line to the next (values shared with LexerCompiler)
+SyntaxHighlighter.STATE_NORMAL = LexerCompiler.STATE_NORMAL;
+SyntaxHighlighter.STATE_BLOCK_COMMENT = LexerCompiler.STATE_BLOCK_COMMENT;
+SyntaxHighlighter.STATE_TEXT_BLOCK = '"""';   // Java text block
+SyntaxHighlighter.STATE_RAW_STRING = LexerCompiler.STATE_RAW_STRING; // C++ raw string, followed by its delimiter
+// Python triple-quoted strings use the quote itself (''' or """) as the state
+
+// ============================================
+// INCREMENTAL HIGHLIGHTING
+// ============================================
+
+/**
+ * Per-line highlight cache bound to a TextBuffer.
+ *
+ * Each line keeps its text, the state it was entered with, the state it
+ * left open and its class array. Buffer edits only invalidate the touched
+ * lines; highlight() re-tokenizes from the first invalid line and stops as
+ * soon as a line is unchanged and entered with the same state as before,
+ * because every line after it must then be unchanged too.
+ */
+class HighlightCache {
+    /**
+     * @param {TextBuffer} buffer - Document to highlight
+     */
+    constructor(buffer) {
+        this.buffer = buffer;
+        this.language = null;
+        this.lineText = [];
+        this.entryState = [];
+        this.exitState = [];
+        this.classes = [];
+        this.dirtyFrom = 0;        // First row that must be re-checked
+        this.dirtyTo = 0;          // Rows below this only need the convergence check
+        this.tokenizedLines = 0;   // Lines tokenized by the last highlight() (diagnostics)
+        this.updatedFrom = 0;      // Rows re-tokenized by the last highlight()
+        this.updatedTo = 0;        // lie in [updatedFrom, updatedTo)
+        
+        this._unsubscribe = buffer.onChange(change => this._onBufferChange(change));
     }
     
-    // ============================================
-    // PYTHON HIGHLIGHTING
-    // ============================================
-    
-    static highlightPythonLine(line, lineClasses) {
-        let pos = 0;
-        
-        // Check for comment (# to end of line)
-        const commentIndex = line.indexOf('#');
-        const lineEnd = commentIndex !== -1 ? commentIndex : line.length;
-        
-        if (commentIndex !== -1) {
-            for (let i = commentIndex; i < line.length; i++) {
-                lineClasses[i] = 'syntax-comment';
-            }
-        }
-        
-        while (pos < lineEnd) {
-            // Skip whitespace
-            if (/\s/.test(line[pos])) {
-                pos++;
-                continue;
-            }
-            
-            // Check for triple-quoted string
-            if (line.substring(pos, pos + 3) === '"""' || line.substring(pos, pos + 3) === "'''") {
-                const quote = line.substring(pos, pos + 3);
-                const start = pos;
-                pos += 3;
-                const end = line.indexOf(quote, pos);
-                if (end !== -1) {
-                    pos = end + 3;
-                } else {
-                    pos = line.length;
-                }
-                for (let i = start; i < pos && i < lineEnd; i++) {
-                    lineClasses[i] = 'syntax-string';
-                }
-                continue;
-            }
-            
-            // Check for string (single or double quotes)
-            if (line[pos] === '"' || line[pos] === "'") {
-                const quote = line[pos];
-                const start = pos;
-                pos++;
-                while (pos < lineEnd && line[pos] !== quote) {
-                    if (line[pos] === '\\') pos++; // Skip escaped char
-                    pos++;
-                }
-                if (pos < lineEnd) pos++; // Include closing quote
-                for (let i = start; i < pos; i++) {
-                    lineClasses[i] = 'syntax-string';
-                }
-                continue;
-            }
-            
-            // Check for number
-            if (/\d/.test(line[pos])) {
-                const start = pos;
-                while (pos < lineEnd && /[\d.eE+-]/.test(line[pos])) {
-                    pos++;
-                }
-                for (let i = start; i < pos; i++) {
-                    lineClasses[i] = 'syntax-number';
-                }
-                continue;
-            }
-            
-            // Check for decorator
-            if (line[pos] === '@') {
-                const start = pos;
-                pos++;
-                while (pos < lineEnd && /[a-zA-Z0-9_]/.test(line[pos])) {
-                    pos++;
-                }
-                for (let i = start; i < pos; i++) {
-                    lineClasses[i] = 'syntax-decorator';
-                }
-                continue;
-            }
-            
-            // Check for word (identifier or keyword)
-            if (/[a-zA-Z_]/.test(line[pos])) {
-                const start = pos;
-                while (pos < lineEnd && /[a-zA-Z0-9_]/.test(line[pos])) {
-                    pos++;
-                }
-                const word = line.substring(start, pos);
-                const syntaxClass = this.getPythonKeywordClass(word);
-                
-                if (syntaxClass) {
-                    for (let i = start; i < pos; i++) {
-                        lineClasses[i] = syntaxClass;
-                    }
-                }
-                continue;
-            }
-            
-            // Check for operators
-            if ('+-*/%=<>!&|^~'.includes(line[pos])) {
-                lineClasses[pos] = 'syntax-operator';
-                pos++;
-                continue;
-            }
-            
-            // Skip unknown character
-            pos++;
-        }
+    /**
+     * Drop everything (e.g. keyword lists finished loading)
+     */
+    invalidate() {
+        this.language = null;
     }
     
-    static getPythonKeywordClass(word) {
-        const keywords = ['if', 'elif', 'else', 'for', 'while', 'break', 'continue', 'pass',
-            'match', 'case', 'try', 'except', 'finally', 'raise', 'with', 'as',
-            'def', 'return', 'yield', 'lambda', 'class', 'import', 'from',
-            'and', 'or', 'not', 'in', 'is', 'global', 'nonlocal', 'del', 'assert'];
-        const values = ['True', 'False', 'None'];
-        const builtins = ['print', 'input', 'len', 'range', 'str', 'int', 'float', 'list',
-            'dict', 'set', 'tuple', 'bool', 'type', 'open', 'abs', 'max', 'min', 'sum', 'sorted'];
-        
-        if (keywords.includes(word)) return 'syntax-keyword';
-        if (values.includes(word)) return 'syntax-logical';
-        if (builtins.includes(word)) return 'syntax-builtin';
-        if (word === 'self') return 'syntax-self';
-        return '';
+    /**
+     * Detach from the buffer
+     */
+    dispose() {
+        if (this._unsubscribe) this._unsubscribe();
     }
     
-    // ============================================
-    // C++ HIGHLIGHTING
-    // ============================================
-    
-    static highlightCppLine(line, lineClasses) {
-        let pos = 0;
+    _onBufferChange(change) {
+        const { startRow, removedLines, insertedLines } = change;
         
-        // Check for single-line comment
-        const commentIndex = line.indexOf('//');
-        const lineEnd = commentIndex !== -1 ? commentIndex : line.length;
+        this.lineText = HighlightCache._spliceEmpty(this.lineText, startRow, removedLines, insertedLines);
+        this.entryState = HighlightCache._spliceEmpty(this.entryState, startRow, removedLines, insertedLines);
+        this.exitState = HighlightCache._spliceEmpty(this.exitState, startRow, removedLines, insertedLines);
+        this.classes = HighlightCache._spliceEmpty(this.classes, startRow, removedLines, insertedLines);
         
-        if (commentIndex !== -1) {
-            for (let i = commentIndex; i < line.length; i++) {
-                lineClasses[i] = 'syntax-comment';
-            }
-        }
-        
-        // Check for preprocessor directive
-        const trimmed = line.trimStart();
-        if (trimmed.startsWith('#')) {
-            for (let i = 0; i < line.length; i++) {
-                lineClasses[i] = 'syntax-preprocessor';
-            }
+        if (this.dirtyFrom >= this.dirtyTo) {
+            this.dirtyFrom = startRow;
+            this.dirtyTo = startRow + insertedLines;
             return;
         }
         
-        while (pos < lineEnd) {
-            // Skip whitespace
-            if (/\s/.test(line[pos])) {
-                pos++;
-                continue;
-            }
-            
-            // Check for string
-            if (line[pos] === '"') {
-                const start = pos;
-                pos++;
-                while (pos < lineEnd && line[pos] !== '"') {
-                    if (line[pos] === '\\') pos++;
-                    pos++;
-                }
-                if (pos < lineEnd) pos++;
-                for (let i = start; i < pos; i++) {
-                    lineClasses[i] = 'syntax-string';
-                }
-                continue;
-            }
-            
-            // Check for char literal
-            if (line[pos] === "'") {
-                const start = pos;
-                pos++;
-                while (pos < lineEnd && line[pos] !== "'") {
-                    if (line[pos] === '\\') pos++;
-                    pos++;
-                }
-                if (pos < lineEnd) pos++;
-                for (let i = start; i < pos; i++) {
-                    lineClasses[i] = 'syntax-string';
-                }
-                continue;
-            }
-            
-            // Check for number
-            if (/\d/.test(line[pos])) {
-                const start = pos;
-                while (pos < lineEnd && /[\d.xXeEfFlLuU]/.test(line[pos])) {
-                    pos++;
-                }
-                for (let i = start; i < pos; i++) {
-                    lineClasses[i] = 'syntax-number';
-                }
-                continue;
-            }
-            
-            // Check for word (identifier or keyword)
-            if (/[a-zA-Z_]/.test(line[pos])) {
-                const start = pos;
-                while (pos < lineEnd && /[a-zA-Z0-9_]/.test(line[pos])) {
-                    pos++;
-                }
-                const word = line.substring(start, pos);
-                const syntaxClass = this.getCppKeywordClass(word);
-                
-                if (syntaxClass) {
-                    for (let i = start; i < pos; i++) {
-                        lineClasses[i] = syntaxClass;
-                    }
-                }
-                continue;
-            }
-            
-            // Check for operators
-            if ('+-*/%=<>!&|^~?:'.includes(line[pos])) {
-                lineClasses[pos] = 'syntax-operator';
-                pos++;
-                continue;
-            }
-            
-            // Skip unknown character
-            pos++;
+        // Merge with the range still pending from earlier edits (shifted by this one)
+        if (this.dirtyTo > startRow) {
+            this.dirtyTo = Math.max(startRow, this.dirtyTo - removedLines + insertedLines);
         }
+        this.dirtyFrom = Math.min(this.dirtyFrom, startRow);
+        this.dirtyTo = Math.max(this.dirtyTo, startRow + insertedLines);
     }
     
-    static getCppKeywordClass(word) {
-        const keywords = ['if', 'else', 'switch', 'case', 'default', 'break', 'continue', 'return', 'goto',
-            'for', 'while', 'do', 'class', 'struct', 'union', 'enum', 'public', 'private', 'protected',
-            'virtual', 'override', 'final', 'friend', 'this', 'new', 'delete',
-            'template', 'typename', 'namespace', 'using', 'typedef',
-            'try', 'catch', 'throw', 'noexcept', 'sizeof', 'inline', 'constexpr'];
-        const types = ['int', 'float', 'double', 'char', 'bool', 'void', 'long', 'short',
-            'unsigned', 'signed', 'auto', 'string', 'vector', 'map', 'set', 'const', 'static'];
-        const values = ['true', 'false', 'nullptr'];
-        const builtins = ['std', 'cout', 'cin', 'endl'];
-        
-        if (keywords.includes(word)) return 'syntax-keyword';
-        if (types.includes(word)) return 'syntax-type';
-        if (values.includes(word)) return 'syntax-logical';
-        if (builtins.includes(word)) return 'syntax-builtin';
-        return '';
+    /**
+     * Replace `removed` entries at `start` with `count` empty (null) entries
+     */
+    static _spliceEmpty(arr, start, removed, count) {
+        if (count <= 1024) {
+            arr.splice(start, removed, ...new Array(count).fill(null));
+            return arr;
+        }
+        // Large pastes: avoid spreading huge argument lists
+        return arr.slice(0, start).concat(new Array(count).fill(null), arr.slice(start + removed));
     }
     
-    // ============================================
-    // JAVA HIGHLIGHTING
-    // ============================================
-    
-    static highlightJavaLine(line, lineClasses) {
-        let pos = 0;
+    /**
+     * Get per-character classes for every line, tokenizing only what changed.
+     * Calling it again without edits does no tokenization at all.
+     * @param {string} language - Language code
+     * @returns {string[][]} One class array per line
+     */
+    highlight(language) {
+        const lineCount = this.buffer.lineCount;
+        this.tokenizedLines = 0;
+        this.updatedFrom = this.updatedTo = 0;
         
-        // Check for single-line comment
-        const commentIndex = line.indexOf('//');
-        const lineEnd = commentIndex !== -1 ? commentIndex : line.length;
+        if (language !== this.language) {
+            this.language = language;
+            this.lineText = new Array(lineCount).fill(null);
+            this.entryState = new Array(lineCount).fill(null);
+            this.exitState = new Array(lineCount).fill(null);
+            this.classes = new Array(lineCount).fill(null);
+            this.dirtyFrom = 0;
+            this.dirtyTo = lineCount;
+        }
         
-        if (commentIndex !== -1) {
-            for (let i = commentIndex; i < line.length; i++) {
-                lineClasses[i] = 'syntax-comment';
-            }
+        if (this.dirtyFrom >= this.dirtyTo) {
+            return this.classes;
         }
         
-        while (pos < lineEnd) {
-            // Skip whitespace
-            if (/\s/.test(line[pos])) {
-                pos++;
-                continue;
-            }
-            
-            // Check for annotation (@Override, @Deprecated, etc.)
-            if (line[pos] === '@') {
-                const start = pos;
-                pos++;
-                while (pos < lineEnd && /[a-zA-Z0-9_]/.test(line[pos])) {
-                    pos++;
-                }
-                for (let i = start; i < pos; i++) {
-                    lineClasses[i] = 'syntax-decorator';
-                }
-                continue;
-            }
-            
-            // Check for string
-            if (line[pos] === '"') {
-                const start = pos;
-                pos++;
-                while (pos < lineEnd && line[pos] !== '"') {
-                    if (line[pos] === '\\') pos++;
-                    pos++;
-                }
-                if (pos < lineEnd) pos++;
-                for (let i = start; i < pos; i++) {
-                    lineClasses[i] = 'syntax-string';
-                }
-                continue;
-            }
-            
-            // Check for char literal
-            if (line[pos] === "'") {
-                const start = pos;
-                pos++;
-                while (pos < lineEnd && line[pos] !== "'") {
-                    if (line[pos] === '\\') pos++;
-                    pos++;
-                }
-                if (pos < lineEnd) pos++;
-                for (let i = start; i < pos; i++) {
-                    lineClasses[i] = 'syntax-string';
-                }
-                continue;
-            }
-            
-            // Check for number
-            if (/\d/.test(line[pos])) {
-                const start = pos;
-                while (pos < lineEnd && /[\d.xXeEfFlLdD]/.test(line[pos])) {
-                    pos++;
-                }
-                for (let i = start; i < pos; i++) {
-                    lineClasses[i] = 'syntax-number';
-                }
-                continue;
-            }
+        let row = this.dirtyFrom;
+        this.updatedFrom = row;
+        let state = row > 0 ? this.exitState[row - 1] : SyntaxHighlighter.STATE_NORMAL;
+        
+        for (; row < lineCount; row++) {
+            const line = this.buffer.getLine(row);
             
-            // Check for word (identifier or keyword)
-            if (/[a-zA-Z_]/.test(line[pos])) {
-                const start = pos;
-                while (pos < lineEnd && /[a-zA-Z0-9_]/.test(line[pos])) {
-                    pos++;
-                }
-                const word = line.substring(start, pos);
-                const syntaxClass = this.getJavaKeywordClass(word);
-                
-                if (syntaxClass) {
-                    for (let i = start; i < pos; i++) {
-                        lineClasses[i] = syntaxClass;
-                    }
-                }
+            if (this.lineText[row] === line && this.entryState[row] === state) {
+                // Converged: this and every following line are still valid
+                if (row >= this.dirtyTo) break;
+                state = this.exitState[row];
                 continue;
             }
             
-            // Check for operators
-            if ('+-*/%=<>!&|^~?:'.includes(line[pos])) {
-                lineClasses[pos] = 'syntax-operator';
-                pos++;
-                continue;
-            }
+            const lineClasses = new Array(line.length).fill('');
+            const exit = SyntaxHighlighter.highlightLine(line, lineClasses, language, state);
             
-            // Skip unknown character
-            pos++;
+            this.lineText[row] = line;
+            this.entryState[row] = state;
+            this.exitState[row] = exit;
+            this.classes[row] = lineClasses;
+            this.tokenizedLines++;
+            state = exit;
         }
-    }
-    
-    static getJavaKeywordClass(word) {
-        const keywords = [
-            'if', 'else', 'switch', 'case', 'default', 'break', 'continue', 'return',
-            'for', 'while', 'do', 'class', 'interface', 'extends', 'implements',
-            'new', 'this', 'super', 'instanceof', 'enum', 'assert',
-            'public', 'private', 'protected', 'abstract', 'final', 'static',
-            'native', 'strictfp', 'synchronized', 'transient', 'volatile',
-            'try', 'catch', 'finally', 'throw', 'throws',
-            'package', 'import', 'void'
-        ];
-        const types = [
-            'int', 'long', 'short', 'byte', 'float', 'double', 'char', 'boolean',
-            'String', 'Integer', 'Long', 'Short', 'Byte', 'Float', 'Double', 'Character', 'Boolean',
-            'Object', 'Class', 'Void', 'List', 'ArrayList', 'LinkedList',
-            'Set', 'HashSet', 'TreeSet', 'Map', 'HashMap', 'TreeMap',
-            'Queue', 'Stack', 'Vector', 'Array', 'Arrays',
-            'Scanner', 'File', 'Exception'
-        ];
-        const values = ['true', 'false', 'null'];
-        const builtins = ['System', 'Math', 'out', 'in', 'err', 'println', 'print', 'printf'];
         
-        if (keywords.includes(word)) return 'syntax-keyword';
-        if (types.includes(word)) return 'syntax-type';
-        if (values.includes(word)) return 'syntax-logical';
-        if (builtins.includes(word)) return 'syntax-builtin';
-        return '';
+        this.updatedTo = row;
+        this.dirtyFrom = lineCount;
+        this.dirtyTo = lineCount;
+        return this.classes;
     }
 }
 
 // Export for use
 if (typeof module !== 'undefined' && module.exports) {
     module.exports = SyntaxHighlighter;
+    module.exports.HighlightCache = HighlightCache;
 }
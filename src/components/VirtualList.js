@@ -0,0 +1,216 @@
+/**
+ * VirtualList - Virtualized, keyed list for side panels
+ *
+ * Only the items near the visible part of the scroll container are in the
+ * DOM, between two spacers that keep the scroll height of the whole list
+ * (same scheme as GridEditor rows and LineGutter).
+ *
+ * - setItems() is a keyed diff: an item whose key and rendered HTML did
+ *   not change keeps its element, so a refresh that adds one file to a
+ *   500-file folder touches one element
+ * - clicks go through one delegated listener: onClick(item, event)
+ * - item height is measured from the first rendered item (items of one
+ *   list are expected to share a height), or given as options.itemHeight
+ *
+ * The container must be the scrolling element. Code that writes its own
+ * innerHTML into it (loading / error messages) is fine: the next
+ * setItems() rebuilds the list structure.
+ */
+
+class VirtualList {
+    /**
+     * @param {HTMLElement} container - Scrolling element the list fills
+     * @param {Object} options
+     * @param {Function} options.key - key(item) -> unique string
+     * @param {Function} options.render - render(item, index) -> HTML of one item element
+     * @param {Function} [options.onClick] - onClick(item, event) for clicks on an item
+     * @param {string} [options.empty=''] - HTML shown when there are no items
+     * @param {number} [options.itemHeight] - Fixed item height in px (default: measured)
+     * @param {number} [options.overscan=10] - Extra items above/below the viewport
+     */
+    constructor(container, options) {
+        this.container = container;
+        this.keyOf = options.key;
+        this.renderItem = options.render;
+        this.onClick = options.onClick || null;
+        this.empty = options.empty || '';
+        this.itemHeight = options.itemHeight || 0;
+        this._fixedHeight = !!options.itemHeight;
+        this.overscan = options.overscan || 10;
+
+        this.items = [];
+        this.itemsByKey = new Map();
+        this.rendered = new Map(); // key -> { el, html } for items in the DOM
+        this.start = 0;
+        this.end = 0;
+        this._frame = null;
+
+        this.headerElement = document.createElement('div');
+        this.headerElement.className = 'virtual-list-header';
+        this.topSpacer = this._createSpacer();
+        this.rowsElement = document.createElement('div');
+        this.rowsElement.className = 'virtual-list-rows';
+        this.bottomSpacer = this._createSpacer();
+        this._headerHtml = null;
+
+        this.container.addEventListener('scroll', () => this._scheduleRender());
+        this.container.addEventListener('click', (e) => this._handleClick(e));
+        if (typeof ResizeObserver !== 'undefined') {
+            // Panels start hidden: render the visible range once they get a size
+            new ResizeObserver(() => this._scheduleRender()).observe(this.container);
+        }
+    }
+
+    /**
+     * Show a new list of items
+     * @param {Object[]} items
+     * @param {Object} [options]
+     * @param {string} [options.header=''] - HTML above the items (scrolls with them)
+     * @param {string} [options.empty] - HTML when items is empty (default: options.empty of the constructor)
+     */
+    setItems(items, options = {}) {
+        this.items = items;
+        this.itemsByKey = new Map();
+        for (const item of items) {
+            this.itemsByKey.set(String(this.keyOf(item)), item);
+        }
+
+        this._attach();
+        const header = (options.header || '') + (items.length === 0 ? (options.empty !== undefined ? options.empty : this.empty) : '');
+        if (header !== this._headerHtml) {
+            this.headerElement.innerHTML = header;
+            this._headerHtml = header;
+        }
+
+        this._render(true);
+
+        // First items in the DOM: measure and redo the range with the real height
+        if (!this._fixedHeight && this.rowsElement.firstElementChild) {
+            const height = this._measure(this.rowsElement.firstElementChild);
+            if (height > 0 && height !== this.itemHeight) {
+                this.itemHeight = height;
+                this._render(true);
+            }
+        }
+    }
+
+    /**
+     * Scroll back to the first item
+     */
+    scrollToTop() {
+        this.container.scrollTop = 0;
+        this._scheduleRender();
+    }
+
+    // ============================================
+    // INTERNALS
+    // ============================================
+
+    _createSpacer() {
+        const spacer = document.createElement('div');
+        spacer.className = 'virtual-list-spacer';
+        return spacer;
+    }
+
+    /**
+     * (Re)build the list structure if something else replaced the container's content
+     */
+    _attach() {
+        if (this.rowsElement.parentNode === this.container) return;
+        this.container.replaceChildren(this.headerElement, this.topSpacer, this.rowsElement, this.bottomSpacer);
+        this.rowsElement.replaceChildren();
+        this.rendered.clear();
+        this._headerHtml = null;
+        this.start = this.end = 0;
+    }
+
+    _measure(el) {
+        const style = getComputedStyle(el);
+        return el.offsetHeight + (parseFloat(style.marginTop) || 0) + (parseFloat(style.marginBottom) || 0);
+    }
+
+    /**
+     * Items intersecting the viewport, widened by the overscan
+     */
+    _visibleRange() {
+        const count = this.items.length;
+        const viewHeight = this.container.clientHeight;
+        if (!this.itemHeight || !viewHeight) {
+            // Unknown height or hidden panel: a first screenful
+            return { start: 0, end: Math.min(count, 2 * this.overscan) };
+        }
+        const scrollTop = Math.max(0, this.container.scrollTop - this.headerElement.offsetHeight);
+        const first = Math.floor(scrollTop / this.itemHeight);
+        const last = Math.ceil((scrollTop + viewHeight) / this.itemHeight);
+        return {
+            start: Math.max(0, first - this.overscan),
+            end: Math.min(count, last + this.overscan)
+        };
+    }
+
+    _scheduleRender() {
+        if (this._frame || this.rowsElement.parentNode !== this.container) return;
+        this._frame = requestAnimationFrame(() => {
+            this._frame = null;
+            this._render(false);
+        });
+    }
+
+    /**
+     * Show items [start, end), reusing the element of every item whose
+     * key and HTML are unchanged
+     * @param {boolean} itemsChanged - false when only the scroll position moved
+     */
+    _render(itemsChanged) {
+        const { start, end } = this._visibleRange();
+        if (!itemsChanged && start === this.start && end === this.end) return;
+
+        const rows = [];
+        const rendered = new Map();
+        let same = this.rowsElement.childElementCount === end - start;
+        for (let i = start; i < end; i++) {
+            const item = this.items[i];
+            const key = String(this.keyOf(item));
+            const html = this.renderItem(item, i);
+            let entry = this.rendered.get(key);
+            if (!entry || entry.html !== html) {
+                entry = { el: this._createElement(html, key), html };
+            }
+            rendered.set(key, entry);
+            if (same && this.rowsElement.children[i - start] !== entry.el) same = false;
+            rows.push(entry.el);
+        }
+
+        if (!same) {
+            this.rowsElement.replaceChildren(...rows);
+        }
+        this.rendered = rendered;
+        this.start = start;
+        this.end = end;
+
+        const height = this.itemHeight;
+        this.topSpacer.style.height = `${start * height}px`;
+        this.bottomSpacer.style.height = `${(this.items.length - end) * height}px`;
+    }
+
+    _createElement(html, key) {
+        const template = document.createElement('template');
+        template.innerHTML = html.trim();
+        const el = template.content.firstElementChild || document.createElement('div');
+        el.dataset.listKey = key;
+        return el;
+    }
+
+    _handleClick(e) {
+        if (!this.onClick) return;
+        const el = e.target.closest('[data-list-key]');
+        if (!el || el.parentNode !== this.rowsElement) return;
+        const item = this.itemsByKey.get(el.dataset.listKey);
+        if (item) this.onClick(item, e);
+    }
+}
+
+// Export for use
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = VirtualList;
+}
@@ -0,0 +1,219 @@
+/**
+ * WorkspaceOverview Component
+ * Teacher's view of the students' private workspaces
+ *
+ * While workspace mode is on, each student edits their own copy of the
+ * board. The server sends low-rate summaries (a few lines around each
+ * student's cursor, see server/WorkspaceManager.js); this panel shows
+ * them as a grid of cards. Clicking a card opens that student's full
+ * document in the editor with live sync; the back button returns to the
+ * board.
+ *
+ * For C++ exercises, "Grade" runs every workspace against the exercise's
+ * tests on the server (server/Grader.js); each card then shows its score.
+ *
+ * Dependencies:
+ * - UIManager (escapeHtml)
+ * - VirtualList (card list rendering)
+ * - Collaboration (mode, open / close)
+ */
+
+const WorkspaceOverview = {
+    enabled: false,
+    activeId: null,        // Student whose workspace is in the editor
+    summaries: new Map(),  // studentId -> latest summary
+    grades: new Map(),     // studentId -> latest grade result
+    grading: false,
+    _list: null,           // VirtualList over #workspace-grid (created on first render)
+
+    /**
+     * Initialize workspace overview (teacher only)
+     */
+    init() {
+        const toggle = document.getElementById('workspace-mode-toggle');
+        if (toggle) {
+            toggle.addEventListener('click', () => {
+                if (typeof Collaboration !== 'undefined') {
+                    Collaboration.setWorkspaceMode(!this.enabled);
+                }
+            });
+        }
+
+        const backBtn = document.getElementById('workspace-back-btn');
+        if (backBtn) {
+            backBtn.addEventListener('click', () => {
+                if (typeof Collaboration !== 'undefined') {
+                    Collaboration.closeWorkspace();
+                }
+            });
+        }
+
+        const gradeBtn = document.getElementById('workspace-grade-btn');
+        if (gradeBtn) {
+            gradeBtn.addEventListener('click', () => this.startGrading());
+        }
+
+        this._render();
+        console.log('🧑‍💻 Workspace Overview initialized');
+    },
+
+    /**
+     * Workspace mode turned on/off
+     * @param {boolean} enabled
+     */
+    setMode(enabled) {
+        this.enabled = enabled;
+        if (!enabled) {
+            this.summaries.clear();
+            this.grades.clear();
+            this.activeId = null;
+            this._updateViewing();
+            this._setGradeSummary('');
+        }
+
+        const toggle = document.getElementById('workspace-mode-toggle');
+        if (toggle) {
+            toggle.classList.toggle('active', enabled);
+        }
+        this._render();
+    },
+
+    /**
+     * New summaries from the server (only the workspaces that changed)
+     * @param {Object[]} summaries - { studentId, name, version, lineCount, firstLine, lines }
+     */
+    updateSummaries(summaries) {
+        for (const summary of summaries) {
+            this.summaries.set(summary.studentId, summary);
+        }
+        this._render();
+    },
+
+    /**
+     * The editor now shows this student's workspace (null = the board)
+     * @param {string|null} studentId
+     */
+    setActive(studentId) {
+        this.activeId = studentId;
+        this._updateViewing();
+        this._render();
+    },
+
+    /**
+     * Ask the server to grade the class
+     */
+    startGrading() {
+        if (this.grading || typeof Collaboration === 'undefined' || !Collaboration.gradeWorkspaces()) return;
+        this.grading = true;
+        this._setGradeSummary('⏳ Grading…');
+    },
+
+    /**
+     * grade_results: one result per workspace, or an error
+     * @param {Object} message - { results, summary, timeMs } or { error }
+     */
+    showGrades(message) {
+        this.grading = false;
+        if (message.error) {
+            this._setGradeSummary('');
+            showToast(`⚠️ ${message.error}`, 'warning');
+            return;
+        }
+        this.grades.clear();
+        message.results.forEach(result => this.grades.set(result.studentId, result));
+
+        const { students, passed, failed, compileErrors } = message.summary;
+        this._setGradeSummary(`✅ ${passed} · ❌ ${failed} · ⚠️ ${compileErrors} of ${students} (${(message.timeMs / 1000).toFixed(1)} s)`);
+        this._render();
+    },
+
+    _setGradeSummary(text) {
+        const summary = document.getElementById('workspace-grade-summary');
+        if (summary) summary.textContent = text;
+    },
+
+    _gradeBadge(studentId) {
+        const grade = this.grades.get(studentId);
+        if (!grade) return '';
+
+        const mismatch = grade.mismatch || {};
+        let icon;
+        let detail;
+        if (grade.status === 'passed') {
+            icon = `✅ ${grade.passed}/${grade.total}`;
+            detail = 'All tests passed';
+        } else if (grade.status === 'failed') {
+            icon = `❌ ${grade.passed}/${grade.total}`;
+            detail = mismatch.reason
+                ? `Test ${mismatch.test}: ${mismatch.reason}`
+                : `Test ${mismatch.test}, line ${mismatch.line}: expected "${mismatch.expected}", got "${mismatch.actual}"`;
+        } else if (grade.status === 'compile_error') {
+            icon = '⚠️ compile';
+            detail = mismatch.error || 'Compilation failed';
+        } else {
+            icon = '➖';
+            detail = grade.status === 'not_graded' ? 'This exercise has no automatic tests' : 'Exercise not recognised';
+        }
+        return `<span class="workspace-card-grade ${grade.status}" title="${escapeHtml(detail)}">${icon}</span>`;
+    },
+
+    _updateViewing() {
+        const viewing = document.getElementById('workspace-viewing');
+        const nameEl = document.getElementById('workspace-viewing-name');
+        if (!viewing) return;
+
+        const summary = this.activeId ? this.summaries.get(this.activeId) : null;
+        viewing.style.display = this.activeId ? 'flex' : 'none';
+        if (nameEl) {
+            nameEl.textContent = summary ? `👀 ${summary.name}` : '';
+        }
+    },
+
+    _render() {
+        const grid = document.getElementById('workspace-grid');
+        if (!grid || typeof VirtualList === 'undefined') return;
+
+        if (!this._list) {
+            this._list = new VirtualList(grid, {
+                key: summary => summary.studentId,
+                render: summary => this._renderCard(summary),
+                onClick: summary => {
+                    if (typeof Collaboration === 'undefined') return;
+                    if (summary.studentId === this.activeId) {
+                        Collaboration.closeWorkspace();
+                    } else {
+                        Collaboration.openWorkspace(summary.studentId);
+                    }
+                }
+            });
+        }
+
+        const items = Array.from(this.summaries.values())
+            .sort((a, b) => a.name.localeCompare(b.name, undefined, { numeric: true }));
+        this._list.setItems(items, {
+            empty: this.enabled
+                ? '<div class="no-students">No student workspaces yet</div>'
+                : '<div class="no-students">Turn on private workspaces to give every student their own copy of the board</div>'
+        });
+    },
+
+    _renderCard(summary) {
+        const active = summary.studentId === this.activeId ? ' active' : '';
+        const lines = summary.lines.map(line => escapeHtml(line)).join('\n');
+        return `
+            <div class="workspace-card${active}" title="${escapeHtml(summary.name)} - click to open">
+                <div class="workspace-card-header">
+                    <span class="workspace-card-name">${escapeHtml(summary.name)}</span>
+                    ${this._gradeBadge(summary.studentId)}
+                    <span class="workspace-card-lines">${summary.lineCount} lines</span>
+                </div>
+                <pre class="workspace-card-code">${lines}</pre>
+            </div>
+        `;
+    }
+};
+
+// Export for module systems if available
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = WorkspaceOverview;
+}
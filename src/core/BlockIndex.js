@@ -0,0 +1,156 @@
+/**
+ * BlockIndex - Incremental index of block-opening lines in a TextBuffer
+ *
+ * SmartInserter needs "the nearest line above the cursor that starts with
+ * ΑΝ" (or ΓΙΑ / ΟΣΟ...) to indent a closing keyword. Instead of splitting
+ * and scanning the document backwards on every insertion, the index keeps
+ * a sorted list of rows per leading word and patches it on every buffer
+ * change.
+ *
+ * Words are tracked on first use (one scan of the document), so the index
+ * only holds the handful of openers the language's insertion rules ask
+ * for. Lookups are a binary search; an edit costs O(k) for the k tracked
+ * rows after it, however long the document is.
+ *
+ * @module core/BlockIndex
+ */
+
+const BlockIndex = (function() {
+    'use strict';
+
+    // Leading identifier of a line ("ΑΝ x > 0 ΤΟΤΕ" -> "ΑΝ")
+    const LEADING_WORD = /^\s*([\p{L}\p{N}_]+)/u;
+    const LEADING_SPACE = /^\s*/;
+
+    /**
+     * First index in a sorted array whose value is >= target
+     */
+    function lowerBound(rows, target) {
+        let lo = 0;
+        let hi = rows.length;
+        while (lo < hi) {
+            const mid = (lo + hi) >>> 1;
+            if (rows[mid] < target) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    class BlockIndex {
+        /**
+         * @param {TextBuffer} buffer - Document to index
+         */
+        constructor(buffer) {
+            this.buffer = buffer;
+            this.rowsByWord = new Map(); // Tracked leading word -> sorted rows
+
+            this._unsubscribe = buffer.onChange(change => this._onBufferChange(change));
+        }
+
+        /**
+         * Leading identifier of a line, or '' if it does not start with one
+         * @param {string} line
+         * @returns {string}
+         */
+        static leadingWord(line) {
+            const match = LEADING_WORD.exec(line);
+            return match ? match[1] : '';
+        }
+
+        /**
+         * Leading whitespace of a line
+         * @param {string} line
+         * @returns {string}
+         */
+        static indentOf(line) {
+            return LEADING_SPACE.exec(line)[0];
+        }
+
+        /**
+         * Start keeping rows that begin with `word` (no-op if already tracked)
+         * @param {string} word
+         */
+        track(word) {
+            if (this.rowsByWord.has(word)) return;
+            const rows = [];
+            const lineCount = this.buffer.lineCount;
+            for (let row = 0; row < lineCount; row++) {
+                if (BlockIndex.leadingWord(this.buffer.getLine(row)) === word) rows.push(row);
+            }
+            this.rowsByWord.set(word, rows);
+        }
+
+        /**
+         * Nearest row above `row` whose leading word is one of `words`
+         * @param {string|string[]} words
+         * @param {number} row - Search rows [0, row)
+         * @returns {number} The row, or -1 if there is none
+         */
+        findBefore(words, row) {
+            let best = -1;
+            for (const word of Array.isArray(words) ? words : [words]) {
+                this.track(word);
+                const rows = this.rowsByWord.get(word);
+                const i = lowerBound(rows, row) - 1;
+                if (i >= 0 && rows[i] > best) best = rows[i];
+            }
+            return best;
+        }
+
+        /**
+         * Indentation of the nearest opener above `row` (see findBefore)
+         * @returns {string|null} null if there is no such opener
+         */
+        findIndentBefore(words, row) {
+            const found = this.findBefore(words, row);
+            return found >= 0 ? BlockIndex.indentOf(this.buffer.getLine(found)) : null;
+        }
+
+        /**
+         * Detach from the buffer
+         */
+        dispose() {
+            if (this._unsubscribe) this._unsubscribe();
+        }
+
+        _onBufferChange(change) {
+            if (this.rowsByWord.size === 0) return;
+
+            const { startRow, removedLines, insertedLines } = change;
+            const shift = insertedLines - removedLines;
+
+            // Leading words of the new lines, grouped by tracked word
+            const inserted = new Map();
+            for (let row = startRow; row < startRow + insertedLines; row++) {
+                const word = BlockIndex.leadingWord(this.buffer.getLine(row));
+                if (!this.rowsByWord.has(word)) continue;
+                if (!inserted.has(word)) inserted.set(word, []);
+                inserted.get(word).push(row);
+            }
+
+            for (const [word, rows] of this.rowsByWord) {
+                const from = lowerBound(rows, startRow);
+                const to = lowerBound(rows, startRow + removedLines);
+                if (shift !== 0) {
+                    for (let i = to; i < rows.length; i++) rows[i] += shift;
+                }
+                const added = inserted.get(word) || [];
+                if (to > from || added.length > 0) {
+                    rows.splice(from, to - from, ...added);
+                }
+            }
+        }
+    }
+
+    return BlockIndex;
+})();
+
+// Make BlockIndex globally available (browser)
+if (typeof window !== 'undefined') {
+    window.BlockIndex = BlockIndex;
+}
+
+// Export for Node.js (tooling)
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = BlockIndex;
+}
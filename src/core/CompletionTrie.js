@@ -0,0 +1,238 @@
+/**
+ * CompletionTrie - Prefix index with ranked suggestions
+ *
+ * Words are stored under a key (the word itself, or its case/accent folded
+ * form for GLOSSA, see LexerCompiler.foldWord) with a weight: the number of
+ * occurrences for document identifiers, a fixed rank for keywords.
+ *
+ * Nodes with more than TOP_K words below them cache their TOP_K heaviest
+ * words. The cache is built from the children's caches the first time a
+ * prefix is queried, and only the nodes on a word's path are invalidated
+ * when its weight changes; smaller subtrees are simply walked. So:
+ * - complete(prefix) walks the prefix, then reads a cached list or sorts
+ *   at most a few TOP_K entries
+ * - add(word, delta) costs O(word length), plus one merge per invalidated
+ *   node at the next query
+ * Queries therefore stay well under a millisecond for any prefix, whatever
+ * the number of words.
+ *
+ * @module core/CompletionTrie
+ */
+
+const CompletionTrie = (function() {
+    'use strict';
+
+    const TOP_K = 32;
+
+    function createNode() {
+        return { children: new Map(), entries: null, count: 0, best: null };
+    }
+
+    /**
+     * Heavier first, then shorter, then alphabetical
+     */
+    function compareEntries(a, b) {
+        return b.weight - a.weight || a.word.length - b.word.length || (a.word < b.word ? -1 : a.word > b.word ? 1 : 0);
+    }
+
+    class CompletionTrie {
+        /**
+         * @param {Object} [options]
+         * @param {Function} [options.fold] - Maps a word to its lookup key (default: identity)
+         */
+        constructor(options = {}) {
+            this.fold = options.fold || null;
+            this.root = createNode();
+            this.size = 0; // Number of distinct words
+        }
+
+        /**
+         * Adds `delta` to the weight of a word; the word is dropped when its
+         * weight reaches 0
+         * @param {string} word
+         * @param {number} [delta=1]
+         * @param {Object} [data] - Kept with the word and returned by complete()
+         */
+        add(word, delta = 1, data = null) {
+            const key = this.fold ? this.fold(word) : word;
+            const path = [this.root];
+            let node = this.root;
+            for (const char of key) {
+                let child = node.children.get(char);
+                if (!child) {
+                    if (delta <= 0) return; // Unknown word
+                    child = createNode();
+                    node.children.set(char, child);
+                }
+                node = child;
+                path.push(node);
+            }
+
+            let entry = node.entries ? node.entries.get(word) : undefined;
+            if (!entry) {
+                if (delta <= 0) return;
+                entry = { word, weight: 0, data };
+                if (!node.entries) node.entries = new Map();
+                node.entries.set(word, entry);
+            }
+            const added = entry.weight === 0 ? 1 : 0;
+            entry.weight += delta;
+            if (data) entry.data = data;
+
+            let removed = 0;
+            if (entry.weight <= 0) {
+                node.entries.delete(word);
+                if (node.entries.size === 0) node.entries = null;
+                removed = 1;
+            }
+            this.size += added - removed;
+
+            // Update counts and invalidate caches on the path; prune nodes left empty
+            const chars = Array.from(key);
+            for (let i = path.length - 1; i >= 0; i--) {
+                const current = path[i];
+                current.count += added - removed;
+                current.best = null;
+                if (i > 0 && current.count === 0) {
+                    path[i - 1].children.delete(chars[i - 1]);
+                }
+            }
+        }
+
+        /**
+         * Weight of a word (0 if absent)
+         * @param {string} word
+         * @returns {number}
+         */
+        weightOf(word) {
+            const node = this._find(this.fold ? this.fold(word) : word);
+            const entry = node && node.entries ? node.entries.get(word) : null;
+            return entry ? entry.weight : 0;
+        }
+
+        /**
+         * Heaviest words whose key starts with the prefix's key
+         * @param {string} prefix
+         * @param {number} [limit=10] - At most TOP_K
+         * @returns {{ word: string, weight: number, data: Object|null }[]}
+         */
+        complete(prefix, limit = 10) {
+            const node = this._find(this.fold ? this.fold(prefix) : prefix);
+            if (!node) return [];
+            const best = this._best(node);
+            return best.length > limit ? best.slice(0, limit) : best;
+        }
+
+        /**
+         * Forget every word
+         */
+        clear() {
+            this.root = createNode();
+            this.size = 0;
+        }
+
+        _find(key) {
+            let node = this.root;
+            for (const char of key) {
+                node = node.children.get(char);
+                if (!node) return null;
+            }
+            return node;
+        }
+
+        /**
+         * Top TOP_K entries of a subtree: cached on large subtrees (rebuilt
+         * from the children when stale), collected directly on small ones
+         */
+        _best(node) {
+            if (node.best) return node.best;
+
+            const candidates = [];
+            if (node.count <= TOP_K) {
+                this._collect(node, candidates);
+                candidates.sort(compareEntries);
+                return candidates;
+            }
+
+            // Merge the sorted lists of the children (and the node's own words),
+            // taking only the first TOP_K
+            const lists = [];
+            if (node.entries) {
+                lists.push(Array.from(node.entries.values()).sort(compareEntries));
+            }
+            for (const child of node.children.values()) {
+                lists.push(this._best(child));
+            }
+            const heads = new Array(lists.length).fill(0);
+            while (candidates.length < TOP_K) {
+                let pick = -1;
+                for (let i = 0; i < lists.length; i++) {
+                    if (heads[i] < lists[i].length &&
+                        (pick < 0 || compareEntries(lists[i][heads[i]], lists[pick][heads[pick]]) < 0)) {
+                        pick = i;
+                    }
+                }
+                if (pick < 0) break;
+                candidates.push(lists[pick][heads[pick]++]);
+            }
+            node.best = candidates;
+            return candidates;
+        }
+
+        _collect(node, out) {
+            if (node.entries) {
+                for (const entry of node.entries.values()) out.push(entry);
+            }
+            for (const child of node.children.values()) this._collect(child, out);
+        }
+
+        /**
+         * Trie of a language pack's keywords, types and sidebar buttons.
+         * Buttons with a smart insertion come back with
+         * data = { kind: 'snippet', insert, smart, desc }, the rest as keywords.
+         * @param {Object} keywords - window.Languages.<Lang>.keywords
+         * @param {Object} [options] - See constructor
+         * @returns {CompletionTrie}
+         */
+        static fromLanguagePack(keywords, options = {}) {
+            const trie = new CompletionTrie(options);
+            if (!keywords) return trie;
+
+            // Sidebar buttons, under the first word of their label
+            // ("🆕 main()" -> main). Snippets rank above plain keywords.
+            for (const group of keywords.SIDEBAR_CONFIG || []) {
+                for (const item of group.keywords || []) {
+                    const match = /[\p{L}_][\p{L}\p{N}_]*/u.exec(item.text || '');
+                    if (!match || trie.weightOf(match[0]) > 0) continue;
+                    trie.add(match[0], item.smart ? 3 : 2, item.smart
+                        ? { kind: 'snippet', insert: item.insert, smart: item.smart, desc: item.desc || '' }
+                        : { kind: 'keyword', desc: item.desc || '' });
+                }
+            }
+
+            const words = typeof keywords.getHighlightableKeywords === 'function'
+                ? keywords.getHighlightableKeywords()
+                : [].concat(keywords.KEYWORDS || [], keywords.TYPES || [], keywords.VALUES || [], keywords.MODIFIERS || []);
+            for (const word of words) {
+                if (/^[\p{L}_][\p{L}\p{N}_]*$/u.test(word) && trie.weightOf(word) === 0) {
+                    trie.add(word, 1, { kind: 'keyword', desc: '' });
+                }
+            }
+            return trie;
+        }
+    }
+
+    CompletionTrie.TOP_K = TOP_K;
+
+    return CompletionTrie;
+})();
+
+// Make CompletionTrie globally available (browser)
+if (typeof window !== 'undefined') {
+    window.CompletionTrie = CompletionTrie;
+}
+
+// Export for Node.js (tooling)
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = CompletionTrie;
+}
@@ -0,0 +1,238 @@
+/**
+ * EditorWorkerClient - Main-thread side of workers/EditorWorker.js
+ *
+ * Mirrors a TextBuffer into the worker as line-level deltas and keeps the
+ * last-known highlight classes per line, so GridEditor can render
+ * immediately and repaint when fresh classes arrive.
+ *
+ * Results are computed for the document version the worker had seen. If the
+ * editor has moved on since, result rows are shifted through the edits made
+ * in the meantime; rows those edits touched are dropped (the worker
+ * re-tokenizes them on the next request anyway).
+ *
+ * @module core/EditorWorkerClient
+ */
+
+const EditorWorkerClient = (function() {
+    'use strict';
+
+    const WORKER_URL = 'src/workers/EditorWorker.js?v=3';
+
+    class EditorWorkerClient {
+        /**
+         * @param {TextBuffer} buffer - Document to mirror
+         * @param {Worker} worker
+         */
+        constructor(buffer, worker) {
+            this.buffer = buffer;
+            this.worker = worker;
+            this.language = null;
+            this.classes = new Array(buffer.lineCount).fill(null); // Last-known classes per line
+            this.onHighlight = null;     // Called after fresh classes were applied
+
+            this._changes = [];          // Edits not yet seen in a highlight result
+            this._highlighted = null;    // { version, start, end } covered by the last result
+            this._inflight = null;       // { start, end } of the request awaiting its result
+            this._range = null;          // Rows the editor last asked for
+            this._requests = new Map();  // id -> resolve (structure / completion queries)
+            this._nextId = 1;
+
+            this._unsubscribe = buffer.onChange(change => this._onBufferChange(change));
+            this.worker.onmessage = (event) => this._onMessage(event.data);
+            this.worker.postMessage({ type: 'reset', text: buffer.getText(), version: buffer.version });
+        }
+
+        /**
+         * Starts the worker, or returns null where workers are unavailable
+         * (file:// pages, old browsers); callers then highlight synchronously.
+         * @param {TextBuffer} buffer
+         * @returns {EditorWorkerClient|null}
+         */
+        static create(buffer) {
+            if (typeof Worker === 'undefined') return null;
+            try {
+                return new EditorWorkerClient(buffer, new Worker(WORKER_URL));
+            } catch (error) {
+                console.warn('⚠️ Editor worker unavailable, highlighting on the main thread', error);
+                return null;
+            }
+        }
+
+        // ============================================
+        // DOCUMENT MIRROR
+        // ============================================
+
+        _onBufferChange(change) {
+            const { startRow, removedLines, insertedLines, version } = change;
+
+            this.worker.postMessage({
+                type: 'edit',
+                startRow,
+                removedLines,
+                lines: this.buffer.getLines(startRow, startRow + insertedLines),
+                version
+            });
+
+            // Keep the old classes on rows that still exist so colors do not flash
+            const kept = this.classes.slice(startRow, startRow + Math.min(removedLines, insertedLines));
+            while (kept.length < insertedLines) kept.push(null);
+            if (insertedLines <= 1024) {
+                this.classes.splice(startRow, removedLines, ...kept);
+            } else {
+                this.classes = this.classes.slice(0, startRow).concat(kept, this.classes.slice(startRow + removedLines));
+            }
+
+            this._changes.push(change);
+        }
+
+        /**
+         * Maps a row of an older version to the current one
+         * @returns {number} Current row, or -1 if an edit since then touched it
+         */
+        _mapRow(row, fromVersion) {
+            for (const change of this._changes) {
+                if (change.version <= fromVersion) continue;
+                if (row < change.startRow) continue;
+                if (row >= change.startRow + change.removedLines) {
+                    row += change.insertedLines - change.removedLines;
+                } else {
+                    return -1;
+                }
+            }
+            return row;
+        }
+
+        // ============================================
+        // HIGHLIGHTING
+        // ============================================
+
+        /**
+         * Switches language (or reloads it after its pack finished loading)
+         * @param {string} language
+         * @param {boolean} [force=false] - Re-highlight even if unchanged
+         */
+        setLanguage(language, force = false) {
+            if (language === this.language && !force) return;
+            this.language = language;
+            this._highlighted = null;
+            this.worker.postMessage({ type: 'language', language });
+        }
+
+        /**
+         * Asks for fresh classes of rows in [start, end) unless they are already
+         * up to date. While a request is in flight only the range is remembered;
+         * it is sent when the result comes back.
+         */
+        requestHighlight(start = 0, end = this.buffer.lineCount) {
+            this._range = { start, end };
+            if (this._inflight) return;
+
+            const done = this._highlighted;
+            if (done && done.version === this.buffer.version && start >= done.start && end <= done.end) return;
+
+            this._inflight = { start, end };
+            this.worker.postMessage({ type: 'highlight', start, end });
+        }
+
+        _applyHighlight(message) {
+            const request = this._inflight;
+            this._inflight = null;
+            if (message.language === this.language) {
+                this._storeHighlight(message);
+                this._highlighted = { version: message.version, start: request.start, end: request.end };
+                if (this.onHighlight) this.onHighlight();
+            }
+            // Edits, scrolling or a language switch since: the worker has the edits queued already
+            if (this._range) {
+                this.requestHighlight(this._range.start, this._range.end);
+            }
+        }
+
+        _storeHighlight(message) {
+            for (const [row, spans] of message.rows) {
+                const current = this._mapRow(row, message.version);
+                if (current < 0 || current >= this.classes.length) continue;
+                const lineClasses = new Array(this.buffer.getLineLength(current)).fill('');
+                for (const [start, end, className] of spans) {
+                    for (let col = start; col < end && col < lineClasses.length; col++) {
+                        lineClasses[col] = className;
+                    }
+                }
+                this.classes[current] = lineClasses;
+            }
+
+            this._changes = this._changes.filter(change => change.version > message.version);
+        }
+
+        // ============================================
+        // QUERIES
+        // ============================================
+
+        _query(message) {
+            return new Promise(resolve => {
+                const id = this._nextId++;
+                this._requests.set(id, resolve);
+                this.worker.postMessage({ ...message, id });
+            });
+        }
+
+        /**
+         * Bracket / block pair at the cursor and the innermost scope around it
+         * (pairs are { open, close }, each { row, col, length })
+         * @returns {Promise<{match, scope}|null>} null if the document changed meanwhile
+         */
+        queryStructure(row, col) {
+            const version = this.buffer.version;
+            return this._query({ type: 'structure', row, col })
+                .then(message => (message.version === version && this.buffer.version === version)
+                    ? { match: message.match, scope: message.scope }
+                    : null);
+        }
+
+        /**
+         * Suggestions for prefix: document identifiers (most frequent first),
+         * then the language's snippets and keywords
+         * @returns {Promise<{text, kind, insert, smart, desc}[]>} kind is 'word', 'keyword' or 'snippet'
+         */
+        getCompletions(prefix, limit = 20) {
+            return this._query({ type: 'complete', prefix, limit })
+                .then(message => message.items);
+        }
+
+        _onMessage(message) {
+            if (message.type === 'highlight') {
+                this._applyHighlight(message);
+                return;
+            }
+            const resolve = this._requests.get(message.id);
+            if (resolve) {
+                this._requests.delete(message.id);
+                resolve(message);
+            }
+        }
+
+        /**
+         * Stop the worker and detach from the buffer
+         */
+        dispose() {
+            this._unsubscribe();
+            this.worker.terminate();
+            for (const resolve of this._requests.values()) {
+                resolve({ version: -1, match: null, scope: null, items: [] });
+            }
+            this._requests.clear();
+        }
+    }
+
+    return EditorWorkerClient;
+})();
+
+// Make EditorWorkerClient globally available (browser)
+if (typeof window !== 'undefined') {
+    window.EditorWorkerClient = EditorWorkerClient;
+}
+
+// Export for Node.js (tooling)
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = EditorWorkerClient;
+}
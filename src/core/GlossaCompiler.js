@@ -0,0 +1,1334 @@
+/**
+ * GlossaCompiler - ΓΛΩΣΣΑ source to bytecode
+ *
+ * Front end of the in-browser GLOSSA engine (GlossaVM runs the result in
+ * workers/GlossaWorker.js):
+ * - lexer: keywords and names match regardless of case and Greek accents
+ *   (ΑΝ, Αν, αν), ← is the same as <-, comments start with !
+ * - parser: ΠΡΟΓΡΑΜΜΑ with ΣΤΑΘΕΡΕΣ / ΜΕΤΑΒΛΗΤΕΣ, every statement of the
+ *   language, ΔΙΑΔΙΚΑΣΙΑ and ΣΥΝΑΡΤΗΣΗ
+ * - checks: undeclared and redeclared names, types of assignments and
+ *   conditions, array dimensions, calls and their argument counts,
+ *   changing the control variable inside ΓΙΑ
+ * - code generation: one flat Int32Array of instructions per routine, with
+ *   variables resolved to slots and the source row of every instruction
+ *
+ * As in the language, ΚΑΙ / Η evaluate both sides, procedures copy their
+ * parameters back to the caller's variables, and functions get copies
+ * (arrays included). Parameters missing from a subprogram's ΜΕΤΑΒΛΗΤΕΣ
+ * take whatever type they are given.
+ *
+ * compile(code) returns { program } or { errors: [{ row, col, message }] }
+ * (0-based rows and columns).
+ *
+ * @module core/GlossaCompiler
+ */
+
+const GlossaCompiler = (function() {
+    'use strict';
+
+    // ===========================================
+    // Instructions (operands follow the opcode)
+    // ===========================================
+
+    const OP = {
+        PUSH: 1,          // const index
+        LOAD: 2,          // slot - error if it has no value
+        LOAD_RAW: 3,      // slot - may have no value (procedure arguments)
+        STORE: 4,         // slot
+        STORE_INT: 5,     // slot - value must be an integer
+        STORE_CHECK: 6,   // slot, type - value of unknown type
+        INDEX: 7,         // slot, dims - indices on the stack -> flat index
+        ALOAD: 8,         // slot - flat index -> element
+        ALOAD_RAW: 9,     // slot
+        ASTORE: 10,       // slot - flat index, value
+        ASTORE_INT: 11,   // slot
+        ASTORE_CHECK: 12, // slot, type
+        ALOAD1: 13,       // slot - one index -> element (INDEX + ALOAD)
+        ADD: 20, SUB: 21, MUL: 22, DIV: 23, IDIV: 24, MOD: 25, POW: 26, POW_INT: 27, NEG: 28,
+        EQ: 30, NE: 31, LT: 32, GT: 33, LE: 34, GE: 35,
+        AND: 36, OR: 37, NOT: 38,
+        CHECK: 39,        // type - value of unknown type used as that type
+        JMP: 40,          // address
+        JMP_FALSE: 41,    // address
+        JMP_TRUE: 42,     // address
+        POP: 43,
+        FOR_INIT: 44,     // var, end, step, exit - skip the loop if it runs 0 times
+        FOR_NEXT: 45,     // var, end, step, body - step, and loop while in range
+        READ: 50,         // slot, type
+        AREAD: 51,        // slot, type - flat index on the stack
+        WRITE: 52,        // count, newline
+        CALL: 60,         // routine, argc
+        RETURN: 61,
+        COPY_ARRAY: 62,   // (array on the stack) - for function arguments
+        BUILTIN: 63,      // builtin id
+        HALT: 70
+    };
+
+    const TYPE = { int: 1, real: 2, str: 3, bool: 4, any: 5 };
+    const TYPE_NAMES = {
+        int: 'ΑΚΕΡΑΙΑ', real: 'ΠΡΑΓΜΑΤΙΚΗ', str: 'ΧΑΡΑΚΤΗΡΑΣ', bool: 'ΛΟΓΙΚΗ', any: 'άγνωστου τύπου'
+    };
+
+    const DECLARATION_TYPES = { 'ΑΚΕΡΑΙΕΣ': 'int', 'ΠΡΑΓΜΑΤΙΚΕΣ': 'real', 'ΧΑΡΑΚΤΗΡΕΣ': 'str', 'ΛΟΓΙΚΕΣ': 'bool' };
+    const RETURN_TYPES = { 'ΑΚΕΡΑΙΑ': 'int', 'ΠΡΑΓΜΑΤΙΚΗ': 'real', 'ΧΑΡΑΚΤΗΡΑΣ': 'str', 'ΛΟΓΙΚΗ': 'bool' };
+
+    // Built-in functions: id (BUILTIN operand), result type
+    const BUILTINS = {
+        'Α_Μ': { id: 1, type: 'int' },
+        'Α_Τ': { id: 2, type: null },   // Type of the argument
+        'Τ_Ρ': { id: 3, type: 'real' },
+        'ΗΜ': { id: 4, type: 'real' },
+        'ΣΥΝ': { id: 5, type: 'real' },
+        'ΕΦ': { id: 6, type: 'real' },
+        'ΛΟΓ': { id: 7, type: 'real' },
+        'Ε': { id: 8, type: 'real' }
+    };
+
+    const KEYWORDS = new Set([
+        'ΠΡΟΓΡΑΜΜΑ', 'ΣΤΑΘΕΡΕΣ', 'ΜΕΤΑΒΛΗΤΕΣ', 'ΑΡΧΗ', 'ΤΕΛΟΣ_ΠΡΟΓΡΑΜΜΑΤΟΣ',
+        'ΑΚΕΡΑΙΕΣ', 'ΠΡΑΓΜΑΤΙΚΕΣ', 'ΧΑΡΑΚΤΗΡΕΣ', 'ΛΟΓΙΚΕΣ',
+        'ΑΚΕΡΑΙΑ', 'ΠΡΑΓΜΑΤΙΚΗ', 'ΧΑΡΑΚΤΗΡΑΣ', 'ΛΟΓΙΚΗ',
+        'ΑΛΗΘΗΣ', 'ΨΕΥΔΗΣ', 'DIV', 'MOD', 'ΚΑΙ', 'Η', 'ΟΧΙ',
+        'ΓΡΑΨΕ', 'ΔΙΑΒΑΣΕ', 'ΑΝ', 'ΤΟΤΕ', 'ΑΛΛΙΩΣ_ΑΝ', 'ΑΛΛΙΩΣ', 'ΤΕΛΟΣ_ΑΝ',
+        'ΕΠΙΛΕΞΕ', 'ΠΕΡΙΠΤΩΣΗ', 'ΤΕΛΟΣ_ΕΠΙΛΟΓΩΝ',
+        'ΓΙΑ', 'ΑΠΟ', 'ΜΕΧΡΙ', 'ΜΕ_ΒΗΜΑ', 'ΤΕΛΟΣ_ΕΠΑΝΑΛΗΨΗΣ', 'ΟΣΟ', 'ΕΠΑΝΑΛΑΒΕ',
+        'ΑΡΧΗ_ΕΠΑΝΑΛΗΨΗΣ', 'ΜΕΧΡΙΣ_ΟΤΟΥ',
+        'ΔΙΑΔΙΚΑΣΙΑ', 'ΤΕΛΟΣ_ΔΙΑΔΙΚΑΣΙΑΣ', 'ΣΥΝΑΡΤΗΣΗ', 'ΤΕΛΟΣ_ΣΥΝΑΡΤΗΣΗΣ', 'ΚΑΛΕΣΕ',
+        'ΑΛΓΟΡΙΘΜΟΣ'
+    ]);
+
+    const MAX_ARRAY_ELEMENTS = 10000000;
+    const MAX_ERRORS = 20;
+
+    class GlossaError extends Error {
+        constructor(message, row, col) {
+            super(message);
+            this.row = row;
+            this.col = col;
+        }
+    }
+
+    /**
+     * Upper case without accents: the form keywords and names are compared in
+     * @param {string} word
+     * @returns {string}
+     */
+    function fold(word) {
+        return word.normalize('NFD').replace(/[̀-ͯ]/g, '').toUpperCase();
+    }
+
+    // ===========================================
+    // Lexer
+    // ===========================================
+
+    const IDENT_START = /[A-Za-z_Ͱ-Ͽἀ-῿]/;
+    const IDENT_PART = /[A-Za-z0-9_Ͱ-Ͽἀ-῿]/;
+    const QUOTES = { "'": "'", '"': '"', '‘': '’', '“': '”' };
+    const OPERATORS = ['<-', '<>', '<=', '>=', '..', '+', '-', '*', '/', '^', '=', '<', '>', '(', ')', '[', ']', ',', ':'];
+
+    /**
+     * Tokens of a source: { type: 'kw'|'id'|'num'|'str'|'op'|'nl'|'eof', value, row, col }
+     * (kw and id values are folded; id tokens keep the written form in `text`)
+     */
+    function tokenize(source) {
+        const tokens = [];
+        const lines = source.replace(/\r\n?/g, '\n').split('\n');
+        for (let row = 0; row < lines.length; row++) {
+            const line = lines[row];
+            let col = 0;
+            while (col < line.length) {
+                const ch = line[col];
+                if (ch === ' ' || ch === '\t' || ch === ' ') {
+                    col++;
+                } else if (ch === '!') {
+                    break;
+                } else if (ch === '&' && line.slice(col + 1).trim() === '') {
+                    // The statement continues on the next line
+                    tokens.continued = true;
+                    break;
+                } else if (IDENT_START.test(ch)) {
+                    let end = col + 1;
+                    while (end < line.length && IDENT_PART.test(line[end])) end++;
+                    const text = line.slice(col, end);
+                    const value = fold(text);
+                    tokens.push({ type: KEYWORDS.has(value) ? 'kw' : 'id', value, text, row, col });
+                    col = end;
+                } else if (ch >= '0' && ch <= '9') {
+                    let end = col;
+                    while (end < line.length && line[end] >= '0' && line[end] <= '9') end++;
+                    let isInt = true;
+                    // A decimal point, but not the .. of a range
+                    if (line[end] === '.' && line[end + 1] >= '0' && line[end + 1] <= '9') {
+                        isInt = false;
+                        end++;
+                        while (end < line.length && line[end] >= '0' && line[end] <= '9') end++;
+                    }
+                    tokens.push({ type: 'num', value: Number(line.slice(col, end)), isInt, row, col });
+                    col = end;
+                } else if (QUOTES[ch]) {
+                    const close = line.indexOf(QUOTES[ch], col + 1);
+                    if (close === -1) throw new GlossaError('Η σταθερά χαρακτήρων δεν κλείνει σε αυτή τη γραμμή', row, col);
+                    tokens.push({ type: 'str', value: line.slice(col + 1, close), row, col });
+                    col = close + 1;
+                } else if (ch === '←') {
+                    tokens.push({ type: 'op', value: '<-', row, col });
+                    col++;
+                } else {
+                    const op = OPERATORS.find(candidate => line.startsWith(candidate, col));
+                    if (!op) throw new GlossaError(`Άγνωστος χαρακτήρας '${ch}'`, row, col);
+                    tokens.push({ type: 'op', value: op, row, col });
+                    col += op.length;
+                }
+            }
+            if (tokens.continued) {
+                tokens.continued = false;
+            } else {
+                tokens.push({ type: 'nl', value: '\n', row, col: line.length });
+            }
+        }
+        tokens.push({ type: 'eof', value: '', row: lines.length - 1, col: 0 });
+        return tokens;
+    }
+
+    // ===========================================
+    // Parser (source -> syntax tree)
+    // ===========================================
+
+    class Parser {
+        constructor(tokens) {
+            this.tokens = tokens;
+            this.pos = 0;
+        }
+
+        get token() {
+            return this.tokens[this.pos];
+        }
+
+        is(type, value) {
+            const token = this.tokens[this.pos];
+            return token.type === type && (value === undefined || token.value === value);
+        }
+
+        isKeyword(...words) {
+            const token = this.tokens[this.pos];
+            return token.type === 'kw' && words.includes(token.value);
+        }
+
+        accept(type, value) {
+            if (!this.is(type, value)) return null;
+            return this.tokens[this.pos++];
+        }
+
+        expect(type, value, what) {
+            const token = this.accept(type, value);
+            if (token) return token;
+            throw this.error(`Περίμενα ${what || value}`);
+        }
+
+        error(message, token = this.token) {
+            const found = token.type === 'nl' ? 'το τέλος της γραμμής'
+                : token.type === 'eof' ? 'το τέλος του προγράμματος'
+                    : `'${token.text || token.value}'`;
+            return new GlossaError(`${message}, βρέθηκε ${found}`, token.row, token.col);
+        }
+
+        skipNewlines() {
+            while (this.is('nl')) this.pos++;
+        }
+
+        endOfLine() {
+            if (!this.is('eof')) this.expect('nl', undefined, 'αλλαγή γραμμής');
+            this.skipNewlines();
+        }
+
+        name(what = 'όνομα') {
+            const token = this.token;
+            if (token.type !== 'id') throw this.error(`Περίμενα ${what}`);
+            this.pos++;
+            return { name: token.value, text: token.text, row: token.row, col: token.col };
+        }
+
+        parseFile() {
+            this.skipNewlines();
+            if (this.isKeyword('ΑΛΓΟΡΙΘΜΟΣ')) {
+                throw new GlossaError('Εκτελούνται μόνο προγράμματα ΓΛΩΣΣΑΣ (ΠΡΟΓΡΑΜΜΑ ... ΤΕΛΟΣ_ΠΡΟΓΡΑΜΜΑΤΟΣ), όχι ψευδογλώσσα', this.token.row, this.token.col);
+            }
+            const subprograms = [];
+            let program = null;
+            while (!this.is('eof')) {
+                if (this.isKeyword('ΔΙΑΔΙΚΑΣΙΑ', 'ΣΥΝΑΡΤΗΣΗ')) {
+                    subprograms.push(this.parseSubprogram());
+                } else if (this.isKeyword('ΠΡΟΓΡΑΜΜΑ') && !program) {
+                    program = this.parseProgram();
+                } else {
+                    throw this.error(program ? 'Περίμενα ΔΙΑΔΙΚΑΣΙΑ ή ΣΥΝΑΡΤΗΣΗ' : 'Περίμενα ΠΡΟΓΡΑΜΜΑ');
+                }
+                this.skipNewlines();
+            }
+            if (!program) throw new GlossaError('Λείπει το ΠΡΟΓΡΑΜΜΑ', 0, 0);
+            program.subprograms = subprograms;
+            return program;
+        }
+
+        parseProgram() {
+            const start = this.expect('kw', 'ΠΡΟΓΡΑΜΜΑ');
+            const name = this.name('όνομα προγράμματος');
+            this.endOfLine();
+            const routine = { kind: 'program', name, row: start.row, col: start.col, params: [] };
+            this.parseDeclarations(routine);
+            routine.body = this.parseBlock(['ΤΕΛΟΣ_ΠΡΟΓΡΑΜΜΑΤΟΣ']);
+            routine.endRow = this.token.row;
+            this.expect('kw', 'ΤΕΛΟΣ_ΠΡΟΓΡΑΜΜΑΤΟΣ');
+            if (this.is('id')) this.pos++; // Optional name after it
+            this.endOfLine();
+            return routine;
+        }
+
+        parseSubprogram() {
+            const start = this.token;
+            const isFunction = this.accept('kw', 'ΣΥΝΑΡΤΗΣΗ') !== null;
+            if (!isFunction) this.expect('kw', 'ΔΙΑΔΙΚΑΣΙΑ');
+            const name = this.name(isFunction ? 'όνομα συνάρτησης' : 'όνομα διαδικασίας');
+            const routine = { kind: isFunction ? 'function' : 'procedure', name, row: start.row, col: start.col, params: [] };
+            if (this.accept('op', '(')) {
+                if (!this.is('op', ')')) {
+                    do {
+                        const param = this.name('όνομα παραμέτρου');
+                        // `Π[100]`: an array parameter ΜΕΤΑΒΛΗΤΕΣ may leave out
+                        param.dims = this.accept('op', '[') ? this.parseList(']') : null;
+                        routine.params.push(param);
+                    } while (this.accept('op', ','));
+                }
+                this.expect('op', ')');
+            }
+            if (isFunction) {
+                this.expect('op', ':', "':' και τύπο συνάρτησης");
+                const type = this.token;
+                if (type.type !== 'kw' || !RETURN_TYPES[type.value]) {
+                    throw this.error('Περίμενα τύπο συνάρτησης (ΑΚΕΡΑΙΑ, ΠΡΑΓΜΑΤΙΚΗ, ΧΑΡΑΚΤΗΡΑΣ, ΛΟΓΙΚΗ)');
+                }
+                this.pos++;
+                routine.returnType = RETURN_TYPES[type.value];
+            }
+            this.endOfLine();
+            this.parseDeclarations(routine, false);
+            const end = isFunction ? 'ΤΕΛΟΣ_ΣΥΝΑΡΤΗΣΗΣ' : 'ΤΕΛΟΣ_ΔΙΑΔΙΚΑΣΙΑΣ';
+            routine.body = this.parseBlock([end]);
+            routine.endRow = this.token.row;
+            this.expect('kw', end);
+            this.endOfLine();
+            return routine;
+        }
+
+        // ΣΤΑΘΕΡΕΣ, ΜΕΤΑΒΛΗΤΕΣ and ΑΡΧΗ (often left out of subprograms)
+        parseDeclarations(routine, requireStart = true) {
+            routine.constants = [];
+            routine.variables = [];
+            if (this.accept('kw', 'ΣΤΑΘΕΡΕΣ')) {
+                this.endOfLine();
+                while (this.is('id')) {
+                    const name = this.name();
+                    this.expect('op', '=', "'='");
+                    routine.constants.push({ ...name, expr: this.parseExpression() });
+                    this.endOfLine();
+                }
+            }
+            if (this.accept('kw', 'ΜΕΤΑΒΛΗΤΕΣ')) {
+                this.endOfLine();
+                while (this.token.type === 'kw' && DECLARATION_TYPES[this.token.value]) {
+                    const type = DECLARATION_TYPES[this.tokens[this.pos++].value];
+                    this.expect('op', ':', "':'");
+                    if (!this.is('nl')) {
+                        do {
+                            const name = this.name('όνομα μεταβλητής');
+                            let dims = null;
+                            if (this.accept('op', '[')) {
+                                dims = this.parseList(']');
+                            }
+                            routine.variables.push({ ...name, type, dims });
+                        } while (this.accept('op', ','));
+                    }
+                    this.endOfLine();
+                }
+            }
+            if (this.accept('kw', 'ΑΡΧΗ')) {
+                this.endOfLine();
+            } else if (requireStart) {
+                this.expect('kw', 'ΑΡΧΗ');
+            }
+        }
+
+        parseList(close) {
+            const items = [];
+            do {
+                items.push(this.parseExpression());
+            } while (this.accept('op', ','));
+            this.expect('op', close);
+            return items;
+        }
+
+        // Statements up to one of the closing keywords (not consumed). A block
+        // starting on the line of its ΤΟΤΕ / ΑΛΛΙΩΣ may keep going on that line
+        // (ΑΝ x > 0 ΤΟΤΕ y <- 1 ΤΕΛΟΣ_ΑΝ).
+        parseBlock(closers) {
+            const statements = [];
+            let inline = !this.is('nl');
+            this.skipNewlines();
+            while (!this.isKeyword(...closers)) {
+                if (this.is('eof')) {
+                    throw this.error(`Περίμενα ${closers[0]}`);
+                }
+                statements.push(this.parseStatement());
+                if (!inline || this.is('nl') || this.is('eof')) {
+                    inline = false;
+                    this.endOfLine();
+                }
+            }
+            return statements;
+        }
+
+        parseStatement() {
+            const token = this.token;
+            const at = { row: token.row, col: token.col };
+            if (token.type === 'id') {
+                const target = this.parseTarget();
+                this.expect('op', '<-', "'<-'");
+                return { kind: 'assign', target, expr: this.parseExpression(), ...at };
+            }
+            if (token.type !== 'kw') throw this.error('Περίμενα εντολή');
+            this.pos++;
+            switch (token.value) {
+                case 'ΓΡΑΨΕ': {
+                    // A trailing comma keeps the next ΓΡΑΨΕ on the same line
+                    const items = [];
+                    let newline = true;
+                    if (!this.is('nl') && !this.is('eof')) {
+                        do {
+                            if (this.is('nl') || this.is('eof')) {
+                                newline = false;
+                                break;
+                            }
+                            items.push(this.parseExpression());
+                        } while (this.accept('op', ','));
+                    }
+                    return { kind: 'write', items, newline, ...at };
+                }
+                case 'ΔΙΑΒΑΣΕ': {
+                    const targets = [];
+                    do {
+                        targets.push(this.parseTarget());
+                    } while (this.accept('op', ','));
+                    return { kind: 'read', targets, ...at };
+                }
+                case 'ΑΝ': {
+                    const branches = [];
+                    let elseBody = null;
+                    let cond = this.parseExpression();
+                    this.expect('kw', 'ΤΟΤΕ');
+                    for (;;) {
+                        const body = this.parseBlock(['ΑΛΛΙΩΣ_ΑΝ', 'ΑΛΛΙΩΣ', 'ΤΕΛΟΣ_ΑΝ']);
+                        branches.push({ cond, body });
+                        if (this.accept('kw', 'ΑΛΛΙΩΣ_ΑΝ')) {
+                            cond = this.parseExpression();
+                            this.expect('kw', 'ΤΟΤΕ');
+                            continue;
+                        }
+                        if (this.accept('kw', 'ΑΛΛΙΩΣ')) {
+                            elseBody = this.parseBlock(['ΤΕΛΟΣ_ΑΝ']);
+                        }
+                        break;
+                    }
+                    this.expect('kw', 'ΤΕΛΟΣ_ΑΝ');
+                    return { kind: 'if', branches, elseBody, ...at };
+                }
+                case 'ΕΠΙΛΕΞΕ': {
+                    const expr = this.parseExpression();
+                    this.endOfLine();
+                    const cases = [];
+                    let elseBody = null;
+                    while (this.accept('kw', 'ΠΕΡΙΠΤΩΣΗ')) {
+                        if (this.accept('kw', 'ΑΛΛΙΩΣ')) {
+                            elseBody = this.parseBlock(['ΤΕΛΟΣ_ΕΠΙΛΟΓΩΝ']);
+                            break;
+                        }
+                        const items = [];
+                        do {
+                            items.push(this.parseCaseItem());
+                        } while (this.accept('op', ','));
+                        cases.push({ items, body: this.parseBlock(['ΠΕΡΙΠΤΩΣΗ', 'ΤΕΛΟΣ_ΕΠΙΛΟΓΩΝ']) });
+                    }
+                    this.expect('kw', 'ΤΕΛΟΣ_ΕΠΙΛΟΓΩΝ');
+                    return { kind: 'select', expr, cases, elseBody, ...at };
+                }
+                case 'ΓΙΑ': {
+                    const variable = this.name('μεταβλητή ελέγχου');
+                    this.expect('kw', 'ΑΠΟ');
+                    const from = this.parseExpression();
+                    this.expect('kw', 'ΜΕΧΡΙ');
+                    const to = this.parseExpression();
+                    let step = null;
+                    if (this.accept('kw', 'ΜΕ_ΒΗΜΑ')) {
+                        step = this.parseExpression();
+                    } else if (this.is('id', 'ΜΕ') && this.tokens[this.pos + 1].value === 'ΒΗΜΑ') {
+                        this.pos += 2;
+                        step = this.parseExpression();
+                    }
+                    const body = this.parseBlock(['ΤΕΛΟΣ_ΕΠΑΝΑΛΗΨΗΣ']);
+                    this.expect('kw', 'ΤΕΛΟΣ_ΕΠΑΝΑΛΗΨΗΣ');
+                    return { kind: 'for', variable, from, to, step, body, ...at };
+                }
+                case 'ΟΣΟ': {
+                    const cond = this.parseExpression();
+                    this.expect('kw', 'ΕΠΑΝΑΛΑΒΕ');
+                    const body = this.parseBlock(['ΤΕΛΟΣ_ΕΠΑΝΑΛΗΨΗΣ']);
+                    this.expect('kw', 'ΤΕΛΟΣ_ΕΠΑΝΑΛΗΨΗΣ');
+                    return { kind: 'while', cond, body, ...at };
+                }
+                case 'ΑΡΧΗ_ΕΠΑΝΑΛΗΨΗΣ': {
+                    const body = this.parseBlock(['ΜΕΧΡΙΣ_ΟΤΟΥ']);
+                    this.expect('kw', 'ΜΕΧΡΙΣ_ΟΤΟΥ');
+                    return { kind: 'repeat', body, cond: this.parseExpression(), ...at };
+                }
+                case 'ΚΑΛΕΣΕ': {
+                    const name = this.name('όνομα διαδικασίας');
+                    const args = this.accept('op', '(') ? (this.is('op', ')') ? (this.pos++, []) : this.parseList(')')) : [];
+                    return { kind: 'procedureCall', name, args, ...at };
+                }
+                default:
+                    this.pos--;
+                    throw this.error('Περίμενα εντολή');
+            }
+        }
+
+        parseTarget() {
+            const name = this.name('μεταβλητή');
+            const indices = this.accept('op', '[') ? this.parseList(']') : null;
+            return { ...name, indices };
+        }
+
+        parseCaseItem() {
+            const token = this.token;
+            if (token.type === 'op' && ['<', '>', '<=', '>=', '<>', '='].includes(token.value)) {
+                this.pos++;
+                return { kind: 'compare', op: token.value, expr: this.parseAdditive() };
+            }
+            // A full expression, for ΕΠΙΛΕΞΕ ΑΛΗΘΗΣ / ΠΕΡΙΠΤΩΣΗ x > 20
+            const from = this.parseExpression();
+            if (this.accept('op', '..')) {
+                return { kind: 'range', from, to: this.parseAdditive() };
+            }
+            return { kind: 'value', expr: from };
+        }
+
+        // Precedence, lowest first: Η, ΚΑΙ, ΟΧΙ, comparisons, + -, * / DIV MOD, unary -, ^
+        parseExpression() {
+            let left = this.parseAnd();
+            while (this.is('kw', 'Η')) {
+                const op = this.tokens[this.pos++];
+                left = { kind: 'binary', op: 'Η', left, right: this.parseAnd(), row: op.row, col: op.col };
+            }
+            return left;
+        }
+
+        parseAnd() {
+            let left = this.parseNot();
+            while (this.is('kw', 'ΚΑΙ')) {
+                const op = this.tokens[this.pos++];
+                left = { kind: 'binary', op: 'ΚΑΙ', left, right: this.parseNot(), row: op.row, col: op.col };
+            }
+            return left;
+        }
+
+        parseNot() {
+            if (this.is('kw', 'ΟΧΙ')) {
+                const op = this.tokens[this.pos++];
+                return { kind: 'unary', op: 'ΟΧΙ', operand: this.parseNot(), row: op.row, col: op.col };
+            }
+            return this.parseComparison();
+        }
+
+        parseComparison() {
+            const left = this.parseAdditive();
+            const token = this.token;
+            if (token.type === 'op' && ['=', '<>', '<', '>', '<=', '>='].includes(token.value)) {
+                this.pos++;
+                return { kind: 'binary', op: token.value, left, right: this.parseAdditive(), row: token.row, col: token.col };
+            }
+            return left;
+        }
+
+        parseAdditive() {
+            let left = this.parseMultiplicative();
+            while (this.is('op', '+') || this.is('op', '-')) {
+                const op = this.tokens[this.pos++];
+                left = { kind: 'binary', op: op.value, left, right: this.parseMultiplicative(), row: op.row, col: op.col };
+            }
+            return left;
+        }
+
+        parseMultiplicative() {
+            let left = this.parseUnary();
+            while (this.is('op', '*') || this.is('op', '/') || this.is('kw', 'DIV') || this.is('kw', 'MOD')) {
+                const op = this.tokens[this.pos++];
+                left = { kind: 'binary', op: op.value, left, right: this.parseUnary(), row: op.row, col: op.col };
+            }
+            return left;
+        }
+
+        parseUnary() {
+            if (this.is('op', '-') || this.is('op', '+')) {
+                const op = this.tokens[this.pos++];
+                const operand = this.parseUnary();
+                return op.value === '-' ? { kind: 'unary', op: '-', operand, row: op.row, col: op.col } : operand;
+            }
+            return this.parsePower();
+        }
+
+        parsePower() {
+            const base = this.parsePrimary();
+            if (this.is('op', '^')) {
+                const op = this.tokens[this.pos++];
+                return { kind: 'binary', op: '^', left: base, right: this.parseUnary(), row: op.row, col: op.col };
+            }
+            return base;
+        }
+
+        parsePrimary() {
+            const token = this.token;
+            const at = { row: token.row, col: token.col };
+            switch (token.type) {
+                case 'num':
+                    this.pos++;
+                    return { kind: 'literal', value: token.value, type: token.isInt ? 'int' : 'real', ...at };
+                case 'str':
+                    this.pos++;
+                    return { kind: 'literal', value: token.value, type: 'str', ...at };
+                case 'kw':
+                    if (token.value === 'ΑΛΗΘΗΣ' || token.value === 'ΨΕΥΔΗΣ') {
+                        this.pos++;
+                        return { kind: 'literal', value: token.value === 'ΑΛΗΘΗΣ', type: 'bool', ...at };
+                    }
+                    break;
+                case 'op':
+                    if (token.value === '(') {
+                        this.pos++;
+                        const inner = this.parseExpression();
+                        this.expect('op', ')', "')'");
+                        return inner;
+                    }
+                    break;
+                case 'id': {
+                    const name = this.name();
+                    if (this.accept('op', '(')) {
+                        const args = this.is('op', ')') ? (this.pos++, []) : this.parseList(')');
+                        return { kind: 'call', ...name, args };
+                    }
+                    const indices = this.accept('op', '[') ? this.parseList(']') : null;
+                    return { kind: 'name', ...name, indices };
+                }
+            }
+            throw this.error('Περίμενα τιμή ή έκφραση');
+        }
+    }
+
+    // ===========================================
+    // Checks and code generation
+    // ===========================================
+
+    const isNumeric = type => type === 'int' || type === 'real' || type === 'any';
+
+    class Generator {
+        constructor(file) {
+            this.file = file;
+            this.errors = [];
+            this.constants = [];            // Constant pool shared by the routines
+            this._constantIndex = new Map();
+            this.routines = [];
+            this.routineIndex = new Map();  // folded name -> index
+        }
+
+        generate() {
+            const all = [this.file, ...this.file.subprograms];
+            all.forEach(routine => {
+                if (routine.kind !== 'program' && this.routineIndex.has(routine.name.name)) {
+                    this.error(`Το υποπρόγραμμα ${routine.name.text} ορίζεται δύο φορές`, routine.name);
+                    return;
+                }
+                this.routineIndex.set(routine.kind === 'program' ? '' : routine.name.name, this.routines.length);
+                this.routines.push({ syntax: routine });
+            });
+            // Signatures first, so calls can be checked wherever the subprogram is
+            this.routines.forEach(entry => this._declare(entry));
+            this.routines.forEach(entry => this._compileRoutine(entry));
+            if (this.errors.length > 0) return { errors: this.errors };
+            return {
+                program: {
+                    constants: this.constants,
+                    routines: this.routines.map(entry => entry.compiled)
+                }
+            };
+        }
+
+        error(message, at) {
+            if (this.errors.length < MAX_ERRORS) {
+                this.errors.push({ row: at.row, col: at.col, message });
+            }
+        }
+
+        constant(value) {
+            const key = `${typeof value}:${value}`;
+            if (!this._constantIndex.has(key)) {
+                this._constantIndex.set(key, this.constants.length);
+                this.constants.push(value);
+            }
+            return this._constantIndex.get(key);
+        }
+
+        // Symbols of a routine: constants, variables, arrays and parameters
+        _declare(entry) {
+            const routine = entry.syntax;
+            const symbols = new Map();
+            const slotNames = [];
+            const addSlot = (name) => {
+                slotNames.push(name);
+                return slotNames.length - 1;
+            };
+            const arrays = [];
+
+            routine.constants.forEach(constant => {
+                if (symbols.has(constant.name)) {
+                    this.error(`Το ${constant.text} δηλώνεται δύο φορές`, constant);
+                    return;
+                }
+                const value = this._constantValue(constant.expr, symbols);
+                if (value) symbols.set(constant.name, { kind: 'const', type: value.type, value: value.value });
+            });
+
+            const params = routine.params.map(param => param.name);
+            params.forEach((name, i) => {
+                if (params.indexOf(name) !== i) this.error(`Η παράμετρος ${routine.params[i].text} επαναλαμβάνεται`, routine.params[i]);
+            });
+
+            routine.variables.forEach(variable => {
+                if (symbols.has(variable.name)) {
+                    this.error(`Το ${variable.text} δηλώνεται δύο φορές`, variable);
+                    return;
+                }
+                if (routine.kind === 'function' && variable.name === routine.name.name) {
+                    this.error(`Το όνομα της συνάρτησης ${variable.text} δεν δηλώνεται ως μεταβλητή`, variable);
+                    return;
+                }
+                const isParam = params.includes(variable.name);
+                const symbol = { kind: 'var', type: variable.type, slot: addSlot(variable.text), param: isParam };
+                if (variable.dims) {
+                    const dims = variable.dims.map(expr => {
+                        const value = this._constantValue(expr, symbols);
+                        if (value && (value.type !== 'int' || value.value < 1)) {
+                            this.error('Το μέγεθος πίνακα πρέπει να είναι θετικός ακέραιος', expr);
+                            return 1;
+                        }
+                        return value ? value.value : 1;
+                    });
+                    if (dims.reduce((a, b) => a * b, 1) > MAX_ARRAY_ELEMENTS) {
+                        this.error(`Ο πίνακας ${variable.text} είναι πολύ μεγάλος`, variable);
+                    }
+                    symbol.kind = 'array';
+                    symbol.dims = dims;
+                    if (!isParam) arrays.push({ slot: symbol.slot, dims, type: TYPE[variable.type], name: variable.text });
+                }
+                symbols.set(variable.name, symbol);
+            });
+
+            // Parameters not declared in ΜΕΤΑΒΛΗΤΕΣ take any type
+            const paramSymbols = routine.params.map(param => {
+                if (!symbols.has(param.name)) {
+                    const symbol = { kind: 'var', type: 'any', slot: addSlot(param.text), param: true };
+                    if (param.dims) {
+                        symbol.kind = 'array';
+                        symbol.dims = param.dims.map(() => 0); // Sizes come with the argument
+                    }
+                    symbols.set(param.name, symbol);
+                }
+                const symbol = symbols.get(param.name);
+                if (symbol.kind === 'const') this.error(`Η παράμετρος ${param.text} είναι σταθερά`, param);
+                return symbol;
+            });
+
+            entry.symbols = symbols;
+            entry.slotNames = slotNames;
+            entry.arrays = arrays;
+            entry.params = paramSymbols;
+            if (routine.kind === 'function') {
+                entry.resultSlot = addSlot(routine.name.text);
+            }
+        }
+
+        // Value of a constant expression (ΣΤΑΘΕΡΕΣ, array sizes): { type, value } or null
+        _constantValue(expr, symbols) {
+            if (expr.kind === 'literal') return { type: expr.type, value: expr.value };
+            if (expr.kind === 'name' && !expr.indices) {
+                const symbol = symbols.get(expr.name);
+                if (symbol && symbol.kind === 'const') return { type: symbol.type, value: symbol.value };
+            }
+            if (expr.kind === 'unary' && expr.op === '-') {
+                const value = this._constantValue(expr.operand, symbols);
+                if (value && isNumeric(value.type)) return { type: value.type, value: -value.value };
+            }
+            if (expr.kind === 'binary' && ['+', '-', '*'].includes(expr.op)) {
+                const left = this._constantValue(expr.left, symbols);
+                const right = this._constantValue(expr.right, symbols);
+                if (left && right && isNumeric(left.type) && isNumeric(right.type)) {
+                    const value = expr.op === '+' ? left.value + right.value
+                        : expr.op === '-' ? left.value - right.value : left.value * right.value;
+                    return { type: left.type === 'int' && right.type === 'int' ? 'int' : 'real', value };
+                }
+            }
+            this.error('Περίμενα σταθερή τιμή', expr);
+            return null;
+        }
+
+        _compileRoutine(entry) {
+            const routine = entry.syntax;
+            this.current = entry;
+            this.code = [];
+            this.lines = [];
+            this.row = routine.row;
+            this.loopVariables = [];   // Control variables of the enclosing ΓΙΑ
+            this.temps = 0;
+
+            this._block(routine.body);
+            this.row = routine.endRow;
+            this._emit(routine.kind === 'program' ? OP.HALT : OP.RETURN);
+
+            entry.compiled = {
+                name: routine.kind === 'program' ? routine.name.text : routine.name.text,
+                kind: routine.kind,
+                code: Int32Array.from(this.code),
+                lines: Int32Array.from(this.lines),
+                slotCount: entry.slotNames.length + this.temps,
+                slotNames: entry.slotNames,
+                arrays: entry.arrays,
+                params: entry.params.map(symbol => ({
+                    slot: symbol.slot,
+                    array: symbol.kind === 'array',
+                    dims: symbol.dims ? symbol.dims.length : 0,
+                    type: TYPE[symbol.type]
+                })),
+                resultSlot: entry.resultSlot === undefined ? -1 : entry.resultSlot,
+                returnType: routine.returnType ? TYPE[routine.returnType] : 0
+            };
+        }
+
+        _emit(...words) {
+            for (const word of words) {
+                this.code.push(word);
+                this.lines.push(this.row);
+            }
+            return this.code.length;
+        }
+
+        // Hidden slot of the routine (loop bounds, selector, ...)
+        _temp() {
+            return this.current.slotNames.length + this.temps++;
+        }
+
+        _block(statements) {
+            statements.forEach(statement => {
+                this.row = statement.row;
+                try {
+                    this._statement(statement);
+                } catch (error) {
+                    if (!(error instanceof GlossaError)) throw error;
+                    this.error(error.message, error);
+                }
+            });
+        }
+
+        _statement(statement) {
+            switch (statement.kind) {
+                case 'assign': {
+                    const target = this._target(statement.target, 'assign');
+                    const type = this._expression(statement.expr);
+                    this._storeTarget(target, type, statement.expr);
+                    break;
+                }
+                case 'write':
+                    statement.items.forEach(item => {
+                        if (item.kind === 'name' && !item.indices && this._lookup(item).kind === 'array') {
+                            throw new GlossaError(`Ο πίνακας ${item.text} γράφεται στοιχείο προς στοιχείο`, item.row, item.col);
+                        }
+                        this._expression(item);
+                    });
+                    this._emit(OP.WRITE, statement.items.length, statement.newline ? 1 : 0);
+                    break;
+                case 'read':
+                    statement.targets.forEach(lvalue => {
+                        const target = this._target(lvalue, 'read');
+                        if (target.indices) {
+                            this._emit(OP.AREAD, target.symbol.slot, TYPE[target.symbol.type]);
+                        } else {
+                            this._emit(OP.READ, target.symbol.slot, TYPE[target.symbol.type]);
+                        }
+                    });
+                    break;
+                case 'if': {
+                    const exits = [];
+                    statement.branches.forEach(branch => {
+                        this.row = branch.cond.row;
+                        this._condition(branch.cond);
+                        const skip = this._emit(OP.JMP_FALSE, 0);
+                        this._block(branch.body);
+                        if (statement.elseBody || branch !== statement.branches[statement.branches.length - 1]) {
+                            exits.push(this._emit(OP.JMP, 0));
+                        }
+                        this.code[skip - 1] = this.code.length;
+                    });
+                    if (statement.elseBody) this._block(statement.elseBody);
+                    exits.forEach(at => { this.code[at - 1] = this.code.length; });
+                    break;
+                }
+                case 'select':
+                    this._select(statement);
+                    break;
+                case 'for':
+                    this._for(statement);
+                    break;
+                case 'while': {
+                    const top = this.code.length;
+                    this._condition(statement.cond);
+                    const exit = this._emit(OP.JMP_FALSE, 0);
+                    this._block(statement.body);
+                    this.row = statement.row;
+                    this._emit(OP.JMP, top);
+                    this.code[exit - 1] = this.code.length;
+                    break;
+                }
+                case 'repeat': {
+                    const top = this.code.length;
+                    this._block(statement.body);
+                    this.row = statement.cond.row;
+                    this._condition(statement.cond);
+                    this._emit(OP.JMP_FALSE, top);
+                    break;
+                }
+                case 'procedureCall':
+                    this._call(statement, 'procedure');
+                    break;
+            }
+        }
+
+        _lookup(name) {
+            const symbol = this.current.symbols.get(name.name);
+            if (symbol) return symbol;
+            if (this.current.syntax.kind === 'function' && name.name === this.current.syntax.name.name) {
+                return { kind: 'result', type: this.current.syntax.returnType, slot: this.current.resultSlot };
+            }
+            throw new GlossaError(`Η μεταβλητή ${name.text} δεν έχει δηλωθεί`, name.row, name.col);
+        }
+
+        // Resolve an assignment / ΔΙΑΒΑΣΕ target and push its flat index if it is an element
+        _target(lvalue, use) {
+            const symbol = this._lookup(lvalue);
+            if (symbol.kind === 'const') {
+                throw new GlossaError(`Η σταθερά ${lvalue.text} δεν αλλάζει τιμή`, lvalue.row, lvalue.col);
+            }
+            if (symbol.kind === 'result' && use === 'read') {
+                throw new GlossaError(`Το όνομα της συνάρτησης ${lvalue.text} δεν διαβάζεται`, lvalue.row, lvalue.col);
+            }
+            if (!lvalue.indices && this.loopVariables.includes(lvalue.name)) {
+                throw new GlossaError(`Η μεταβλητή ελέγχου ${lvalue.text} δεν αλλάζει μέσα στο ΓΙΑ`, lvalue.row, lvalue.col);
+            }
+            this._checkIndices(lvalue, symbol);
+            if (lvalue.indices) this._index(lvalue, symbol);
+            return { symbol, indices: lvalue.indices, name: lvalue };
+        }
+
+        _checkIndices(name, symbol) {
+            if (symbol.kind === 'array' && !name.indices) {
+                throw new GlossaError(`Ο πίνακας ${name.text} χρειάζεται δείκτες`, name.row, name.col);
+            }
+            if (symbol.kind !== 'array' && name.indices) {
+                throw new GlossaError(`Το ${name.text} δεν είναι πίνακας`, name.row, name.col);
+            }
+            if (name.indices && name.indices.length !== symbol.dims.length) {
+                throw new GlossaError(`Ο πίνακας ${name.text} έχει ${symbol.dims.length} διαστάσεις`, name.row, name.col);
+            }
+        }
+
+        _index(name, symbol) {
+            name.indices.forEach(index => {
+                const type = this._expression(index);
+                if (type !== 'int' && type !== 'any') {
+                    throw new GlossaError('Ο δείκτης πίνακα πρέπει να είναι ακέραιος', index.row, index.col);
+                }
+            });
+            this._emit(OP.INDEX, symbol.slot, name.indices.length);
+        }
+
+        _storeTarget(target, type, at) {
+            const targetType = target.symbol.type;
+            this._checkAssignable(targetType, type, at);
+            const slot = target.symbol.slot;
+            let op;
+            if (targetType === 'int' && type !== 'int') op = 'INT';       // From an unknown type
+            else if (type === 'any' && targetType !== 'any' && targetType !== 'real') op = 'CHECK';
+            else if (type === 'any' && targetType === 'real') op = 'CHECK';
+            if (target.indices) {
+                if (op === 'INT') this._emit(OP.ASTORE_INT, slot);
+                else if (op === 'CHECK') this._emit(OP.ASTORE_CHECK, slot, TYPE[targetType]);
+                else this._emit(OP.ASTORE, slot);
+            } else if (op === 'INT') {
+                this._emit(OP.STORE_INT, slot);
+            } else if (op === 'CHECK') {
+                this._emit(OP.STORE_CHECK, slot, TYPE[targetType]);
+            } else {
+                this._emit(OP.STORE, slot);
+            }
+        }
+
+        _checkAssignable(targetType, type, at) {
+            if (targetType === 'any' || type === 'any' || targetType === type) return;
+            if (targetType === 'real' && type === 'int') return;
+            throw new GlossaError(`Ασύμβατοι τύποι: τιμή ${TYPE_NAMES[type]} σε μεταβλητή ${TYPE_NAMES[targetType]}`, at.row, at.col);
+        }
+
+        _condition(expr) {
+            const type = this._expression(expr);
+            if (type === 'any') {
+                this._emit(OP.CHECK, TYPE.bool);
+            } else if (type !== 'bool') {
+                throw new GlossaError('Η συνθήκη πρέπει να είναι λογική έκφραση', expr.row, expr.col);
+            }
+        }
+
+        _select(statement) {
+            const selectorType = this._expression(statement.expr);
+            const selector = this._temp();
+            this._emit(OP.STORE, selector);
+            const exits = [];
+            statement.cases.forEach(branch => {
+                // Any matching item jumps into the body
+                const matches = [];
+                branch.items.forEach(item => {
+                    if (item.kind === 'range') {
+                        this._emit(OP.LOAD_RAW, selector);
+                        this._compatible(selectorType, this._expression(item.from), item.from);
+                        this._emit(OP.GE);
+                        this._emit(OP.LOAD_RAW, selector);
+                        this._compatible(selectorType, this._expression(item.to), item.to);
+                        this._emit(OP.LE, OP.AND);
+                    } else {
+                        this._emit(OP.LOAD_RAW, selector);
+                        this._compatible(selectorType, this._expression(item.expr), item.expr);
+                        const op = item.kind === 'compare' ? item.op : '=';
+                        this._emit(COMPARISONS[op]);
+                    }
+                    matches.push(this._emit(OP.JMP_TRUE, 0));
+                });
+                const skip = this._emit(OP.JMP, 0);
+                matches.forEach(at => { this.code[at - 1] = this.code.length; });
+                this._block(branch.body);
+                exits.push(this._emit(OP.JMP, 0));
+                this.code[skip - 1] = this.code.length;
+            });
+            if (statement.elseBody) this._block(statement.elseBody);
+            exits.forEach(at => { this.code[at - 1] = this.code.length; });
+        }
+
+        _for(statement) {
+            const symbol = this._lookup(statement.variable);
+            if (symbol.kind !== 'var') {
+                throw new GlossaError(`Η μεταβλητή ελέγχου ${statement.variable.text} πρέπει να είναι απλή μεταβλητή`, statement.variable.row, statement.variable.col);
+            }
+            if (!isNumeric(symbol.type)) {
+                throw new GlossaError('Η μεταβλητή ελέγχου πρέπει να είναι αριθμητική', statement.variable.row, statement.variable.col);
+            }
+            if (this.loopVariables.includes(statement.variable.name)) {
+                throw new GlossaError(`Η μεταβλητή ελέγχου ${statement.variable.text} χρησιμοποιείται ήδη από εξωτερικό ΓΙΑ`, statement.variable.row, statement.variable.col);
+            }
+            const bound = (expr) => {
+                const type = this._expression(expr);
+                if (type === 'any') this._emit(OP.CHECK, TYPE.real);
+                else if (!isNumeric(type)) throw new GlossaError('Τα όρια του ΓΙΑ πρέπει να είναι αριθμοί', expr.row, expr.col);
+                if (symbol.type === 'int' && type === 'real') {
+                    throw new GlossaError('Η ακέραια μεταβλητή ελέγχου παίρνει μόνο ακέραιες τιμές', expr.row, expr.col);
+                }
+            };
+            const end = this._temp();
+            const step = this._temp();
+            bound(statement.from);
+            this._emit(symbol.type === 'int' ? OP.STORE_INT : OP.STORE, symbol.slot);
+            bound(statement.to);
+            this._emit(OP.STORE, end);
+            if (statement.step) {
+                bound(statement.step);
+            } else {
+                this._emit(OP.PUSH, this.constant(1));
+            }
+            this._emit(OP.STORE, step);
+
+            this.row = statement.row;
+            const exit = this._emit(OP.FOR_INIT, symbol.slot, end, step, 0);
+            const body = this.code.length;
+            this.loopVariables.push(statement.variable.name);
+            this._block(statement.body);
+            this.loopVariables.pop();
+            this.row = statement.row;
+            this._emit(OP.FOR_NEXT, symbol.slot, end, step, body);
+            this.code[exit - 1] = this.code.length;
+        }
+
+        _compatible(selectorType, type, at) {
+            if (selectorType === 'any' || type === 'any') return;
+            if (isNumeric(selectorType) && isNumeric(type)) return;
+            if (selectorType !== type) {
+                throw new GlossaError('Ασύμβατοι τύποι στην ΠΕΡΙΠΤΩΣΗ', at.row, at.col);
+            }
+        }
+
+        // ΚΑΛΕΣΕ or a function call in an expression; returns the result type
+        _call(call, expected) {
+            const name = call.kind === 'procedureCall' ? call.name : call;
+            const index = this.routineIndex.get(name.name);
+            const callee = index !== undefined && index > 0 ? this.routines[index] : null;
+            if (!callee) {
+                const message = expected === 'procedure' ? `Η διαδικασία ${name.text} δεν έχει οριστεί` : `Η συνάρτηση ${name.text} δεν έχει οριστεί`;
+                throw new GlossaError(message, name.row, name.col);
+            }
+            if (callee.syntax.kind !== expected) {
+                const message = expected === 'procedure'
+                    ? `Η ${name.text} είναι συνάρτηση: χρησιμοποιείται μέσα σε έκφραση, όχι με ΚΑΛΕΣΕ`
+                    : `Η ${name.text} είναι διαδικασία: καλείται με ΚΑΛΕΣΕ`;
+                throw new GlossaError(message, name.row, name.col);
+            }
+            if (call.args.length !== callee.params.length) {
+                throw new GlossaError(`Το ${name.text} παίρνει ${callee.params.length} παραμέτρους, δόθηκαν ${call.args.length}`, name.row, name.col);
+            }
+
+            // Arguments; a procedure's variables get the parameters back afterwards
+            const writeBack = [];
+            call.args.forEach((arg, i) => {
+                const param = callee.params[i];
+                const symbol = arg.kind === 'name' ? this._lookup(arg) : null;
+                if (param.kind === 'array') {
+                    if (!symbol || symbol.kind !== 'array' || arg.indices) {
+                        throw new GlossaError(`Η παράμετρος ${i + 1} του ${name.text} είναι πίνακας`, arg.row, arg.col);
+                    }
+                    if (symbol.dims.length !== param.dims.length) {
+                        throw new GlossaError(`Ο πίνακας ${arg.text} δεν έχει τις διαστάσεις της παραμέτρου`, arg.row, arg.col);
+                    }
+                    this._checkAssignable(param.type, symbol.type, arg);
+                    this._emit(OP.LOAD_RAW, symbol.slot);
+                    // Procedures work on the caller's array, functions on a copy
+                    if (expected === 'function') this._emit(OP.COPY_ARRAY);
+                    writeBack.push(null);
+                    return;
+                }
+                if (symbol && symbol.kind === 'array' && !arg.indices) {
+                    throw new GlossaError(`Η παράμετρος ${i + 1} του ${name.text} δεν είναι πίνακας`, arg.row, arg.col);
+                }
+                const isVariable = expected === 'procedure' && symbol && symbol.kind !== 'const' && symbol.kind !== 'result';
+                if (isVariable && !arg.indices) {
+                    this._checkAssignable(param.type, symbol.type, arg);
+                    this._emit(OP.LOAD_RAW, symbol.slot);
+                    writeBack.push({ symbol, element: null, arg });
+                } else if (isVariable) {
+                    this._checkIndices(arg, symbol);
+                    this._index(arg, symbol);
+                    const element = this._temp();
+                    this._emit(OP.STORE, element);
+                    this._emit(OP.LOAD_RAW, element);
+                    this._emit(OP.ALOAD_RAW, symbol.slot);
+                    this._checkAssignable(param.type, symbol.type, arg);
+                    writeBack.push({ symbol, element, arg });
+                } else {
+                    this._checkAssignable(param.type, this._expression(arg), arg);
+                    writeBack.push(null);
+                }
+            });
+            this.row = name.row;
+            this._emit(OP.CALL, index, call.args.length);
+
+            if (expected === 'function') return callee.syntax.returnType;
+
+            // The procedure left its parameters on the stack, last on top
+            for (let i = writeBack.length - 1; i >= 0; i--) {
+                const back = writeBack[i];
+                if (!back) {
+                    this._emit(OP.POP);
+                    continue;
+                }
+                const paramType = callee.params[i].type;
+                if (back.element === null) {
+                    if (this.loopVariables.includes(back.arg.name)) {
+                        this._emit(OP.POP); // Control variables don't change
+                        continue;
+                    }
+                    this._storeTarget({ symbol: back.symbol, indices: null }, paramType, back.arg);
+                } else {
+                    // Value on top, the saved index under it
+                    const value = this._temp();
+                    this._emit(OP.STORE, value);
+                    this._emit(OP.LOAD_RAW, back.element);
+                    this._emit(OP.LOAD_RAW, value);
+                    this._storeTarget({ symbol: back.symbol, indices: back.arg.indices }, paramType, back.arg);
+                }
+            }
+            return null;
+        }
+
+        // Push the value of an expression; returns its type
+        _expression(expr) {
+            switch (expr.kind) {
+                case 'literal':
+                    this._emit(OP.PUSH, this.constant(expr.value));
+                    return expr.type;
+
+                case 'name': {
+                    const symbol = this._lookup(expr);
+                    if (symbol.kind === 'const') {
+                        if (expr.indices) throw new GlossaError(`Το ${expr.text} δεν είναι πίνακας`, expr.row, expr.col);
+                        this._emit(OP.PUSH, this.constant(symbol.value));
+                        return symbol.type;
+                    }
+                    this._checkIndices(expr, symbol);
+                    if (expr.indices && expr.indices.length === 1) {
+                        const type = this._expression(expr.indices[0]);
+                        if (type !== 'int' && type !== 'any') {
+                            throw new GlossaError('Ο δείκτης πίνακα πρέπει να είναι ακέραιος', expr.indices[0].row, expr.indices[0].col);
+                        }
+                        this._emit(OP.ALOAD1, symbol.slot);
+                    } else if (expr.indices) {
+                        this._index(expr, symbol);
+                        this._emit(OP.ALOAD, symbol.slot);
+                    } else {
+                        this._emit(OP.LOAD, symbol.slot);
+                    }
+                    return symbol.type;
+                }
+
+                case 'call': {
+                    const builtin = BUILTINS[expr.name];
+                    if (builtin && !this.routineIndex.has(expr.name)) {
+                        if (expr.args.length !== 1) {
+                            throw new GlossaError(`Η ${expr.text} παίρνει μία παράμετρο`, expr.row, expr.col);
+                        }
+                        const type = this._expression(expr.args[0]);
+                        if (type === 'any') this._emit(OP.CHECK, TYPE.real);
+                        else if (!isNumeric(type)) throw new GlossaError(`Η ${expr.text} δέχεται αριθμό`, expr.row, expr.col);
+                        this._emit(OP.BUILTIN, builtin.id);
+                        return builtin.type || (type === 'int' ? 'int' : type === 'any' ? 'any' : 'real');
+                    }
+                    return this._call(expr, 'function');
+                }
+
+                case 'unary': {
+                    const type = this._expression(expr.operand);
+                    if (expr.op === 'ΟΧΙ') {
+                        this._operand(type, 'bool', expr);
+                        this._emit(OP.NOT);
+                        return 'bool';
+                    }
+                    this._operand(type, 'number', expr);
+                    this._emit(OP.NEG);
+                    return type;
+                }
+
+                case 'binary':
+                    return this._binary(expr);
+            }
+            throw new GlossaError('Άγνωστη έκφραση', expr.row, expr.col);
+        }
+
+        // A value of an unknown type is checked where it is used; a known wrong type is an error
+        _operand(type, wanted, at) {
+            if (type === 'any') {
+                this._emit(OP.CHECK, wanted === 'bool' ? TYPE.bool : TYPE.real);
+                return;
+            }
+            if (wanted === 'bool' ? type !== 'bool' : !isNumeric(type)) {
+                throw new GlossaError(wanted === 'bool' ? 'Περίμενα λογική τιμή' : 'Περίμενα αριθμό', at.row, at.col);
+            }
+        }
+
+        _binary(expr) {
+            const op = expr.op;
+            const left = this._expression(expr.left);
+            if (op === 'ΚΑΙ' || op === 'Η') {
+                this._operand(left, 'bool', expr.left);
+                this._operand(this._expression(expr.right), 'bool', expr.right);
+                this._emit(op === 'ΚΑΙ' ? OP.AND : OP.OR);
+                return 'bool';
+            }
+            if (COMPARISONS[op]) {
+                const right = this._expression(expr.right);
+                if (left !== 'any' && right !== 'any' &&
+                    !(isNumeric(left) && isNumeric(right)) && left !== right) {
+                    throw new GlossaError(`Σύγκριση ${TYPE_NAMES[left]} με ${TYPE_NAMES[right]}`, expr.row, expr.col);
+                }
+                this._emit(COMPARISONS[op]);
+                return 'bool';
+            }
+            this._operand(left, 'number', expr.left);
+            const right = this._expression(expr.right);
+            this._operand(right, 'number', expr.right);
+            const bothInt = left === 'int' && right === 'int';
+            const unknown = left === 'any' || right === 'any';
+            switch (op) {
+                case '+': this._emit(OP.ADD); break;
+                case '-': this._emit(OP.SUB); break;
+                case '*': this._emit(OP.MUL); break;
+                case '/': this._emit(OP.DIV); return 'real';
+                case 'DIV':
+                case 'MOD':
+                    if (!bothInt && !unknown) {
+                        throw new GlossaError(`Το ${op} εφαρμόζεται σε ακέραιους`, expr.row, expr.col);
+                    }
+                    this._emit(op === 'DIV' ? OP.IDIV : OP.MOD);
+                    return 'int';
+                case '^':
+                    this._emit(bothInt ? OP.POW_INT : OP.POW);
+                    return bothInt ? 'int' : unknown ? 'any' : 'real';
+            }
+            return bothInt ? 'int' : unknown ? 'any' : 'real';
+        }
+    }
+
+    const COMPARISONS = { '=': OP.EQ, '<>': OP.NE, '<': OP.LT, '>': OP.GT, '<=': OP.LE, '>=': OP.GE };
+
+    /**
+     * Compile a GLOSSA program
+     * @param {string} source
+     * @returns {{ program: Object }|{ errors: Object[] }}
+     */
+    function compile(source) {
+        let file;
+        try {
+            file = new Parser(tokenize(source)).parseFile();
+        } catch (error) {
+            if (!(error instanceof GlossaError)) throw error;
+            return { errors: [{ row: error.row, col: error.col, message: error.message }] };
+        }
+        return new Generator(file).generate();
+    }
+
+    return {
+        compile,
+        tokenize,
+        fold,
+        OP,
+        TYPE,
+        BUILTINS
+    };
+})();
+
+// Make GlossaCompiler globally available (browser)
+if (typeof window !== 'undefined') {
+    window.GlossaCompiler = GlossaCompiler;
+}
+
+// Export for Node.js (tooling)
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = GlossaCompiler;
+}
@@ -0,0 +1,136 @@
+/**
+ * GlossaRunner - Main-thread side of workers/GlossaWorker.js
+ *
+ * Runs GLOSSA programs in the browser, one at a time, and reports them in
+ * the shape of the server's C++ run messages, so RunPanel shows both the
+ * same way:
+ *   { type: 'run_status', runId, state: 'running' }
+ *   { type: 'run_output', runId, data, stream: 'stdout' }
+ *   { type: 'run_exit', runId, reason, exitCode, timeMs, steps, errors, error }
+ *
+ * Every run gets a fresh worker, so Stop (terminate) works even in the
+ * middle of an endless loop.
+ *
+ * @module core/GlossaRunner
+ */
+
+const GlossaRunner = (function() {
+    'use strict';
+
+    const WORKER_URL = 'src/workers/GlossaWorker.js?v=2';
+
+    class GlossaRunner {
+        /**
+         * @param {Function} onMessage - Receives the run_* messages
+         */
+        constructor(onMessage) {
+            this.onMessage = onMessage;
+            this.worker = null;
+            this.runId = null;
+            this._nextId = 1;
+        }
+
+        /**
+         * Returns a runner, or null where workers are unavailable (file:// pages)
+         * @param {Function} onMessage
+         * @returns {GlossaRunner|null}
+         */
+        static create(onMessage) {
+            if (typeof Worker === 'undefined') return null;
+            return new GlossaRunner(onMessage);
+        }
+
+        /**
+         * Compile and run a program, stopping any earlier one
+         * @param {string} code
+         * @returns {string|null} The run's id, or null if no worker could start
+         */
+        run(code) {
+            this._terminate();
+            let worker;
+            try {
+                worker = new Worker(WORKER_URL);
+            } catch (error) {
+                console.warn('⚠️ GLOSSA worker unavailable', error);
+                return null;
+            }
+            const runId = `glossa-${this._nextId++}`;
+            this.worker = worker;
+            this.runId = runId;
+            worker.onmessage = (event) => this._onWorkerMessage(runId, event.data);
+            worker.onerror = (event) => {
+                event.preventDefault();
+                this._exit(runId, { reason: 'error', message: event.message });
+            };
+            worker.postMessage({ type: 'run', code });
+            return runId;
+        }
+
+        /**
+         * @param {string} data - A line typed in the console, with its '\n'
+         */
+        sendInput(data) {
+            if (this.worker) this.worker.postMessage({ type: 'input', data });
+        }
+
+        sendEof() {
+            if (this.worker) this.worker.postMessage({ type: 'eof' });
+        }
+
+        stop() {
+            if (!this.worker) return;
+            const runId = this.runId;
+            this._terminate();
+            this.onMessage({ type: 'run_exit', runId, reason: 'stopped' });
+        }
+
+        _onWorkerMessage(runId, message) {
+            if (runId !== this.runId) return;
+            switch (message.type) {
+                case 'compiled':
+                    this.onMessage({ type: 'run_status', runId, state: 'running' });
+                    break;
+                case 'output':
+                    this.onMessage({ type: 'run_output', runId, data: message.data, stream: 'stdout' });
+                    break;
+                case 'exit':
+                    this._exit(runId, message);
+                    break;
+            }
+        }
+
+        _exit(runId, exit) {
+            this._terminate();
+            const reason = exit.reason === 'done' ? null : exit.reason;
+            this.onMessage({
+                type: 'run_exit',
+                runId,
+                reason,
+                exitCode: reason ? 1 : 0,
+                timeMs: exit.timeMs || 0,
+                steps: exit.steps || 0,
+                errors: exit.errors || null,
+                error: exit.error || null
+            });
+        }
+
+        _terminate() {
+            if (this.worker) {
+                this.worker.terminate();
+                this.worker = null;
+            }
+        }
+    }
+
+    return GlossaRunner;
+})();
+
+// Make GlossaRunner globally available (browser)
+if (typeof window !== 'undefined') {
+    window.GlossaRunner = GlossaRunner;
+}
+
+// Export for Node.js (tooling)
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = GlossaRunner;
+}
@@ -0,0 +1,541 @@
+/**
+ * GlossaVM - Runs the bytecode of core/GlossaCompiler.js
+ *
+ * A stack machine over the compiler's flat Int32Array code. run(budget)
+ * executes at most `budget` instructions and returns where it stopped, so
+ * the caller (workers/GlossaWorker.js) decides how long a program may run
+ * and flushes output between slices:
+ *   { status: 'done' }
+ *   { status: 'yield' }   budget used up - call run() again to continue
+ *   { status: 'input' }   ΔΙΑΒΑΣΕ needs more input - addInput() / closeInput()
+ *   { status: 'error', message, row }
+ *
+ * Values are plain JS numbers, strings and booleans (undefined = no value
+ * yet). Arrays are { data, dims }: numeric ones a Float64Array with NaN
+ * for "no value", the rest a plain Array.
+ *
+ * ΔΙΑΒΑΣΕ takes numbers and logical values one token at a time (separated by
+ * spaces, commas or lines) and strings a whole line.
+ *
+ * @module core/GlossaVM
+ */
+
+const GlossaVM = (function() {
+    'use strict';
+
+    const Compiler = typeof GlossaCompiler !== 'undefined' ? GlossaCompiler : require('./GlossaCompiler.js');
+    const OP = Compiler.OP;
+    const TYPE = Compiler.TYPE;
+
+    const MAX_DEPTH = 10000;
+    const DEGREES = Math.PI / 180;
+
+    class GlossaRuntimeError extends Error {}
+
+    function fail(message) {
+        throw new GlossaRuntimeError(message);
+    }
+
+    /**
+     * A value as ΓΡΑΨΕ prints it
+     * @param {*} value
+     * @returns {string}
+     */
+    function format(value) {
+        if (typeof value === 'number') {
+            if (Number.isInteger(value)) return String(value);
+            return String(Number(value.toPrecision(15)));
+        }
+        if (typeof value === 'boolean') return value ? 'ΑΛΗΘΗΣ' : 'ΨΕΥΔΗΣ';
+        return value;
+    }
+
+    function typeMatches(value, type) {
+        switch (type) {
+            case TYPE.int: return Number.isInteger(value);
+            case TYPE.real: return typeof value === 'number';
+            case TYPE.str: return typeof value === 'string';
+            case TYPE.bool: return typeof value === 'boolean';
+        }
+        return true;
+    }
+
+    const TYPE_NAMES = { [TYPE.int]: 'ακέραια', [TYPE.real]: 'αριθμητική', [TYPE.str]: 'χαρακτήρες', [TYPE.bool]: 'λογική' };
+
+    function checkType(value, type) {
+        if (value !== undefined && !typeMatches(value, type)) {
+            fail(`Περίμενα τιμή ${TYPE_NAMES[type]}, βρέθηκε ${format(value)}`);
+        }
+        return value;
+    }
+
+    function newArray(dims, type) {
+        const size = dims.reduce((a, b) => a * b, 1);
+        if (type === TYPE.int || type === TYPE.real) {
+            return { data: new Float64Array(size).fill(NaN), dims, numeric: true };
+        }
+        return { data: new Array(size).fill(undefined), dims, numeric: false };
+    }
+
+    function copyArray(array) {
+        return { data: array.data.slice(), dims: array.dims, numeric: array.numeric };
+    }
+
+    class GlossaVM {
+        /**
+         * @param {Object} program - compile(code).program
+         */
+        constructor(program) {
+            this.program = program;
+            this.constants = program.constants;
+            this.steps = 0;              // Instructions executed so far
+            this.output = [];            // Text written since the last takeOutput()
+            this._input = '';            // Complete lines not read yet
+            this._inputClosed = false;
+            this._midLine = false;       // Values were read from the current line
+            this._stack = [];
+            this._frames = [];
+            this._frame = this._enter(0, []);
+        }
+
+        /**
+         * Execute up to `budget` instructions
+         * @param {number} budget
+         * @returns {{ status: string, message?: string, row?: number }}
+         */
+        run(budget) {
+            let frame = this._frame;
+            let routine = frame.routine;
+            let code = routine.code;
+            let slots = frame.slots;
+            let pc = frame.pc;
+            const stack = this._stack;
+            const constants = this.constants;
+            let sp = this._sp || 0;
+            let left = budget;
+            let start = pc;
+            let a, b, v, array, index, op;
+
+            try {
+                for (;;) {
+                    if (--left < 0) {
+                        this._save(frame, pc, sp, budget);
+                        return { status: 'yield' };
+                    }
+                    start = pc;
+                    op = code[pc++];
+                    switch (op) {
+                        case OP.PUSH:
+                            stack[sp++] = constants[code[pc++]];
+                            break;
+                        case OP.LOAD:
+                            v = slots[code[pc++]];
+                            if (v === undefined) fail(`Η μεταβλητή ${routine.slotNames[code[pc - 1]]} δεν έχει τιμή`);
+                            stack[sp++] = v;
+                            break;
+                        case OP.LOAD_RAW:
+                            stack[sp++] = slots[code[pc++]];
+                            break;
+                        case OP.STORE:
+                            slots[code[pc++]] = stack[--sp];
+                            break;
+                        case OP.STORE_INT:
+                            v = stack[--sp];
+                            if (v !== undefined && !Number.isInteger(v)) fail(`Η ακέραια μεταβλητή ${routine.slotNames[code[pc]] || ''} δεν παίρνει την τιμή ${format(v)}`);
+                            slots[code[pc++]] = v;
+                            break;
+                        case OP.STORE_CHECK:
+                            slots[code[pc]] = checkType(stack[--sp], code[pc + 1]);
+                            pc += 2;
+                            break;
+
+                        case OP.INDEX: {
+                            array = slots[code[pc++]];
+                            const count = code[pc++];
+                            const dims = array.dims;
+                            index = 0;
+                            sp -= count;
+                            for (let k = 0; k < count; k++) {
+                                v = stack[sp + k];
+                                if (!Number.isInteger(v) || v < 1 || v > dims[k]) this._badIndex(routine, code[pc - 2], v, dims[k]);
+                                index = index * dims[k] + v - 1;
+                            }
+                            stack[sp++] = index;
+                            break;
+                        }
+                        case OP.ALOAD:
+                            array = slots[code[pc++]];
+                            v = array.data[stack[sp - 1]];
+                            if (v === undefined || v !== v) fail(`Το στοιχείο του πίνακα ${routine.slotNames[code[pc - 1]]} δεν έχει τιμή`);
+                            stack[sp - 1] = v;
+                            break;
+                        case OP.ALOAD_RAW:
+                            array = slots[code[pc++]];
+                            v = array.data[stack[sp - 1]];
+                            stack[sp - 1] = v !== v ? undefined : v;
+                            break;
+                        case OP.ALOAD1:
+                            array = slots[code[pc++]];
+                            index = stack[sp - 1];
+                            if (!Number.isInteger(index) || index < 1 || index > array.data.length) this._badIndex(routine, code[pc - 1], index, array.data.length);
+                            v = array.data[index - 1];
+                            if (v === undefined || v !== v) fail(`Το στοιχείο ${routine.slotNames[code[pc - 1]]}[${index}] δεν έχει τιμή`);
+                            stack[sp - 1] = v;
+                            break;
+                        case OP.ASTORE:
+                            v = stack[--sp];
+                            array = slots[code[pc++]];
+                            array.data[stack[--sp]] = v === undefined && array.numeric ? NaN : v;
+                            break;
+                        case OP.ASTORE_INT:
+                            v = stack[--sp];
+                            if (v !== undefined && !Number.isInteger(v)) fail(`Ο ακέραιος πίνακας ${routine.slotNames[code[pc]]} δεν παίρνει την τιμή ${format(v)}`);
+                            array = slots[code[pc++]];
+                            array.data[stack[--sp]] = v === undefined ? NaN : v;
+                            break;
+                        case OP.ASTORE_CHECK:
+                            v = checkType(stack[--sp], code[pc + 1]);
+                            array = slots[code[pc]];
+                            array.data[stack[--sp]] = v === undefined && array.numeric ? NaN : v;
+                            pc += 2;
+                            break;
+
+                        case OP.ADD:
+                            b = stack[--sp];
+                            stack[sp - 1] += b;
+                            break;
+                        case OP.SUB:
+                            b = stack[--sp];
+                            stack[sp - 1] -= b;
+                            break;
+                        case OP.MUL:
+                            b = stack[--sp];
+                            stack[sp - 1] *= b;
+                            break;
+                        case OP.DIV:
+                            b = stack[--sp];
+                            if (b === 0) fail('Διαίρεση με το μηδέν');
+                            stack[sp - 1] /= b;
+                            break;
+                        case OP.IDIV:
+                            b = stack[--sp];
+                            a = stack[sp - 1];
+                            if (!Number.isInteger(a) || !Number.isInteger(b)) fail('Το DIV εφαρμόζεται σε ακέραιους');
+                            if (b === 0) fail('Διαίρεση με το μηδέν (DIV)');
+                            stack[sp - 1] = Math.trunc(a / b);
+                            break;
+                        case OP.MOD:
+                            b = stack[--sp];
+                            a = stack[sp - 1];
+                            if (!Number.isInteger(a) || !Number.isInteger(b)) fail('Το MOD εφαρμόζεται σε ακέραιους');
+                            if (b === 0) fail('Διαίρεση με το μηδέν (MOD)');
+                            stack[sp - 1] = a % b;
+                            break;
+                        case OP.POW:
+                        case OP.POW_INT:
+                            b = stack[--sp];
+                            a = stack[sp - 1];
+                            if (a === 0 && b < 0) fail('Το 0 δεν υψώνεται σε αρνητική δύναμη');
+                            if (op === OP.POW_INT && b < 0) fail('Ακέραια δύναμη με αρνητικό εκθέτη - γράψε τη βάση ως πραγματικό (π.χ. 2.0)');
+                            v = Math.pow(a, b);
+                            if (v !== v) fail(`Η δύναμη ${format(a)}^${format(b)} δεν ορίζεται`);
+                            stack[sp - 1] = v;
+                            break;
+                        case OP.NEG:
+                            stack[sp - 1] = -stack[sp - 1];
+                            break;
+
+                        case OP.EQ:
+                            b = stack[--sp];
+                            stack[sp - 1] = stack[sp - 1] === b;
+                            break;
+                        case OP.NE:
+                            b = stack[--sp];
+                            stack[sp - 1] = stack[sp - 1] !== b;
+                            break;
+                        case OP.LT:
+                            b = stack[--sp];
+                            stack[sp - 1] = stack[sp - 1] < b;
+                            break;
+                        case OP.GT:
+                            b = stack[--sp];
+                            stack[sp - 1] = stack[sp - 1] > b;
+                            break;
+                        case OP.LE:
+                            b = stack[--sp];
+                            stack[sp - 1] = stack[sp - 1] <= b;
+                            break;
+                        case OP.GE:
+                            b = stack[--sp];
+                            stack[sp - 1] = stack[sp - 1] >= b;
+                            break;
+                        case OP.AND:
+                            b = stack[--sp];
+                            stack[sp - 1] = stack[sp - 1] && b;
+                            break;
+                        case OP.OR:
+                            b = stack[--sp];
+                            stack[sp - 1] = stack[sp - 1] || b;
+                            break;
+                        case OP.NOT:
+                            stack[sp - 1] = !stack[sp - 1];
+                            break;
+                        case OP.CHECK:
+                            checkType(stack[sp - 1], code[pc++]);
+                            break;
+
+                        case OP.JMP:
+                            pc = code[pc];
+                            break;
+                        case OP.JMP_FALSE:
+                            pc = stack[--sp] ? pc + 1 : code[pc];
+                            break;
+                        case OP.JMP_TRUE:
+                            pc = stack[--sp] ? code[pc] : pc + 1;
+                            break;
+                        case OP.POP:
+                            sp--;
+                            break;
+
+                        case OP.FOR_INIT:
+                            v = slots[code[pc + 2]];
+                            if (v === 0) fail('Το βήμα του ΓΙΑ είναι μηδέν');
+                            a = slots[code[pc]];
+                            b = slots[code[pc + 1]];
+                            pc = (v > 0 ? a > b : a < b) ? code[pc + 3] : pc + 4;
+                            break;
+                        case OP.FOR_NEXT:
+                            v = slots[code[pc + 2]];
+                            a = slots[code[pc]] + v;
+                            slots[code[pc]] = a;
+                            b = slots[code[pc + 1]];
+                            pc = (v > 0 ? a <= b : a >= b) ? code[pc + 3] : pc + 4;
+                            break;
+
+                        case OP.READ:
+                        case OP.AREAD:
+                            v = this._read(code[pc + 1]);
+                            if (v === undefined) {
+                                this._save(frame, start, sp, budget - left);
+                                return { status: 'input' };
+                            }
+                            if (op === OP.READ) {
+                                slots[code[pc]] = v;
+                            } else {
+                                slots[code[pc]].data[stack[--sp]] = v;
+                            }
+                            pc += 2;
+                            break;
+                        case OP.WRITE: {
+                            const count = code[pc++];
+                            // Items are separated by a space: ΓΡΑΨΕ 'Άθροισμα:', Σ -> "Άθροισμα: 15"
+                            let text = '';
+                            for (let k = sp - count; k < sp; k++) {
+                                text += (k > sp - count ? ' ' : '') + format(stack[k]);
+                            }
+                            sp -= count;
+                            this.output.push(code[pc++] ? text + '\n' : text);
+                            break;
+                        }
+
+                        case OP.CALL: {
+                            const callee = code[pc++];
+                            const argc = code[pc++];
+                            sp -= argc;
+                            const args = stack.slice(sp, sp + argc);
+                            frame.pc = pc;
+                            frame.sp = sp;
+                            frame = this._enter(callee, args);
+                            routine = frame.routine;
+                            code = routine.code;
+                            slots = frame.slots;
+                            pc = 0;
+                            break;
+                        }
+                        case OP.RETURN: {
+                            const callee = routine;
+                            const locals = slots;
+                            if (callee.kind === 'function' && locals[callee.resultSlot] === undefined) {
+                                fail(`Η συνάρτηση ${callee.name} τελείωσε χωρίς να πάρει τιμή`);
+                            }
+                            this._frames.pop();
+                            frame = this._frames[this._frames.length - 1];
+                            routine = frame.routine;
+                            code = routine.code;
+                            slots = frame.slots;
+                            pc = frame.pc;
+                            sp = frame.sp;
+                            if (callee.kind === 'function') {
+                                stack[sp++] = locals[callee.resultSlot];
+                            } else {
+                                // Parameters go back to the caller's variables
+                                for (const param of callee.params) stack[sp++] = locals[param.slot];
+                            }
+                            break;
+                        }
+                        case OP.COPY_ARRAY:
+                            stack[sp - 1] = copyArray(stack[sp - 1]);
+                            break;
+                        case OP.BUILTIN:
+                            stack[sp - 1] = this._builtin(code[pc++], stack[sp - 1]);
+                            break;
+
+                        case OP.HALT:
+                            this._save(frame, start, sp, budget - left);
+                            return { status: 'done' };
+
+                        default:
+                            fail(`Άγνωστη εντολή ${op}`);
+                    }
+                }
+            } catch (error) {
+                if (!(error instanceof GlossaRuntimeError) && !(error instanceof RangeError)) throw error;
+                this._save(frame, start, sp, budget - left);
+                const message = error instanceof RangeError ? 'Η μνήμη δεν φτάνει' : error.message;
+                return { status: 'error', message, row: routine.lines[Math.min(start, routine.lines.length - 1)] };
+            }
+        }
+
+        // Where run() stopped, to continue from there
+        _save(frame, pc, sp, steps) {
+            this._frame = frame;
+            frame.pc = pc;
+            this._sp = sp;
+            this.steps += steps;
+        }
+
+        /**
+         * Text for ΔΙΑΒΑΣΕ (whole lines, ending in '\n')
+         * @param {string} text
+         */
+        addInput(text) {
+            this._input += text;
+        }
+
+        /**
+         * No more input: a ΔΙΑΒΑΣΕ waiting for it fails
+         */
+        closeInput() {
+            this._inputClosed = true;
+        }
+
+        /**
+         * Output written since the last call
+         * @returns {string}
+         */
+        takeOutput() {
+            const text = this.output.join('');
+            this.output = [];
+            return text;
+        }
+
+        // New frame for routine `index`, with its arguments, arrays and parameters
+        _enter(index, args) {
+            if (this._frames.length >= MAX_DEPTH) {
+                fail('Πάρα πολλές κλήσεις η μία μέσα στην άλλη (ατέρμονη αναδρομή;)');
+            }
+            const routine = this.program.routines[index];
+            const slots = new Array(routine.slotCount).fill(undefined);
+            for (const array of routine.arrays) {
+                slots[array.slot] = newArray(array.dims, array.type);
+            }
+            routine.params.forEach((param, i) => {
+                const value = args[i];
+                if (param.array) {
+                    if (param.type !== TYPE.any && (param.type === TYPE.int || param.type === TYPE.real) !== value.numeric) {
+                        fail(`Ο πίνακας της παραμέτρου ${i + 1} του ${routine.name} είναι άλλου τύπου`);
+                    }
+                } else {
+                    checkType(value, param.type);
+                }
+                slots[param.slot] = value;
+            });
+            const frame = { routine, slots, pc: 0, sp: 0 };
+            this._frames.push(frame);
+            return frame;
+        }
+
+        _badIndex(routine, slot, index, size) {
+            if (!Number.isInteger(index)) fail(`Ο δείκτης του ${routine.slotNames[slot]} πρέπει να είναι ακέραιος, είναι ${format(index)}`);
+            fail(`Ο δείκτης ${index} είναι έξω από τα όρια του ${routine.slotNames[slot]} (1..${size})`);
+        }
+
+        // Next value of `type` from the input, or undefined if more is needed
+        _read(type) {
+            const input = this._input;
+            let pos = 0;
+            let value;
+            if (type === TYPE.str) {
+                // The rest of the line, or the next line if values before it used this one up
+                if (this._midLine) {
+                    while (pos < input.length && (input[pos] === ' ' || input[pos] === '\t' || input[pos] === ',')) pos++;
+                    if (input[pos] === '\n') pos++;
+                }
+                const end = input.indexOf('\n', pos);
+                if (end === -1) return this._noInput();
+                this._input = input.slice(end + 1);
+                this._midLine = false;
+                return input.slice(pos, end).trim();
+            }
+
+            while (pos < input.length && /[\s,]/.test(input[pos])) pos++;
+            let end = pos;
+            while (end < input.length && !/[\s,]/.test(input[end])) end++;
+            if (end === input.length) return this._noInput(); // No complete token yet
+            const token = input.slice(pos, end);
+            if (type === TYPE.bool) {
+                const folded = Compiler.fold(token);
+                if (folded !== 'ΑΛΗΘΗΣ' && folded !== 'ΨΕΥΔΗΣ') fail(`Περίμενα ΑΛΗΘΗΣ ή ΨΕΥΔΗΣ, δόθηκε '${token}'`);
+                value = folded === 'ΑΛΗΘΗΣ';
+            } else if (type === TYPE.int) {
+                if (!/^[+-]?\d+$/.test(token)) fail(`Περίμενα ακέραιο αριθμό, δόθηκε '${token}'`);
+                value = Number(token);
+            } else {
+                value = token === '' ? NaN : Number(token);
+                if (value !== value || !Number.isFinite(value)) fail(`Περίμενα αριθμό, δόθηκε '${token}'`);
+            }
+            this._input = input.slice(end);
+            this._midLine = true;
+            return value;
+        }
+
+        _noInput() {
+            if (this._inputClosed) fail('Τελείωσαν τα δεδομένα εισόδου');
+            return undefined;
+        }
+
+        _builtin(id, x) {
+            switch (id) {
+                case 1: return Math.trunc(x);
+                case 2: return Math.abs(x);
+                case 3:
+                    if (x < 0) fail(`Τ_Ρ αρνητικού αριθμού (${format(x)})`);
+                    return Math.sqrt(x);
+                case 4: return Math.sin(x * DEGREES);
+                case 5: return Math.cos(x * DEGREES);
+                case 6:
+                    if (Math.abs(Math.cos(x * DEGREES)) < 1e-12) fail(`Η ΕΦ(${format(x)}) δεν ορίζεται`);
+                    return Math.tan(x * DEGREES);
+                case 7:
+                    if (x <= 0) fail(`ΛΟΓ μη θετικού αριθμού (${format(x)})`);
+                    return Math.log(x);
+                case 8: return Math.exp(x);
+            }
+            return fail(`Άγνωστη συνάρτηση ${id}`);
+        }
+    }
+
+    GlossaVM.format = format;
+
+    return GlossaVM;
+})();
+
+// Make GlossaVM globally available (browser)
+if (typeof window !== 'undefined') {
+    window.GlossaVM = GlossaVM;
+}
+
+// Export for Node.js (tooling)
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = GlossaVM;
+}
@@ -0,0 +1,545 @@
+/**
+ * LexerCompiler - Table-driven lexers generated from the language packs
+ *
+ * Each language's syntax.js declares a LEXER_SPEC (character sets, comment and
+ * string delimiters, keyword groups taken from keywords.js). compile() turns it
+ * into a lexer that:
+ * - classifies characters with a 64K flag table (no per-character regexes)
+ * - classifies words with one Map lookup (no Array.includes chains), with
+ *   optional Greek accent / case folding (ΑΝ, αν, Αν all match)
+ * - carries line state (block comments, multi-line strings, raw strings)
+ * - finds structure tokens (bracket pairs, block keyword pairs such as
+ *   ΑΝ…ΤΕΛΟΣ_ΑΝ) outside strings and comments, for StructureIndex
+ *
+ * The same scanner feeds both highlighting paths: per-character class arrays
+ * for GridEditor (via SyntaxHighlighter) and HTML for the legacy textarea view.
+ *
+ * @module core/LexerCompiler
+ */
+
+const LexerCompiler = (function() {
+    'use strict';
+
+    // ===========================================
+    // Character Class Flags
+    // ===========================================
+
+    const IDENT_START = 1;
+    const IDENT_PART = 2;
+    const NUMBER_START = 4;
+    const NUMBER_PART = 8;
+    const OPERATOR = 16;
+    const BRACKET = 32;
+    const PUNCTUATION = 64;
+    const SPACE = 128;
+    // First characters of multi-character tokens, so startsWith() only runs where it can match
+    const COMMENT_START = 256;
+    const MULTILINE_START = 512;
+    const MULTI_OPERATOR_START = 1024;
+    const QUOTE = 2048;
+    const STRUCTURE_BRACKET = 4096; // Opens or closes a structure pair
+
+    // Line states carried from one line to the next
+    const STATE_NORMAL = '';
+    const STATE_BLOCK_COMMENT = '/*';
+    const STATE_RAW_STRING = 'R"'; // Followed by the raw string delimiter
+    // Multi-line strings use their own delimiter (""", ''') as the state
+
+    // Runs whose identifiers are not code (skipped when indexing words)
+    const NOT_WORDS = new Set(['syntax-string', 'syntax-comment', 'syntax-preprocessor', 'syntax-number']);
+
+    // Runs whose brackets do not count as structure
+    const NOT_CODE = new Set(['syntax-string', 'syntax-comment', 'syntax-preprocessor']);
+
+    const RAW_STRING_PREFIXES = new Set(['R', 'LR', 'uR', 'UR', 'u8R']);
+
+    // ===========================================
+    // Helpers
+    // ===========================================
+
+    /**
+     * Expands a character set like 'a-zA-Z_α-ω' into char codes.
+     * A literal '-' must come first or last (e.g. '+=-').
+     * @param {string} set
+     * @returns {number[]}
+     */
+    function expandCharSet(set) {
+        const codes = [];
+        for (let i = 0; i < set.length; i++) {
+            const from = set.charCodeAt(i);
+            if (set[i + 1] === '-' && i + 2 < set.length) {
+                const to = set.charCodeAt(i + 2);
+                for (let c = from; c <= to; c++) codes.push(c);
+                i += 2;
+            } else {
+                codes.push(from);
+            }
+        }
+        return codes;
+    }
+
+    let foldTable = null;
+
+    /**
+     * Lazily builds the case/accent folding table.
+     * Latin folds to upper case; Greek also drops accents and diaeresis
+     * (ά -> Α, ϊ -> Ι) and maps final sigma to Σ.
+     */
+    function getFoldTable() {
+        if (foldTable) return foldTable;
+
+        foldTable = new Uint16Array(0x10000);
+        for (let c = 0; c < 0x10000; c++) foldTable[c] = c;
+
+        const foldRange = (from, to) => {
+            for (let c = from; c <= to; c++) {
+                const folded = String.fromCharCode(c)
+                    .normalize('NFD')
+                    .replace(/[\u0300-\u036f]/g, '')
+                    .toUpperCase();
+                if (folded.length === 1) foldTable[c] = folded.charCodeAt(0);
+            }
+        };
+        foldRange(0x61, 0x7a);     // a-z
+        foldRange(0x0370, 0x03ff); // Greek and Coptic
+        foldRange(0x1f00, 0x1fff); // Greek Extended (polytonic)
+        foldTable[0x03c2] = 0x03a3; // ς -> Σ
+        return foldTable;
+    }
+
+    /**
+     * Folds a word for case/accent-insensitive comparison
+     * @param {string} word
+     * @returns {string}
+     */
+    function foldWord(word) {
+        const table = getFoldTable();
+        let out = '';
+        for (let i = 0; i < word.length; i++) {
+            out += String.fromCharCode(table[word.charCodeAt(i)]);
+        }
+        return out;
+    }
+
+    function escapeHtml(text) {
+        return text
+            .replace(/&/g, '&amp;')
+            .replace(/</g, '&lt;')
+            .replace(/>/g, '&gt;');
+    }
+
+    // ===========================================
+    // Compiled Lexer
+    // ===========================================
+
+    class CompiledLexer {
+        /**
+         * @param {Object} spec - LEXER_SPEC from a language's syntax.js
+         */
+        constructor(spec) {
+            this.name = spec.name;
+            this.foldCase = !!spec.foldCase;
+            this.lineComment = spec.lineComment || null;
+            this.blockComment = spec.blockComment || null;
+            this.preprocessor = spec.preprocessor || null;
+            this.decorator = spec.decorator || null;
+            this.rawStrings = !!spec.rawStrings;
+            this.multiCharOperators = spec.multiCharOperators || [];
+            this.multilineStrings = spec.multilineStrings || [];
+            this.htmlReplacements = spec.htmlReplacements || {};
+
+            // Character class table
+            this.charClass = new Uint16Array(0x10000);
+            const mark = (set, flag) => {
+                for (const c of expandCharSet(set || '')) this.charClass[c] |= flag;
+            };
+            mark(spec.identStart, IDENT_START);
+            mark(spec.identPart, IDENT_PART);
+            mark(spec.numberStart || '0-9', NUMBER_START);
+            mark(spec.numberPart || '0-9.', NUMBER_PART);
+            mark(spec.operators, OPERATOR);
+            mark(spec.brackets, BRACKET);
+            mark(spec.punctuation, PUNCTUATION);
+            mark(' \t\r\f\v\u00a0', SPACE);
+            if (this.lineComment) this.charClass[this.lineComment.charCodeAt(0)] |= COMMENT_START;
+            if (this.blockComment) this.charClass[this.blockComment[0].charCodeAt(0)] |= COMMENT_START;
+            for (const delimiter of this.multilineStrings) {
+                this.charClass[delimiter.charCodeAt(0)] |= MULTILINE_START;
+            }
+            for (const op of this.multiCharOperators) {
+                this.charClass[op.charCodeAt(0)] |= MULTI_OPERATOR_START;
+            }
+
+            // Quote char -> escape char ('' = no escapes)
+            this.quotes = new Map();
+            for (const str of spec.strings || []) {
+                this.quotes.set(str.quote, str.escape || '');
+                this.charClass[str.quote.charCodeAt(0)] |= QUOTE;
+            }
+
+            // Word -> CSS class; earlier groups win
+            this.keywords = new Map();
+            for (const group of spec.keywordGroups || []) {
+                for (const word of group.words || []) {
+                    const key = this.foldCase ? foldWord(word) : word;
+                    if (!this.keywords.has(key)) {
+                        this.keywords.set(key, group.className);
+                    }
+                }
+            }
+            if (this.foldCase) getFoldTable();
+
+            // Structure tokens: each pair gets a kind, +kind opens and -kind closes
+            const structure = spec.structure || {};
+            const scopeBrackets = structure.scopeBrackets || '';
+            this.bracketKinds = new Map();  // Char code -> signed kind
+            this.blockKinds = new Map();    // (Folded) word -> signed kind
+            this.scopeKinds = new Set();    // Kinds that delimit a scope
+            let kind = 0;
+            const pairs = structure.brackets || '';
+            for (let i = 0; i + 1 < pairs.length; i += 2) {
+                kind++;
+                this.bracketKinds.set(pairs.charCodeAt(i), kind);
+                this.bracketKinds.set(pairs.charCodeAt(i + 1), -kind);
+                this.charClass[pairs.charCodeAt(i)] |= STRUCTURE_BRACKET;
+                this.charClass[pairs.charCodeAt(i + 1)] |= STRUCTURE_BRACKET;
+                if (scopeBrackets.includes(pairs[i])) this.scopeKinds.add(kind);
+            }
+            for (const block of structure.blocks || []) {
+                kind++;
+                for (const word of block.open) {
+                    this.blockKinds.set(this.foldCase ? foldWord(word) : word, kind);
+                }
+                this.blockKinds.set(this.foldCase ? foldWord(block.close) : block.close, -kind);
+                this.scopeKinds.add(kind);
+            }
+        }
+
+        /**
+         * CSS class for a word, or '' if it is a plain identifier
+         * @param {string} word
+         * @returns {string}
+         */
+        classify(word) {
+            return this.keywords.get(this.foldCase ? foldWord(word) : word) || '';
+        }
+
+        /**
+         * Scans one line, calling emit(start, end, className) for every
+         * highlighted run (plain text is skipped).
+         * @param {string} line
+         * @param {string} state - State left open by the previous line
+         * @param {Function} emit
+         * @returns {string} State left open by this line
+         */
+        scan(line, state, emit) {
+            const len = line.length;
+            const charClass = this.charClass;
+            let pos = 0;
+
+            // Finish a construct left open by the previous line
+            if (state !== STATE_NORMAL) {
+                let close;
+                let className = 'syntax-string';
+                if (state === STATE_BLOCK_COMMENT && this.blockComment) {
+                    close = this.blockComment[1];
+                    className = 'syntax-comment';
+                } else if (state.startsWith(STATE_RAW_STRING)) {
+                    close = ')' + state.slice(STATE_RAW_STRING.length) + '"';
+                } else {
+                    close = state;
+                }
+                const end = line.indexOf(close);
+                if (end === -1) {
+                    if (len > 0) emit(0, len, className);
+                    return state;
+                }
+                pos = end + close.length;
+                emit(0, pos, className);
+            }
+
+            // Preprocessor directive: the whole line
+            if (this.preprocessor && pos === 0) {
+                let first = 0;
+                while (first < len && charClass[line.charCodeAt(first)] & SPACE) first++;
+                if (line.startsWith(this.preprocessor, first)) {
+                    emit(0, len, 'syntax-preprocessor');
+                    return STATE_NORMAL;
+                }
+            }
+
+            scanLoop:
+            while (pos < len) {
+                const code = line.charCodeAt(pos);
+                const flags = charClass[code];
+                const ch = line[pos];
+
+                if (flags & SPACE) {
+                    pos++;
+                    continue;
+                }
+
+                // Line comment
+                if ((flags & COMMENT_START) && this.lineComment && line.startsWith(this.lineComment, pos)) {
+                    emit(pos, len, 'syntax-comment');
+                    return STATE_NORMAL;
+                }
+
+                // Block comment (may stay open)
+                if ((flags & COMMENT_START) && this.blockComment && line.startsWith(this.blockComment[0], pos)) {
+                    const close = this.blockComment[1];
+                    const end = line.indexOf(close, pos + this.blockComment[0].length);
+                    if (end === -1) {
+                        emit(pos, len, 'syntax-comment');
+                        return STATE_BLOCK_COMMENT;
+                    }
+                    emit(pos, end + close.length, 'syntax-comment');
+                    pos = end + close.length;
+                    continue;
+                }
+
+                // Multi-line strings (""" / ''')
+                if (flags & MULTILINE_START) {
+                    for (const delimiter of this.multilineStrings) {
+                        if (!line.startsWith(delimiter, pos)) continue;
+                        const end = line.indexOf(delimiter, pos + delimiter.length);
+                        if (end === -1) {
+                            emit(pos, len, 'syntax-string');
+                            return delimiter;
+                        }
+                        emit(pos, end + delimiter.length, 'syntax-string');
+                        pos = end + delimiter.length;
+                        continue scanLoop;
+                    }
+                }
+
+                // Single-line strings
+                if (flags & QUOTE) {
+                    const escape = this.quotes.get(ch);
+                    const start = pos;
+                    pos++;
+                    while (pos < len && line[pos] !== ch) {
+                        if (escape && line[pos] === escape) pos++;
+                        pos++;
+                    }
+                    if (pos < len) pos++;
+                    emit(start, Math.min(pos, len), 'syntax-string');
+                    continue;
+                }
+
+                // Numbers
+                if (flags & NUMBER_START) {
+                    const start = pos;
+                    while (pos < len && charClass[line.charCodeAt(pos)] & NUMBER_PART) pos++;
+                    if (pos === start) pos++;
+                    emit(start, pos, 'syntax-number');
+                    continue;
+                }
+
+                // Decorators / annotations
+                if (this.decorator && ch === this.decorator) {
+                    const start = pos;
+                    pos++;
+                    while (pos < len && charClass[line.charCodeAt(pos)] & IDENT_PART) pos++;
+                    emit(start, pos, 'syntax-decorator');
+                    continue;
+                }
+
+                // Words
+                if (flags & IDENT_START) {
+                    const start = pos;
+                    pos++;
+                    while (pos < len && charClass[line.charCodeAt(pos)] & IDENT_PART) pos++;
+                    const word = line.substring(start, pos);
+
+                    // C++ raw string: R"delim( ... )delim"
+                    if (this.rawStrings && line[pos] === '"' && RAW_STRING_PREFIXES.has(word)) {
+                        const open = line.indexOf('(', pos + 1);
+                        const delimiter = open === -1 ? '' : line.substring(pos + 1, open);
+                        if (open !== -1 && delimiter.length <= 16 && !/[\s()\\]/.test(delimiter)) {
+                            const close = ')' + delimiter + '"';
+                            const end = line.indexOf(close, open + 1);
+                            if (end === -1) {
+                                emit(start, len, 'syntax-string');
+                                return STATE_RAW_STRING + delimiter;
+                            }
+                            pos = end + close.length;
+                            emit(start, pos, 'syntax-string');
+                            continue;
+                        }
+                    }
+
+                    const className = this.classify(word);
+                    if (className) emit(start, pos, className);
+                    continue;
+                }
+
+                // Multi-character operators (e.g. <- in GLOSSA)
+                if (flags & MULTI_OPERATOR_START) {
+                    for (const op of this.multiCharOperators) {
+                        if (!line.startsWith(op, pos)) continue;
+                        emit(pos, pos + op.length, 'syntax-operator');
+                        pos += op.length;
+                        continue scanLoop;
+                    }
+                }
+
+                if (flags & OPERATOR) {
+                    emit(pos, pos + 1, 'syntax-operator');
+                } else if (flags & BRACKET) {
+                    emit(pos, pos + 1, 'syntax-bracket');
+                } else if (flags & PUNCTUATION) {
+                    emit(pos, pos + 1, 'syntax-punctuation');
+                }
+                pos++;
+            }
+
+            return STATE_NORMAL;
+        }
+
+        /**
+         * Fills one class per character (GridEditor path)
+         * @param {string} line
+         * @param {string[]} lineClasses - Pre-filled with ''
+         * @param {string} state
+         * @returns {string} Exit state
+         */
+        tokenizeLine(line, lineClasses, state = STATE_NORMAL) {
+            return this.scan(line, state, (start, end, className) => {
+                for (let i = start; i < end; i++) lineClasses[i] = className;
+            });
+        }
+
+        /**
+         * Calls callback(word, start) for every identifier outside strings
+         * and comments (autocomplete indexing)
+         * @param {string} line
+         * @param {string[]} lineClasses - Output of tokenizeLine for this line
+         * @param {Function} callback
+         */
+        forEachWord(line, lineClasses, callback) {
+            const charClass = this.charClass;
+            let pos = 0;
+            while (pos < line.length) {
+                if (!(charClass[line.charCodeAt(pos)] & IDENT_START)) {
+                    pos++;
+                    continue;
+                }
+                const start = pos;
+                pos++;
+                while (pos < line.length && charClass[line.charCodeAt(pos)] & IDENT_PART) pos++;
+                const className = lineClasses[start];
+                if (!NOT_WORDS.has(className)) {
+                    callback(line.substring(start, pos), start);
+                }
+            }
+        }
+
+        /**
+         * Calls callback(kind, start, length) for every structure token
+         * outside strings and comments: +kind opens a pair, -kind closes it
+         * (see spec.structure)
+         * @param {string} line
+         * @param {string[]} lineClasses - Output of tokenizeLine for this line
+         * @param {Function} callback
+         */
+        forEachStructureToken(line, lineClasses, callback) {
+            const charClass = this.charClass;
+            const hasBlocks = this.blockKinds.size > 0;
+            let pos = 0;
+            while (pos < line.length) {
+                const flags = charClass[line.charCodeAt(pos)];
+                if (flags & STRUCTURE_BRACKET) {
+                    if (!NOT_CODE.has(lineClasses[pos])) {
+                        callback(this.bracketKinds.get(line.charCodeAt(pos)), pos, 1);
+                    }
+                    pos++;
+                } else if (hasBlocks && flags & IDENT_START) {
+                    const start = pos;
+                    pos++;
+                    while (pos < line.length && charClass[line.charCodeAt(pos)] & IDENT_PART) pos++;
+                    if (NOT_WORDS.has(lineClasses[start])) continue;
+                    const word = line.substring(start, pos);
+                    const kind = this.blockKinds.get(this.foldCase ? foldWord(word) : word);
+                    if (kind) callback(kind, start, pos - start);
+                } else {
+                    pos++;
+                }
+            }
+        }
+
+        /**
+         * Whether a structure kind delimits a scope (braces, block keywords),
+         * as opposed to grouping brackets
+         * @param {number} kind
+         * @returns {boolean}
+         */
+        isScopeKind(kind) {
+            return this.scopeKinds.has(Math.abs(kind));
+        }
+
+        /**
+         * Renders code as HTML spans (legacy textarea overlay path)
+         * @param {string} code
+         * @returns {string}
+         */
+        highlightHtml(code) {
+            if (!code) return '';
+
+            const lines = code.split('\n');
+            let state = STATE_NORMAL;
+
+            for (let row = 0; row < lines.length; row++) {
+                const line = lines[row];
+                let html = '';
+                let last = 0;
+                let openClass = null;   // Class of the span still open (adjacent runs share it)
+                state = this.scan(line, state, (start, end, className) => {
+                    const text = line.substring(start, end);
+                    const shown = this.htmlReplacements[text] || escapeHtml(text);
+                    if (start === last && className === openClass) {
+                        html += shown;
+                    } else {
+                        if (openClass) html += '</span>';
+                        html += escapeHtml(line.substring(last, start)) +
+                            `<span class="${className}">${shown}`;
+                        openClass = className;
+                    }
+                    last = end;
+                });
+                if (openClass) html += '</span>';
+                lines[row] = html + escapeHtml(line.substring(last));
+            }
+
+            return lines.join('\n');
+        }
+    }
+
+    /**
+     * Compiles a language spec into a lexer
+     * @param {Object} spec
+     * @returns {CompiledLexer}
+     */
+    function compile(spec) {
+        return new CompiledLexer(spec);
+    }
+
+    return {
+        compile,
+        foldWord,
+        escapeHtml,
+        STATE_NORMAL,
+        STATE_BLOCK_COMMENT,
+        STATE_RAW_STRING
+    };
+})();
+
+// Make LexerCompiler globally available (browser)
+if (typeof window !== 'undefined') {
+    window.LexerCompiler = LexerCompiler;
+}
+
+// Export for Node.js (tooling)
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = LexerCompiler;
+}
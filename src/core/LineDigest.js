@@ -0,0 +1,151 @@
+/**
+ * LineDigest - Block hashes of a document for divergence checks
+ *
+ * The text is cut into blocks of BLOCK_LINES lines and each block gets a
+ * 32-bit FNV-1a hash; a root hash over the block hashes lets a client
+ * tell with one compare whether its copy matches. When it does not, only
+ * the blocks whose hashes differ are fetched and patched in:
+ *
+ *   server: digest = LineDigest.compute(code)           -> code_digest
+ *   client: LineDigest.diff(localCode, digest)          -> [block indices]
+ *   server: LineDigest.blocks(code, indices)            -> code_repair
+ *   client: LineDigest.patch(localCode, digest, blocks) -> repaired text
+ *
+ * Used by both the browser (Collaboration) and the server.
+ *
+ * @module core/LineDigest
+ */
+
+const LineDigest = (function() {
+    'use strict';
+
+    // Lines per hashed block
+    const BLOCK_LINES = 32;
+
+    /**
+     * 32-bit FNV-1a over the UTF-16 code units of a string
+     * @param {string} str
+     * @param {number} [seed]
+     * @returns {number} Unsigned 32-bit hash
+     */
+    function hash(str, seed = 0x811c9dc5) {
+        let h = seed >>> 0;
+        for (let i = 0; i < str.length; i++) {
+            h ^= str.charCodeAt(i);
+            h = Math.imul(h, 0x01000193);
+        }
+        return h >>> 0;
+    }
+
+    function splitBlocks(code) {
+        const lines = code.split('\n');
+        const blocks = [];
+        for (let i = 0; i < lines.length; i += BLOCK_LINES) {
+            blocks.push(lines.slice(i, i + BLOCK_LINES).join('\n'));
+        }
+        return blocks;
+    }
+
+    function rootOf(hashes) {
+        return hash(hashes.join(','));
+    }
+
+    /**
+     * Digest of a document
+     * @param {string} code
+     * @returns {{ lineCount: number, root: number, blocks: number[] }}
+     */
+    function compute(code) {
+        const blocks = splitBlocks(code).map(block => hash(block));
+        return {
+            lineCount: code.split('\n').length,
+            root: rootOf(blocks),
+            blocks
+        };
+    }
+
+    /**
+     * Checks that a digest received over the network is usable
+     * @param {*} digest
+     * @returns {boolean}
+     */
+    function isValid(digest) {
+        return !!digest &&
+            Number.isInteger(digest.root) &&
+            Array.isArray(digest.blocks) &&
+            digest.blocks.every(Number.isInteger);
+    }
+
+    /**
+     * Blocks of the local text that differ from a digest
+     * @param {string} code - Local text
+     * @param {Object} digest - compute() of the reference text
+     * @returns {number[]} Block indices to fetch (empty when in sync)
+     */
+    function diff(code, digest) {
+        const local = compute(code);
+        if (local.root === digest.root) return [];
+
+        const indices = [];
+        digest.blocks.forEach((blockHash, i) => {
+            if (local.blocks[i] !== blockHash) indices.push(i);
+        });
+        return indices;
+    }
+
+    /**
+     * Text of some blocks (server side of a repair)
+     * @param {string} code
+     * @param {number[]} indices
+     * @returns {Object} index -> block text (indices past the end are skipped)
+     */
+    function blocks(code, indices) {
+        const all = splitBlocks(code);
+        const result = {};
+        for (const i of indices) {
+            if (Number.isInteger(i) && i >= 0 && i < all.length) {
+                result[i] = all[i];
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Rebuild the reference text from the local text and the fetched blocks
+     * @param {string} code - Local text
+     * @param {Object} digest - Digest the blocks were requested against
+     * @param {Object} repaired - blocks() output
+     * @returns {string|null} Repaired text, or null if it still doesn't match
+     */
+    function patch(code, digest, repaired) {
+        const local = splitBlocks(code);
+        const result = [];
+        for (let i = 0; i < digest.blocks.length; i++) {
+            const block = typeof repaired[i] === 'string' ? repaired[i] : local[i];
+            if (block === undefined) return null;
+            result.push(block);
+        }
+        const text = result.join('\n');
+        return compute(text).root === digest.root ? text : null;
+    }
+
+    return {
+        BLOCK_LINES,
+        hash,
+        compute,
+        isValid,
+        diff,
+        blocks,
+        patch
+    };
+})();
+
+// Make LineDigest globally available (browser)
+if (typeof window !== 'undefined') {
+    window.LineDigest = LineDigest;
+}
+
+// Export for Node.js (server)
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = LineDigest;
+}
@@ -5,52 +5,72 @@
  * based on context and language-specific rules. It provides a pure, stateless
  * interface that can be used by any editor implementation.
  * 
+ * It works on a line-indexed document: anything with `lineCount`, `length`,
+ * `getLine(row)`, `offsetAt(row, col)` and `getText()`, such as GridEditor's
+ * TextBuffer. Cursor-relative insertions only read the lines they need, and
+ * closing keywords find their opener through a BlockIndex, so their cost
+ * does not grow with the file. Structural placements (start/end of the
+ * program, after the declarations) still scan the document; they are used
+ * once per program. Plain strings go through calculateInsertion().
+ * 
+ * Dependencies:
+ * - core/BlockIndex.js (leading word / indentation helpers)
+ * 
  * @module core/SmartInserter
  */
 
 const SmartInserter = (function() {
     'use strict';
 
+    const TYPE_DECLARATION = /^\s*(ΑΚΕΡΑΙΕΣ|ΠΡΑΓΜΑΤΙΚΕΣ|ΧΑΡΑΚΤΗΡΕΣ|ΛΟΓΙΚΕΣ)/;
+    const VARIABLES_SECTION = /^ΜΕΤΑΒΛΗΤΕΣ\s*$/;
+    const PROGRAM_DECLARATION = /^(ΑΛΓΟΡΙΘΜΟΣ|Αλγόριθμος|ΠΡΟΓΡΑΜΜΑ)\s+\S+/;
+    const PROGRAM_ENDING = /^(ΤΕΛΟΣ(_ΠΡΟΓΡΑΜΜΑΤΟΣ)?|Τέλος)\s*\S*\s*$/;
+
     // ===========================================
     // Helper Functions
     // ===========================================
 
     /**
-     * Gets the current line's indentation at a given position
-     * @param {string} code - The full code string
-     * @param {number} cursorPos - Linear cursor position
+     * Gets the current line's indentation at the cursor
+     * @param {Object} doc - Line-indexed document
+     * @param {{row: number, col: number}} cursor
      * @returns {string} The indentation string (spaces/tabs)
      */
-    function getCurrentIndent(code, cursorPos) {
-        const beforeCursor = code.substring(0, cursorPos);
-        const lines = beforeCursor.split('\n');
-        const currentLine = lines[lines.length - 1];
-        const match = currentLine.match(/^(\s*)/);
-        return match ? match[1] : '';
+    function getCurrentIndent(doc, cursor) {
+        const beforeCursor = doc.getLine(cursor.row).substring(0, cursor.col);
+        return BlockIndex.indentOf(beforeCursor);
     }
 
     /**
      * Finds the indentation of a matching opening keyword
-     * Searches backwards from cursor position for a keyword that starts a block
+     * Searches upwards from the cursor for a line that starts with the keyword
      * 
-     * @param {string} code - The full code string
-     * @param {number} cursorPos - Linear cursor position
+     * @param {Object} doc - Line-indexed document
+     * @param {{row: number, col: number}} cursor
      * @param {string|string[]} matchKeywords - Keyword(s) to match
+     * @param {BlockIndex} [blockIndex] - Index of `doc` (avoids scanning upwards)
      * @returns {string} The indentation of the matching keyword, or empty string
      */
-    function findMatchingIndent(code, cursorPos, matchKeywords) {
-        const beforeCursor = code.substring(0, cursorPos);
-        const lines = beforeCursor.split('\n');
+    function findMatchingIndent(doc, cursor, matchKeywords, blockIndex = null) {
         const keywords = Array.isArray(matchKeywords) ? matchKeywords : [matchKeywords];
         
-        // Search backwards for the opening keyword
-        for (let i = lines.length - 1; i >= 0; i--) {
-            const line = lines[i];
-            for (const kw of keywords) {
-                if (line.trim().startsWith(kw)) {
-                    const indent = line.match(/^(\s*)/);
-                    return indent ? indent[1] : '';
-                }
+        // The current line counts up to the cursor
+        const beforeCursor = doc.getLine(cursor.row).substring(0, cursor.col);
+        if (keywords.includes(BlockIndex.leadingWord(beforeCursor))) {
+            return BlockIndex.indentOf(beforeCursor);
+        }
+        
+        if (blockIndex) {
+            const indent = blockIndex.findIndentBefore(keywords, cursor.row);
+            return indent !== null ? indent : '';
+        }
+        
+        // No index: search backwards for the opening keyword
+        for (let row = cursor.row - 1; row >= 0; row--) {
+            const line = doc.getLine(row);
+            if (keywords.includes(BlockIndex.leadingWord(line))) {
+                return BlockIndex.indentOf(line);
             }
         }
         return ''; // No match found, no indentation
@@ -70,63 +90,69 @@ const SmartInserter = (function() {
         }).join('\n');
     }
 
+    /**
+     * Offset of the end of a line
+     */
+    function endOfLine(doc, row) {
+        return doc.offsetAt(row, doc.getLine(row).length);
+    }
+
     /**
      * Finds the position right after variable declarations
-     * @param {string} code - The full code string
+     * @param {Object} doc - Line-indexed document
      * @returns {number} Position after variables, or -1 if not found
      */
-    function findAfterVariablesPosition(code) {
-        const varLines = code.split('\n');
-        let lastTypeLineIdx = -1;
+    function findAfterVariablesPosition(doc) {
+        let lastTypeRow = -1;
+        let sectionRow = -1;
         
         // Look for the last type declaration line
-        for (let i = 0; i < varLines.length; i++) {
-            if (varLines[i].match(/^\s*(ΑΚΕΡΑΙΕΣ|ΠΡΑΓΜΑΤΙΚΕΣ|ΧΑΡΑΚΤΗΡΕΣ|ΛΟΓΙΚΕΣ)/)) {
-                lastTypeLineIdx = i;
+        for (let row = 0; row < doc.lineCount; row++) {
+            const line = doc.getLine(row);
+            if (TYPE_DECLARATION.test(line)) {
+                lastTypeRow = row;
+            } else if (sectionRow < 0 && VARIABLES_SECTION.test(line)) {
+                sectionRow = row;
             }
         }
         
-        if (lastTypeLineIdx >= 0) {
-            let charCount = 0;
-            for (let i = 0; i <= lastTypeLineIdx; i++) {
-                charCount += varLines[i].length + 1;
-            }
-            return charCount - 1;
-        }
+        if (lastTypeRow >= 0) return endOfLine(doc, lastTypeRow);
         
-        // Check if ΜΕΤΑΒΛΗΤΕΣ exists
-        const metabMatch = code.match(/^ΜΕΤΑΒΛΗΤΕΣ\s*$/m);
-        if (metabMatch) {
-            return code.indexOf(metabMatch[0]) + metabMatch[0].length;
-        }
+        // Otherwise right after ΜΕΤΑΒΛΗΤΕΣ, if it exists
+        if (sectionRow >= 0) return endOfLine(doc, sectionRow);
         
         return -1;
     }
 
     /**
      * Finds the position right after program/algorithm declaration
-     * @param {string} code - The full code string
+     * @param {Object} doc - Line-indexed document
      * @returns {number} Position after declaration, or -1 if not found
      */
-    function findAfterDeclarationPosition(code) {
-        const declMatch = code.match(/^(ΑΛΓΟΡΙΘΜΟΣ|Αλγόριθμος|ΠΡΟΓΡΑΜΜΑ)\s+\S+.*$/m);
-        if (declMatch) {
-            return code.indexOf(declMatch[0]) + declMatch[0].length;
+    function findAfterDeclarationPosition(doc) {
+        for (let row = 0; row < doc.lineCount; row++) {
+            if (PROGRAM_DECLARATION.test(doc.getLine(row))) {
+                return endOfLine(doc, row);
+            }
         }
         return -1;
     }
 
     /**
-     * Finds the position before the ending keyword (ΤΕΛΟΣ/ΤΕΛΟΣ_ΠΡΟΓΡΑΜΜΑΤΟΣ)
-     * @param {string} code - The full code string
-     * @returns {number} Position before ending, or code.length if not found
+     * Finds the position before the ending keyword (ΤΕΛΟΣ/ΤΕΛΟΣ_ΠΡΟΓΡΑΜΜΑΤΟΣ):
+     * the newline ending the line above it
+     * @param {Object} doc - Line-indexed document
+     * @returns {number} Position before ending, or doc.length if not found
      */
-    function findBeforeEndingPosition(code) {
-        const telosMatch = code.match(/\n(ΤΕΛΟΣ(_ΠΡΟΓΡΑΜΜΑΤΟΣ)?|Τέλος)\s*\S*\s*$/);
-        if (telosMatch) {
-            return telosMatch.index;
+    function findBeforeEndingPosition(doc) {
+        // Skip trailing blank lines
+        let row = doc.lineCount - 1;
+        while (row > 0 && doc.getLine(row).trim() === '') row--;
+        
+        if (row > 0 && PROGRAM_ENDING.test(doc.getLine(row))) {
+            return doc.offsetAt(row, 0) - 1;
         }
-        return code.length;
+        return doc.length;
     }
 
     // ===========================================
@@ -134,18 +160,24 @@ const SmartInserter = (function() {
     // ===========================================
 
     /**
-     * Calculates the insertion result based on code context and rules
+     * Calculates where and what to insert, based on code context and rules
      * 
-     * @param {string} code - Current code in the editor
-     * @param {number} cursorPos - Current cursor position (linear)
+     * @param {Object} doc - Line-indexed document (e.g. a TextBuffer)
+     * @param {{row: number, col: number}} cursor - Current cursor position
      * @param {string} keyword - The keyword/text to insert
      * @param {Object} rule - Smart insertion rule from SMART_INSERTION
      * @param {Object} [options] - Additional options
      * @param {Function} [options.promptFn] - Function for prompting user (receives message, default)
-     * @returns {{ newCode: string, newCursorPos: number, cancelled?: boolean }}
+     * @param {BlockIndex} [options.blockIndex] - Block index of `doc`, for closing keywords
+     * @returns {{ offset: number, text: string, cursorOffset: number, cancelled?: boolean }}
+     *          Insert `text` at `offset`; the cursor then goes to `cursorOffset`
      */
-    function calculateInsertion(code, cursorPos, keyword, rule, options = {}) {
-        const { promptFn = null } = options;
+    function calculateEdit(doc, cursor, keyword, rule, options = {}) {
+        const { promptFn = null, blockIndex = null } = options;
+        
+        const cursorPos = doc.offsetAt(cursor.row, cursor.col);
+        const docLength = doc.length;
+        const atLineStart = cursor.col === 0; // Start of the document or right after a newline
         
         let insertText = keyword;
         let insertPos = cursorPos;
@@ -153,10 +185,7 @@ const SmartInserter = (function() {
         
         // No rule - simple insertion at cursor
         if (!rule) {
-            return {
-                newCode: code.substring(0, cursorPos) + keyword + code.substring(cursorPos),
-                newCursorPos: cursorPos + keyword.length
-            };
+            return { offset: cursorPos, text: keyword, cursorOffset: cursorPos + keyword.length };
         }
 
         // Handle template-based insertion
@@ -168,7 +197,7 @@ const SmartInserter = (function() {
                 const name = promptFn(rule.promptName, rule.defaultName);
                 if (name === null) {
                     // User cancelled
-                    return { newCode: code, newCursorPos: cursorPos, cancelled: true };
+                    return { offset: cursorPos, text: '', cursorOffset: cursorPos, cancelled: true };
                 }
                 template = template.replace(/\{\{NAME\}\}/g, name || rule.defaultName);
             } else if (rule.promptName) {
@@ -177,7 +206,7 @@ const SmartInserter = (function() {
             }
             
             // Get base indentation from current position
-            const baseIndent = getCurrentIndent(code, cursorPos);
+            const baseIndent = getCurrentIndent(doc, cursor);
             
             // Apply indentation to template
             template = indentTemplate(template, baseIndent);
@@ -193,25 +222,25 @@ const SmartInserter = (function() {
             switch (rule.placement) {
                 case 'start':
                     insertPos = 0;
-                    if (code.length > 0) {
+                    if (docLength > 0) {
                         template = template + '\n';
                     }
                     newCursorPos = cursorOffset >= 0 ? cursorOffset : template.length;
                     break;
                     
                 case 'end-of-file': {
-                    const beforeEnd = findBeforeEndingPosition(code);
-                    if (beforeEnd < code.length) {
+                    const beforeEnd = findBeforeEndingPosition(doc);
+                    if (beforeEnd < docLength) {
                         insertPos = beforeEnd;
                         template = '\n' + template + '\n';
                     } else {
-                        insertPos = code.length;
+                        insertPos = docLength;
                         template = '\n\n' + template;
                     }
                     // Calculate cursor position in the inserted text
-                    const insertedCursorOffset = template.indexOf(cursorMarker) >= 0 ? 
-                        template.indexOf(cursorMarker) : 
-                        (cursorOffset >= 0 ? cursorOffset + (template.startsWith('\n\n') ? 2 : 1) : template.length);
+                    const insertedCursorOffset = cursorOffset >= 0
+                        ? cursorOffset + (template.startsWith('\n\n') ? 2 : 1)
+                        : template.length;
                     newCursorPos = insertPos + insertedCursorOffset;
                     break;
                 }
@@ -222,8 +251,7 @@ const SmartInserter = (function() {
                     insertPos = cursorPos;
                     
                     // Ensure we're on a new line
-                    const beforeInsert = code.substring(0, insertPos);
-                    if (beforeInsert.length > 0 && !beforeInsert.endsWith('\n')) {
+                    if (!atLineStart) {
                         template = '\n' + baseIndent + template;
                         newCursorPos = insertPos + 1 + baseIndent.length + (cursorOffset >= 0 ? cursorOffset : 0);
                     } else {
@@ -236,18 +264,23 @@ const SmartInserter = (function() {
             insertText = template;
         } else {
             // Non-template insertion (keyword-based)
-            insertText = rule.getText ? rule.getText(code) : keyword;
+            // Only getText(code) functions that read the code get the full text
+            if (rule.getText) {
+                insertText = rule.getText(rule.getText.length > 0 ? doc.getText() : '');
+            }
             
             switch (rule.placement) {
-                case 'end':
-                    insertPos = code.length;
-                    if (code.length > 0 && !code.endsWith('\n')) {
+                case 'end': {
+                    const endsWithNewline = docLength > 0 && doc.getLine(doc.lineCount - 1) === '';
+                    insertPos = docLength;
+                    if (docLength > 0 && !endsWithNewline) {
                         insertText = '\n\n' + insertText;
-                    } else if (code.length > 0) {
+                    } else if (docLength > 0) {
                         insertText = '\n' + insertText;
                     }
                     newCursorPos = insertPos + insertText.length;
                     break;
+                }
                     
                 case 'start':
                     insertPos = 0;
@@ -255,7 +288,7 @@ const SmartInserter = (function() {
                     break;
                     
                 case 'after-declaration': {
-                    const declPos = findAfterDeclarationPosition(code);
+                    const declPos = findAfterDeclarationPosition(doc);
                     if (declPos >= 0) {
                         insertPos = declPos;
                         insertText = '\n\n' + insertText;
@@ -268,7 +301,7 @@ const SmartInserter = (function() {
                 }
                     
                 case 'after-variables': {
-                    const varPos = findAfterVariablesPosition(code);
+                    const varPos = findAfterVariablesPosition(doc);
                     if (varPos >= 0) {
                         insertPos = varPos;
                         insertText = '\n\n' + insertText;
@@ -282,11 +315,10 @@ const SmartInserter = (function() {
                     
                 case 'match-indent': {
                     const indent = rule.matchStart ? 
-                        findMatchingIndent(code, cursorPos, rule.matchStart) : 
-                        getCurrentIndent(code, cursorPos);
+                        findMatchingIndent(doc, cursor, rule.matchStart, blockIndex) : 
+                        getCurrentIndent(doc, cursor);
                         
-                    const beforePos = code.substring(0, cursorPos);
-                    if (!beforePos.endsWith('\n') && beforePos.length > 0) {
+                    if (!atLineStart) {
                         insertText = '\n' + indent + insertText;
                     } else {
                         insertText = indent + insertText;
@@ -296,14 +328,9 @@ const SmartInserter = (function() {
                 }
                     
                 case 'end-of-file': {
-                    const beforeEnd = findBeforeEndingPosition(code);
-                    if (beforeEnd < code.length) {
-                        insertPos = beforeEnd;
-                        insertText = '\n\n' + insertText;
-                    } else {
-                        insertPos = code.length;
-                        insertText = '\n\n' + insertText;
-                    }
+                    const beforeEnd = findBeforeEndingPosition(doc);
+                    insertPos = beforeEnd < docLength ? beforeEnd : docLength;
+                    insertText = '\n\n' + insertText;
                     newCursorPos = insertPos + insertText.length;
                     break;
                 }
@@ -316,10 +343,30 @@ const SmartInserter = (function() {
             }
         }
         
-        // Perform the insertion
-        const newCode = code.substring(0, insertPos) + insertText + code.substring(insertPos);
+        return { offset: insertPos, text: insertText, cursorOffset: newCursorPos };
+    }
+
+    /**
+     * String version of calculateEdit (legacy textarea editor)
+     * 
+     * @param {string} code - Current code in the editor
+     * @param {number} cursorPos - Current cursor position (linear)
+     * @param {string} keyword - The keyword/text to insert
+     * @param {Object} rule - Smart insertion rule from SMART_INSERTION
+     * @param {Object} [options] - See calculateEdit
+     * @returns {{ newCode: string, newCursorPos: number, cancelled?: boolean }}
+     */
+    function calculateInsertion(code, cursorPos, keyword, rule, options = {}) {
+        const doc = createStringDocument(code);
+        const edit = calculateEdit(doc, linearToRowCol(code, cursorPos), keyword, rule, options);
         
-        return { newCode, newCursorPos };
+        if (edit.cancelled) {
+            return { newCode: code, newCursorPos: cursorPos, cancelled: true };
+        }
+        
+        // Perform the insertion
+        const newCode = code.substring(0, edit.offset) + edit.text + code.substring(edit.offset);
+        return { newCode, newCursorPos: edit.cursorOffset };
     }
 
     // ===========================================
@@ -371,13 +418,44 @@ const SmartInserter = (function() {
         return pos;
     }
 
+    /**
+     * Wraps a string in the line-indexed document interface
+     * @param {string} code
+     * @returns {Object} { lineCount, length, getLine, offsetAt, getText }
+     */
+    function createStringDocument(code) {
+        const lines = code.split('\n');
+        const lineStarts = new Array(lines.length);
+        let pos = 0;
+        for (let i = 0; i < lines.length; i++) {
+            lineStarts[i] = pos;
+            pos += lines[i].length + 1; // +1 for newline
+        }
+        
+        return {
+            lineCount: lines.length,
+            length: code.length,
+            getLine: (row) => lines[row],
+            offsetAt: (row, col) => {
+                row = Math.max(0, Math.min(row, lines.length - 1));
+                return lineStarts[row] + Math.max(0, Math.min(col, lines[row].length));
+            },
+            getText: () => code
+        };
+    }
+
     // ===========================================
     // Public API
     // ===========================================
 
     return {
         /**
-         * Main entry point for calculating smart insertion
+         * Main entry point: smart insertion into a line-indexed document
+         */
+        calculateEdit,
+        
+        /**
+         * Smart insertion into a plain string
          */
         calculateInsertion,
         
@@ -396,6 +474,11 @@ const SmartInserter = (function() {
          */
         indentTemplate,
         
+        /**
+         * Utility: Line-indexed document over a string
+         */
+        createStringDocument,
+        
         /**
          * Utility: Convert linear position to row/col
          */
@@ -0,0 +1,219 @@
+/**
+ * StructureIndex - Bracket and block pairs of a TextBuffer
+ *
+ * Built on the tokenizer output: HighlightCache re-tokenizes the lines an
+ * edit touched and hands them to updateRow(), which keeps that row's
+ * structure tokens (brackets outside strings/comments, and for GLOSSA the
+ * block keywords ΑΝ…ΤΕΛΟΣ_ΑΝ, ΓΙΑ…ΤΕΛΟΣ_ΕΠΑΝΑΛΗΨΗΣ, ...).
+ *
+ * Tokens are paired with one stack pass into flat typed arrays the first
+ * time they are queried after an edit (cost: the number of structure
+ * tokens, not characters). After that, "partner of the token at (row, col)"
+ * and "enclosing scope of (row, col)" are binary searches, so moving the
+ * cursor around costs O(log n).
+ *
+ * A closer that does not match the innermost opener closes the nearest
+ * matching opener within MAX_RECOVERY_DEPTH levels (the openers in between
+ * stay unmatched); otherwise it is ignored. One missing ΤΕΛΟΣ_ΑΝ therefore
+ * does not shift every block after it.
+ *
+ * @module core/StructureIndex
+ */
+
+const StructureIndex = (function() {
+    'use strict';
+
+    const MAX_RECOVERY_DEPTH = 8;
+    const EMPTY = [];
+
+    class StructureIndex {
+        /**
+         * @param {TextBuffer} buffer - Document whose rows are indexed
+         */
+        constructor(buffer) {
+            this.buffer = buffer;
+            this.lexer = null;        // Lexer of the last updateRow() (scope kinds)
+            this.rowTokens = new Array(buffer.lineCount).fill(null); // [col, length, kind, ...] per row
+            this._built = null;       // Paired tokens, null when stale
+
+            this._unsubscribe = buffer.onChange(change => this._onBufferChange(change));
+        }
+
+        /**
+         * Re-read the structure tokens of a freshly tokenized row
+         * @param {number} row
+         * @param {string[]} lineClasses - Tokenizer classes of the row
+         * @param {Object} lexer - Compiled lexer (see LexerCompiler)
+         */
+        updateRow(row, lineClasses, lexer) {
+            const tokens = [];
+            if (lexer && lineClasses) {
+                lexer.forEachStructureToken(this.buffer.getLine(row), lineClasses, (kind, col, length) => {
+                    tokens.push(col, length, kind);
+                });
+            }
+            this.rowTokens[row] = tokens.length > 0 ? tokens : EMPTY;
+            this.lexer = lexer;
+            this._built = null;
+        }
+
+        /**
+         * Detach from the buffer
+         */
+        dispose() {
+            if (this._unsubscribe) this._unsubscribe();
+        }
+
+        _onBufferChange(change) {
+            const { startRow, removedLines, insertedLines } = change;
+            const fresh = new Array(insertedLines).fill(null);
+            if (insertedLines <= 1024) {
+                this.rowTokens.splice(startRow, removedLines, ...fresh);
+            } else {
+                this.rowTokens = this.rowTokens.slice(0, startRow).concat(fresh, this.rowTokens.slice(startRow + removedLines));
+            }
+            this._built = null;
+        }
+
+        // ===========================================
+        // Pairing
+        // ===========================================
+
+        _build() {
+            if (this._built) return this._built;
+
+            let count = 0;
+            for (const tokens of this.rowTokens) {
+                if (tokens) count += tokens.length / 3;
+            }
+
+            const rows = new Int32Array(count);
+            const cols = new Int32Array(count);
+            const lengths = new Int32Array(count);
+            const kinds = new Int32Array(count);
+            const partner = new Int32Array(count).fill(-1);
+            const parent = new Int32Array(count).fill(-1); // Innermost opener around the token
+
+            const stack = [];
+            let i = 0;
+            for (let row = 0; row < this.rowTokens.length; row++) {
+                const tokens = this.rowTokens[row];
+                if (!tokens) continue;
+                for (let t = 0; t < tokens.length; t += 3, i++) {
+                    const kind = tokens[t + 2];
+                    rows[i] = row;
+                    cols[i] = tokens[t];
+                    lengths[i] = tokens[t + 1];
+                    kinds[i] = kind;
+                    parent[i] = stack.length > 0 ? stack[stack.length - 1] : -1;
+
+                    if (kind > 0) {
+                        stack.push(i);
+                        continue;
+                    }
+
+                    const limit = Math.max(0, stack.length - MAX_RECOVERY_DEPTH);
+                    let depth = stack.length - 1;
+                    while (depth >= limit && kinds[stack[depth]] !== -kind) depth--;
+                    if (depth < limit) continue; // Stray closer
+
+                    const open = stack[depth];
+                    partner[open] = i;
+                    partner[i] = open;
+                    parent[i] = parent[open];
+                    stack.length = depth;
+                }
+            }
+
+            this._built = { count, rows, cols, lengths, kinds, partner, parent };
+            return this._built;
+        }
+
+        /**
+         * Index of the last token starting before (row, col), or -1
+         */
+        _lastBefore(built, row, col) {
+            let lo = 0;
+            let hi = built.count;
+            while (lo < hi) {
+                const mid = (lo + hi) >>> 1;
+                if (built.rows[mid] < row || (built.rows[mid] === row && built.cols[mid] < col)) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            return lo - 1;
+        }
+
+        _position(built, i) {
+            return { row: built.rows[i], col: built.cols[i], length: built.lengths[i] };
+        }
+
+        _pair(built, i) {
+            const j = built.partner[i];
+            const open = built.kinds[i] > 0 ? i : j;
+            const close = built.kinds[i] > 0 ? j : i;
+            return { open: this._position(built, open), close: this._position(built, close) };
+        }
+
+        // ===========================================
+        // Queries
+        // ===========================================
+
+        /**
+         * Pair of the token under the cursor, or of the one just before it
+         * @param {number} row
+         * @param {number} col
+         * @returns {{ open: {row, col, length}, close: {row, col, length} }|null}
+         */
+        matchAt(row, col) {
+            const built = this._build();
+
+            // Token covering col
+            let i = this._lastBefore(built, row, col + 1);
+            if (i >= 0 && built.rows[i] === row && col < built.cols[i] + built.lengths[i]) {
+                return built.partner[i] >= 0 ? this._pair(built, i) : null;
+            }
+
+            // Token ending right at the cursor
+            i = this._lastBefore(built, row, col);
+            if (i >= 0 && built.rows[i] === row && built.cols[i] + built.lengths[i] === col) {
+                return built.partner[i] >= 0 ? this._pair(built, i) : null;
+            }
+            return null;
+        }
+
+        /**
+         * Innermost matched scope (braces, block keywords) containing the
+         * cursor. The cursor is inside once it is past the opener's first
+         * character and until it passes the closer's first character.
+         * @param {number} row
+         * @param {number} col
+         * @returns {{ open: {row, col, length}, close: {row, col, length} }|null}
+         */
+        enclosingScope(row, col) {
+            const built = this._build();
+            const lexer = this.lexer;
+
+            const i = this._lastBefore(built, row, col);
+            let open = i < 0 ? -1 : (built.kinds[i] > 0 ? i : built.parent[i]);
+            while (open >= 0 && (built.partner[open] < 0 || !(lexer && lexer.isScopeKind(built.kinds[open])))) {
+                open = built.parent[open];
+            }
+            return open >= 0 ? this._pair(built, open) : null;
+        }
+    }
+
+    return StructureIndex;
+})();
+
+// Make StructureIndex globally available (browser)
+if (typeof window !== 'undefined') {
+    window.StructureIndex = StructureIndex;
+}
+
+// Export for Node.js (tooling)
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = StructureIndex;
+}
@@ -0,0 +1,459 @@
+/**
+ * TextBuffer - Line-indexed text storage for GridEditor
+ *
+ * Stores the document as an implicit treap (randomized balanced tree) of lines.
+ * Every node caches the number of lines and characters (including the newline
+ * after each line) in its subtree, so line lookup, row/col <-> offset
+ * conversion, and inserting/removing lines are all O(log n).
+ *
+ * Edits never re-split the whole document: only the inserted text itself is
+ * split into lines, and the affected lines are swapped in place.
+ *
+ * @module core/TextBuffer
+ */
+
+const TextBuffer = (function() {
+    'use strict';
+
+    // ===========================================
+    // Treap Primitives
+    // ===========================================
+
+    /**
+     * A single line in the treap
+     * @private
+     */
+    class LineNode {
+        constructor(line, prio) {
+            this.line = line;
+            this.prio = prio;
+            this.left = null;
+            this.right = null;
+            this.count = 1;              // Lines in subtree
+            this.chars = line.length + 1; // Chars in subtree (+1 newline per line)
+        }
+    }
+
+    function count(node) {
+        return node ? node.count : 0;
+    }
+
+    function chars(node) {
+        return node ? node.chars : 0;
+    }
+
+    function update(node) {
+        node.count = 1 + count(node.left) + count(node.right);
+        node.chars = node.line.length + 1 + chars(node.left) + chars(node.right);
+    }
+
+    function merge(a, b) {
+        if (!a) return b;
+        if (!b) return a;
+        if (a.prio > b.prio) {
+            a.right = merge(a.right, b);
+            update(a);
+            return a;
+        }
+        b.left = merge(a, b.left);
+        update(b);
+        return b;
+    }
+
+    /**
+     * Splits a treap so that the first k lines end up on the left
+     * @returns {LineNode[]} [left, right]
+     */
+    function split(node, k) {
+        if (!node) return [null, null];
+        const leftCount = count(node.left);
+        if (k <= leftCount) {
+            const parts = split(node.left, k);
+            node.left = parts[1];
+            update(node);
+            return [parts[0], node];
+        }
+        const parts = split(node.right, k - leftCount - 1);
+        node.right = parts[0];
+        update(node);
+        return [node, parts[1]];
+    }
+
+    /**
+     * Builds a balanced treap from an array of lines in O(k log k).
+     * Priorities are sorted and handed out level by level so the heap
+     * property holds without any rotations.
+     */
+    function build(lines) {
+        if (lines.length === 0) return null;
+
+        const buildRange = (lo, hi) => {
+            if (lo > hi) return null;
+            const mid = (lo + hi) >> 1;
+            const node = new LineNode(lines[mid], 0);
+            node.left = buildRange(lo, mid - 1);
+            node.right = buildRange(mid + 1, hi);
+            update(node);
+            return node;
+        };
+        const root = buildRange(0, lines.length - 1);
+
+        const prios = new Float64Array(lines.length);
+        for (let i = 0; i < prios.length; i++) prios[i] = Math.random();
+        prios.sort();
+
+        // Breadth-first: parents always get a higher priority than children
+        let idx = prios.length - 1;
+        let level = [root];
+        while (level.length > 0) {
+            const next = [];
+            for (const node of level) {
+                node.prio = prios[idx--];
+                if (node.left) next.push(node.left);
+                if (node.right) next.push(node.right);
+            }
+            level = next;
+        }
+        return root;
+    }
+
+    function collect(node, out) {
+        // Iterative in-order walk (documents can be deep enough to matter)
+        const stack = [];
+        let cur = node;
+        while (cur || stack.length > 0) {
+            while (cur) {
+                stack.push(cur);
+                cur = cur.left;
+            }
+            cur = stack.pop();
+            out.push(cur.line);
+            cur = cur.right;
+        }
+        return out;
+    }
+
+    // ===========================================
+    // TextBuffer
+    // ===========================================
+
+    class TextBuffer {
+        /**
+         * @param {string} [text=''] - Initial document text
+         */
+        constructor(text = '') {
+            this.root = build(text.split('\n'));
+            this.version = 0;
+            this._text = text;      // Cached full text (null when stale)
+            this._listeners = [];
+        }
+
+        /**
+         * Creates a buffer from a plain string
+         * @param {string} text
+         * @returns {TextBuffer}
+         */
+        static fromText(text) {
+            return new TextBuffer(text);
+        }
+
+        /** Number of lines (always >= 1) */
+        get lineCount() {
+            return count(this.root);
+        }
+
+        /** Total number of characters including newlines */
+        get length() {
+            return chars(this.root) - 1;
+        }
+
+        // ===========================================
+        // Reading
+        // ===========================================
+
+        /**
+         * Returns the text of a line, or '' for an out-of-range row
+         * @param {number} row - 0-based row
+         * @returns {string}
+         */
+        getLine(row) {
+            let node = this.root;
+            while (node) {
+                const leftCount = count(node.left);
+                if (row < leftCount) {
+                    node = node.left;
+                } else if (row === leftCount) {
+                    return node.line;
+                } else {
+                    row -= leftCount + 1;
+                    node = node.right;
+                }
+            }
+            return '';
+        }
+
+        /**
+         * Length of a line without walking the text
+         * @param {number} row
+         * @returns {number}
+         */
+        getLineLength(row) {
+            return this.getLine(row).length;
+        }
+
+        /**
+         * Returns lines in [start, end) as an array
+         * @param {number} [start=0]
+         * @param {number} [end=lineCount]
+         * @returns {string[]}
+         */
+        getLines(start = 0, end = this.lineCount) {
+            start = Math.max(0, start);
+            end = Math.min(this.lineCount, end);
+            if (start >= end) return [];
+            if (start === 0 && end === this.lineCount) {
+                return collect(this.root, []);
+            }
+            const [a, rest] = split(this.root, start);
+            const [mid, b] = split(rest, end - start);
+            const out = collect(mid, []);
+            this.root = merge(a, merge(mid, b));
+            return out;
+        }
+
+        /**
+         * Full document text. Cached until the next edit, so repeated
+         * calls between edits cost nothing.
+         * @returns {string}
+         */
+        getText() {
+            if (this._text === null) {
+                this._text = collect(this.root, []).join('\n');
+            }
+            return this._text;
+        }
+
+        /**
+         * Character offset of the start of a line
+         * @param {number} row - 0-based row
+         * @returns {number}
+         */
+        offsetOfLine(row) {
+            let node = this.root;
+            let offset = 0;
+            while (node) {
+                const leftCount = count(node.left);
+                if (row <= leftCount) {
+                    if (row === leftCount) return offset + chars(node.left);
+                    node = node.left;
+                } else {
+                    offset += chars(node.left) + node.line.length + 1;
+                    row -= leftCount + 1;
+                    node = node.right;
+                }
+            }
+            return offset;
+        }
+
+        /**
+         * Converts row/col to a character offset (col is clamped to the line)
+         * @param {number} row - 0-based row
+         * @param {number} col - 0-based column
+         * @returns {number}
+         */
+        offsetAt(row, col) {
+            row = Math.max(0, Math.min(row, this.lineCount - 1));
+            const lineLen = this.getLineLength(row);
+            return this.offsetOfLine(row) + Math.max(0, Math.min(col, lineLen));
+        }
+
+        /**
+         * Converts a character offset to row/col (clamped to the document)
+         * @param {number} offset
+         * @returns {{ row: number, col: number }}
+         */
+        positionAt(offset) {
+            offset = Math.max(0, Math.min(offset, this.length));
+            let node = this.root;
+            let row = 0;
+            while (node) {
+                const leftChars = chars(node.left);
+                if (offset < leftChars) {
+                    node = node.left;
+                    continue;
+                }
+                offset -= leftChars;
+                if (offset <= node.line.length) {
+                    return { row: row + count(node.left), col: offset };
+                }
+                offset -= node.line.length + 1;
+                row += count(node.left) + 1;
+                node = node.right;
+            }
+            // Only reachable for an empty tree, which never happens
+            return { row: 0, col: 0 };
+        }
+
+        // ===========================================
+        // Editing
+        // ===========================================
+
+        /**
+         * Replaces the text between two positions.
+         * Only the replaced lines are touched; the rest of the tree is reused.
+         *
+         * @param {number} startRow
+         * @param {number} startCol
+         * @param {number} endRow
+         * @param {number} endCol
+         * @param {string} text - Replacement text (may contain newlines)
+         * @returns {{ row: number, col: number }} Position right after the inserted text
+         */
+        replaceRange(startRow, startCol, endRow, endCol, text) {
+            const lastRow = this.lineCount - 1;
+            startRow = Math.max(0, Math.min(startRow, lastRow));
+            endRow = Math.max(startRow, Math.min(endRow, lastRow));
+
+            const [before, rest] = split(this.root, startRow);
+            const [middle, after] = split(rest, endRow - startRow + 1);
+
+            const oldLines = collect(middle, []);
+            const first = oldLines[0];
+            const last = oldLines[oldLines.length - 1];
+            startCol = Math.max(0, Math.min(startCol, first.length));
+            endCol = Math.max(0, Math.min(endCol, last.length));
+            if (endRow === startRow && endCol < startCol) endCol = startCol;
+
+            const inserted = text.split('\n');
+            const tail = inserted[inserted.length - 1];
+            const endPos = {
+                row: startRow + inserted.length - 1,
+                col: inserted.length === 1 ? startCol + tail.length : tail.length
+            };
+            inserted[0] = first.slice(0, startCol) + inserted[0];
+            inserted[inserted.length - 1] += last.slice(endCol);
+
+            this.root = merge(before, merge(build(inserted), after));
+
+            const removedText = oldLines.length === 1
+                ? first.slice(startCol, endCol)
+                : [first.slice(startCol), ...oldLines.slice(1, -1), last.slice(0, endCol)].join('\n');
+
+            this._changed({
+                startRow,
+                removedLines: oldLines.length,
+                insertedLines: inserted.length,
+                offset: this.offsetOfLine(startRow) + startCol,
+                removedText,
+                insertedText: text
+            });
+            return endPos;
+        }
+
+        /**
+         * Replaces a range given as character offsets
+         * @param {number} offset - Start offset
+         * @param {number} deleteCount - Characters to remove
+         * @param {string} text - Text to insert
+         * @returns {{ row: number, col: number }} Position right after the inserted text
+         */
+        replace(offset, deleteCount, text) {
+            const start = this.positionAt(offset);
+            const end = this.positionAt(offset + deleteCount);
+            return this.replaceRange(start.row, start.col, end.row, end.col, text);
+        }
+
+        /**
+         * Replaces the text of a single line (must not contain newlines)
+         * @param {number} row
+         * @param {string} text
+         */
+        setLine(row, text) {
+            this.replaceRange(row, 0, row, Infinity, text);
+        }
+
+        /**
+         * Replaces the whole document, touching only the span that differs
+         * (common prefix and suffix are kept), so listeners see a minimal change.
+         * @param {string} text
+         * @returns {Object|null} The applied { offset, deleteCount, text }, or null if unchanged
+         */
+        setText(text) {
+            const op = TextBuffer.diff(this.getText(), text);
+            if (op) {
+                this.replace(op.offset, op.deleteCount, op.text);
+                this._text = text;
+            }
+            return op;
+        }
+
+        /**
+         * Smallest single range edit that turns oldText into newText
+         * @param {string} oldText
+         * @param {string} newText
+         * @returns {Object|null} { offset, deleteCount, text } or null when equal
+         */
+        static diff(oldText, newText) {
+            if (oldText === newText) return null;
+
+            const maxPrefix = Math.min(oldText.length, newText.length);
+            let prefix = 0;
+            while (prefix < maxPrefix && oldText.charCodeAt(prefix) === newText.charCodeAt(prefix)) {
+                prefix++;
+            }
+
+            const maxSuffix = maxPrefix - prefix;
+            let suffix = 0;
+            while (suffix < maxSuffix &&
+                   oldText.charCodeAt(oldText.length - 1 - suffix) === newText.charCodeAt(newText.length - 1 - suffix)) {
+                suffix++;
+            }
+
+            return {
+                offset: prefix,
+                deleteCount: oldText.length - prefix - suffix,
+                text: newText.slice(prefix, newText.length - suffix)
+            };
+        }
+
+        // ===========================================
+        // Change Notification
+        // ===========================================
+
+        /**
+         * Registers a listener for changes.
+         * Listeners receive { startRow, removedLines, insertedLines, version }
+         * (the lines replaced) and { offset, removedText, insertedText }
+         * (the exact text edit, enough to invert it).
+         * @param {Function} listener
+         * @returns {Function} Unsubscribe function
+         */
+        onChange(listener) {
+            this._listeners.push(listener);
+            return () => {
+                this._listeners = this._listeners.filter(l => l !== listener);
+            };
+        }
+
+        _changed(change) {
+            this.version++;
+            this._text = null;
+            change.version = this.version;
+            for (const listener of this._listeners) {
+                listener(change);
+            }
+        }
+    }
+
+    return TextBuffer;
+})();
+
+// Make TextBuffer globally available (browser)
+if (typeof window !== 'undefined') {
+    window.TextBuffer = TextBuffer;
+}
+
+// Export for Node.js (server / tooling)
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = TextBuffer;
+}
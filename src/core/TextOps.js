@@ -0,0 +1,157 @@
+/**
+ * TextOps - Range edit operations for code synchronization
+ *
+ * An op replaces `deleteCount` characters at `offset` with `text`:
+ *   { offset: number, deleteCount: number, text: string }
+ *
+ * Used by both the browser (Collaboration) and the server so that editors
+ * exchange small deltas instead of the whole document. Concurrent ops are
+ * reconciled with transform(): two sides that apply each other's transformed
+ * ops end up with identical text.
+ *
+ * @module core/TextOps
+ */
+
+const TextOps = (function() {
+    'use strict';
+
+    /**
+     * Creates an op, returning null for a no-op
+     * @param {number} offset
+     * @param {number} deleteCount
+     * @param {string} text
+     * @returns {Object|null}
+     */
+    function create(offset, deleteCount, text) {
+        if (deleteCount <= 0 && !text) return null;
+        return { offset, deleteCount: Math.max(0, deleteCount), text: text || '' };
+    }
+
+    /**
+     * Checks that a value received over the network is a usable op
+     * @param {*} op
+     * @returns {boolean}
+     */
+    function isValid(op) {
+        return !!op &&
+            Number.isInteger(op.offset) && op.offset >= 0 &&
+            Number.isInteger(op.deleteCount) && op.deleteCount >= 0 &&
+            typeof op.text === 'string';
+    }
+
+    /**
+     * Applies an op to a string
+     * @param {string} text
+     * @param {Object} op
+     * @returns {string}
+     */
+    function apply(text, op) {
+        const offset = Math.min(op.offset, text.length);
+        return text.slice(0, offset) + op.text + text.slice(offset + op.deleteCount);
+    }
+
+    /**
+     * Applies a list of ops in order
+     * @param {string} text
+     * @param {Object[]} ops
+     * @returns {string}
+     */
+    function applyAll(text, ops) {
+        for (const op of ops) {
+            text = apply(text, op);
+        }
+        return text;
+    }
+
+    /**
+     * Rewrites op `a` so it can be applied after op `b` (both made on the same text).
+     * When both touch the same position, `aWins` decides whose text comes first.
+     *
+     * @param {Object} a
+     * @param {Object} b
+     * @param {boolean} aWins
+     * @returns {Object[]} Zero, one or two ops
+     */
+    function transformOp(a, b, aWins) {
+        const aEnd = a.offset + a.deleteCount;
+        const bEnd = b.offset + b.deleteCount;
+        const shift = b.text.length - b.deleteCount;
+
+        // Two inserts at the same spot: the winner stays in front
+        if (a.deleteCount === 0 && b.deleteCount === 0 && a.offset === b.offset) {
+            return [aWins ? a : { offset: a.offset + b.text.length, deleteCount: 0, text: a.text }];
+        }
+        // Entirely before b
+        if (aEnd <= b.offset) {
+            return [a];
+        }
+        // Entirely after b
+        if (a.offset >= bEnd) {
+            return [{ offset: a.offset + shift, deleteCount: a.deleteCount, text: a.text }];
+        }
+
+        // Overlap: delete only what b has not already removed
+        const headLength = Math.max(0, Math.min(aEnd, b.offset) - a.offset);
+        const tailStart = Math.max(a.offset, bEnd);
+        const tailLength = Math.max(0, aEnd - tailStart);
+        const aFirst = a.offset < b.offset || (a.offset === b.offset && aWins);
+
+        const result = [];
+        if (aFirst) {
+            // Remove the tail first so the head offset stays valid
+            const tail = create(tailStart + shift, tailLength, '');
+            if (tail) result.push(tail);
+            const head = create(a.offset, headLength, a.text);
+            if (head) result.push(head);
+        } else {
+            const tail = create(b.offset + b.text.length, tailLength, a.text);
+            if (tail) result.push(tail);
+        }
+        return result;
+    }
+
+    /**
+     * Transforms two op sequences made concurrently on the same text.
+     * Returns [aPrime, bPrime] such that apply(apply(s, a), bPrime)
+     * equals apply(apply(s, b), aPrime).
+     *
+     * @param {Object[]} a
+     * @param {Object[]} b
+     * @param {boolean} aWins - Tie-break for same-position inserts
+     * @returns {Array<Object[]>}
+     */
+    function transform(a, b, aWins) {
+        if (a.length === 0 || b.length === 0) return [a, b];
+
+        if (a.length === 1 && b.length === 1) {
+            return [transformOp(a[0], b[0], aWins), transformOp(b[0], a[0], !aWins)];
+        }
+        if (a.length > 1) {
+            const [headA, b1] = transform([a[0]], b, aWins);
+            const [restA, b2] = transform(a.slice(1), b1, aWins);
+            return [headA.concat(restA), b2];
+        }
+        const [a1, headB] = transform(a, [b[0]], aWins);
+        const [a2, restB] = transform(a1, b.slice(1), aWins);
+        return [a2, headB.concat(restB)];
+    }
+
+    return {
+        create,
+        isValid,
+        apply,
+        applyAll,
+        transformOp,
+        transform
+    };
+})();
+
+// Make TextOps globally available (browser)
+if (typeof window !== 'undefined') {
+    window.TextOps = TextOps;
+}
+
+// Export for Node.js (server)
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = TextOps;
+}
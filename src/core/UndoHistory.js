@@ -0,0 +1,209 @@
+/**
+ * UndoHistory - Edit-log undo/redo for a TextBuffer
+ *
+ * Instead of snapshotting the whole document, every buffer change is kept
+ * as { offset, removedText, insertedText }, which is enough to apply it
+ * backwards (undo) or forwards again (redo). A step costs memory in
+ * proportion to what it changed, so a remote update that touches one line
+ * costs one line, whatever the document size.
+ *
+ * Steps start at checkpoint(); every change until the next checkpoint
+ * belongs to the same step. History is capped by an estimated size in
+ * bytes: the oldest steps are dropped first.
+ *
+ * @module core/UndoHistory
+ */
+
+const UndoHistory = (function() {
+    'use strict';
+
+    const DEFAULT_MAX_BYTES = 16 * 1024 * 1024;
+    const CHANGE_OVERHEAD = 64;   // Rough per-change object cost
+    const STEP_OVERHEAD = 128;    // Rough per-step object cost (state, arrays)
+
+    class UndoHistory {
+        /**
+         * @param {TextBuffer} buffer - Document whose changes are recorded
+         * @param {Object} [options]
+         * @param {number} [options.maxBytes=16MB] - Memory budget for undo + redo
+         */
+        constructor(buffer, options = {}) {
+            this.buffer = buffer;
+            this.maxBytes = options.maxBytes || DEFAULT_MAX_BYTES;
+            this.undoSteps = [];
+            this.redoSteps = [];
+            this.bytes = 0;
+            this._applying = false; // True while undo/redo edits the buffer
+
+            this._unsubscribe = buffer.onChange(change => this._record(change));
+        }
+
+        get canUndo() {
+            return this.undoSteps.length > 0;
+        }
+
+        get canRedo() {
+            return this.redoSteps.length > 0;
+        }
+
+        /**
+         * Starts a new step. `state` (cursor, selection...) is handed back by
+         * undo() when this step is undone.
+         * @param {Object} state
+         */
+        checkpoint(state) {
+            const top = this.undoSteps[this.undoSteps.length - 1];
+            if (top && top.changes.length === 0) {
+                // Nothing happened since the last checkpoint: just move it
+                this.bytes -= top.bytes;
+                top.before = state;
+                top.bytes = UndoHistory._stateBytes(state);
+                this.bytes += top.bytes;
+                return;
+            }
+            this._clearRedo();
+            const step = { changes: [], before: state, after: null, bytes: UndoHistory._stateBytes(state) };
+            this.undoSteps.push(step);
+            this.bytes += step.bytes;
+            this._enforceBudget();
+        }
+
+        /**
+         * Reverts the latest step
+         * @param {Object} currentState - Restored by a later redo()
+         * @returns {{ state: Object, ops: Object[] }|null} State to restore and
+         *          the { offset, deleteCount, text } ops that were applied
+         */
+        undo(currentState) {
+            const step = this.undoSteps.pop();
+            if (!step) return null;
+
+            const ops = [];
+            for (let i = step.changes.length - 1; i >= 0; i--) {
+                const change = step.changes[i];
+                ops.push(this._apply(change.offset, change.insertedText.length, change.removedText));
+            }
+
+            this.bytes -= UndoHistory._stateBytes(step.after);
+            step.after = currentState;
+            this.bytes += UndoHistory._stateBytes(currentState);
+            this.redoSteps.push(step);
+            this._enforceBudget();
+            return { state: step.before, ops };
+        }
+
+        /**
+         * Re-applies the latest undone step
+         * @returns {{ state: Object, ops: Object[] }|null}
+         */
+        redo() {
+            const step = this.redoSteps.pop();
+            if (!step) return null;
+
+            const ops = [];
+            for (const change of step.changes) {
+                ops.push(this._apply(change.offset, change.removedText.length, change.insertedText));
+            }
+
+            const state = step.after;
+            this.bytes -= UndoHistory._stateBytes(state);
+            step.after = null;
+            this.undoSteps.push(step);
+            return { state, ops };
+        }
+
+        /**
+         * Forget everything (e.g. a new document was loaded)
+         */
+        clear() {
+            this.undoSteps = [];
+            this.redoSteps = [];
+            this.bytes = 0;
+        }
+
+        /**
+         * Detach from the buffer
+         */
+        dispose() {
+            if (this._unsubscribe) this._unsubscribe();
+        }
+
+        // ============================================
+        // INTERNALS
+        // ============================================
+
+        _apply(offset, deleteCount, text) {
+            this._applying = true;
+            try {
+                this.buffer.replace(offset, deleteCount, text);
+            } finally {
+                this._applying = false;
+            }
+            return { offset, deleteCount, text };
+        }
+
+        _record(change) {
+            if (this._applying) return;
+
+            // Redo steps no longer line up with the document
+            this._clearRedo();
+
+            // Changes before the first checkpoint cannot be undone
+            const step = this.undoSteps[this.undoSteps.length - 1];
+            if (!step) return;
+
+            const entry = {
+                offset: change.offset,
+                removedText: change.removedText,
+                insertedText: change.insertedText
+            };
+            const bytes = CHANGE_OVERHEAD + 2 * (entry.removedText.length + entry.insertedText.length);
+            step.changes.push(entry);
+            step.bytes += bytes;
+            this.bytes += bytes;
+            this._enforceBudget();
+        }
+
+        _clearRedo() {
+            for (const step of this.redoSteps) {
+                this.bytes -= step.bytes + UndoHistory._stateBytes(step.after);
+            }
+            this.redoSteps = [];
+        }
+
+        /**
+         * Drop the farthest redo steps, then the oldest undo steps, until the
+         * history fits. The most recent undo step is always kept.
+         */
+        _enforceBudget() {
+            while (this.bytes > this.maxBytes && this.redoSteps.length > 0) {
+                const step = this.redoSteps.shift();
+                this.bytes -= step.bytes + UndoHistory._stateBytes(step.after);
+            }
+            let dropped = 0;
+            while (this.bytes > this.maxBytes && this.undoSteps.length - dropped > 1) {
+                this.bytes -= this.undoSteps[dropped].bytes;
+                dropped++;
+            }
+            if (dropped > 0) this.undoSteps.splice(0, dropped);
+        }
+
+        static _stateBytes(state) {
+            if (!state) return 0;
+            const selection = state.selection ? state.selection.size || state.selection.length || 0 : 0;
+            return STEP_OVERHEAD + selection * 32;
+        }
+    }
+
+    return UndoHistory;
+})();
+
+// Make UndoHistory globally available (browser)
+if (typeof window !== 'undefined') {
+    window.UndoHistory = UndoHistory;
+}
+
+// Export for Node.js (tooling)
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = UndoHistory;
+}
@@ -32,16 +32,45 @@
     ];
 
     /**
-     * Escape HTML special characters
-     * @param {string} text - Text to escape
-     * @returns {string} Escaped text
+     * C++ literal values (colored before KEYWORDS, which also lists them)
      */
-    function escapeHtml(text) {
-        return text
-            .replace(/&/g, '&amp;')
-            .replace(/</g, '&lt;')
-            .replace(/>/g, '&gt;');
-    }
+    const VALUES = ['true', 'false', 'nullptr'];
+
+    /**
+     * Standard library names students use constantly
+     */
+    const BUILTINS = ['std', 'cout', 'cin', 'endl'];
+
+    /**
+     * Lexer specification compiled by LexerCompiler.
+     * Keyword groups are checked in order; the first match wins.
+     */
+    const LEXER_SPEC = {
+        name: 'cpp',
+        identStart: 'a-zA-Z_',
+        identPart: 'a-zA-Z0-9_',
+        numberStart: '0-9',
+        numberPart: '0-9.xXeEfFlLuU',
+        operators: '+*/%=<>!&|^~?:-',
+        lineComment: '//',
+        blockComment: ['/*', '*/'],
+        preprocessor: '#',
+        rawStrings: true,
+        strings: [
+            { quote: '"', escape: '\\' },
+            { quote: "'", escape: '\\' }
+        ],
+        keywordGroups: [
+            { className: 'syntax-logical', words: VALUES },
+            { className: 'syntax-type', words: TYPES },
+            { className: 'syntax-keyword', words: KEYWORDS },
+            { className: 'syntax-builtin', words: BUILTINS }
+        ],
+        // Bracket pairs (matching); braces also delimit scopes
+        structure: { brackets: '(){}[]', scopeBrackets: '{}' }
+    };
+
+    const lexer = LexerCompiler.compile(LEXER_SPEC);
 
     /**
      * Highlight C++ syntax
@@ -49,146 +78,16 @@
      * @returns {string} HTML with syntax highlighting
      */
     function highlightSyntax(code) {
-        if (!code) return '';
-        
-        const lines = code.split('\n');
-        let inBlockComment = false;
-        
-        const highlightedLines = lines.map(line => {
-            let result = '';
-            let i = 0;
-            
-            while (i < line.length) {
-                // Check if we're inside a block comment
-                if (inBlockComment) {
-                    const endIdx = line.indexOf('*/', i);
-                    if (endIdx !== -1) {
-                        result += `<span class="syntax-comment">${escapeHtml(line.substring(i, endIdx + 2))}</span>`;
-                        i = endIdx + 2;
-                        inBlockComment = false;
-                    } else {
-                        result += `<span class="syntax-comment">${escapeHtml(line.substring(i))}</span>`;
-                        break;
-                    }
-                    continue;
-                }
-                
-                // Check for block comment start /*
-                if (line.substring(i, i + 2) === '/*') {
-                    const endIdx = line.indexOf('*/', i + 2);
-                    if (endIdx !== -1) {
-                        result += `<span class="syntax-comment">${escapeHtml(line.substring(i, endIdx + 2))}</span>`;
-                        i = endIdx + 2;
-                    } else {
-                        result += `<span class="syntax-comment">${escapeHtml(line.substring(i))}</span>`;
-                        inBlockComment = true;
-                        break;
-                    }
-                    continue;
-                }
-                
-                // Check for single-line comment //
-                if (line.substring(i, i + 2) === '//') {
-                    result += `<span class="syntax-comment">${escapeHtml(line.substring(i))}</span>`;
-                    break;
-                }
-                
-                // Check for preprocessor directives #
-                if (line[i] === '#' && line.substring(0, i).trim() === '') {
-                    result += `<span class="syntax-preprocessor">${escapeHtml(line.substring(i))}</span>`;
-                    break;
-                }
-                
-                // Check for strings "..."
-                if (line[i] === '"') {
-                    let end = i + 1;
-                    while (end < line.length && (line[end] !== '"' || line[end - 1] === '\\')) {
-                        end++;
-                    }
-                    if (end < line.length) end++; // Include closing quote
-                    result += `<span class="syntax-string">${escapeHtml(line.substring(i, end))}</span>`;
-                    i = end;
-                    continue;
-                }
-                
-                // Check for character literals '...'
-                if (line[i] === "'") {
-                    let end = i + 1;
-                    while (end < line.length && (line[end] !== "'" || line[end - 1] === '\\')) {
-                        end++;
-                    }
-                    if (end < line.length) end++; // Include closing quote
-                    result += `<span class="syntax-string">${escapeHtml(line.substring(i, end))}</span>`;
-                    i = end;
-                    continue;
-                }
-                
-                // Check for numbers
-                if (/[0-9]/.test(line[i]) && (i === 0 || !/[a-zA-Z_]/.test(line[i - 1]))) {
-                    let end = i;
-                    // Match integers, floats, hex (0x), binary (0b)
-                    while (end < line.length && /[0-9a-fA-FxXbB.eEuUlLfF]/.test(line[end])) {
-                        end++;
-                    }
-                    result += `<span class="syntax-number">${escapeHtml(line.substring(i, end))}</span>`;
-                    i = end;
-                    continue;
-                }
-                
-                // Check for identifiers (keywords, types, variables)
-                if (/[a-zA-Z_]/.test(line[i])) {
-                    let end = i;
-                    while (end < line.length && /[a-zA-Z0-9_]/.test(line[end])) {
-                        end++;
-                    }
-                    const word = line.substring(i, end);
-                    
-                    if (KEYWORDS.includes(word)) {
-                        result += `<span class="syntax-keyword">${escapeHtml(word)}</span>`;
-                    } else if (TYPES.includes(word)) {
-                        result += `<span class="syntax-type">${escapeHtml(word)}</span>`;
-                    } else if (word === 'std' || word === 'cout' || word === 'cin' || word === 'endl') {
-                        result += `<span class="syntax-builtin">${escapeHtml(word)}</span>`;
-                    } else {
-                        result += escapeHtml(word);
-                    }
-                    i = end;
-                    continue;
-                }
-                
-                // Check for operators
-                if (['<', '>', '=', '+', '-', '*', '/', '%', '&', '|', '^', '!', '~', '?', ':'].includes(line[i])) {
-                    let opEnd = i + 1;
-                    // Check for multi-character operators
-                    const twoChar = line.substring(i, i + 2);
-                    const threeChar = line.substring(i, i + 3);
-                    if (['<<', '>>', '<=', '>=', '==', '!=', '&&', '||', '++', '--', '->', '::'].includes(twoChar)) {
-                        opEnd = i + 2;
-                    }
-                    if (['<<=', '>>='].includes(threeChar)) {
-                        opEnd = i + 3;
-                    }
-                    result += `<span class="syntax-operator">${escapeHtml(line.substring(i, opEnd))}</span>`;
-                    i = opEnd;
-                    continue;
-                }
-                
-                // Default: just add the character
-                result += escapeHtml(line[i]);
-                i++;
-            }
-            
-            return result;
-        });
-        
-        return highlightedLines.join('\n');
+        return lexer.highlightHtml(code);
     }
 
     // Register to namespace
     window.Languages.Cpp.syntax = {
         highlight: highlightSyntax,  // LanguageManager expects 'highlight'
         highlightSyntax,             // Keep for backward compatibility
-        escapeHtml,
+        escapeHtml: LexerCompiler.escapeHtml,
+        lexer,                       // Shared with SyntaxHighlighter (GridEditor)
+        LEXER_SPEC,
         KEYWORDS,
         TYPES
     };
@@ -39,16 +39,34 @@
     ];
 
     /**
-     * Escape HTML special characters
-     * @param {string} text - Text to escape
-     * @returns {string} - Escaped text
+     * Lexer specification compiled by LexerCompiler.
+     * Keyword groups are checked in order; the first match wins.
      */
-    function escapeHtml(text) {
-        return text
-            .replace(/&/g, '&amp;')
-            .replace(/</g, '&lt;')
-            .replace(/>/g, '&gt;');
-    }
+    const LEXER_SPEC = {
+        name: 'python',
+        identStart: 'a-zA-Z_',
+        identPart: 'a-zA-Z0-9_',
+        numberStart: '0-9',
+        numberPart: '0-9.eE+-',
+        operators: '+*/%=<>!&|^~-',
+        lineComment: '#',
+        decorator: '@',
+        multilineStrings: ['"""', "'''"],
+        strings: [
+            { quote: '"', escape: '\\' },
+            { quote: "'", escape: '\\' }
+        ],
+        keywordGroups: [
+            { className: 'syntax-logical', words: ['True', 'False', 'None'] },
+            { className: 'syntax-self', words: ['self'] },
+            { className: 'syntax-keyword', words: getKeywords() },
+            { className: 'syntax-builtin', words: BUILTINS }
+        ],
+        // Bracket pairs (matching); scopes are indentation-based
+        structure: { brackets: '()[]{}' }
+    };
+
+    const lexer = LexerCompiler.compile(LEXER_SPEC);
 
     /**
      * Highlight Python syntax
@@ -56,82 +74,15 @@
      * @returns {string} - HTML with syntax highlighting spans
      */
     function highlightSyntax(code) {
-        if (!code) return '';
-
-        // Escape HTML first
-        let escaped = escapeHtml(code);
-        
-        // Track positions to avoid double-highlighting
-        let highlighted = escaped;
-
-        // 1. Highlight comments (# to end of line)
-        highlighted = highlighted.replace(
-            /(#[^\n]*)/g,
-            '<span class="syntax-comment">$1</span>'
-        );
-
-        // 2. Highlight triple-quoted strings (docstrings)
-        highlighted = highlighted.replace(
-            /("""[\s\S]*?"""|'''[\s\S]*?''')/g,
-            '<span class="syntax-string">$1</span>'
-        );
-
-        // 3. Highlight f-strings
-        highlighted = highlighted.replace(
-            /\b(f)(["'])((?:(?!\2)[^\\]|\\.)*)(\2)/g,
-            '<span class="syntax-keyword">$1</span><span class="syntax-string">$2$3$4</span>'
-        );
-
-        // 4. Highlight regular strings (single and double quotes)
-        highlighted = highlighted.replace(
-            /(?<!<span class="syntax-[^"]*)(["'])((?:(?!\1)[^\\]|\\.)*)(\1)/g,
-            '<span class="syntax-string">$1$2$3</span>'
-        );
-
-        // 5. Highlight decorators (@something)
-        highlighted = highlighted.replace(
-            /(@\w+)/g,
-            '<span class="syntax-decorator">$1</span>'
-        );
-
-        // 6. Highlight numbers (integers and floats)
-        highlighted = highlighted.replace(
-            /\b(\d+\.?\d*)\b/g,
-            '<span class="syntax-number">$1</span>'
-        );
-
-        // 7. Highlight 'self' as special variable
-        highlighted = highlighted.replace(
-            /\b(self)\b/g,
-            '<span class="syntax-self">$1</span>'
-        );
-
-        // 8. Highlight keywords
-        const KEYWORDS = getKeywords();
-        KEYWORDS.forEach(keyword => {
-            const regex = new RegExp(`\\b(${keyword})\\b`, 'g');
-            highlighted = highlighted.replace(
-                regex,
-                '<span class="syntax-keyword">$1</span>'
-            );
-        });
-
-        // 9. Highlight built-in functions
-        BUILTINS.forEach(builtin => {
-            const regex = new RegExp(`\\b(${builtin})(?=\\s*\\()`, 'g');
-            highlighted = highlighted.replace(
-                regex,
-                '<span class="syntax-builtin">$1</span>'
-            );
-        });
-
-        return highlighted;
+        return lexer.highlightHtml(code);
     }
 
     // Register to namespace
     window.Languages.Python.syntax = {
         highlight: highlightSyntax,  // LanguageManager expects 'highlight'
         highlightSyntax,             // Keep for backward compatibility
+        lexer,                       // Shared with SyntaxHighlighter (GridEditor)
+        LEXER_SPEC,
         
         /**
          * Get CSS classes used by this highlighter
@@ -145,7 +96,9 @@
                 'syntax-number': 'Numeric literals',
                 'syntax-decorator': 'Decorators (@)',
                 'syntax-self': 'Self reference',
-                'syntax-builtin': 'Built-in functions'
+                'syntax-builtin': 'Built-in functions',
+                'syntax-logical': 'True, False, None',
+                'syntax-operator': 'Operators'
             };
         }
     };
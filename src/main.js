@@ -48,36 +48,30 @@ const state = {
  * Uses SmartInserter module for position calculations
  */
 function smartInsertKeyword(keyword, smartType) {
-    const code = gridEditor ? gridEditor.getValue() : elements.codeEditor.value;
-    
-    let cursorPos;
-    if (gridEditor) {
-        const cursor = gridEditor.getCursor();
-        cursorPos = SmartInserter.rowColToLinear(code, cursor.row, cursor.col);
-    } else {
-        cursorPos = state.savedCursorPos;
-    }
-    
     const snippets = typeof LanguageManager !== 'undefined' ? LanguageManager.getSnippets() : null;
     const SMART_INSERTION = snippets?.SMART_INSERTION || window.SMART_INSERTION || {};
     const rule = smartType ? SMART_INSERTION[smartType] : null;
-    
-    const result = SmartInserter.calculateInsertion(code, cursorPos, keyword, rule, {
-        promptFn: (message, defaultValue) => prompt(message, defaultValue)
-    });
-    
-    if (result.cancelled) {
-        if (gridEditor) gridEditor.focus();
-        else elements.codeEditor.focus();
-        return;
-    }
+    const promptFn = (message, defaultValue) => prompt(message, defaultValue);
     
     if (gridEditor) {
-        gridEditor.setValue(result.newCode);
-        const pos = SmartInserter.linearToRowCol(result.newCode, result.newCursorPos);
-        gridEditor.setCursor(pos.row, pos.col);
+        // Works on the editor's line-indexed buffer: no full-text copies
+        const edit = SmartInserter.calculateEdit(gridEditor.getBuffer(), gridEditor.getCursor(), keyword, rule, {
+            promptFn,
+            blockIndex: gridEditor.getBlockIndex()
+        });
+        if (edit.cancelled) {
+            gridEditor.focus();
+            return;
+        }
+        gridEditor.insertAt(edit.offset, edit.text, edit.cursorOffset);
         gridEditor.focus();
     } else {
+        const code = elements.codeEditor.value;
+        const result = SmartInserter.calculateInsertion(code, state.savedCursorPos, keyword, rule, { promptFn });
+        if (result.cancelled) {
+            elements.codeEditor.focus();
+            return;
+        }
         elements.codeEditor.value = result.newCode;
         elements.codeEditor.selectionStart = elements.codeEditor.selectionEnd = result.newCursorPos;
         updateEditor();
@@ -233,11 +227,15 @@ function loadTemplate() {
         return;
     }
     
+    // Teacher: opens in a new tab (Collaboration.openDocument puts it in the editor)
+    const templateName = elements.templateSelect.options[elements.templateSelect.selectedIndex].text;
+    const openedAsTab = typeof Collaboration !== 'undefined' && Collaboration.openDocument(template, templateName);
+    
     if (gridEditor) gridEditor.setValue(template);
     else { elements.codeEditor.value = template; updateEditor(); }
     
-    if (typeof Collaboration !== 'undefined' && Collaboration.connected) {
-        Collaboration.sendTemplateLoaded(template, elements.templateSelect.options[elements.templateSelect.selectedIndex].text);
+    if (!openedAsTab && typeof Collaboration !== 'undefined' && Collaboration.connected) {
+        Collaboration.sendTemplateLoaded(template, templateName);
     }
     
     showToast(`📁 Φορτώθηκε: ${elements.templateSelect.options[elements.templateSelect.selectedIndex].text}`, 'success');
@@ -261,10 +259,12 @@ function loadExercise() {
         return;
     }
     
+    const openedAsTab = typeof Collaboration !== 'undefined' && Collaboration.openDocument(exercise.code, `🎯 ${exercise.name}`);
+    
     if (gridEditor) gridEditor.setValue(exercise.code);
     else { elements.codeEditor.value = exercise.code; updateEditor(); }
     
-    if (typeof Collaboration !== 'undefined' && Collaboration.connected) {
+    if (!openedAsTab && typeof Collaboration !== 'undefined' && Collaboration.connected) {
         Collaboration.sendTemplateLoaded(exercise.code, `🎯 ${exercise.name}`);
     }
     
@@ -284,10 +284,12 @@ function loadAlgorithm() {
     const result = content?.algorithms?.get(algorithmId);
     
     if (result?.code) {
+        const openedAsTab = typeof Collaboration !== 'undefined' && Collaboration.openDocument(result.code, result.name);
+        
         if (gridEditor) gridEditor.setValue(result.code);
         else { elements.codeEditor.value = result.code; updateEditor(); }
         
-        if (typeof Collaboration !== 'undefined' && Collaboration.connected) {
+        if (!openedAsTab && typeof Collaboration !== 'undefined' && Collaboration.connected) {
             Collaboration.sendTemplateLoaded(result.code, result.name);
         }
         showToast(`📖 Αλγόριθμος: ${result.name}`, 'success');
@@ -374,9 +376,15 @@ function init() {
         const SYNC_DEBOUNCE_MS = 150;
         
         // Set up GridEditor callbacks for collaboration
-        gridEditor.onContentChange = (code) => {
-            // Update line numbers immediately (UI feedback)
-            StatusBar.updateLineNumbers();
+        // Every local edit is queued as a small range op (see core/TextOps.js)
+        gridEditor.onEdit = (op) => {
+            if (typeof Collaboration !== 'undefined') {
+                Collaboration.queueLocalOp(op);
+            }
+        };
+        
+        gridEditor.onContentChange = () => {
+            // Line numbers follow render() through gridEditor.onGutterChange
             
             // Debounce collaboration sync to reduce WebSocket flooding
             if (typeof Collaboration !== 'undefined' && Collaboration.connected && !Collaboration.isUpdatingFromRemote) {
@@ -384,7 +392,7 @@ function init() {
                     clearTimeout(syncDebounceTimer);
                 }
                 syncDebounceTimer = setTimeout(() => {
-                    Collaboration.sendCodeUpdate(code);
+                    Collaboration.flushLocalOps();
                     syncDebounceTimer = null;
                 }, SYNC_DEBOUNCE_MS);
             }
@@ -426,6 +434,17 @@ function init() {
             }
         };
         
+        gridEditor.onScopeChange = (range) => {
+            if (typeof Collaboration !== 'undefined' && Collaboration.connected && Collaboration.myRole === 'teacher') {
+                Collaboration.sendScope(range);
+            }
+        };
+        
+        // Snippet suggestions expand like their sidebar button
+        gridEditor.onCompletionAccept = (item) => {
+            smartInsertKeyword(item.insert, item.smart);
+        };
+        
         gridEditor.onScrollToLine = (lineNumber) => {
             if (typeof Collaboration !== 'undefined' && Collaboration.connected && Collaboration.myRole === 'teacher') {
                 Collaboration.sendScrollToLine(lineNumber);
@@ -502,6 +521,7 @@ function init() {
                     console.log(`📂 Loaded local file: ${filename}`);
                     
                     // Trigger collaboration sync if connected
+                    // (full update: supersedes the edit queued by setValue)
                     if (typeof Collaboration !== 'undefined' && Collaboration.connected) {
                         Collaboration.sendCodeUpdate(content);
                     }
@@ -510,6 +530,26 @@ function init() {
         });
     }
     
+    // 6.7 Initialize WorkspaceOverview (Teacher only - student workspaces)
+    if (typeof WorkspaceOverview !== 'undefined') {
+        WorkspaceOverview.init();
+    }
+    
+    // 6.8 Initialize RecordingsPanel (Teacher only - lesson recording)
+    if (isTeacher && typeof RecordingsPanel !== 'undefined') {
+        RecordingsPanel.init();
+    }
+    
+    // 6.9 Initialize RunPanel (C++ compile & run)
+    if (typeof RunPanel !== 'undefined') {
+        RunPanel.init();
+    }
+    
+    // 6.10 Initialize ComplexityPanel (benchmark plot, all boards)
+    if (typeof ComplexityPanel !== 'undefined') {
+        ComplexityPanel.init();
+    }
+    
     // 7. Initialize LanguageManager and language-dependent UI
     if (typeof LanguageManager !== 'undefined') {
         LanguageManager.setLanguage('glossa').then(() => {
@@ -47,6 +47,8 @@ const Collaboration = {
     
     // Teacher tools state
     remoteCursors: {},  // Store cursor positions of other users
+    _visualCursors: null, // RemoteCursorLayer over the legacy textarea (created on first use)
+    _studentList: null, // VirtualList of the teacher's student panel
     cursorUpdateInterval: null,
     highlightSyncEnabled: true, // Sync text selection/highlight
     
@@ -62,6 +64,26 @@ const Collaboration = {
     // Flag to indicate content was loaded from server (prevents init() from overwriting)
     contentLoadedFromServer: false,
     
+    // Delta code sync (see core/TextOps.js)
+    docVersion: 0,          // Last server code version we are in sync with
+    _inflightOps: null,     // Ops sent and awaiting code_ack
+    _pendingOps: [],        // Local ops not yet sent
+    _fullUpdatesInFlight: 0, // Full code_update/template_loaded awaiting ack
+    _resyncRequested: false,
+    _repairDigest: null,     // code_digest our copy failed, while its blocks are on the way
+    _afterSync: [],          // Requests (run, benchmark) waiting for our queued edits to be sent
+    
+    // Workspace mode: private per-student documents (see server/WorkspaceManager.js)
+    workspaceMode: false,
+    activeWorkspace: null,  // Student id of the document the editor is synced to (null = the board)
+    
+    // Board documents (tabs): only the active one is synced live (see server/SessionDocuments.js)
+    documents: [],            // [{ id, name, version }] - metadata only
+    activeDocId: null,        // Tab the board is on
+    _docCache: new Map(),     // docId -> { code, version } of tabs not on screen
+    _fetchingDocId: null,     // Tab whose text is on its way (doc_fetch)
+    _creatingDocument: false, // doc_create sent, its id not known yet
+    
     // Throttled functions (initialized in init)
     _throttledSendCursor: null,
     _throttledSendLaser: null,
@@ -103,6 +125,13 @@ const Collaboration = {
         const urlParams = new URLSearchParams(window.location.search);
         const role = urlParams.get('role') || 'student';
         
+        // Replay of a recorded lesson: no connection, recorded messages instead
+        if (urlParams.get('replay') && typeof ReplayPlayer !== 'undefined') {
+            this.myRole = 'student';
+            ReplayPlayer.start(urlParams.get('replay'));
+            return;
+        }
+        
         // Check if teacher password is required
         if (role === 'teacher') {
             this._checkAndPromptPassword(role);
@@ -461,6 +490,18 @@ const Collaboration = {
                 this.myId = message.yourId;
                 this.myRole = message.yourRole;
                 this.connectedUsers = message.connectedUsers;
+                this.workspaceMode = !!(message.state && message.state.workspaceMode);
+                this.activeWorkspace = (message.state && message.state.workspace) || null;
+                this.documents = (message.state && message.state.documents) || [];
+                this.activeDocId = (message.state && message.state.activeDoc) || null;
+                this._docCache.clear();
+                this._fetchingDocId = null;
+                this._creatingDocument = false;
+                this._resetCodeSync(message.state ? message.state.version : 0);
+                this._renderDocumentTabs();
+                if (typeof WorkspaceOverview !== 'undefined') {
+                    WorkspaceOverview.setMode(this.workspaceMode);
+                }
                 
                 // Hide lobby if it was showing
                 if (typeof LobbyManager !== 'undefined') {
@@ -534,8 +575,10 @@ const Collaboration = {
                 break;
                 
             case 'code_update':
-                // Another user changed the code
+                // Another user replaced the code (full text)
+                if (!this._isActiveDocument(message)) break;
                 if (!this.isUpdatingFromRemote) {
+                    this._resetCodeSync(message.version);
                     this.updateEditorContent(message.code);
                     // Update line numbers
                     if (typeof StatusBar !== 'undefined' && StatusBar.updateLineNumbers) {
@@ -554,7 +597,49 @@ const Collaboration = {
                 }
                 break;
                 
+            case 'code_ops':
+                // Another user edited the code (ranges only)
+                if (!this._isActiveDocument(message)) break;
+                this._handleRemoteOps(message);
+                break;
+                
+            case 'code_ack':
+                if (!this._isActiveDocument(message)) break;
+                this._handleCodeAck(message);
+                break;
+                
+            case 'code_resync':
+                // Server could not merge our edits - take its copy as the truth
+                if (!this._isActiveDocument(message)) break;
+                console.log(`🔁 Code resync (version ${message.version})`);
+                this._resetCodeSync(message.version);
+                this.updateEditorContent(message.code, false);
+                if (typeof StatusBar !== 'undefined' && StatusBar.updateLineNumbers) {
+                    StatusBar.updateLineNumbers();
+                }
+                break;
+                
+            case 'code_digest':
+                // Block hashes of the server's copy: repair ours if it drifted
+                if (!this._isActiveDocument(message)) break;
+                this._checkDigest(message);
+                break;
+                
+            case 'code_diagnostics':
+                // Compiler errors/warnings of the document we're on (C++)
+                if (!this._isActiveDocument(message)) break;
+                this._handleDiagnostics(message);
+                break;
+                
+            case 'code_repair':
+                // The blocks our copy got wrong
+                if (!this._isActiveDocument(message)) break;
+                this._handleCodeRepair(message);
+                break;
+                
             case 'template_loaded':
+                if (!this._isActiveDocument(message)) break;
+                this._resetCodeSync(message.version);
                 this.updateEditorContent(message.code);
                 // Update line numbers
                 if (typeof StatusBar !== 'undefined' && StatusBar.updateLineNumbers) {
@@ -563,6 +648,94 @@ const Collaboration = {
                 showToast(`📁 ${message.loadedBy} loaded: ${message.templateName}`, 'info');
                 break;
                 
+            case 'workspace_mode':
+                // Teacher turned private workspaces on/off
+                this._handleWorkspaceMode(message);
+                break;
+                
+            case 'run_status':
+                // Our C++ run: queued / compiling / running
+                if (typeof RunPanel !== 'undefined') RunPanel.handleStatus(message);
+                break;
+                
+            case 'run_output':
+                if (typeof RunPanel !== 'undefined') RunPanel.handleOutput(message);
+                break;
+                
+            case 'run_exit':
+                if (typeof RunPanel !== 'undefined') RunPanel.handleExit(message);
+                break;
+                
+            case 'bench_state':
+            case 'bench_series':
+            case 'bench_point':
+            case 'bench_done':
+            case 'bench_clear':
+            case 'bench_error':
+                // Complexity lab results (every board)
+                if (typeof ComplexityPanel !== 'undefined') {
+                    ComplexityPanel.handleMessage(message);
+                }
+                break;
+                
+            case 'recording_state':
+                // Lesson recording started/stopped (teachers)
+                if (typeof RecordingsPanel !== 'undefined') {
+                    RecordingsPanel.setState(message);
+                }
+                break;
+                
+            case 'workspace_summaries':
+                // Low-rate excerpts of every workspace (teacher overview)
+                if (this.myRole === 'teacher' && typeof WorkspaceOverview !== 'undefined') {
+                    WorkspaceOverview.updateSummaries(message.summaries);
+                }
+                break;
+                
+            case 'grade_results':
+                // Auto-grader summary of the class (teachers)
+                if (this.myRole === 'teacher' && typeof WorkspaceOverview !== 'undefined') {
+                    WorkspaceOverview.showGrades(message);
+                }
+                break;
+                
+            case 'workspace_snapshot':
+                // Full document of the workspace we opened (or of the board, when going back)
+                if (this.myRole === 'teacher') {
+                    this._switchDocument(message.workspace, message.code, message.version, message.doc);
+                    if (message.workspace) {
+                        showToast(`👀 ${message.name}`, 'info');
+                    }
+                }
+                break;
+                
+            case 'docs_list':
+                // Tabs opened/closed (metadata only)
+                this._handleDocsList(message);
+                break;
+                
+            case 'doc_activate':
+                // Teacher switched tabs: show it from the cache, or fetch it
+                this._enterBoardDocument(message.docId, message.version);
+                break;
+                
+            case 'doc_created':
+                // Our doc_create got its id
+                this._handleDocCreated(message);
+                break;
+                
+            case 'doc_content':
+                // Reply to doc_fetch: full text, or the ops since our cached version
+                this._handleDocContent(message);
+                break;
+                
+            case 'workspace_closed':
+                // The workspace we asked for is gone (mode turned off meanwhile)
+                if (this.myRole === 'teacher' && message.workspace === this.activeWorkspace) {
+                    this.closeWorkspace();
+                }
+                break;
+                
             case 'user_joined':
                 this.connectedUsers = message.connectedUsers;
                 this.updateUserList();
@@ -572,6 +745,7 @@ const Collaboration = {
             case 'user_left':
                 this.connectedUsers = message.connectedUsers;
                 this.updateUserList();
+                this.hideRemoteCursor(message.userId);
                 showToast(`👋 ${message.userName} disconnected`, 'info');
                 break;
                 
@@ -679,6 +853,11 @@ const Collaboration = {
                 this.handleBreakpoints(message);
                 break;
             
+            case 'scope':
+                // Teacher's current block (students receive)
+                this.handleScope(message);
+                break;
+            
             case 'scroll_to_line':
                 // Teacher sent scroll-to-line command (students receive)
                 this.handleScrollToLine(message);
@@ -895,11 +1074,19 @@ const Collaboration = {
      */
     handleBreakpoints(message) {
         if (typeof gridEditor !== 'undefined' && gridEditor) {
-            gridEditor.setRemoteBreakpoints(message.rows || []);
-            // Trigger line number update
-            if (typeof updateLineNumbers === 'function') {
-                updateLineNumbers();
-            }
+            gridEditor.setRemoteBreakpoints(message.rows || []); // Repaints the gutter
+        }
+    },
+    
+    /**
+     * Handle the teacher's current scope (block around their cursor)
+     */
+    handleScope(message) {
+        if (typeof gridEditor !== 'undefined' && gridEditor) {
+            const range = message.startRow !== null && message.startRow !== undefined
+                ? { startRow: message.startRow, endRow: message.endRow }
+                : null;
+            gridEditor.setRemoteScope(range);
         }
     },
     
@@ -931,6 +1118,20 @@ const Collaboration = {
         }
     },
     
+    /**
+     * Send the block around the cursor to students (teacher)
+     * @param {{startRow: number, endRow: number}|null} range - 0-indexed rows, null to clear
+     */
+    sendScope(range) {
+        if (this.connected && this.ws.readyState === WebSocket.OPEN && this.myRole === 'teacher') {
+            this._send(JSON.stringify({
+                type: 'scope',
+                startRow: range ? range.startRow : null,
+                endRow: range ? range.endRow : null
+            }));
+        }
+    },
+    
     /**
      * Send scroll-to-line command to students (teacher)
      * @param {number} lineNumber - 1-indexed line number
@@ -945,20 +1146,34 @@ const Collaboration = {
     },
     
     /**
-     * Send code change to server
+     * Get the local cursor as 1-based row/col (for remote cursor display)
+     */
+    _getCursorForSync() {
+        let cursorRow = 1, cursorCol = 1;
+        if (typeof gridEditor !== 'undefined' && gridEditor) {
+            const cursor = gridEditor.getCursor();
+            cursorRow = cursor.row + 1; // Convert to 1-based
+            cursorCol = cursor.col + 1;
+        }
+        return { cursorRow, cursorCol };
+    },
+    
+    /**
+     * Send the full code to server.
+     * Used when the whole document is replaced; normal typing goes through
+     * queueLocalOp()/flushLocalOps() and only sends the changed ranges.
      */
     sendCodeUpdate(code) {
         if (this.connected && this.ws.readyState === WebSocket.OPEN) {
-            // Include cursor position for remote cursor display
-            let cursorRow = 1, cursorCol = 1;
-            if (typeof gridEditor !== 'undefined' && gridEditor) {
-                const cursor = gridEditor.getCursor();
-                cursorRow = cursor.row + 1; // Convert to 1-based
-                cursorCol = cursor.col + 1;
-            }
+            // The full text already contains any queued edits
+            this._pendingOps = [];
+            this._fullUpdatesInFlight++;
             
+            const { cursorRow, cursorCol } = this._getCursorForSync();
             this._send(JSON.stringify({
                 type: 'code_update',
+                workspace: this.activeWorkspace,
+                doc: this.activeDocId,
                 code: code,
                 cursorRow: cursorRow,
                 cursorCol: cursorCol
@@ -966,19 +1181,566 @@ const Collaboration = {
         }
     },
     
+    /**
+     * Queue a local edit for the next flush
+     * @param {Object} op - { offset, deleteCount, text }
+     */
+    queueLocalOp(op) {
+        if (!this.connected || this.isUpdatingFromRemote) return;
+        this._pendingOps.push(op);
+    },
+    
+    /**
+     * Send queued edits to server.
+     * Only one batch is in flight at a time; the rest waits for code_ack
+     * so every batch is based on a version the server knows.
+     */
+    flushLocalOps() {
+        if (!this.connected || this.ws.readyState !== WebSocket.OPEN) return;
+        if (this._inflightOps || this._fullUpdatesInFlight > 0 || this._pendingOps.length === 0) return;
+        // No document to send to yet (tab being fetched or created)
+        if (this._fetchingDocId || this._creatingDocument) return;
+        
+        this._inflightOps = this._pendingOps;
+        this._pendingOps = [];
+        
+        const { cursorRow, cursorCol } = this._getCursorForSync();
+        this._send(JSON.stringify({
+            type: 'code_ops',
+            workspace: this.activeWorkspace,
+            doc: this.activeDocId,
+            baseVersion: this.docVersion,
+            ops: this._inflightOps,
+            cursorRow: cursorRow,
+            cursorCol: cursorCol
+        }));
+    },
+    
+    /**
+     * Forget unsent edits and adopt a server version (after a full replace)
+     * @param {number} version
+     */
+    _resetCodeSync(version) {
+        this.docVersion = version || 0;
+        this._inflightOps = null;
+        this._pendingOps = [];
+        this._fullUpdatesInFlight = 0;
+        this._resyncRequested = false;
+        this._repairDigest = null;
+    },
+    
+    /**
+     * Server accepted our last code_ops batch or full update
+     */
+    _handleCodeAck(message) {
+        if (message.ackFor === 'full') {
+            this._fullUpdatesInFlight = Math.max(0, this._fullUpdatesInFlight - 1);
+        } else {
+            this._inflightOps = null;
+        }
+        this.docVersion = message.version;
+        this.flushLocalOps();
+        if (this._afterSync.length > 0 && this._pendingOps.length === 0) {
+            this._afterSync.splice(0).forEach(request => request());
+        }
+    },
+    
+    /**
+     * Show the server's syntax check, if it is of the text we have
+     * (after more edits a newer check is on its way)
+     */
+    _handleDiagnostics(message) {
+        if (message.version !== this.docVersion || this._inflightOps ||
+            this._pendingOps.length > 0 || this._fullUpdatesInFlight > 0) return;
+        if (typeof LanguageManager !== 'undefined' && LanguageManager.getCurrentLanguage() !== 'cpp') return;
+        if (typeof gridEditor !== 'undefined' && gridEditor) {
+            gridEditor.setDiagnostics(message.diagnostics || []);
+        }
+    },
+    
+    /**
+     * Apply another user's code_ops, rebased over our own unacknowledged edits
+     */
+    _handleRemoteOps(message) {
+        // Our full update reaches the server after this edit and replaces it there too
+        if (this._fullUpdatesInFlight > 0) return;
+        
+        if (message.version !== this.docVersion + 1 || typeof TextOps === 'undefined') {
+            // Missed a version - ask for the full text instead of guessing
+            this._requestResync();
+            return;
+        }
+        
+        let ops = message.ops;
+        if (this._inflightOps) {
+            [this._inflightOps, ops] = TextOps.transform(this._inflightOps, ops, false);
+        }
+        if (this._pendingOps.length > 0) {
+            [this._pendingOps, ops] = TextOps.transform(this._pendingOps, ops, false);
+        }
+        this.docVersion = message.version;
+        
+        this.isUpdatingFromRemote = true;
+        if (typeof gridEditor !== 'undefined' && gridEditor) {
+            gridEditor.applyRemoteOps(ops);
+        } else {
+            const editor = document.getElementById('code-editor');
+            if (editor) {
+                editor.value = TextOps.applyAll(editor.value, ops);
+                if (typeof updateEditor === 'function') {
+                    updateEditor();
+                }
+            }
+        }
+        this.isUpdatingFromRemote = false;
+        
+        if (typeof StatusBar !== 'undefined' && StatusBar.updateLineNumbers) {
+            StatusBar.updateLineNumbers();
+        }
+        if (message.cursorRow !== undefined && message.cursorCol !== undefined) {
+            this.showRemoteCursor({
+                userId: message.userId,
+                line: message.cursorRow,
+                column: message.cursorCol
+            });
+        }
+        this.showRemoteEdit(message.updaterName);
+    },
+    
+    /**
+     * Ask the server for the full text of the current document (once)
+     */
+    _requestResync() {
+        if (this._resyncRequested) return;
+        this._resyncRequested = true;
+        this._send(JSON.stringify({ type: 'code_resync_request', workspace: this.activeWorkspace, doc: this.activeDocId }));
+    },
+    
+    /**
+     * @returns {boolean} true while local edits are not acknowledged yet
+     */
+    _hasUnsyncedEdits() {
+        return !!this._inflightOps || this._pendingOps.length > 0 || this._fullUpdatesInFlight > 0;
+    },
+    
+    /**
+     * Current editor text
+     * @returns {string|null}
+     */
+    _getEditorCode() {
+        if (typeof gridEditor !== 'undefined' && gridEditor) {
+            return gridEditor.getValue();
+        }
+        const editor = document.getElementById('code-editor');
+        return editor ? editor.value : null;
+    },
+    
     /**
      * Send template loaded notification
      */
     sendTemplateLoaded(code, templateName) {
         if (this.connected && this.ws.readyState === WebSocket.OPEN) {
+            this._pendingOps = [];
+            this._fullUpdatesInFlight++;
             this._send(JSON.stringify({
                 type: 'template_loaded',
+                workspace: this.activeWorkspace,
+                doc: this.activeDocId,
                 code: code,
                 templateName: templateName
             }));
         }
     },
     
+    // ============================================
+    // ANTI-ENTROPY (see core/LineDigest.js)
+    // ============================================
+    
+    /**
+     * Compare our copy with the server's block hashes.
+     * Only a copy at the digest's version without unacknowledged edits is
+     * comparable; anything else waits for the next digest.
+     */
+    _checkDigest(digest) {
+        this._repairDigest = null;
+        if (typeof LineDigest === 'undefined' || !LineDigest.isValid(digest)) return;
+        if (digest.version !== this.docVersion || this._hasUnsyncedEdits()) return;
+        
+        const code = this._getEditorCode();
+        if (code === null) return;
+        const differing = LineDigest.diff(code, digest);
+        if (differing.length === 0) return;
+        
+        console.warn(`🧩 Copy differs from the server in ${differing.length}/${digest.blocks.length} block(s) - repairing`);
+        // Mostly different (e.g. lines shifted): the full text is cheaper
+        if (differing.length * 2 > digest.blocks.length) {
+            this._requestResync();
+            return;
+        }
+        this._repairDigest = digest;
+        this._send(JSON.stringify({
+            type: 'code_repair_request',
+            workspace: this.activeWorkspace,
+            doc: this.activeDocId,
+            version: digest.version,
+            blocks: differing
+        }));
+    },
+    
+    /**
+     * Patch the fetched blocks into our copy
+     */
+    _handleCodeRepair(message) {
+        const digest = this._repairDigest;
+        this._repairDigest = null;
+        if (!digest || message.version !== digest.version) return;
+        if (message.version !== this.docVersion || this._hasUnsyncedEdits()) return;
+        
+        const code = this._getEditorCode();
+        const repaired = code === null ? null : LineDigest.patch(code, digest, message.blocks || {});
+        if (repaired === null) {
+            this._requestResync();
+            return;
+        }
+        this.updateEditorContent(repaired, false);
+        if (typeof StatusBar !== 'undefined' && StatusBar.updateLineNumbers) {
+            StatusBar.updateLineNumbers();
+        }
+    },
+    
+    // ============================================
+    // RUNNING C++ (see server/CppRunner.js)
+    // ============================================
+    
+    /**
+     * Compile & run the document the editor is on
+     */
+    startRun() {
+        this._sendWhenSynced(() => ({ type: 'run_start', workspace: this.activeWorkspace, doc: this.activeDocId }));
+    },
+    
+    /**
+     * The server works on its own copy of the document, so queued edits
+     * are sent first (messages arrive in order; the request waits for the
+     * in-flight batch). Repeated requests of one type are sent once.
+     * @param {Function} build - () => message, built when it is sent
+     */
+    _sendWhenSynced(build) {
+        this.flushLocalOps();
+        const request = () => this._send(JSON.stringify(build()));
+        if (this._pendingOps.length === 0) {
+            request();
+            return;
+        }
+        request.kind = build().type;
+        this._afterSync = this._afterSync.filter(queued => queued.kind !== request.kind);
+        this._afterSync.push(request);
+    },
+    
+    /**
+     * @param {string} runId
+     * @param {string} data - Text for the program's stdin
+     */
+    sendRunInput(runId, data) {
+        this._send(JSON.stringify({ type: 'run_input', runId, data }));
+    },
+    
+    sendRunEof(runId) {
+        this._send(JSON.stringify({ type: 'run_eof', runId }));
+    },
+    
+    stopRun(runId) {
+        this._send(JSON.stringify({ type: 'run_stop', runId }));
+    },
+    
+    // ============================================
+    // COMPLEXITY LAB (see server/ComplexityLab.js)
+    // ============================================
+    
+    /**
+     * Measure how the functions of the document scale (teacher)
+     * @param {string} [baseline] - Built-in reference series instead, e.g. 'std::sort'
+     */
+    startBenchmark(baseline) {
+        if (!this.connected || this.myRole !== 'teacher') return;
+        this._sendWhenSynced(() => ({
+            type: 'bench_start',
+            workspace: this.activeWorkspace,
+            doc: this.activeDocId,
+            baseline: baseline || null
+        }));
+    },
+    
+    clearBenchmarks() {
+        if (this.connected && this.myRole === 'teacher') {
+            this._send(JSON.stringify({ type: 'bench_clear' }));
+        }
+    },
+    
+    // ============================================
+    // WORKSPACES (private per-student documents)
+    // ============================================
+    
+    /**
+     * Code messages carry the document they belong to; drop the ones for
+     * a document the editor is not showing (e.g. a late ack after a switch)
+     */
+    _isActiveDocument(message) {
+        if ((message.workspace || null) !== this.activeWorkspace) return false;
+        if (message.workspace) return true;
+        // Board: the tab we are on, once its text is here
+        if (this._fetchingDocId || this._creatingDocument) return false;
+        return message.doc === undefined || message.doc === this.activeDocId;
+    },
+    
+    /**
+     * Start/stop recording the lesson on the server (teacher)
+     * @param {boolean} enabled
+     */
+    setRecording(enabled) {
+        if (this.connected && this.myRole === 'teacher') {
+            this._send(JSON.stringify({ type: enabled ? 'recording_start' : 'recording_stop' }));
+        }
+    },
+    
+    /**
+     * Turn private student workspaces on/off (teacher)
+     * @param {boolean} enabled
+     */
+    setWorkspaceMode(enabled) {
+        if (this.connected && this.myRole === 'teacher') {
+            console.log(`📝 Setting workspace mode: ${enabled ? 'ON' : 'OFF'}`);
+            this._send(JSON.stringify({ type: 'workspace_mode', enabled: !!enabled }));
+        }
+    },
+    
+    /**
+     * Show one student's workspace in the editor, with live sync (teacher).
+     * The editor keeps the current document until the snapshot arrives.
+     * @param {string} studentId
+     */
+    openWorkspace(studentId) {
+        if (this.connected && this.myRole === 'teacher' && this.workspaceMode) {
+            this._send(JSON.stringify({ type: 'workspace_open', studentId: String(studentId) }));
+        }
+    },
+    
+    /**
+     * Back to the board (teacher)
+     */
+    closeWorkspace() {
+        if (this.connected && this.myRole === 'teacher') {
+            this._send(JSON.stringify({ type: 'workspace_close' }));
+        }
+    },
+    
+    /**
+     * Grade every student workspace against the exercise's reference (teacher)
+     * @returns {boolean} true if the request was sent
+     */
+    gradeWorkspaces() {
+        if (!this.connected || this.myRole !== 'teacher' || !this.workspaceMode) return false;
+        this._send(JSON.stringify({ type: 'grade_start' }));
+        return true;
+    },
+    
+    _handleWorkspaceMode(message) {
+        this.workspaceMode = !!message.enabled;
+        if (typeof WorkspaceOverview !== 'undefined') {
+            WorkspaceOverview.setMode(this.workspaceMode);
+        }
+        
+        if (this.myRole === 'student') {
+            // Our own copy of the board, or back to the shared board
+            this._switchDocument(this.workspaceMode ? String(this.myId) : null, message.code, message.version, message.doc);
+            showToast(this.workspaceMode ? '📝 Private workspace' : '📋 Back to the board', 'info');
+        } else if (!this.workspaceMode && this.activeWorkspace) {
+            // Teacher had a student open: that workspace is gone
+            this._switchDocument(null, message.code, message.version, message.doc);
+        }
+    },
+    
+    /**
+     * Put another document in the editor and sync with it from now on
+     * @param {string|null} workspace - Student id, or null for the board
+     * @param {string} code
+     * @param {number} version
+     * @param {string} [docId] - Board tab, when going to the board
+     */
+    _switchDocument(workspace, code, version, docId) {
+        // Last edits still go to the document they were made in
+        this.flushLocalOps();
+        this._cacheActiveDocument();
+        
+        this.activeWorkspace = workspace || null;
+        if (docId) this.activeDocId = docId;
+        this._loadDocument(code, version);
+        
+        if (this.myRole === 'teacher' && typeof WorkspaceOverview !== 'undefined') {
+            WorkspaceOverview.setActive(this.activeWorkspace);
+        }
+        this._renderDocumentTabs();
+    },
+    
+    /**
+     * Show a document's text and adopt its version (no undo across documents)
+     */
+    _loadDocument(code, version) {
+        this._fetchingDocId = null;
+        this._creatingDocument = false;
+        this._resetCodeSync(version);
+        this.updateEditorContent(code, false);
+        
+        if (typeof gridEditor !== 'undefined' && gridEditor) {
+            gridEditor.setReadOnly(false);
+            gridEditor.clearUndoHistory();
+            gridEditor.clearRemoteCursor();
+        }
+        if (typeof StatusBar !== 'undefined' && StatusBar.updateLineNumbers) {
+            StatusBar.updateLineNumbers();
+        }
+    },
+    
+    // ============================================
+    // BOARD DOCUMENTS (tabs)
+    // ============================================
+    
+    /**
+     * Open code in a new tab and make it the board (teacher).
+     * Puts the code in the editor; returns false when the caller should
+     * replace the current document instead (student, not connected, or
+     * a student's workspace is open).
+     * @param {string} code
+     * @param {string} name - Tab title
+     * @returns {boolean}
+     */
+    openDocument(code, name) {
+        if (!this.connected || this.myRole !== 'teacher' || this.activeWorkspace) return false;
+        
+        this.flushLocalOps();
+        this._cacheActiveDocument();
+        this.activeDocId = null;
+        this._loadDocument(code, 0);
+        // Edits made before doc_created wait in _pendingOps (based on version 0)
+        this._creatingDocument = true;
+        
+        this._send(JSON.stringify({ type: 'doc_create', name: name, code: code }));
+        return true;
+    },
+    
+    /**
+     * Switch the class to another tab (teacher)
+     * @param {string} docId
+     */
+    activateDocument(docId) {
+        if (this.connected && this.myRole === 'teacher' && docId !== this.activeDocId) {
+            this._send(JSON.stringify({ type: 'doc_activate', docId: docId }));
+        }
+    },
+    
+    /**
+     * Close a tab (teacher)
+     * @param {string} docId
+     */
+    closeDocument(docId) {
+        if (this.connected && this.myRole === 'teacher') {
+            this._send(JSON.stringify({ type: 'doc_close', docId: docId }));
+        }
+    },
+    
+    /**
+     * Keep the text of the tab we leave, if the editor holds exactly its
+     * server version (no unacknowledged edits)
+     */
+    _cacheActiveDocument() {
+        if (!this.activeDocId || this.activeWorkspace || this._fetchingDocId || this._creatingDocument) return;
+        if (this._hasUnsyncedEdits()) return;
+        
+        const code = this._getEditorCode();
+        if (code !== null) {
+            this._docCache.set(this.activeDocId, { code, version: this.docVersion });
+        }
+    },
+    
+    /**
+     * Move the board to a tab: from the cache if it is still at that
+     * version, otherwise ask the server (sending the cached version so
+     * the reply can be just the ops since then)
+     * @param {string} docId
+     * @param {number} version - Server version of the tab
+     */
+    _enterBoardDocument(docId, version) {
+        if (this.activeWorkspace) {
+            // A workspace is on screen: the board is reloaded when we go back to it
+            this.activeDocId = docId;
+            this._renderDocumentTabs();
+            return;
+        }
+        if (docId === this.activeDocId && !this._fetchingDocId) return;
+        
+        this.flushLocalOps();
+        this._cacheActiveDocument();
+        this.activeDocId = docId;
+        
+        const cached = this._docCache.get(docId);
+        if (cached && cached.version === version) {
+            this._docCache.delete(docId);
+            this._loadDocument(cached.code, version);
+        } else {
+            this._resetCodeSync(version);
+            this._fetchingDocId = docId;
+            if (typeof gridEditor !== 'undefined' && gridEditor) {
+                gridEditor.setReadOnly(true);
+            }
+            this._send(JSON.stringify({
+                type: 'doc_fetch',
+                docId: docId,
+                version: cached ? cached.version : null
+            }));
+        }
+        this._renderDocumentTabs();
+    },
+    
+    _handleDocContent(message) {
+        if (message.docId !== this._fetchingDocId) return;
+        
+        let code = message.code;
+        if (message.ops) {
+            const cached = this._docCache.get(message.docId);
+            if (!cached || cached.version !== message.baseVersion || typeof TextOps === 'undefined') {
+                // Cache changed meanwhile: ask for the full text
+                this._send(JSON.stringify({ type: 'doc_fetch', docId: message.docId, version: null }));
+                return;
+            }
+            code = TextOps.applyAll(cached.code, message.ops);
+        }
+        this._docCache.delete(message.docId);
+        this._loadDocument(code, message.version);
+    },
+    
+    _handleDocCreated(message) {
+        if (!this._creatingDocument) return;
+        this._creatingDocument = false;
+        this.activeDocId = message.docId;
+        this._renderDocumentTabs();
+        this.flushLocalOps();
+    },
+    
+    _handleDocsList(message) {
+        this.documents = message.documents || [];
+        const open = new Set(this.documents.map(doc => doc.id));
+        for (const docId of this._docCache.keys()) {
+            if (!open.has(docId)) this._docCache.delete(docId);
+        }
+        this._renderDocumentTabs();
+    },
+    
+    _renderDocumentTabs() {
+        if (typeof DocumentTabs !== 'undefined') {
+            DocumentTabs.render(this.documents, this.activeDocId, this.myRole === 'teacher');
+        }
+    },
+    
     // ============================================
     // ACCESS CONTROL METHODS
     // ============================================
@@ -1138,10 +1900,13 @@ const Collaboration = {
             highlightContainer.remove();
         }
         
-        // Hide visual cursor
-        const visualCursor = document.getElementById('visual-cursor');
-        if (visualCursor) {
-            visualCursor.style.display = 'none';
+        // Hide remote cursors
+        this.remoteCursors = {};
+        if (this._visualCursors) {
+            this._visualCursors.clear();
+        }
+        if (typeof gridEditor !== 'undefined' && gridEditor) {
+            gridEditor.clearRemoteCursor();
         }
         
         console.log('🧹 Cleanup remote elements');
@@ -1206,24 +1971,28 @@ const Collaboration = {
             countEl.textContent = students.length;
         }
         
-        if (contentEl) {
-            if (students.length === 0) {
-                contentEl.innerHTML = '<div class="no-students">No students connected</div>';
-            } else {
-                contentEl.innerHTML = students.map(student => {
-                    const initials = student.name.split(' ')
-                        .map(w => w.charAt(0).toUpperCase())
-                        .slice(0, 2)
-                        .join('');
-                    return `
-                        <div class="student-item" data-student-id="${student.id}">
-                            <div class="student-avatar">${initials || '👤'}</div>
-                            <span class="student-name">${student.name}</span>
-                            <div class="student-status" title="Online"></div>
-                        </div>
-                    `;
-                }).join('');
+        if (contentEl && typeof VirtualList !== 'undefined') {
+            // Virtualized: a 100-student class keeps only the visible rows in the DOM
+            if (!this._studentList) {
+                this._studentList = new VirtualList(contentEl, {
+                    key: student => student.id,
+                    empty: '<div class="no-students">No students connected</div>',
+                    render: student => {
+                        const initials = student.name.split(' ')
+                            .map(w => w.charAt(0).toUpperCase())
+                            .slice(0, 2)
+                            .join('');
+                        return `
+                            <div class="student-item" data-student-id="${student.id}">
+                                <div class="student-avatar">${initials || '👤'}</div>
+                                <span class="student-name">${student.name}</span>
+                                <div class="student-status" title="Online"></div>
+                            </div>
+                        `;
+                    }
+                });
             }
+            this._studentList.setItems(students);
         }
     },
     
@@ -1266,7 +2035,7 @@ const Collaboration = {
         // Use GridEditor if available
         if (typeof gridEditor !== 'undefined' && gridEditor) {
             // Convert from 1-based (collaboration) to 0-based (GridEditor)
-            gridEditor.setRemoteCursor(data.line - 1, data.column - 1);
+            gridEditor.setRemoteCursor(data.line - 1, data.column - 1, data.userId);
             return;
         }
         
@@ -1278,38 +2047,40 @@ const Collaboration = {
     },
     
     /**
-     * Show simple visual cursor in editor
+     * Show simple visual cursor in editor.
+     * Positions are applied once per animation frame with pooled elements;
+     * cursors hide after 5 seconds of inactivity (see RemoteCursorLayer).
      */
     showVisualCursor(userId, line, column) {
         const codeArea = document.querySelector('.code-area');
         const editor = document.getElementById('code-editor');
-        if (!codeArea || !editor) return;
-        
-        // Find or create cursor element
-        let cursorEl = document.getElementById(`visual-cursor-${userId}`);
-        if (!cursorEl) {
-            cursorEl = document.createElement('div');
-            cursorEl.id = `visual-cursor-${userId}`;
-            cursorEl.className = 'visual-cursor';
-            codeArea.appendChild(cursorEl);
-            
-            // Update cursor position when teacher scrolls
-            editor.addEventListener('scroll', () => {
-                const cursorData = this.remoteCursors[userId];
-                if (cursorData && cursorEl.style.display === 'block') {
-                    this.updateCursorPosition(cursorEl, cursorData.line, cursorData.column);
-                }
+        if (!codeArea || !editor || typeof RemoteCursorLayer === 'undefined') return;
+        
+        if (!this._visualCursors) {
+            this._visualCursors = new RemoteCursorLayer(codeArea, {
+                className: 'visual-cursor',
+                idleMs: 5000,
+                place: (el, cursorLine, cursorColumn) => this.updateCursorPosition(el, cursorLine, cursorColumn)
             });
+            
+            // One listener moves every cursor when the teacher scrolls
+            editor.addEventListener('scroll', () => this._visualCursors.refresh());
         }
         
-        this.updateCursorPosition(cursorEl, line, column);
-        cursorEl.style.display = 'block';
-        
-        // Hide after 5 seconds of inactivity
-        clearTimeout(cursorEl.hideTimeout);
-        cursorEl.hideTimeout = setTimeout(() => {
-            cursorEl.style.display = 'none';
-        }, 5000);
+        this._visualCursors.set(userId, line, column);
+    },
+    
+    /**
+     * Hide one user's cursor (e.g. the user disconnected)
+     */
+    hideRemoteCursor(userId) {
+        delete this.remoteCursors[userId];
+        if (this._visualCursors) {
+            this._visualCursors.remove(userId);
+        }
+        if (typeof gridEditor !== 'undefined' && gridEditor) {
+            gridEditor.clearRemoteCursor(userId);
+        }
     },
     
     /**
@@ -1384,9 +2155,14 @@ const Collaboration = {
     },
     
     /**
-     * Convert character index to row/column
+     * Convert character index to row/column (1-based row)
+     * @param {string|TextBuffer} text - Plain text or a TextBuffer (O(log n), no split)
      */
     indexToRowCol(text, index) {
+        if (typeof text !== 'string') {
+            const pos = text.positionAt(index);
+            return { row: pos.row + 1, col: pos.col };
+        }
         const lines = text.substring(0, index).split('\n');
         const row = lines.length;
         const col = lines[lines.length - 1].length;
@@ -1394,9 +2170,13 @@ const Collaboration = {
     },
     
     /**
-     * Convert row/column to character index
+     * Convert row/column (1-based row) to character index
+     * @param {string|TextBuffer} text - Plain text or a TextBuffer (O(log n), no split)
      */
     rowColToIndex(text, row, col) {
+        if (typeof text !== 'string') {
+            return text.offsetAt(row - 1, col);
+        }
         const lines = text.split('\n');
         let index = 0;
         for (let i = 0; i < row - 1 && i < lines.length; i++) {
@@ -5,6 +5,7 @@
  * 
  * Dependencies:
  * - GridEditor (optional)
+ * - LineGutter (virtualized line numbers for GridEditor)
  */
 
 const StatusBar = {
@@ -28,6 +29,7 @@ const StatusBar = {
     // Reference to editor
     gridEditor: null,
     legacyEditor: null,
+    gutter: null, // LineGutter when a GridEditor is used
     
     // Teacher mode flag
     isTeacher: false,
@@ -50,6 +52,14 @@ const StatusBar = {
         this.elements.ngrokLatency = document.getElementById('ngrok-latency');
         this.elements.ngrokConnections = document.getElementById('ngrok-connections');
         
+        // Line numbers follow GridEditor's rendered rows and scroll position
+        if (this.gridEditor && this.elements.lineNumbers && typeof LineGutter !== 'undefined') {
+            this.gutter = new LineGutter(this.elements.lineNumbers, this.gridEditor, {
+                interactive: this.isTeacher
+            });
+            this.gridEditor.onGutterChange = () => this.gutter.update();
+        }
+        
         // Initial update
         this.updateLineNumbers();
         this.updateCursor(1, 1, 0);
@@ -96,42 +106,26 @@ const StatusBar = {
     
     /**
      * Update line numbers display (gutter)
+     * With GridEditor only the rendered rows are touched (see LineGutter)
      */
     updateLineNumbers() {
-        let lineCount;
+        if (this.gutter) {
+            this.gutter.update();
+            return;
+        }
         
-        if (this.gridEditor) {
-            lineCount = this.gridEditor.getLineCount();
-        } else if (this.legacyEditor) {
-            const code = this.legacyEditor.value;
-            const lines = code.split('\n');
-            lineCount = lines.length;
-        } else {
-            lineCount = 1;
+        let lineCount = 1;
+        if (this.legacyEditor) {
+            lineCount = this.legacyEditor.value.split('\n').length;
         }
         
-        // Build line numbers HTML
+        // Build line numbers HTML (legacy textarea editor)
         if (this.elements.lineNumbers) {
             let lineNumbersHtml = '';
             for (let i = 1; i <= lineCount; i++) {
-                const hasBreakpoint = this.gridEditor && this.gridEditor.hasBreakpoint(i - 1);
-                const breakpointClass = hasBreakpoint ? ' has-breakpoint' : '';
-                const breakpointMarker = hasBreakpoint ? '<span class="breakpoint-marker">●</span>' : '';
-                lineNumbersHtml += `<div class="line-number${breakpointClass}" data-line="${i-1}">${breakpointMarker}${i}</div>`;
+                lineNumbersHtml += `<div class="line-number" data-line="${i-1}">${i}</div>`;
             }
-            
             this.elements.lineNumbers.innerHTML = lineNumbersHtml;
-            
-            // Add click handlers for breakpoints (teacher only)
-            if (this.isTeacher && this.gridEditor) {
-                this.elements.lineNumbers.querySelectorAll('.line-number').forEach(el => {
-                    el.style.cursor = 'pointer';
-                    el.addEventListener('click', () => {
-                        const row = parseInt(el.dataset.line);
-                        this.gridEditor.toggleBreakpoint(row);
-                    });
-                });
-            }
         }
     },
     
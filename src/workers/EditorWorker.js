@@ -0,0 +1,295 @@
+/**
+ * EditorWorker - Off-main-thread highlighting and analysis
+ *
+ * Owns a mirror of the GridEditor document (a TextBuffer kept in sync with
+ * line-level deltas) and does the work that used to block input handling:
+ * - incremental syntax highlighting (HighlightCache + compiled lexers)
+ * - bracket / block pairs and the enclosing scope (StructureIndex)
+ * - autocomplete: a trie of the document's identifiers, kept up to date
+ *   from the rows the tokenizer re-reads, plus one keyword/snippet trie
+ *   per language built from its pack (CompletionTrie)
+ *
+ * Talks to core/EditorWorkerClient.js. Messages in:
+ *   { type: 'reset', text, version }
+ *   { type: 'edit', startRow, removedLines, lines, version }
+ *   { type: 'language', language }
+ *   { type: 'highlight', start, end }
+ *   { type: 'structure', id, row, col }
+ *   { type: 'complete', id, prefix, limit }
+ * Messages out:
+ *   { type: 'highlight', version, language, rows: [[row, spans], ...] }
+ *   { type: 'structure', id, version, match, scope }
+ *   { type: 'complete', id, items: [{ text, kind, insert, smart, desc }, ...] }
+ *
+ * @module workers/EditorWorker
+ */
+
+// Language packs and SyntaxHighlighter register on `window`
+self.window = self;
+
+importScripts(
+    '../core/LexerCompiler.js?v=3',
+    '../core/TextBuffer.js?v=2',
+    '../core/StructureIndex.js?v=1',
+    '../core/CompletionTrie.js?v=1',
+    '../components/SyntaxHighlighter.js?v=4'
+);
+
+// ============================================
+// STATE
+// ============================================
+
+const LANGUAGE_FILES = {
+    glossa: ['../languages/glossa/keywords.js', '../languages/glossa/syntax.js'],
+    python: ['../languages/python/keywords.js', '../languages/python/syntax.js'],
+    cpp: ['../languages/cpp/keywords.js', '../languages/cpp/syntax.js'],
+    java: ['../languages/java/keywords.js', '../languages/java/syntax.js']
+};
+
+const loadedLanguages = new Set();
+
+let buffer = null;
+let cache = null;
+let structure = null;
+let docVersion = 0;
+let language = null;
+
+// Rows whose classes changed since they were last sent to the editor
+let unsent = [];
+
+// Autocomplete index: words per row, and a trie of occurrence counts
+let rowWords = [];
+let documentWords = new CompletionTrie();
+
+// Keywords and snippets, one trie per language (built on first use)
+const languageWords = new Map();
+
+// ============================================
+// DOCUMENT MIRROR
+// ============================================
+
+function attachBuffer(text) {
+    if (cache) cache.dispose();
+    if (structure) structure.dispose();
+    buffer = new TextBuffer(text);
+    cache = new HighlightCache(buffer);
+    structure = new StructureIndex(buffer);
+    buffer.onChange(onBufferChange);
+    unsent = new Array(buffer.lineCount).fill(true);
+    resetWords();
+}
+
+function onBufferChange(change) {
+    const { startRow, removedLines, insertedLines } = change;
+    for (let row = startRow; row < startRow + removedLines; row++) {
+        forgetWords(rowWords[row]);
+    }
+    unsent = HighlightCache._spliceEmpty(unsent, startRow, removedLines, insertedLines);
+    rowWords = HighlightCache._spliceEmpty(rowWords, startRow, removedLines, insertedLines);
+}
+
+function applyEdit(message) {
+    const lastRow = message.startRow + message.removedLines - 1;
+    buffer.replaceRange(message.startRow, 0, lastRow, Infinity, message.lines.join('\n'));
+}
+
+function loadLanguage(lang) {
+    if (loadedLanguages.has(lang) || !LANGUAGE_FILES[lang]) return;
+    try {
+        importScripts(...LANGUAGE_FILES[lang]);
+        loadedLanguages.add(lang);
+    } catch (error) {
+        console.error(`❌ EditorWorker: failed to load ${lang}`, error);
+    }
+}
+
+// ============================================
+// HIGHLIGHTING
+// ============================================
+
+/**
+ * Re-tokenizes what changed since the last call; re-tokenized rows are
+ * queued for the editor and re-indexed for autocomplete and structure
+ * @returns {string[][]} Classes per line
+ */
+function refresh() {
+    const classes = cache.highlight(language);
+    const lexer = SyntaxHighlighter.getLexer(language);
+    for (let row = cache.updatedFrom; row < cache.updatedTo; row++) {
+        unsent[row] = true;
+        indexWords(row, classes[row]);
+        structure.updateRow(row, classes[row], lexer);
+    }
+    return classes;
+}
+
+/**
+ * Returns the requested rows that the editor has not seen yet,
+ * as [start, end, className] runs
+ */
+function highlight(start, end) {
+    const classes = refresh();
+    const rows = [];
+    end = Math.min(end, buffer.lineCount);
+    for (let row = Math.max(0, start); row < end; row++) {
+        if (!unsent[row]) continue;
+        unsent[row] = false;
+        rows.push([row, toSpans(classes[row] || [])]);
+    }
+    return rows;
+}
+
+function toSpans(lineClasses) {
+    const spans = [];
+    let col = 0;
+    while (col < lineClasses.length) {
+        const className = lineClasses[col];
+        const start = col;
+        while (col < lineClasses.length && lineClasses[col] === className) col++;
+        if (className) spans.push([start, col, className]);
+    }
+    return spans;
+}
+
+// ============================================
+// STRUCTURE
+// ============================================
+
+/**
+ * Pair at the cursor and the scope around it
+ * @returns {{ match: Object|null, scope: Object|null }}
+ */
+function queryStructure(row, col) {
+    refresh();
+    return {
+        match: structure.matchAt(row, col),
+        scope: structure.enclosingScope(row, col)
+    };
+}
+
+// ============================================
+// AUTOCOMPLETE INDEX
+// ============================================
+
+function foldOf(lang) {
+    const lexer = SyntaxHighlighter.getLexer(lang);
+    return lexer && lexer.foldCase ? LexerCompiler.foldWord : null;
+}
+
+/**
+ * Empty the document index (new document, or a language with other
+ * case rules); refresh() fills it again
+ */
+function resetWords() {
+    rowWords = new Array(buffer.lineCount).fill(null);
+    documentWords = new CompletionTrie({ fold: foldOf(language) });
+}
+
+function getLanguageWords(lang) {
+    if (!languageWords.has(lang)) {
+        const pack = self.Languages && self.Languages[SyntaxHighlighter.LANGUAGE_NAMESPACES[lang]];
+        languageWords.set(lang, CompletionTrie.fromLanguagePack(pack && pack.keywords, { fold: foldOf(lang) }));
+    }
+    return languageWords.get(lang);
+}
+
+function forgetWords(words) {
+    if (!words) return;
+    for (const word of words) {
+        documentWords.add(word, -1);
+    }
+}
+
+function indexWords(row, lineClasses) {
+    const lexer = SyntaxHighlighter.getLexer(language);
+    forgetWords(rowWords[row]);
+    const words = [];
+    if (lexer && lineClasses) {
+        lexer.forEachWord(buffer.getLine(row), lineClasses, word => {
+            if (word.length < 2) return;
+            words.push(word);
+            documentWords.add(word, 1);
+        });
+    }
+    rowWords[row] = words;
+}
+
+/**
+ * Suggestions for prefix: the document's own identifiers (most frequent
+ * first), then the language's snippets and keywords
+ */
+function complete(prefix, limit) {
+    refresh();
+    const packWords = getLanguageWords(language);
+
+    const items = [];
+    for (const entry of documentWords.complete(prefix, limit + 1)) {
+        if (entry.word === prefix || packWords.weightOf(entry.word) > 0) continue;
+        items.push({ text: entry.word, kind: 'word', insert: entry.word, smart: null, desc: '' });
+    }
+    for (const entry of packWords.complete(prefix, limit)) {
+        if (entry.word === prefix) continue;
+        const data = entry.data;
+        items.push({ text: entry.word, kind: data.kind, insert: data.insert || entry.word, smart: data.smart || null, desc: data.desc });
+    }
+    return items.slice(0, limit);
+}
+
+// ============================================
+// MESSAGES
+// ============================================
+
+self.onmessage = (event) => {
+    const message = event.data;
+
+    switch (message.type) {
+        case 'reset':
+            attachBuffer(message.text);
+            docVersion = message.version;
+            break;
+
+        case 'edit':
+            applyEdit(message);
+            docVersion = message.version;
+            break;
+
+        case 'language':
+            loadLanguage(message.language);
+            language = message.language;
+            cache.invalidate();
+            resetWords();
+            unsent.fill(true);
+            break;
+
+        case 'highlight':
+            self.postMessage({
+                type: 'highlight',
+                version: docVersion,
+                language,
+                rows: highlight(message.start, message.end)
+            });
+            break;
+
+        case 'structure': {
+            const { match, scope } = queryStructure(message.row, message.col);
+            self.postMessage({
+                type: 'structure',
+                id: message.id,
+                version: docVersion,
+                match,
+                scope
+            });
+            break;
+        }
+
+        case 'complete':
+            self.postMessage({
+                type: 'complete',
+                id: message.id,
+                items: complete(message.prefix, message.limit || 20)
+            });
+            break;
+    }
+};
+
+attachBuffer('');
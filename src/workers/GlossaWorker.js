@@ -0,0 +1,116 @@
+/**
+ * GlossaWorker - Runs GLOSSA programs off the main thread
+ *
+ * Compiles the program (core/GlossaCompiler.js) and runs the bytecode
+ * (core/GlossaVM.js) in slices of SLICE_STEPS instructions, sending the
+ * output written by each slice. The page stays responsive however long the
+ * program loops; Stop terminates the worker, and a program still running
+ * after MAX_STEPS instructions is stopped here.
+ *
+ * When ΔΙΑΒΑΣΕ runs out of input the worker returns to its message loop
+ * until an 'input' (a line typed in the console) or 'eof' arrives. Lines
+ * typed while the program is busy queue up and are read in order.
+ *
+ * Talks to core/GlossaRunner.js. Messages in:
+ *   { type: 'run', code }
+ *   { type: 'input', data }
+ *   { type: 'eof' }
+ * Messages out:
+ *   { type: 'compiled' }
+ *   { type: 'output', data }
+ *   { type: 'exit', reason, errors, error, steps, timeMs }
+ *     reason: 'done' | 'compile_error' | 'runtime_error' | 'step_limit' | 'output_limit'
+ *
+ * @module workers/GlossaWorker
+ */
+
+// The compiler and VM register on `window`
+self.window = self;
+
+importScripts(
+    '../core/GlossaCompiler.js?v=1',
+    '../core/GlossaVM.js?v=2'
+);
+
+const SLICE_STEPS = 2000000;
+const MAX_STEPS = 5000000000;
+const OUTPUT_LIMIT_CHARS = 256 * 1024;
+
+let vm = null;
+let startedAt = 0;
+let outputChars = 0;
+
+self.onmessage = (event) => {
+    const message = event.data;
+    switch (message.type) {
+        case 'run':
+            start(message.code);
+            break;
+        case 'input':
+            if (!vm) return;
+            vm.addInput(message.data);
+            resume();
+            break;
+        case 'eof':
+            if (!vm) return;
+            vm.closeInput();
+            resume();
+            break;
+    }
+};
+
+function start(code) {
+    const compiled = GlossaCompiler.compile(code);
+    if (compiled.errors) {
+        self.postMessage({ type: 'exit', reason: 'compile_error', errors: compiled.errors, steps: 0, timeMs: 0 });
+        return;
+    }
+    self.postMessage({ type: 'compiled' });
+    vm = new GlossaVM(compiled.program);
+    startedAt = Date.now();
+    outputChars = 0;
+    resume();
+}
+
+// Run until the program ends, waits for input or hits a limit
+function resume() {
+    for (;;) {
+        const result = vm.run(SLICE_STEPS);
+        if (!sendOutput()) {
+            finish({ reason: 'output_limit' });
+            return;
+        }
+        switch (result.status) {
+            case 'yield':
+                if (vm.steps >= MAX_STEPS) {
+                    finish({ reason: 'step_limit' });
+                    return;
+                }
+                continue;
+            case 'input':
+                return;
+            case 'done':
+                finish({ reason: 'done' });
+                return;
+            case 'error':
+                finish({ reason: 'runtime_error', error: { row: result.row, message: result.message } });
+                return;
+        }
+    }
+}
+
+// False once the output limit is reached
+function sendOutput() {
+    let data = vm.takeOutput();
+    if (!data) return true;
+    const room = OUTPUT_LIMIT_CHARS - outputChars;
+    if (data.length > room) data = data.slice(0, room);
+    outputChars += data.length;
+    self.postMessage({ type: 'output', data });
+    return outputChars < OUTPUT_LIMIT_CHARS;
+}
+
+function finish(exit) {
+    self.postMessage({ type: 'exit', ...exit, steps: vm.steps, timeMs: Date.now() - startedAt });
+    vm = null;
+}
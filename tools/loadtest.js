@@ -0,0 +1,707 @@
+/**
+ * loadtest - How many students can one server.js handle?
+ *
+ * Opens a teacher and N simulated student connections to a running server
+ * and replays classroom traffic:
+ * - typing: the teacher types a real exercise in bursts (code_ops, one
+ *   character per message, like the editor sends while typing fast)
+ * - laser: laser-pointer sweeps across the code at 30 points a second
+ * - templates: a real template loaded every TEMPLATE_EVERY_MS
+ * - cursors: students moving their cursors (cursor_update, to the teacher)
+ * - churn: students leaving and joining again
+ *
+ * It measures the end-to-end fan-out latency of every event to every
+ * recipient (one process, one clock: the time from the send to each
+ * receive), join time (socket open -> init), bytes and messages per second
+ * seen by the clients, and the server's CPU and memory from /api/status.
+ *
+ *   npm run loadtest -- --students 40 --duration 60
+ *   node tools/loadtest.js --url ws://10.0.0.5:3000 --password secret --out run.json
+ *   node tools/loadtest.js --baseline run.json      (compare, exit 1 on a regression)
+ *
+ * The report is JSON (stdout, or --out); progress and a summary table go to
+ * stderr. Runs with the same --seed send the same traffic.
+ *
+ * The teacher types into a board document of its own ("loadtest"), closed
+ * at the end, and turns public access on if the students need a code -
+ * still, point it at a test server, not at a lesson in progress.
+ */
+
+const fs = require('fs');
+const path = require('path');
+const { monitorEventLoopDelay } = require('perf_hooks');
+const WebSocket = require('ws');
+
+const CONTENT_DIR = path.join(__dirname, '..', 'content');
+
+const DEFAULTS = {
+    url: 'ws://localhost:3000',
+    password: '',
+    students: 30,
+    duration: 30,       // Seconds of traffic
+    mix: 'classroom',
+    seed: 1,
+    out: null,
+    baseline: null,
+    tolerance: 20       // % a baseline metric may worsen before it counts as a regression
+};
+
+// Which generators each mix runs
+const MIXES = {
+    classroom: ['typing', 'laser', 'templates', 'cursors', 'churn'],
+    typing: ['typing'],
+    laser: ['laser'],
+    templates: ['templates'],
+    churn: ['churn', 'cursors']
+};
+
+const TYPING_INTERVAL_MS = 90;         // ~11 characters a second within a burst
+const TYPING_BURST = [15, 60];         // Characters per burst
+const TYPING_PAUSE_MS = [1000, 4000];
+const LASER_INTERVAL_MS = 33;
+const LASER_SWEEP_MS = [1500, 3000];
+const LASER_PAUSE_MS = [2000, 6000];
+const TEMPLATE_EVERY_MS = 15000;
+const CURSOR_EVERY_MS = [700, 2000];   // Per student
+const CHURN_EVERY_MS = 3000;           // One student leaves, comes back 1-3 s later
+const SAMPLE_MS = 1000;                // Server status / throughput samples
+const LAG_RESOLUTION_MS = 10;          // Event-loop lag sampling (included in its readings)
+const CONNECT_TIMEOUT_MS = 10000;
+
+// ============================================
+// Setup
+// ============================================
+
+function parseArgs(argv) {
+    const options = { ...DEFAULTS };
+    for (let i = 0; i < argv.length; i++) {
+        const name = argv[i].replace(/^--/, '');
+        if (name === 'help' || name === 'h') {
+            options.help = true;
+            continue;
+        }
+        if (!(name in DEFAULTS)) throw new Error(`Unknown option --${name}`);
+        const value = argv[++i];
+        if (value === undefined) throw new Error(`--${name} needs a value`);
+        options[name] = typeof DEFAULTS[name] === 'number' ? Number(value) : value;
+    }
+    if (!MIXES[options.mix]) throw new Error(`Unknown mix "${options.mix}" (${Object.keys(MIXES).join(', ')})`);
+    return options;
+}
+
+// Small seeded PRNG (mulberry32), so runs with one seed send the same traffic
+function createRandom(seed) {
+    let state = seed >>> 0;
+    const next = () => {
+        state = (state + 0x6D2B79F5) >>> 0;
+        let t = state;
+        t = Math.imul(t ^ (t >>> 15), t | 1);
+        t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+        return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+    };
+    next.between = ([min, max]) => min + Math.floor(next() * (max - min + 1));
+    next.pick = list => list[Math.floor(next() * list.length)];
+    return next;
+}
+
+// Real files to type and to load as templates
+function loadFixtures() {
+    const pick = (dir, extension) => {
+        const files = [];
+        const walk = (current) => {
+            if (!fs.existsSync(current)) return;
+            for (const entry of fs.readdirSync(current, { withFileTypes: true })) {
+                const full = path.join(current, entry.name);
+                if (entry.isDirectory()) walk(full);
+                else if (entry.name.endsWith(extension)) files.push(full);
+            }
+        };
+        walk(dir);
+        return files.sort();
+    };
+    const templates = pick(path.join(CONTENT_DIR, 'cpp', 'templates'), '.cpp')
+        .map(file => ({ name: path.basename(file), code: fs.readFileSync(file, 'utf8') }));
+    const exercises = pick(path.join(CONTENT_DIR, 'cpp', 'exercises'), '-solved.cpp');
+    const typing = exercises.length > 0
+        ? fs.readFileSync(exercises[Math.floor(exercises.length / 2)], 'utf8')
+        : 'for (int i = 0; i < n; i++) {\n    sum += i;\n}\n';
+    if (templates.length === 0) templates.push({ name: 'empty.cpp', code: 'int main() {\n}\n' });
+    return { templates, typing };
+}
+
+// ============================================
+// Measurements
+// ============================================
+
+class Latencies {
+    constructor() {
+        this.samples = new Map(); // kind -> number[] (ms)
+        this.expected = new Map(); // kind -> deliveries expected
+    }
+
+    expect(kind, count) {
+        this.expected.set(kind, (this.expected.get(kind) || 0) + count);
+    }
+
+    add(kind, ms) {
+        if (!this.samples.has(kind)) this.samples.set(kind, []);
+        this.samples.get(kind).push(ms);
+    }
+
+    summary() {
+        const result = {};
+        const kinds = new Set([...this.samples.keys(), ...this.expected.keys()]);
+        for (const kind of kinds) {
+            const samples = (this.samples.get(kind) || []).slice().sort((a, b) => a - b);
+            const at = p => samples.length === 0 ? null
+                : round(samples[Math.min(samples.length - 1, Math.floor(p * samples.length))]);
+            const expected = this.expected.get(kind);
+            result[kind] = {
+                count: samples.length,
+                missing: expected === undefined ? null : Math.max(0, expected - samples.length),
+                p50: at(0.5),
+                p90: at(0.9),
+                p99: at(0.99),
+                max: samples.length > 0 ? round(samples[samples.length - 1]) : null,
+                mean: samples.length > 0 ? round(samples.reduce((a, b) => a + b, 0) / samples.length) : null
+            };
+        }
+        return result;
+    }
+}
+
+const round = (value, digits = 2) => Math.round(value * 10 ** digits) / 10 ** digits;
+
+// A monitorEventLoopDelay reading (ns) is the sampling interval plus the lag
+const lagMs = ns => round(Math.max(0, ns / 1e6 - LAG_RESOLUTION_MS));
+
+function stats(values) {
+    if (values.length === 0) return { mean: null, max: null };
+    return {
+        mean: round(values.reduce((a, b) => a + b, 0) / values.length),
+        max: round(Math.max(...values))
+    };
+}
+
+// ============================================
+// Simulated clients
+// ============================================
+
+class Client {
+    /**
+     * @param {LoadTest} test
+     * @param {string} role - 'teacher' | 'student'
+     * @param {string|null} studentId - Reconnect as this student
+     */
+    constructor(test, role, studentId = null) {
+        this.test = test;
+        this.role = role;
+        this.id = studentId;
+        this.ready = false;
+        this.closed = false;
+        this.onMessage = null;
+
+        const params = new URLSearchParams({ role });
+        if (role === 'teacher' && test.options.password) params.set('password', test.options.password);
+        if (studentId) params.set('studentId', studentId);
+        this.openedAt = performance.now();
+        this.ws = new WebSocket(`${test.options.url}/?${params}`);
+        this.ws.on('message', (data) => this._receive(data));
+        this.ws.on('close', () => {
+            this.closed = true;
+            this.ready = false;
+        });
+        this.ws.on('error', (error) => test.error(`${role}: ${error.message}`));
+    }
+
+    send(message) {
+        if (this.ws.readyState !== WebSocket.OPEN) return false;
+        const data = JSON.stringify(message);
+        this.test.bytesOut += Buffer.byteLength(data);
+        this.test.messagesOut++;
+        this.ws.send(data);
+        return true;
+    }
+
+    close() {
+        this.closed = true;
+        this.ready = false;
+        this.ws.close();
+    }
+
+    _receive(data) {
+        const now = performance.now();
+        this.test.bytesIn += data.length;
+        this.test.messagesIn++;
+        const message = JSON.parse(data);
+        if (message.type === 'init') {
+            this.id = String(message.yourId);
+            if (!this.ready) this.test.latencies.add('join', now - this.openedAt);
+            this.ready = true;
+        } else if (message.type === 'auth_required') {
+            this.id = String(message.yourId);
+            this.test.needsPublicAccess();
+        }
+        this.test.observe(this, message, now);
+        if (this.onMessage) this.onMessage(message);
+    }
+}
+
+class LoadTest {
+    constructor(options) {
+        this.options = options;
+        this.random = createRandom(options.seed);
+        this.fixtures = loadFixtures();
+        this.latencies = new Latencies();
+        this.students = [];
+        this.teacher = null;
+        this.timers = new Set();
+        this.errors = [];
+        this.bytesIn = 0;
+        this.bytesOut = 0;
+        this.messagesIn = 0;
+        this.messagesOut = 0;
+        this.samples = { cpuPercent: [], rssMb: [], bytesInPerSec: [], bytesOutPerSec: [], messagesInPerSec: [], messagesOutPerSec: [] };
+
+        this._docId = null;
+        this._version = null;          // Version of the teacher's document after its last send
+        this._sentAt = new Map();      // document version -> { kind, at }
+        this._laserAt = new Map();     // laser col -> sent at
+        this._cursorAt = new Map();    // cursor column -> sent at
+        this._laserSeq = 0;
+        this._cursorSeq = 0;
+        this._typingOffset = 0;
+        this._typingPos = 0;
+        this._enabledPublic = false;
+        this._statusUrl = options.url.replace(/^ws/, 'http').replace(/\/$/, '') + '/api/status';
+    }
+
+    error(message) {
+        if (this.errors.length < 20) this.errors.push(message);
+    }
+
+    async run() {
+        const lag = monitorEventLoopDelay({ resolution: LAG_RESOLUTION_MS });
+        lag.enable();
+
+        await this._connectTeacher();
+        await this._createDocument();
+        await this._connectStudents();
+
+        const log = (text) => process.stderr.write(`${text}\n`);
+        log(`📈 ${this.students.length} students + teacher connected, mix "${this.options.mix}", ${this.options.duration} s`);
+
+        const generators = MIXES[this.options.mix];
+        generators.forEach(name => this[`_${name}`]());
+        const stopSampling = this._sample(log);
+
+        await this._sleep(this.options.duration * 1000);
+        this.timers.forEach(timer => clearTimeout(timer));
+        this.timers.clear();
+        await this._sleep(1000); // Let the last deliveries arrive
+        stopSampling();
+        lag.disable();
+
+        await this._cleanUp();
+        return this._report(lag);
+    }
+
+    // ---------------- Connections ----------------
+
+    _connectTeacher() {
+        return new Promise((resolve, reject) => {
+            const timeout = setTimeout(() => reject(new Error(`No init from ${this.options.url} (is the server running?)`)), CONNECT_TIMEOUT_MS);
+            this.teacher = new Client(this, 'teacher');
+            this.teacher.onMessage = (message) => {
+                if (message.type === 'auth_error') reject(new Error('Teacher password rejected (--password)'));
+                if (message.type === 'init') {
+                    clearTimeout(timeout);
+                    resolve();
+                }
+            };
+        });
+    }
+
+    // A document of our own, so the board's code is left alone
+    _createDocument() {
+        return new Promise((resolve, reject) => {
+            const timeout = setTimeout(() => reject(new Error('No reply to doc_create')), CONNECT_TIMEOUT_MS);
+            this.teacher.onMessage = (message) => {
+                if (message.type === 'doc_created') {
+                    this._docId = message.docId;
+                    // One full load to learn the document's version
+                    this.teacher.send({ type: 'template_loaded', doc: this._docId, code: this.fixtures.templates[0].code, templateName: 'loadtest' });
+                    this._typingOffset = this.fixtures.templates[0].code.length;
+                } else if (message.type === 'code_ack' && message.doc === this._docId && this._version === null) {
+                    this._version = message.version;
+                    clearTimeout(timeout);
+                    this.teacher.onMessage = null;
+                    resolve();
+                }
+            };
+            this.teacher.send({ type: 'doc_create', name: 'loadtest', code: '' });
+        });
+    }
+
+    async _connectStudents() {
+        const pending = [];
+        for (let i = 0; i < this.options.students; i++) {
+            pending.push(this._connectStudent());
+            if (i % 10 === 9) await this._sleep(20); // Don't open hundreds of sockets in one tick
+        }
+        await Promise.all(pending);
+    }
+
+    _connectStudent(studentId = null, slot = null) {
+        return new Promise((resolve) => {
+            const student = new Client(this, 'student', studentId);
+            if (slot === null) this.students.push(student);
+            else this.students[slot] = student;
+            const timeout = setTimeout(() => {
+                this.error('A student got no init in time');
+                resolve();
+            }, CONNECT_TIMEOUT_MS);
+            student.onMessage = (message) => {
+                if (message.type === 'init') {
+                    clearTimeout(timeout);
+                    student.onMessage = null;
+                    resolve();
+                }
+            };
+        });
+    }
+
+    // Students wait for an access code: let them in, and close the door again at the end
+    needsPublicAccess() {
+        if (this._enabledPublic || !this.teacher) return;
+        this._enabledPublic = true;
+        this.teacher.send({ type: 'admin_set_public', enabled: true });
+    }
+
+    // ---------------- Traffic ----------------
+
+    _every(delay, action) {
+        const timer = setTimeout(() => {
+            this.timers.delete(timer);
+            const next = action();
+            if (next !== null) this._every(next, action);
+        }, delay);
+        this.timers.add(timer);
+    }
+
+    // The teacher types the text of a real exercise, in bursts
+    _typing() {
+        let left = 0;
+        this._every(TYPING_INTERVAL_MS, () => {
+            if (left === 0) {
+                left = this.random.between(TYPING_BURST);
+                return this.random.between(TYPING_PAUSE_MS);
+            }
+            left--;
+            const text = this.fixtures.typing;
+            const ch = text[this._typingPos++ % text.length];
+            this._sendCode('typing', {
+                type: 'code_ops',
+                ops: [{ offset: this._typingOffset, deleteCount: 0, text: ch }],
+                baseVersion: this._version
+            });
+            this._typingOffset += ch.length;
+            return TYPING_INTERVAL_MS;
+        });
+    }
+
+    _templates() {
+        this._every(TEMPLATE_EVERY_MS, () => {
+            const template = this.random.pick(this.fixtures.templates);
+            this._sendCode('template', { type: 'template_loaded', code: template.code, templateName: template.name });
+            this._typingOffset = template.code.length;
+            return TEMPLATE_EVERY_MS;
+        });
+    }
+
+    // Each code change bumps the document's version by one; the version identifies it on arrival
+    _sendCode(kind, message) {
+        message.doc = this._docId;
+        if (!this.teacher.send(message)) return;
+        this._version++;
+        this._sentAt.set(this._version, { kind, at: performance.now() });
+        this.latencies.expect(kind, this._readyStudents());
+    }
+
+    _laser() {
+        let sweepEnd = 0;
+        this._every(LASER_INTERVAL_MS, () => {
+            const now = performance.now();
+            if (now > sweepEnd) {
+                if (sweepEnd > 0) {
+                    this.teacher.send({ type: 'laser_point', row: 0, col: 0, active: false });
+                    sweepEnd = 0;
+                    return this.random.between(LASER_PAUSE_MS);
+                }
+                sweepEnd = now + this.random.between(LASER_SWEEP_MS);
+            }
+            // The column is unique per point, so arrivals can be matched to sends
+            const seq = ++this._laserSeq;
+            if (this.teacher.send({ type: 'laser_point', row: seq % 40, col: seq, active: true })) {
+                this._laserAt.set(seq, now);
+                this.latencies.expect('laser', this._readyStudents());
+            }
+            return LASER_INTERVAL_MS;
+        });
+    }
+
+    _cursors() {
+        this.students.forEach((_, slot) => {
+            this._every(this.random.between(CURSOR_EVERY_MS), () => {
+                const student = this.students[slot];
+                if (student.ready) {
+                    const seq = ++this._cursorSeq;
+                    const line = this.random.between([0, 40]);
+                    if (student.send({ type: 'cursor_update', position: 0, line, column: seq })) {
+                        this._cursorAt.set(seq, performance.now());
+                        this.latencies.expect('cursor', 1);
+                    }
+                }
+                return this.random.between(CURSOR_EVERY_MS);
+            });
+        });
+    }
+
+    _churn() {
+        this._every(CHURN_EVERY_MS, () => {
+            const slot = Math.floor(this.random() * this.students.length);
+            const student = this.students[slot];
+            if (!student || !student.ready) return CHURN_EVERY_MS;
+            const id = student.id;
+            student.close();
+            const timer = setTimeout(() => {
+                this.timers.delete(timer);
+                this._connectStudent(id, slot);
+            }, this.random.between([1000, 3000]));
+            this.timers.add(timer);
+            return CHURN_EVERY_MS;
+        });
+    }
+
+    _readyStudents() {
+        return this.students.reduce((count, student) => count + (student.ready ? 1 : 0), 0);
+    }
+
+    // Match every arrival to its send
+    observe(client, message, now) {
+        switch (message.type) {
+            case 'code_ops':
+            case 'template_loaded': {
+                if (client.role !== 'student' || message.doc !== this._docId) return;
+                const sent = this._sentAt.get(message.version);
+                if (sent) this.latencies.add(sent.kind, now - sent.at);
+                break;
+            }
+            case 'laser_point': {
+                if (client.role !== 'student' || !message.active) return;
+                const at = this._laserAt.get(message.col);
+                if (at !== undefined) this.latencies.add('laser', now - at);
+                break;
+            }
+            case 'cursor_update': {
+                if (client !== this.teacher) return;
+                const at = this._cursorAt.get(message.column);
+                if (at !== undefined) this.latencies.add('cursor', now - at);
+                break;
+            }
+        }
+    }
+
+    // ---------------- Sampling and report ----------------
+
+    _sample(log) {
+        let last = { at: performance.now(), bytesIn: 0, bytesOut: 0, messagesIn: 0, messagesOut: 0, cpuMs: null, uptimeMs: null };
+        let ticks = 0;
+        const timer = setInterval(async () => {
+            const now = performance.now();
+            const seconds = (now - last.at) / 1000;
+            const current = { at: now, bytesIn: this.bytesIn, bytesOut: this.bytesOut, messagesIn: this.messagesIn, messagesOut: this.messagesOut };
+            this.samples.bytesInPerSec.push((current.bytesIn - last.bytesIn) / seconds);
+            this.samples.bytesOutPerSec.push((current.bytesOut - last.bytesOut) / seconds);
+            this.samples.messagesInPerSec.push((current.messagesIn - last.messagesIn) / seconds);
+            this.samples.messagesOutPerSec.push((current.messagesOut - last.messagesOut) / seconds);
+
+            const server = await this._serverStatus();
+            if (server) {
+                if (last.cpuMs !== null && server.uptimeMs > last.uptimeMs) {
+                    this.samples.cpuPercent.push((server.cpuMs - last.cpuMs) / (server.uptimeMs - last.uptimeMs) * 100);
+                }
+                this.samples.rssMb.push(server.rssBytes / 1048576);
+                current.cpuMs = server.cpuMs;
+                current.uptimeMs = server.uptimeMs;
+            } else {
+                current.cpuMs = null;
+            }
+            last = current;
+
+            if (++ticks % 5 === 0) {
+                const cpu = this.samples.cpuPercent[this.samples.cpuPercent.length - 1];
+                const rss = this.samples.rssMb[this.samples.rssMb.length - 1];
+                log(`  ${ticks}s: ${this._readyStudents()} students, ${Math.round(this.samples.messagesInPerSec.at(-1))} msg/s in, ` +
+                    `${(this.samples.bytesInPerSec.at(-1) / 1024).toFixed(0)} KB/s in` +
+                    (cpu !== undefined ? `, server CPU ${cpu.toFixed(0)}%, RSS ${rss.toFixed(0)} MB` : ''));
+            }
+        }, SAMPLE_MS);
+        return () => clearInterval(timer);
+    }
+
+    async _serverStatus() {
+        try {
+            const response = await fetch(this._statusUrl);
+            const status = await response.json();
+            return status.server || null;
+        } catch (error) {
+            return null;
+        }
+    }
+
+    async _cleanUp() {
+        if (this._docId !== null) this.teacher.send({ type: 'doc_close', docId: this._docId });
+        if (this._enabledPublic) this.teacher.send({ type: 'admin_set_public', enabled: false });
+        await this._sleep(200);
+        this.students.forEach(student => student.close());
+        this.teacher.close();
+    }
+
+    _report(lag) {
+        const duration = this.options.duration;
+        return {
+            tool: 'loadtest',
+            format: 1,
+            date: new Date().toISOString(),
+            options: {
+                url: this.options.url,
+                students: this.options.students,
+                duration,
+                mix: this.options.mix,
+                seed: this.options.seed
+            },
+            latencyMs: this.latencies.summary(),
+            server: {
+                cpuPercent: stats(this.samples.cpuPercent),
+                rssMb: stats(this.samples.rssMb)
+            },
+            traffic: {
+                bytesInPerSec: stats(this.samples.bytesInPerSec),
+                bytesOutPerSec: stats(this.samples.bytesOutPerSec),
+                messagesInPerSec: stats(this.samples.messagesInPerSec),
+                messagesOutPerSec: stats(this.samples.messagesOutPerSec)
+            },
+            // High lag here means the generator, not the server, was the bottleneck
+            generatorLagMs: {
+                p50: lagMs(lag.percentile(50)),
+                p99: lagMs(lag.percentile(99)),
+                max: lagMs(lag.max)
+            },
+            errors: this.errors
+        };
+    }
+
+    _sleep(ms) {
+        return new Promise(resolve => setTimeout(resolve, ms));
+    }
+}
+
+// ============================================
+// Output
+// ============================================
+
+function printSummary(report) {
+    const lines = ['', 'latency (ms)        count  missing      p50      p90      p99      max'];
+    for (const [kind, row] of Object.entries(report.latencyMs)) {
+        const cell = value => String(value === null ? '-' : value).padStart(8);
+        lines.push(`${kind.padEnd(16)} ${String(row.count).padStart(8)} ${cell(row.missing)} ${cell(row.p50)} ${cell(row.p90)} ${cell(row.p99)} ${cell(row.max)}`);
+    }
+    const { server, traffic } = report;
+    lines.push('');
+    lines.push(`server CPU    mean ${server.cpuPercent.mean}%  max ${server.cpuPercent.max}%`);
+    lines.push(`server RSS    mean ${server.rssMb.mean} MB  max ${server.rssMb.max} MB`);
+    lines.push(`to clients    ${(traffic.bytesInPerSec.mean / 1024).toFixed(1)} KB/s, ${traffic.messagesInPerSec.mean} msg/s (mean)`);
+    lines.push(`from clients  ${(traffic.bytesOutPerSec.mean / 1024).toFixed(1)} KB/s, ${traffic.messagesOutPerSec.mean} msg/s (mean)`);
+    lines.push(`generator lag p99 ${report.generatorLagMs.p99} ms`);
+    if (report.errors.length > 0) lines.push(`⚠️ ${report.errors.length} errors: ${report.errors.slice(0, 3).join('; ')}`);
+    process.stderr.write(`${lines.join('\n')}\n`);
+}
+
+/**
+ * Compare with an earlier report: the metrics that got worse by more than
+ * tolerance percent
+ * @returns {string[]} Regressions
+ */
+function compareReports(report, baseline, tolerance) {
+    const regressions = [];
+    const check = (label, now, before) => {
+        if (now === null || before === null || now === undefined || before === undefined) return;
+        const change = before === 0 ? (now === 0 ? 0 : Infinity) : (now - before) / before * 100;
+        const line = `${label.padEnd(28)} ${String(before).padStart(10)} -> ${String(now).padStart(10)}  (${change >= 0 ? '+' : ''}${change.toFixed(0)}%)`;
+        process.stderr.write(`${line}\n`);
+        if (change > tolerance) regressions.push(line);
+    };
+    process.stderr.write(`\ncompared with ${baseline.date} (${baseline.options.students} students, mix ${baseline.options.mix})\n`);
+    if (baseline.options.students !== report.options.students || baseline.options.mix !== report.options.mix) {
+        process.stderr.write('⚠️ Different students or mix: the numbers are not comparable one to one\n');
+    }
+    for (const [kind, row] of Object.entries(report.latencyMs)) {
+        const before = baseline.latencyMs[kind];
+        if (!before) continue;
+        check(`${kind} p50 ms`, row.p50, before.p50);
+        check(`${kind} p99 ms`, row.p99, before.p99);
+    }
+    check('server CPU mean %', report.server.cpuPercent.mean, baseline.server.cpuPercent.mean);
+    check('server RSS max MB', report.server.rssMb.max, baseline.server.rssMb.max);
+    check('bytes to clients /s', report.traffic.bytesInPerSec.mean, baseline.traffic.bytesInPerSec.mean);
+    return regressions;
+}
+
+async function main() {
+    let options;
+    try {
+        options = parseArgs(process.argv.slice(2));
+    } catch (error) {
+        process.stderr.write(`❌ ${error.message}\n`);
+        process.exit(2);
+    }
+    if (options.help) {
+        process.stderr.write(`Usage: node tools/loadtest.js [--url ws://host:port] [--password pw] [--students n]\n` +
+            `  [--duration s] [--mix ${Object.keys(MIXES).join('|')}] [--seed n] [--out file.json]\n` +
+            `  [--baseline earlier.json] [--tolerance %]\n`);
+        return;
+    }
+
+    let report;
+    try {
+        report = await new LoadTest(options).run();
+    } catch (error) {
+        process.stderr.write(`❌ ${error.message}\n`);
+        process.exit(2);
+    }
+
+    printSummary(report);
+    const json = JSON.stringify(report, null, 2);
+    if (options.out) {
+        fs.writeFileSync(options.out, `${json}\n`);
+        process.stderr.write(`\n💾 Report saved to ${options.out}\n`);
+    } else {
+        process.stdout.write(`${json}\n`);
+    }
+
+    if (options.baseline) {
+        const baseline = JSON.parse(fs.readFileSync(options.baseline, 'utf8'));
+        const regressions = compareReports(report, baseline, options.tolerance);
+        if (regressions.length > 0) {
+            process.stderr.write(`\n❌ ${regressions.length} metrics worse by more than ${options.tolerance}%\n`);
+            process.exitCode = 1;
+        }
+    }
+}
+
+if (require.main === module) {
+    main();
+}
+
+module.exports = { LoadTest, parseArgs, compareReports };
@@ -0,0 +1,552 @@
+/**
+ * render-bench - What does the editor cost per keystroke, per drag step,
+ * per remote update?
+ *
+ * Loads the real GridEditor, SyntaxHighlighter, TextBuffer and language
+ * packs into a headless page (a small DOM stand-in, no dependencies) and
+ * times the operations behind each interaction on real documents: the
+ * solved exercises in content/, joined into 1000-line files.
+ *
+ * Scenarios:
+ *   highlight         SyntaxHighlighter.highlight of the whole C++ file (cold)
+ *   highlight-glossa  the same for a GLOSSA file
+ *   render            GridEditor.render() with nothing changed (cursor move)
+ *   type              one keystroke at line 500 (input -> insert -> render)
+ *   select-range      _selectRange over 300 lines
+ *   drag              mouse drag growing a selection to 300 lines, one step per row
+ *   remote-op         a remote character insert (applyRemoteOps + render)
+ *   remote-load       a remote template replacing the document (setValue)
+ *
+ * Each operation reports time (p50/p90/max), heap bytes allocated and the
+ * DOM nodes it creates (elements, plus the tags it writes as innerHTML).
+ * Times are JavaScript time only: there is no real layout or paint here,
+ * so compare runs with each other, not with the browser's profiler. There
+ * are no workers either, so renders highlight on the page (HighlightCache),
+ * the work EditorWorker does off the main thread in the browser.
+ *
+ *   npm run bench:render
+ *   node tools/render-bench.js --only type,drag --out before.json
+ *   node tools/render-bench.js --baseline before.json   (exit 1 on a regression)
+ *
+ * The JSON report goes to stdout (or --out); the table goes to stderr.
+ * Allocation figures need --expose-gc; the script restarts itself with it.
+ */
+
+const fs = require('fs');
+const path = require('path');
+const vm = require('vm');
+const v8 = require('v8');
+const { PerformanceObserver, performance } = require('perf_hooks');
+const { spawnSync } = require('child_process');
+
+const ROOT = path.join(__dirname, '..');
+
+// Scripts in index.html order (only those the editor needs)
+const SCRIPTS = [
+    'src/core/LexerCompiler.js',
+    'src/core/BlockIndex.js',
+    'src/core/TextBuffer.js',
+    'src/core/TextOps.js',
+    'src/core/UndoHistory.js',
+    'src/components/SyntaxHighlighter.js',
+    'src/components/GridEditor.js',
+    'src/components/RemoteCursorLayer.js',
+    'src/languages/cpp/keywords.js',
+    'src/languages/cpp/syntax.js',
+    'src/languages/glossa/keywords.js',
+    'src/languages/glossa/syntax.js'
+];
+
+const DEFAULTS = {
+    iterations: 200,
+    lines: 1000,
+    only: null,
+    out: null,
+    baseline: null,
+    tolerance: 20
+};
+
+const VIEWPORT_HEIGHT = 800;   // px of editor visible, as on a classroom laptop
+const TYPING_ROW = 500;
+const SELECTION_ROWS = 300;
+const SELECTION_FROM = 100;
+const WARMUP = 20;
+
+// V8 flags: a young generation big enough that one operation never triggers
+// a scavenge, so the heap growth across it is what it allocated
+const NODE_FLAGS = ['--expose-gc', '--max-semi-space-size=128'];
+
+// ============================================
+// Headless page
+// ============================================
+
+/**
+ * Just enough DOM for GridEditor: elements with style, classList,
+ * attributes and children, and innerHTML that is counted, not parsed.
+ */
+function createPage() {
+    const counters = { elements: 0, htmlNodes: 0, htmlBytes: 0 };
+
+    class ClassList {
+        constructor() { this.names = new Set(); }
+        add(...names) { names.forEach(name => this.names.add(name)); }
+        remove(...names) { names.forEach(name => this.names.delete(name)); }
+        contains(name) { return this.names.has(name); }
+        toggle(name, force = !this.names.has(name)) {
+            if (force) this.names.add(name);
+            else this.names.delete(name);
+            return force;
+        }
+    }
+
+    class Element {
+        constructor(tagName) {
+            counters.elements++;
+            this.tagName = tagName.toUpperCase();
+            this.children = [];
+            this.parentNode = null;
+            this.attributes = {};
+            this.style = { setProperty(name, value) { this[name] = value; } };
+            this.classList = new ClassList();
+            this.listeners = {};
+            this.value = '';
+            this.scrollTop = 0;
+            this.scrollLeft = 0;
+            this.clientHeight = 0;
+            this.clientWidth = 0;
+            this._html = '';
+            this._text = '';
+        }
+
+        get className() { return [...this.classList.names].join(' '); }
+        set className(value) {
+            this.classList = new ClassList();
+            String(value).split(/\s+/).filter(Boolean).forEach(name => this.classList.add(name));
+        }
+
+        get innerHTML() { return this._html; }
+        set innerHTML(html) {
+            // What the browser would have to parse: count the opening tags
+            this.children.forEach(child => { child.parentNode = null; });
+            this.children = [];
+            this._html = html;
+            counters.htmlBytes += html.length;
+            for (let i = html.indexOf('<'); i !== -1; i = html.indexOf('<', i + 1)) {
+                if (html.charCodeAt(i + 1) !== 47) counters.htmlNodes++; // Not '</'
+            }
+        }
+
+        get textContent() { return this._text; }
+        set textContent(text) {
+            this._text = String(text);
+            this._html = this._text.replace(/&/g, '&amp;').replace(/</g, '&lt;').replace(/>/g, '&gt;');
+        }
+
+        setAttribute(name, value) { this.attributes[name] = String(value); }
+        getAttribute(name) { return name in this.attributes ? this.attributes[name] : null; }
+        appendChild(child) {
+            if (child.parentNode) child.parentNode.removeChild(child);
+            child.parentNode = this;
+            this.children.push(child);
+            return child;
+        }
+        removeChild(child) {
+            const index = this.children.indexOf(child);
+            if (index !== -1) this.children.splice(index, 1);
+            child.parentNode = null;
+            return child;
+        }
+        remove() { if (this.parentNode) this.parentNode.removeChild(this); }
+        querySelector() { return null; }
+        querySelectorAll() { return []; }
+        addEventListener(type, handler) { (this.listeners[type] = this.listeners[type] || []).push(handler); }
+        removeEventListener() {}
+        getBoundingClientRect() { return { left: 0, top: 0, right: 0, bottom: 0, width: 0, height: 0 }; }
+        scrollTo(options) { if (options && options.top !== undefined) this.scrollTop = options.top; }
+        focus() {}
+        blur() {}
+    }
+
+    const document = {
+        body: new Element('body'),
+        head: new Element('head'),
+        activeElement: null,
+        createElement: tagName => new Element(tagName),
+        addEventListener() {},
+        removeEventListener() {},
+        querySelector: () => null,
+        querySelectorAll: () => []
+    };
+
+    const window = {
+        document,
+        console: { ...console, log() {} }, // The packs announce themselves
+        performance,
+        addEventListener() {},
+        removeEventListener() {},
+        // Frames never come: renders the editor schedules are left to the scenarios
+        requestAnimationFrame: () => 0,
+        cancelAnimationFrame: () => {},
+        setTimeout: () => 0,
+        clearTimeout: () => {}
+    };
+    window.window = window;
+    window.self = window;
+
+    const context = vm.createContext(window);
+    for (const script of SCRIPTS) {
+        const file = path.join(ROOT, script);
+        vm.runInContext(fs.readFileSync(file, 'utf8'), context, { filename: file });
+    }
+
+    // The editor asks the language manager which language to color
+    const language = { current: 'cpp' };
+    context.LanguageManager = { getCurrentLanguage: () => language.current };
+
+    return {
+        counters,
+        language,
+        run: code => vm.runInContext(code, context),
+        createEditor(options = {}) {
+            const container = document.createElement('div');
+            document.body.appendChild(container);
+            const editor = new (vm.runInContext('GridEditor', context))(container, options);
+            editor.gridElement.clientHeight = VIEWPORT_HEIGHT;
+            return editor;
+        }
+    };
+}
+
+// ============================================
+// Fixtures
+// ============================================
+
+/**
+ * The solved exercises of a language, joined until the file has `lines` lines
+ * @returns {string[]} Two different documents (for replacing one with the other)
+ */
+function loadDocuments(language, suffix, lines) {
+    const files = [];
+    const walk = (dir) => {
+        if (!fs.existsSync(dir)) return;
+        for (const entry of fs.readdirSync(dir, { withFileTypes: true })) {
+            const full = path.join(dir, entry.name);
+            if (entry.isDirectory()) walk(full);
+            else if (entry.name.endsWith(suffix)) files.push(full);
+        }
+    };
+    walk(path.join(ROOT, 'content', language, 'exercises'));
+    files.sort();
+    if (files.length === 0) throw new Error(`No ${suffix} files under content/${language}/exercises`);
+
+    const build = (offset) => {
+        const out = [];
+        for (let i = 0; out.length < lines; i++) {
+            const text = fs.readFileSync(files[(offset + i) % files.length], 'utf8');
+            out.push(...text.replace(/\r\n/g, '\n').split('\n'));
+        }
+        return out.slice(0, lines).join('\n');
+    };
+    return [build(0), build(Math.floor(files.length / 2))];
+}
+
+// ============================================
+// Measuring
+// ============================================
+
+const round = (value, digits = 3) => Math.round(value * 10 ** digits) / 10 ** digits;
+
+function percentile(sorted, p) {
+    if (sorted.length === 0) return null;
+    return sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))];
+}
+
+/**
+ * Run `op` `iterations` times after a warm-up; `prepare` runs untimed before each
+ * @returns {Object} Timings, allocation and DOM figures per operation
+ */
+function measure(page, iterations, op, prepare = () => {}) {
+    const gc = typeof global.gc === 'function' ? global.gc : null;
+    for (let i = 0; i < WARMUP; i++) {
+        prepare(i);
+        op(i);
+    }
+
+    const times = [];
+    const heap = [];
+    const elements = [];
+    const htmlNodes = [];
+    const windows = [];
+    for (let i = 0; i < iterations; i++) {
+        prepare(WARMUP + i);
+        if (gc) gc();
+        const counters = { ...page.counters };
+        const heapBefore = v8.getHeapStatistics().used_heap_size;
+        const start = performance.now();
+        op(WARMUP + i);
+        const end = performance.now();
+        const heapAfter = v8.getHeapStatistics().used_heap_size;
+        times.push(end - start);
+        windows.push([start, end]);
+        heap.push(heapAfter - heapBefore);
+        elements.push(page.counters.elements - counters.elements);
+        htmlNodes.push(page.counters.htmlNodes - counters.htmlNodes);
+    }
+
+    const sorted = times.slice().sort((a, b) => a - b);
+    const mean = values => values.reduce((a, b) => a + b, 0) / values.length;
+    return {
+        iterations,
+        ms: {
+            p50: round(percentile(sorted, 0.5)),
+            p90: round(percentile(sorted, 0.9)),
+            max: round(sorted[sorted.length - 1]),
+            mean: round(mean(times))
+        },
+        // A negative delta means a collection ran mid-operation: leave it out
+        heapBytes: gc ? Math.round(mean(heap.filter(bytes => bytes >= 0)) || 0) : null,
+        domNodes: Math.round(mean(elements) + mean(htmlNodes)),
+        _windows: windows
+    };
+}
+
+// ============================================
+// Scenarios
+// ============================================
+
+/**
+ * @returns {Object<string, Function>} name -> (page, options) => measurement
+ */
+function createScenarios(fixtures) {
+    const [cppA, cppB] = fixtures.cpp;
+    const [glossa] = fixtures.glossa;
+
+    // A C++ editor showing the rows around `row`
+    const editorAt = (page, text, row) => {
+        page.language.current = 'cpp';
+        const editor = page.createEditor();
+        editor.setValue(text, { skipUndo: true });
+        editor.gridElement.scrollTop = Math.max(0, row * editor.charHeight - VIEWPORT_HEIGHT / 3);
+        editor.cursor = { row, col: 0 };
+        editor.render();
+        return editor;
+    };
+
+    return {
+        'highlight': (page, { iterations }) => {
+            const lines = cppA.split('\n');
+            const SyntaxHighlighter = page.run('SyntaxHighlighter');
+            return measure(page, iterations, () => SyntaxHighlighter.highlight(lines, 'cpp'));
+        },
+
+        'highlight-glossa': (page, { iterations }) => {
+            const lines = glossa.split('\n');
+            const SyntaxHighlighter = page.run('SyntaxHighlighter');
+            return measure(page, iterations, () => SyntaxHighlighter.highlight(lines, 'glossa'));
+        },
+
+        'render': (page, { iterations }) => {
+            const editor = editorAt(page, cppA, TYPING_ROW);
+            return measure(page, iterations, () => editor.render(),
+                (i) => { editor.cursor = { row: TYPING_ROW + (i % 10), col: i % 20 }; });
+        },
+
+        'type': (page, { iterations }) => {
+            const editor = editorAt(page, cppA, TYPING_ROW);
+            const text = cppB.replace(/\s+/g, ' ');
+            return measure(page, iterations, (i) => {
+                editor.hiddenInput.value = text[i % text.length];
+                editor._handleInput({});
+            });
+        },
+
+        'select-range': (page, { iterations }) => {
+            const editor = editorAt(page, cppA, SELECTION_FROM);
+            const from = { row: SELECTION_FROM, col: 0 };
+            const to = { row: SELECTION_FROM + SELECTION_ROWS, col: 5 };
+            return measure(page, iterations, () => editor._selectRange(from, to));
+        },
+
+        'drag': (page, { iterations }) => {
+            // One mousemove per row, scrolling along like the browser does while
+            // dragging; always whole drags, from 1 to SELECTION_ROWS rows selected
+            const editor = editorAt(page, cppA, SELECTION_FROM);
+            const padding = 15;
+            let row = SELECTION_FROM;
+            const prepare = (i) => {
+                const step = Math.max(0, i - WARMUP) % SELECTION_ROWS;
+                row = SELECTION_FROM + 1 + step;
+                if (step === 0) {
+                    editor.clearSelection();
+                    editor.selectionAnchor = { row: SELECTION_FROM, col: 0 };
+                    editor.isDragging = true;
+                }
+                editor.gridElement.scrollTop = Math.max(0, (row + 5) * editor.charHeight - VIEWPORT_HEIGHT);
+            };
+            return measure(page, Math.ceil(iterations / SELECTION_ROWS) * SELECTION_ROWS, () => editor._handleMouseMove({
+                clientX: padding + 4.5 * editor.charWidth,
+                clientY: padding + (row + 0.5) * editor.charHeight - editor.gridElement.scrollTop
+            }), prepare);
+        },
+
+        'remote-op': (page, { iterations }) => {
+            // The teacher typing at line 500 while this student reads the same rows
+            const editor = editorAt(page, cppA, TYPING_ROW);
+            let offset = editor.buffer.offsetAt(TYPING_ROW, 0);
+            return measure(page, iterations, () => {
+                editor.applyRemoteOps([{ offset: offset++, deleteCount: 0, text: 'x' }]);
+            });
+        },
+
+        'remote-load': (page, { iterations }) => {
+            // A template from the teacher, as Collaboration applies it
+            const editor = editorAt(page, cppA, 0);
+            return measure(page, iterations, (i) => {
+                editor.setValue(i % 2 ? cppA : cppB, { skipNotify: true, preserveCursor: true, skipUndo: true });
+            });
+        }
+    };
+}
+
+// ============================================
+// Report
+// ============================================
+
+function parseArgs(argv) {
+    const options = { ...DEFAULTS };
+    for (let i = 0; i < argv.length; i++) {
+        const name = argv[i].replace(/^--/, '');
+        if (name === 'help' || name === 'h') {
+            options.help = true;
+            continue;
+        }
+        if (!(name in DEFAULTS)) throw new Error(`Unknown option --${name}`);
+        const value = argv[++i];
+        if (value === undefined) throw new Error(`--${name} needs a value`);
+        options[name] = typeof DEFAULTS[name] === 'number' ? Number(value) : value;
+    }
+    return options;
+}
+
+function printSummary(report) {
+    const lines = ['', 'operation           p50 ms   p90 ms   max ms   heap KB  DOM nodes  GCs'];
+    for (const [name, row] of Object.entries(report.scenarios)) {
+        const cell = (value, width = 8) => String(value === null ? '-' : value).padStart(width);
+        lines.push(`${name.padEnd(17)} ${cell(row.ms.p50)} ${cell(row.ms.p90)} ${cell(row.ms.max)} ` +
+            `${cell(row.heapBytes === null ? null : round(row.heapBytes / 1024, 1), 9)} ${cell(row.domNodes, 10)} ${cell(row.gcDuringOps, 4)}`);
+    }
+    lines.push(`\n${report.lines}-line documents from content/, ${report.iterations} iterations, node ${process.version}`);
+    process.stderr.write(`${lines.join('\n')}\n`);
+}
+
+/**
+ * Compare with an earlier report: the operations that got slower (p50) or
+ * allocate more by more than tolerance percent
+ * @returns {string[]} Regressions
+ */
+function compareReports(report, baseline, tolerance) {
+    const regressions = [];
+    const check = (label, now, before) => {
+        if (now === null || before === null || now === undefined || before === undefined) return;
+        const change = before === 0 ? (now === 0 ? 0 : Infinity) : (now - before) / before * 100;
+        const line = `${label.padEnd(28)} ${String(before).padStart(10)} -> ${String(now).padStart(10)}  (${change >= 0 ? '+' : ''}${change.toFixed(0)}%)`;
+        process.stderr.write(`${line}\n`);
+        if (change > tolerance) regressions.push(line);
+    };
+    process.stderr.write(`\ncompared with ${baseline.date}\n`);
+    for (const [name, row] of Object.entries(report.scenarios)) {
+        const before = baseline.scenarios[name];
+        if (!before) continue;
+        check(`${name} p50 ms`, row.ms.p50, before.ms.p50);
+        check(`${name} heap bytes`, row.heapBytes, before.heapBytes);
+        check(`${name} DOM nodes`, row.domNodes, before.domNodes);
+    }
+    return regressions;
+}
+
+function main() {
+    // Restart with the flags allocation counting needs
+    if (typeof global.gc !== 'function' && !process.env.RENDER_BENCH_CHILD) {
+        const child = spawnSync(process.execPath, [...NODE_FLAGS, __filename, ...process.argv.slice(2)], {
+            stdio: 'inherit',
+            env: { ...process.env, RENDER_BENCH_CHILD: '1' }
+        });
+        process.exit(child.status === null ? 1 : child.status);
+    }
+
+    let options;
+    try {
+        options = parseArgs(process.argv.slice(2));
+    } catch (error) {
+        process.stderr.write(`❌ ${error.message}\n`);
+        process.exit(2);
+    }
+
+    const fixtures = {
+        cpp: loadDocuments('cpp', '-solved.cpp', options.lines),
+        glossa: loadDocuments('glossa', '-solved.gls', options.lines)
+    };
+    const scenarios = createScenarios(fixtures);
+    const names = options.only ? options.only.split(',') : Object.keys(scenarios);
+    const unknown = names.filter(name => !scenarios[name]);
+    if (options.help || unknown.length > 0) {
+        if (unknown.length > 0) process.stderr.write(`❌ Unknown scenario: ${unknown.join(', ')}\n`);
+        process.stderr.write(`Usage: node tools/render-bench.js [--only ${Object.keys(scenarios).join(',')}]\n` +
+            `  [--iterations n] [--lines n] [--out file.json] [--baseline earlier.json] [--tolerance %]\n`);
+        process.exit(unknown.length > 0 ? 2 : 0);
+    }
+
+    // Collections running inside a timed operation
+    const gcs = [];
+    const observer = new PerformanceObserver(list => gcs.push(...list.getEntries()));
+    observer.observe({ entryTypes: ['gc'] });
+
+    const report = {
+        tool: 'render-bench',
+        format: 1,
+        date: new Date().toISOString(),
+        node: process.version,
+        lines: options.lines,
+        iterations: options.iterations,
+        scenarios: {}
+    };
+    for (const name of names) {
+        // A fresh page per scenario, so one's garbage is not another's
+        const page = createPage();
+        report.scenarios[name] = scenarios[name](page, options);
+    }
+
+    // Entries arrive asynchronously
+    setImmediate(() => {
+        observer.disconnect();
+        for (const result of Object.values(report.scenarios)) {
+            result.gcDuringOps = result._windows.reduce((count, [start, end]) =>
+                count + gcs.filter(entry => entry.startTime >= start && entry.startTime < end).length, 0);
+            delete result._windows;
+        }
+
+        printSummary(report);
+        const json = JSON.stringify(report, null, 2);
+        if (options.out) {
+            fs.writeFileSync(options.out, `${json}\n`);
+            process.stderr.write(`💾 Report saved to ${options.out}\n`);
+        } else {
+            process.stdout.write(`${json}\n`);
+        }
+
+        if (options.baseline) {
+            const baseline = JSON.parse(fs.readFileSync(options.baseline, 'utf8'));
+            const regressions = compareReports(report, baseline, options.tolerance);
+            if (regressions.length > 0) {
+                process.stderr.write(`\n❌ ${regressions.length} metrics worse by more than ${options.tolerance}%\n`);
+                process.exitCode = 1;
+            }
+        }
+    });
+}
+
+if (require.main === module) {
+    main();
+}
+
+module.exports = { createPage, createScenarios, measure };